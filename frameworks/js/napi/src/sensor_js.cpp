@@ -496,6 +496,87 @@ static napi_value EmitAsyncWork(napi_value param, sptr<AsyncCallbackInfo> info)
     return promise;
 }
 
+static bool GetGeomagneticPositions(napi_env env, napi_value locations, napi_value times,
+    GeomagneticPositions &positions)
+{
+    uint32_t count = 0;
+    CHKNRF(env, napi_get_array_length(env, locations, &count), "napi_get_array_length");
+    positions.latitudes.reserve(count);
+    positions.longitudes.reserve(count);
+    positions.altitudes.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        napi_value location = nullptr;
+        CHKNRF(env, napi_get_element(env, locations, i, &location), "napi_get_element");
+        CHKNCF(env, IsMatchType(env, location, napi_object), "Wrong argument type. Object expected");
+        double value[3] = { 0.0 };
+        const char *names[] = { "latitude", "longitude", "altitude" };
+        for (size_t j = 0; j < sizeof(names) / sizeof(names[0]); ++j) {
+            napi_value property = GetNamedProperty(env, location, names[j]);
+            CHKPF(property);
+            CHKNCF(env, GetNativeDouble(env, property, value[j]), "Get location fail");
+        }
+        positions.latitudes.push_back(static_cast<float>(value[0]));
+        positions.longitudes.push_back(static_cast<float>(value[1]));
+        positions.altitudes.push_back(static_cast<float>(value[2]));
+    }
+    if (!IsMatchArrayType(env, times)) {
+        int64_t timeMillis = 0;
+        CHKNCF(env, GetNativeInt64(env, times, timeMillis), "Get timeMillis fail");
+        positions.timeMillis.push_back(timeMillis);
+        return true;
+    }
+    uint32_t timeCount = 0;
+    CHKNRF(env, napi_get_array_length(env, times, &timeCount), "napi_get_array_length");
+    CHKNCF(env, timeCount == count, "Number of times does not match number of locations");
+    positions.timeMillis.reserve(timeCount);
+    for (uint32_t i = 0; i < timeCount; ++i) {
+        napi_value element = nullptr;
+        CHKNRF(env, napi_get_element(env, times, i, &element), "napi_get_element");
+        int64_t timeMillis = 0;
+        CHKNCF(env, GetNativeInt64(env, element, timeMillis), "Get timeMillis fail");
+        positions.timeMillis.push_back(timeMillis);
+    }
+    return true;
+}
+
+// Batch form of getGeomagneticField: an array of locations with one shared time or an array of times.
+static napi_value GetGeomagneticFields(napi_env env, napi_value args[], size_t argc)
+{
+    CALL_LOG_ENTER;
+    GeomagneticPositions positions;
+    if (!GetGeomagneticPositions(env, args[0], args[1], positions)) {
+        ThrowErr(env, PARAMETER_ERROR, "Get locations or timeMillis fail");
+        return nullptr;
+    }
+    GeomagneticComponents components;
+    if (GeomagneticField::ObtainBatch(positions, components) != SUCCESS) {
+        ThrowErr(env, PARAMETER_ERROR, "Obtain geomagnetic fields fail");
+        return nullptr;
+    }
+    sptr<AsyncCallbackInfo> asyncCallbackInfo =
+        new (std::nothrow) AsyncCallbackInfo(env, GET_GEOMAGNETIC_FIELDS);
+    CHKPP(asyncCallbackInfo);
+    asyncCallbackInfo->geomagneticDatas.reserve(components.x.size());
+    for (size_t i = 0; i < components.x.size(); ++i) {
+        float x = components.x[i];
+        float y = components.y[i];
+        float z = components.z[i];
+        asyncCallbackInfo->geomagneticDatas.push_back({
+            .x = x,
+            .y = y,
+            .z = z,
+            .geomagneticDip = GeomagneticField::CalculateGeomagneticDip(x, y, z),
+            .deflectionAngle = GeomagneticField::CalculateDeflectionAngle(x, y),
+            .levelIntensity = GeomagneticField::CalculateLevelIntensity(x, y),
+            .totalIntensity = GeomagneticField::CalculateTotalIntensity(x, y, z),
+        });
+    }
+    if (argc >= 3 && IsMatchType(env, args[2], napi_function)) {
+        return EmitAsyncWork(args[2], asyncCallbackInfo);
+    }
+    return EmitAsyncWork(nullptr, asyncCallbackInfo);
+}
+
 static napi_value GetGeomagneticField(napi_env env, napi_callback_info info)
 {
     CALL_LOG_ENTER;
@@ -507,6 +588,9 @@ static napi_value GetGeomagneticField(napi_env env, napi_callback_info info)
         ThrowErr(env, PARAMETER_ERROR, "napi_get_cb_info fail or number of parameter invalid");
         return nullptr;
     }
+    if (IsMatchArrayType(env, args[0])) {
+        return GetGeomagneticFields(env, args, argc);
+    }
     if ((!IsMatchType(env, args[0], napi_object)) || (!IsMatchType(env, args[1], napi_number))) {
         ThrowErr(env, PARAMETER_ERROR, "Wrong argument type");
         return nullptr;
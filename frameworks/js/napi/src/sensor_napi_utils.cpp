@@ -189,6 +189,7 @@ std::map<int32_t, ConvertDataFunc> g_convertfuncList = {
     {ON_CALLBACK, ConvertToSensorData},
     {ONCE_CALLBACK, ConvertToSensorData},
     {GET_GEOMAGNETIC_FIELD, ConvertToGeomagneticData},
+    {GET_GEOMAGNETIC_FIELDS, ConvertToGeomagneticDatas},
     {GET_ALTITUDE, ConvertToNumber},
     {GET_GEOMAGNETIC_DIP, ConvertToNumber},
     {GET_ANGLE_MODIFY, ConvertToArray},
@@ -204,33 +205,32 @@ std::map<int32_t, ConvertDataFunc> g_convertfuncList = {
     {SUBSCRIBE_COMPASS, ConvertToCompass},
 };
 
-bool getJsonObject(const napi_env &env, sptr<AsyncCallbackInfo> asyncCallbackInfo, napi_value &result)
+bool getJsonObject(const napi_env &env, const GeomagneticData &geomagneticData, napi_value &result)
 {
-    CHKPF(asyncCallbackInfo);
     CHKNRF(env, napi_create_object(env, &result), "napi_create_object");
     napi_value value = nullptr;
-    CHKNRF(env, napi_create_double(env, asyncCallbackInfo->data.geomagneticData.x, &value), "napi_create_double");
+    CHKNRF(env, napi_create_double(env, geomagneticData.x, &value), "napi_create_double");
     CHKNRF(env, napi_set_named_property(env, result, "x", value), "napi_set_named_property");
     value = nullptr;
-    CHKNRF(env, napi_create_double(env, asyncCallbackInfo->data.geomagneticData.y, &value), "napi_create_double");
+    CHKNRF(env, napi_create_double(env, geomagneticData.y, &value), "napi_create_double");
     CHKNRF(env, napi_set_named_property(env, result, "y", value), "napi_set_named_property");
     value = nullptr;
-    CHKNRF(env, napi_create_double(env, asyncCallbackInfo->data.geomagneticData.z, &value), "napi_create_double");
+    CHKNRF(env, napi_create_double(env, geomagneticData.z, &value), "napi_create_double");
     CHKNRF(env, napi_set_named_property(env, result, "z", value), "napi_set_named_property");
     value = nullptr;
-    CHKNRF(env, napi_create_double(env, asyncCallbackInfo->data.geomagneticData.geomagneticDip, &value),
+    CHKNRF(env, napi_create_double(env, geomagneticData.geomagneticDip, &value),
         "napi_create_double");
     CHKNRF(env, napi_set_named_property(env, result, "geomagneticDip", value), "napi_set_named_property");
     value = nullptr;
-    CHKNRF(env, napi_create_double(env, asyncCallbackInfo->data.geomagneticData.deflectionAngle, &value),
+    CHKNRF(env, napi_create_double(env, geomagneticData.deflectionAngle, &value),
         "napi_create_double");
     CHKNRF(env, napi_set_named_property(env, result, "deflectionAngle", value), "napi_set_named_property");
     value = nullptr;
-    CHKNRF(env, napi_create_double(env, asyncCallbackInfo->data.geomagneticData.levelIntensity, &value),
+    CHKNRF(env, napi_create_double(env, geomagneticData.levelIntensity, &value),
         "napi_create_double");
     CHKNRF(env, napi_set_named_property(env, result, "levelIntensity", value), "napi_set_named_property");
     value = nullptr;
-    CHKNRF(env, napi_create_double(env, asyncCallbackInfo->data.geomagneticData.totalIntensity, &value),
+    CHKNRF(env, napi_create_double(env, geomagneticData.totalIntensity, &value),
         "napi_create_double");
     CHKNRF(env, napi_set_named_property(env, result, "totalIntensity", value), "napi_set_named_property");
     return true;
@@ -347,7 +347,22 @@ bool ConvertToSensorData(const napi_env &env, sptr<AsyncCallbackInfo> asyncCallb
 bool ConvertToGeomagneticData(const napi_env &env, sptr<AsyncCallbackInfo> asyncCallbackInfo, napi_value result[2])
 {
     CALL_LOG_ENTER;
-    return getJsonObject(env, asyncCallbackInfo, result[1]);
+    CHKPF(asyncCallbackInfo);
+    return getJsonObject(env, asyncCallbackInfo->data.geomagneticData, result[1]);
+}
+
+bool ConvertToGeomagneticDatas(const napi_env &env, sptr<AsyncCallbackInfo> asyncCallbackInfo, napi_value result[2])
+{
+    CALL_LOG_ENTER;
+    CHKPF(asyncCallbackInfo);
+    CHKNRF(env, napi_create_array(env, &result[1]), "napi_create_array");
+    const auto &geomagneticDatas = asyncCallbackInfo->geomagneticDatas;
+    for (uint32_t i = 0; i < geomagneticDatas.size(); ++i) {
+        napi_value value = nullptr;
+        CHKNCF(env, getJsonObject(env, geomagneticDatas[i], value), "Convert geomagnetic data fail");
+        CHKNRF(env, napi_set_element(env, result[1], i, value), "napi_set_element");
+    }
+    return true;
 }
 
 bool ConvertToBodyData(const napi_env &env, sptr<AsyncCallbackInfo> asyncCallbackInfo, napi_value result[2])
@@ -16,29 +16,152 @@
 #ifndef GEOMAGNETIC_FIELD_H
 #define GEOMAGNETIC_FIELD_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+/**
+ * Positions for {@link GeomagneticField::ObtainBatch} in structure-of-arrays layout.
+ * latitudes, longitudes and altitudes must have the same size. timeMillis holds either one time per position or a
+ * single time shared by all positions.
+ */
+struct GeomagneticPositions {
+    std::vector<float> latitudes;
+    std::vector<float> longitudes;
+    std::vector<float> altitudes;
+    std::vector<int64_t> timeMillis;
+};
+
+/**
+ * North, east and down components of the field for each position, in nanotesla.
+ */
+struct GeomagneticComponents {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+};
+
+/**
+ * Cache mode of {@link GeomagneticField}. When enabled, positions are snapped to a grid of the given resolutions and
+ * the field of each grid cell center is kept in a per-thread LRU cache, so repeated requests within one cell reuse
+ * the same result instead of rerunning the spherical harmonic expansion.
+ */
+struct GeomagneticCacheConfig {
+    bool enable { false };
+    /** Cell size in degrees. */
+    float latitudeResolution { 0.01f };
+    /** Cell size in degrees. */
+    float longitudeResolution { 0.01f };
+    /** Cell size in meters. */
+    float altitudeResolution { 100.0f };
+    /** Cell size in milliseconds. */
+    int64_t timeResolutionMillis { 86400000 };
+    /** Maximum number of cells cached by each thread. */
+    size_t capacity { 256 };
+};
+
+struct GeomagneticCacheStats {
+    uint64_t hits { 0 };
+    uint64_t misses { 0 };
+};
+
+/**
+ * World Magnetic Model evaluation at one position and time.
+ * All intermediate state lives in the instance, so separate instances can be evaluated concurrently without locks.
+ */
 class GeomagneticField {
 public:
     GeomagneticField(float latitude, float longitude, float altitude, int64_t timeMillis);
     ~GeomagneticField() = default;
-    float ObtainX();
-    float ObtainY();
-    float ObtainZ();
-    float ObtainGeomagneticDip();
-    float ObtainDeflectionAngle();
-    float ObtainLevelIntensity();
-    float ObtainTotalIntensity();
+    float ObtainX() const;
+    float ObtainY() const;
+    float ObtainZ() const;
+    float ObtainGeomagneticDip() const;
+    float ObtainDeflectionAngle() const;
+    float ObtainLevelIntensity() const;
+    float ObtainTotalIntensity() const;
+
+    /**
+     * @brief Evaluate the model for many positions at once.
+     * Positions are processed in blocks whose Legendre recursion and harmonic sums run across the block, and the
+     * time dependent Gauss coefficients are computed once per distinct time.
+     *
+     * @param positions Positions to evaluate, see {@link GeomagneticPositions}.
+     * @param components Receives the components of each position.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    static int32_t ObtainBatch(const GeomagneticPositions &positions, GeomagneticComponents &components);
+    static float CalculateGeomagneticDip(float x, float y, float z);
+    static float CalculateDeflectionAngle(float x, float y);
+    static float CalculateLevelIntensity(float x, float y);
+    static float CalculateTotalIntensity(float x, float y, float z);
+
+    /**
+     * @brief Enable, reconfigure or disable the cache mode for all threads. Cached cells are dropped.
+     *
+     * @param config Cache configuration, resolutions are raised to their supported minimum.
+     */
+    static void SetCacheMode(const GeomagneticCacheConfig &config);
+    static GeomagneticCacheConfig GetCacheMode();
+
+    /**
+     * @brief Choose grid resolutions so that a cached result differs from the exact one by at most
+     * 'maxErrorNanotesla' on each component.
+     * The bound relies on the largest gradients of the model over the globe, time is rounded to whole days.
+     *
+     * @param maxErrorNanotesla Tolerated error in nanotesla.
+     * @param capacity Maximum number of cells cached by each thread.
+     *
+     * @return Returns an enabled cache configuration.
+     */
+    static GeomagneticCacheConfig CreateCacheConfig(float maxErrorNanotesla, size_t capacity);
+    static GeomagneticCacheStats GetCacheStats();
+    static void ResetCacheStats();
+
+    static constexpr int32_t COEFFICIENT_DIMENSION = 13;
+    // Coefficients of degree n and order m are stored flat at n * (n + 1) / 2 + m.
+    static constexpr int32_t TRIANGLE_SIZE = COEFFICIENT_DIMENSION * (COEFFICIENT_DIMENSION + 1) / 2;
+
+    // Number of positions evaluated together by ObtainBatch.
+    static constexpr size_t BATCH_LANES = 8;
 
 private:
-    std::vector<std::vector<float>> GetSchmidtQuasiNormalFactors(int32_t expansionDegree);
-    void CalculateGeomagneticComponent(double latDiffRad, int64_t timeMillis);
+    struct GaussCoefficients {
+        std::array<float, TRIANGLE_SIZE> g {};
+        std::array<float, TRIANGLE_SIZE> h {};
+    };
+    struct GeocentricCoordinates {
+        float latitude { 0.0f };
+        float longitude { 0.0f };
+        float radius { 0.0f };
+    };
+    struct BlockCoefficients;
+
+    void Calculate(float latitude, float longitude, float altitude, int64_t timeMillis);
+    void CalculateGeomagneticComponent(double latDiffRad, const GaussCoefficients &coefficients);
     void GetLongitudeTrigonometric();
     void GetRelativeRadiusPower();
-    void CalibrateGeocentricCoordinates(float latitude, float longitude, float altitude);
     void InitLegendreTable(int32_t expansionDegree, float thetaRad);
-    double ToDegrees(double angrad);
-    double ToRadians(double angdeg);
+    static GeocentricCoordinates CalibrateGeocentricCoordinates(float latitude, float longitude, float altitude);
+    static void GetGaussCoefficients(int64_t timeMillis, GaussCoefficients &coefficients);
+    static void CalculateBlock(const GeomagneticPositions &positions, size_t first, size_t count,
+        const BlockCoefficients &coefficients, GeomagneticComponents &components);
+    static double ToDegrees(double angrad);
+    static double ToRadians(double angdeg);
+
+private:
+    float northComponent_ { 0.0f };
+    float eastComponent_ { 0.0f };
+    float downComponent_ { 0.0f };
+    float geocentricLatitude_ { 0.0f };
+    float geocentricLongitude_ { 0.0f };
+    float geocentricRadius_ { 0.0f };
+    std::array<float, TRIANGLE_SIZE> polynomials_ {};
+    std::array<float, TRIANGLE_SIZE> polynomialsDerivative_ {};
+    std::array<float, COEFFICIENT_DIMENSION + 2> relativeRadiusPower_ {};
+    std::array<float, COEFFICIENT_DIMENSION> sinMLongitude_ {};
+    std::array<float, COEFFICIENT_DIMENSION> cosMLongitude_ {};
 };
-#endif // GEOMAGNETIC_FIELD_H
\ No newline at end of file
+#endif // GEOMAGNETIC_FIELD_H
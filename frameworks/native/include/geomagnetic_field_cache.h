@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GEOMAGNETIC_FIELD_CACHE_H
+#define GEOMAGNETIC_FIELD_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Grid cell of the quantized (latitude, longitude, altitude, time) space.
+ */
+struct GeomagneticCacheKey {
+    int64_t latitude { 0 };
+    int64_t longitude { 0 };
+    int64_t altitude { 0 };
+    int64_t period { 0 };
+
+    bool operator==(const GeomagneticCacheKey &other) const
+    {
+        return (latitude == other.latitude) && (longitude == other.longitude) && (altitude == other.altitude) &&
+            (period == other.period);
+    }
+};
+
+struct GeomagneticCacheKeyHash {
+    size_t operator()(const GeomagneticCacheKey &key) const;
+};
+
+struct GeomagneticCacheValue {
+    float x { 0.0f };
+    float y { 0.0f };
+    float z { 0.0f };
+};
+
+/**
+ * Least recently used map from grid cells to field components. Not thread safe, each thread owns its own cache.
+ */
+class GeomagneticFieldCache {
+public:
+    explicit GeomagneticFieldCache(size_t capacity = 0);
+    ~GeomagneticFieldCache() = default;
+    bool Find(const GeomagneticCacheKey &key, GeomagneticCacheValue &value);
+    void Insert(const GeomagneticCacheKey &key, const GeomagneticCacheValue &value);
+    void Reset(size_t capacity);
+    size_t Size() const;
+
+private:
+    using Entry = std::pair<GeomagneticCacheKey, GeomagneticCacheValue>;
+    size_t capacity_ { 0 };
+    // Most recently used entry first.
+    std::list<Entry> entries_;
+    std::unordered_map<GeomagneticCacheKey, std::list<Entry>::iterator, GeomagneticCacheKeyHash> index_;
+};
+#endif // GEOMAGNETIC_FIELD_CACHE_H
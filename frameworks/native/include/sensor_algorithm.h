@@ -16,11 +16,65 @@
 #ifndef SENSOR_ALGORITHM_H
 #define SENSOR_ALGORITHM_H
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+#include "sensor_agent_type.h"
+
+/**
+ * Rotation vectors in structure-of-arrays layout, x, y and z must have the same size. w holds the scalar part of
+ * each sample; when it is empty the samples are treated as 3 element rotation vectors and w is derived from x, y, z.
+ */
+struct RotationVectorBatch {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> w;
+};
+
+/**
+ * Unit quaternions (w, x, y, z) in structure-of-arrays layout.
+ */
+struct QuaternionBatch {
+    std::vector<float> w;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+};
+
+/**
+ * Row-major 3x3 rotation matrices in structure-of-arrays layout: elements[i][k] is element i of sample k.
+ */
+struct RotationMatrixBatch {
+    std::array<std::vector<float>, 9> elements;
+};
+
+/**
+ * Angles in radians in structure-of-arrays layout, laid out like the rotationAngle output of
+ * {@link SensorAlgorithm::GetDirection} (around the z, x and y axes).
+ */
+struct OrientationBatch {
+    std::vector<float> z;
+    std::vector<float> x;
+    std::vector<float> y;
+};
+
+/**
+ * Orientation helpers. Every operation has a std::vector form whose sizes are checked at run time and a std::array
+ * form whose sizes are template parameters: rotation vectors hold 3 or 4 elements and matrices are row-major 3x3
+ * (9 elements) or 4x4 (16 elements). The std::array forms do not allocate, the std::vector forms copy through them.
+ */
 class SensorAlgorithm {
 public:
+    static constexpr size_t QUATERNION_LENGTH = 4;
+    static constexpr size_t ROTATION_VECTOR_LENGTH = 3;
+    static constexpr size_t THREE_DIMENSIONAL_MATRIX_LENGTH = 9;
+    static constexpr size_t FOUR_DIMENSIONAL_MATRIX_LENGTH = 16;
+    using Quaternion = std::array<float, QUATERNION_LENGTH>;
+    using Vector3 = std::array<float, ROTATION_VECTOR_LENGTH>;
+
     SensorAlgorithm() = default;
     ~SensorAlgorithm() = default;
     int32_t CreateQuaternion(std::vector<float> rotationVector, std::vector<float> &quaternion);
@@ -35,13 +89,79 @@ public:
     int32_t CreateRotationAndInclination(std::vector<float> gravity, std::vector<float> geomagnetic,
                                         std::vector<float> &rotationMatrix, std::vector<float> &inclinationMatrix);
 
+    template<size_t V>
+    int32_t CreateQuaternion(const std::array<float, V> &rotationVector, Quaternion &quaternion);
+    /**
+     * @brief Remap the axes of a rotation matrix, 'inRotationMatrix' and 'outRotationMatrix' may be the same object.
+     */
+    template<size_t N>
+    int32_t TransformCoordinateSystem(const std::array<float, N> &inRotationMatrix, int32_t axisX, int32_t axisY,
+        std::array<float, N> &outRotationMatrix);
+    template<size_t N>
+    int32_t GetGeomagneticDip(const std::array<float, N> &inclinationMatrix, float *geomagneticDip);
+    template<size_t C, size_t P>
+    int32_t GetAngleModify(const std::array<float, C> &curRotationMatrix, const std::array<float, P> &preRotationMatrix,
+        Vector3 &angleChange);
+    template<size_t N>
+    int32_t GetDirection(const std::array<float, N> &rotationMatrix, Vector3 &rotationAngle);
+    template<size_t V, size_t N>
+    int32_t CreateRotationMatrix(const std::array<float, V> &rotationVector, std::array<float, N> &rotationMatrix);
+    template<size_t R, size_t I>
+    int32_t CreateRotationAndInclination(const Vector3 &gravity, const Vector3 &geomagnetic,
+        std::array<float, R> &rotationMatrix, std::array<float, I> &inclinationMatrix);
+
+    /**
+     * @brief Append the payload of rotation vector events to 'batch', events of other sensor types are skipped.
+     * Subscribers receive one event per callback, so a caller collects the events of several callbacks and loads
+     * them together before running the batch kernels.
+     *
+     * @param events Collected events.
+     * @param num Number of events.
+     * @param batch Receives x, y, z and w of each rotation vector event.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    int32_t LoadRotationVectors(const SensorEvent *events, int32_t num, RotationVectorBatch &batch);
+
+    /**
+     * @brief Batch form of {@link CreateQuaternion}, four samples per SIMD step.
+     * Output vectors are resized to the sample count, their capacity is reused between calls.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    int32_t CreateQuaternionBatch(const RotationVectorBatch &rotationVectors, QuaternionBatch &quaternions);
+
+    /**
+     * @brief Batch form of {@link CreateRotationMatrix} producing 3x3 matrices.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    int32_t CreateRotationMatrixBatch(const RotationVectorBatch &rotationVectors,
+        RotationMatrixBatch &rotationMatrices);
+
+    /**
+     * @brief Batch form of {@link GetDirection}.
+     * atan2 is replaced by a polynomial approximation, the angles are within 1e-6 radians of {@link GetDirection},
+     * 2 float ulps at pi on sampled rotations.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    int32_t GetDirectionBatch(const RotationMatrixBatch &rotationMatrices, OrientationBatch &rotationAngles);
+
+    /**
+     * @brief Batch form of {@link GetAngleModify}, sample k of 'curRotationMatrices' is compared with sample k of
+     * 'preRotationMatrices'. atan2 and asin are replaced by polynomial approximations, the angles are within 1e-6
+     * radians of {@link GetAngleModify}, 2 float ulps at pi on sampled rotations.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    int32_t GetAngleModifyBatch(const RotationMatrixBatch &curRotationMatrices,
+        const RotationMatrixBatch &preRotationMatrices, OrientationBatch &angleChanges);
+
 private:
-    int32_t TransformCoordinateSystemImpl(std::vector<float> inRotationMatrix, int32_t axisX,
-                                                           int32_t axisY, std::vector<float> &outRotationMatrix);
-    static constexpr int32_t QUATERNION_LENGTH = 4;
-    static constexpr int32_t ROTATION_VECTOR_LENGTH = 3;
-    static constexpr int32_t THREE_DIMENSIONAL_MATRIX_LENGTH = 9;
-    static constexpr int32_t FOUR_DIMENSIONAL_MATRIX_LENGTH = 16;
+    template<size_t N>
+    int32_t TransformCoordinateSystemImpl(const std::array<float, N> &inRotationMatrix, int32_t axisX,
+        int32_t axisY, std::array<float, N> &outRotationMatrix);
     static constexpr float GRAVITATIONAL_ACCELERATION = 9.81f;
     static constexpr float RECIPROCAL_COEFFICIENT = 5.255f;
     static constexpr float ZERO_PRESSURE_ALTITUDE = 44330.0f;
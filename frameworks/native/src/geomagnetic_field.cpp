@@ -15,12 +15,17 @@
 
 #include "geomagnetic_field.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <mutex>
 
+#include "geomagnetic_field_cache.h"
 #include "sensor_errors.h"
 #include "sensor_utils.h"
 
+#undef LOG_TAG
+#define LOG_TAG "GeomagneticField"
 using namespace std;
 using namespace OHOS::Sensors;
 namespace {
@@ -95,115 +100,227 @@ constexpr float DELTA_GAUSS_COEFFICIENT_H[13][13] = {
     {0.0f, 0.0f, 0.1f, 0.0f, 0.2f, 0.0f, 0.0f, 0.1f, 0.0f, -0.1f, 0.0f, 0.0f},
     {0.0f, 0.0f, 0.0f, -0.1f, 0.1f, 0.0f, 0.0f, 0.0f, 0.1f, 0.0f, 0.0f, 0.0f, -0.1f}
 };
-constexpr int32_t GAUSSIAN_COEFFICIENT_DIMENSION = 13;
-std::mutex g_mutex;
-
-float g_northComponent;
-float g_eastComponent;
-float g_downComponent;
-float g_geocentricLatitude;
-float g_geocentricLongitude;
-float g_geocentricRadius;
-
-std::vector<std::vector<float>> schmidtQuasiNormalFactors;
-std::vector<std::vector<float>> polynomials(GAUSSIAN_COEFFICIENT_DIMENSION);
-std::vector<std::vector<float>> polynomialsDerivative(GAUSSIAN_COEFFICIENT_DIMENSION);
-std::vector<float> relativeRadiusPower(GAUSSIAN_COEFFICIENT_DIMENSION + 2);
-std::vector<float> sinMLongitude(GAUSSIAN_COEFFICIENT_DIMENSION);
-std::vector<float> cosMLongitude(GAUSSIAN_COEFFICIENT_DIMENSION);
-}  // namespace
+constexpr int32_t GAUSSIAN_COEFFICIENT_DIMENSION = GeomagneticField::COEFFICIENT_DIMENSION;
+constexpr int32_t TRIANGLE_SIZE = GeomagneticField::TRIANGLE_SIZE;
 
-GeomagneticField::GeomagneticField(float latitude, float longitude, float altitude, int64_t timeMillis)
+constexpr int32_t TriangleIndex(int32_t row, int32_t column)
 {
-    std::lock_guard<std::mutex> geomagneticLock(g_mutex);
-    schmidtQuasiNormalFactors = GetSchmidtQuasiNormalFactors(GAUSSIAN_COEFFICIENT_DIMENSION);
-    float gcLatitude = fmax(LATITUDE_MIN + PRECISION, fmin(LATITUDE_MAX - PRECISION, latitude));
-    CalibrateGeocentricCoordinates(gcLatitude, longitude, altitude);
-    InitLegendreTable(GAUSSIAN_COEFFICIENT_DIMENSION - 1, static_cast<float>(M_PI / 2.0 - g_geocentricLatitude));
-    GetRelativeRadiusPower();
-    double latDiffRad = ToRadians(gcLatitude) - g_geocentricLatitude;
-    CalculateGeomagneticComponent(latDiffRad, timeMillis);
+    return row * (row + 1) / 2 + column;
 }
 
-std::vector<std::vector<float>> GeomagneticField::GetSchmidtQuasiNormalFactors(int32_t expansionDegree)
+// Position independent factors of the expansion, computed once for the process.
+struct ExpansionFactors {
+    std::array<float, TRIANGLE_SIZE> schmidtQuasiNormal {};
+    std::array<float, TRIANGLE_SIZE> legendreRecursion {};
+};
+
+ExpansionFactors ComputeExpansionFactors()
 {
-    std::vector<std::vector<float>> schmidtQuasiNormFactors(expansionDegree + 1);
-    schmidtQuasiNormFactors[0].resize(1);
-    schmidtQuasiNormFactors[0][0] = 1.0f;
-    for (int32_t row = 1; row <= expansionDegree; row++) {
-        schmidtQuasiNormFactors[row].resize(row + 1);
-        schmidtQuasiNormFactors[row][0] =
-            schmidtQuasiNormFactors[row - 1][0] * (2 * row - 1) / static_cast<float>(row);
+    ExpansionFactors factors;
+    factors.schmidtQuasiNormal[0] = 1.0f;
+    for (int32_t row = 1; row < GAUSSIAN_COEFFICIENT_DIMENSION; row++) {
+        factors.schmidtQuasiNormal[TriangleIndex(row, 0)] =
+            factors.schmidtQuasiNormal[TriangleIndex(row - 1, 0)] * (2 * row - 1) / static_cast<float>(row);
         for (int32_t column = 1; column <= row; column++) {
-            schmidtQuasiNormFactors[row][column] = schmidtQuasiNormFactors[row][column - 1]
+            factors.schmidtQuasiNormal[TriangleIndex(row, column)] =
+                factors.schmidtQuasiNormal[TriangleIndex(row, column - 1)]
                 * static_cast<float>(sqrt((row - column + 1) * ((column == 1) ? 2 : 1)
                 / static_cast<float>(row + column)));
         }
     }
-    return schmidtQuasiNormFactors;
+    for (int32_t row = 2; row < GAUSSIAN_COEFFICIENT_DIMENSION; row++) {
+        for (int32_t column = 0; column < row - 1; column++) {
+            factors.legendreRecursion[TriangleIndex(row, column)] = ((row - 1) * (row - 1) - column * column)
+                / static_cast<float>((2 * row - 1) * (2 * row - 3));
+        }
+    }
+    return factors;
+}
+
+const ExpansionFactors &GetExpansionFactors()
+{
+    static const ExpansionFactors factors = ComputeExpansionFactors();
+    return factors;
+}
+
+// Largest gradients of the model over the globe from sea level to 10 km, rounded up, in nanotesla.
+constexpr float MAX_GRADIENT_PER_LATITUDE_DEGREE = 2000.0f;
+constexpr float MAX_GRADIENT_PER_LONGITUDE_DEGREE = 600.0f;
+constexpr float MAX_GRADIENT_PER_METER = 0.04f;
+constexpr float MAX_GRADIENT_PER_DAY = 0.7f;
+// Latitude, longitude, altitude and time each get an equal share of the error bound.
+constexpr float ERROR_AXES = 4.0f;
+constexpr int64_t MILLIS_PER_DAY = 86400000;
+constexpr float MIN_ANGLE_RESOLUTION = 1e-5f;
+constexpr float MIN_ALTITUDE_RESOLUTION = 0.1f;
+
+struct ThreadCache {
+    uint64_t generation { 0 };
+    GeomagneticCacheConfig config;
+    GeomagneticFieldCache cache;
+};
+
+// The configuration is only locked when it changes, lookups go to the calling thread's own cache.
+std::mutex g_cacheConfigMutex;
+GeomagneticCacheConfig g_cacheConfig;
+std::atomic<uint64_t> g_cacheGeneration { 0 };
+std::atomic<uint64_t> g_cacheHits { 0 };
+std::atomic<uint64_t> g_cacheMisses { 0 };
+
+ThreadCache &GetThreadCache()
+{
+    thread_local ThreadCache threadCache;
+    if (threadCache.generation != g_cacheGeneration.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> cacheConfigLock(g_cacheConfigMutex);
+        threadCache.config = g_cacheConfig;
+        threadCache.generation = g_cacheGeneration.load(std::memory_order_relaxed);
+        threadCache.cache.Reset(threadCache.config.enable ? threadCache.config.capacity : 0);
+    }
+    return threadCache;
+}
+
+int64_t FloorDivide(int64_t value, int64_t divisor)
+{
+    int64_t quotient = value / divisor;
+    return (((value % divisor) != 0) && (value < 0)) ? (quotient - 1) : quotient;
+}
+}  // namespace
+
+// Gauss coefficients laid out [index][lane] so the harmonic sum of a block runs across lanes.
+struct GeomagneticField::BlockCoefficients {
+    float g[TRIANGLE_SIZE][BATCH_LANES];
+    float h[TRIANGLE_SIZE][BATCH_LANES];
+
+    void SetLane(size_t lane, const GaussCoefficients &coefficients)
+    {
+        for (int32_t index = 0; index < TRIANGLE_SIZE; ++index) {
+            g[index][lane] = coefficients.g[index];
+            h[index][lane] = coefficients.h[index];
+        }
+    }
+};
+
+GeomagneticField::GeomagneticField(float latitude, float longitude, float altitude, int64_t timeMillis)
+{
+    ThreadCache &threadCache = GetThreadCache();
+    const GeomagneticCacheConfig &config = threadCache.config;
+    if ((!config.enable) || (!std::isfinite(latitude)) || (!std::isfinite(longitude)) ||
+        (!std::isfinite(altitude))) {
+        Calculate(latitude, longitude, altitude, timeMillis);
+        return;
+    }
+    GeomagneticCacheKey key;
+    key.latitude = static_cast<int64_t>(floor(latitude / config.latitudeResolution));
+    key.longitude = static_cast<int64_t>(floor(longitude / config.longitudeResolution));
+    key.altitude = static_cast<int64_t>(floor(altitude / config.altitudeResolution));
+    key.period = FloorDivide(timeMillis - WMM_BASE_TIME, config.timeResolutionMillis);
+    GeomagneticCacheValue value;
+    if (threadCache.cache.Find(key, value)) {
+        g_cacheHits.fetch_add(1, std::memory_order_relaxed);
+        northComponent_ = value.x;
+        eastComponent_ = value.y;
+        downComponent_ = value.z;
+        return;
+    }
+    g_cacheMisses.fetch_add(1, std::memory_order_relaxed);
+    // Every position of a cell gets the field of the cell center.
+    Calculate(static_cast<float>((key.latitude + 0.5) * config.latitudeResolution),
+        static_cast<float>((key.longitude + 0.5) * config.longitudeResolution),
+        static_cast<float>((key.altitude + 0.5) * config.altitudeResolution),
+        WMM_BASE_TIME + key.period * config.timeResolutionMillis + config.timeResolutionMillis / 2);
+    threadCache.cache.Insert(key, { northComponent_, eastComponent_, downComponent_ });
 }
 
-void GeomagneticField::CalculateGeomagneticComponent(double latDiffRad, int64_t timeMillis)
+void GeomagneticField::Calculate(float latitude, float longitude, float altitude, int64_t timeMillis)
+{
+    float gcLatitude = fmax(LATITUDE_MIN + PRECISION, fmin(LATITUDE_MAX - PRECISION, latitude));
+    GeocentricCoordinates coordinates = CalibrateGeocentricCoordinates(gcLatitude, longitude, altitude);
+    geocentricLatitude_ = coordinates.latitude;
+    geocentricLongitude_ = coordinates.longitude;
+    geocentricRadius_ = coordinates.radius;
+    InitLegendreTable(GAUSSIAN_COEFFICIENT_DIMENSION - 1, static_cast<float>(M_PI / 2.0 - geocentricLatitude_));
+    GetRelativeRadiusPower();
+    double latDiffRad = ToRadians(gcLatitude) - geocentricLatitude_;
+    GaussCoefficients coefficients;
+    GetGaussCoefficients(timeMillis, coefficients);
+    CalculateGeomagneticComponent(latDiffRad, coefficients);
+}
+
+void GeomagneticField::GetGaussCoefficients(int64_t timeMillis, GaussCoefficients &coefficients)
 {
     float yearsSinceBase = (timeMillis - WMM_BASE_TIME) / (365.0f * 24.0f * 60.0f * 60.0f * 1000.0f);
-    float inverseCosLatitude = IsEqual(static_cast<float>(cos(g_geocentricLatitude)), 0.0f) ?
-        std::numeric_limits<float>::max() : DERIVATIVE_FACTOR / static_cast<float>(cos(g_geocentricLatitude));
+    for (int32_t row = 0; row < GAUSSIAN_COEFFICIENT_DIMENSION; row++) {
+        for (int32_t column = 0; column <= row; column++) {
+            int32_t index = TriangleIndex(row, column);
+            coefficients.g[index] = GAUSS_COEFFICIENT_G[row][column] + yearsSinceBase
+                * DELTA_GAUSS_COEFFICIENT_G[row][column];
+            coefficients.h[index] = GAUSS_COEFFICIENT_H[row][column] + yearsSinceBase
+                * DELTA_GAUSS_COEFFICIENT_H[row][column];
+        }
+    }
+}
+
+void GeomagneticField::CalculateGeomagneticComponent(double latDiffRad, const GaussCoefficients &coefficients)
+{
+    const std::array<float, TRIANGLE_SIZE> &schmidtQuasiNormalFactors = GetExpansionFactors().schmidtQuasiNormal;
+    float inverseCosLatitude = IsEqual(static_cast<float>(cos(geocentricLatitude_)), 0.0f) ?
+        std::numeric_limits<float>::max() : DERIVATIVE_FACTOR / static_cast<float>(cos(geocentricLatitude_));
     GetLongitudeTrigonometric();
     float gcX = 0.0f;
     float gcY = 0.0f;
     float gcZ = 0.0f;
     for (int32_t row = 1; row < GAUSSIAN_COEFFICIENT_DIMENSION; row++) {
         for (int32_t column = 0; column <= row; column++) {
-            float g = GAUSS_COEFFICIENT_G[row][column] + yearsSinceBase
-                * DELTA_GAUSS_COEFFICIENT_G[row][column];
-            float h = GAUSS_COEFFICIENT_H[row][column] + yearsSinceBase
-                * DELTA_GAUSS_COEFFICIENT_H[row][column];
-            gcX += relativeRadiusPower[row + 2]
-                * (g * cosMLongitude[column] + h * sinMLongitude[column])
-                * polynomialsDerivative[row][column]
-                * schmidtQuasiNormalFactors[row][column];
-            gcY += relativeRadiusPower[row + 2] * column
-                * (g * sinMLongitude[column] - h * cosMLongitude[column])
-                * polynomials[row][column]
-                * schmidtQuasiNormalFactors[row][column]
+            int32_t index = TriangleIndex(row, column);
+            float g = coefficients.g[index];
+            float h = coefficients.h[index];
+            gcX += relativeRadiusPower_[row + 2]
+                * (g * cosMLongitude_[column] + h * sinMLongitude_[column])
+                * polynomialsDerivative_[index]
+                * schmidtQuasiNormalFactors[index];
+            gcY += relativeRadiusPower_[row + 2] * column
+                * (g * sinMLongitude_[column] - h * cosMLongitude_[column])
+                * polynomials_[index]
+                * schmidtQuasiNormalFactors[index]
                 * inverseCosLatitude;
-            gcZ -= (row + 1) * relativeRadiusPower[row + 2]
-                * (g * cosMLongitude[column] + h * sinMLongitude[column])
-                * polynomials[row][column]
-                * schmidtQuasiNormalFactors[row][column];
+            gcZ -= (row + 1) * relativeRadiusPower_[row + 2]
+                * (g * cosMLongitude_[column] + h * sinMLongitude_[column])
+                * polynomials_[index]
+                * schmidtQuasiNormalFactors[index];
         }
-        g_northComponent = static_cast<float>(gcX * cos(latDiffRad) + gcZ * sin(latDiffRad));
-        g_eastComponent = gcY;
-        g_downComponent = static_cast<float>(-gcX * sin(latDiffRad) + gcZ * cos(latDiffRad));
     }
+    northComponent_ = static_cast<float>(gcX * cos(latDiffRad) + gcZ * sin(latDiffRad));
+    eastComponent_ = gcY;
+    downComponent_ = static_cast<float>(-gcX * sin(latDiffRad) + gcZ * cos(latDiffRad));
 }
 
 void GeomagneticField::GetLongitudeTrigonometric()
 {
-    sinMLongitude[0] = 0.0f;
-    cosMLongitude[0] = 1.0f;
-    sinMLongitude[1] = static_cast<float>(sin(g_geocentricLongitude));
-    cosMLongitude[1] = static_cast<float>(cos(g_geocentricLongitude));
+    sinMLongitude_[0] = 0.0f;
+    cosMLongitude_[0] = 1.0f;
+    sinMLongitude_[1] = static_cast<float>(sin(geocentricLongitude_));
+    cosMLongitude_[1] = static_cast<float>(cos(geocentricLongitude_));
     for (uint32_t index = 2; index < GAUSSIAN_COEFFICIENT_DIMENSION; ++index) {
         uint32_t x = index >> 1;
-        sinMLongitude[index] = (sinMLongitude[index - x] * cosMLongitude[x]
-            + cosMLongitude[index - x] * sinMLongitude[x]);
-        cosMLongitude[index] = (cosMLongitude[index - x] * cosMLongitude[x]
-            - sinMLongitude[index - x] * sinMLongitude[x]);
+        sinMLongitude_[index] = (sinMLongitude_[index - x] * cosMLongitude_[x]
+            + cosMLongitude_[index - x] * sinMLongitude_[x]);
+        cosMLongitude_[index] = (cosMLongitude_[index - x] * cosMLongitude_[x]
+            - sinMLongitude_[index - x] * sinMLongitude_[x]);
     }
 }
 
 void GeomagneticField::GetRelativeRadiusPower()
 {
-    relativeRadiusPower[0] = 1.0f;
-    relativeRadiusPower[1] = IsEqual(g_geocentricRadius, 0.0f) ? std::numeric_limits<float>::max() :
-        EARTH_REFERENCE_RADIUS / g_geocentricRadius;
-    for (int32_t index = 2; index < static_cast<int32_t>(relativeRadiusPower.size()); ++index) {
-        relativeRadiusPower[index] = relativeRadiusPower[index - 1] * relativeRadiusPower[1];
+    relativeRadiusPower_[0] = 1.0f;
+    relativeRadiusPower_[1] = IsEqual(geocentricRadius_, 0.0f) ? std::numeric_limits<float>::max() :
+        EARTH_REFERENCE_RADIUS / geocentricRadius_;
+    for (size_t index = 2; index < relativeRadiusPower_.size(); ++index) {
+        relativeRadiusPower_[index] = relativeRadiusPower_[index - 1] * relativeRadiusPower_[1];
     }
 }
 
-void GeomagneticField::CalibrateGeocentricCoordinates(float latitude, float longitude, float altitude)
+GeomagneticField::GeocentricCoordinates GeomagneticField::CalibrateGeocentricCoordinates(float latitude,
+    float longitude, float altitude)
 {
     float altitudeKm = altitude / CONVERSION_FACTOR;
     float a2 = EARTH_MAJOR_AXIS_RADIUS * EARTH_MAJOR_AXIS_RADIUS;
@@ -213,71 +330,68 @@ void GeomagneticField::CalibrateGeocentricCoordinates(float latitude, float long
     float slat = static_cast<float>(sin(gdLatRad));
     float tlat = IsEqual(clat, 0.0f) ? std::numeric_limits<float>::max() : slat / clat;
     float latRad = static_cast<float>(sqrt(a2 * clat * clat + b2 * slat * slat));
-    g_geocentricLatitude = static_cast<float>(atan(tlat * (latRad * altitudeKm + b2)
+    GeocentricCoordinates coordinates;
+    coordinates.latitude = static_cast<float>(atan(tlat * (latRad * altitudeKm + b2)
         / (latRad * altitudeKm + a2)));
-    g_geocentricLongitude = static_cast<float>(ToRadians(longitude));
+    coordinates.longitude = static_cast<float>(ToRadians(longitude));
     float radSq = altitudeKm * altitudeKm + 2 * altitudeKm
         * latRad + (a2 * a2 * clat * clat + b2 * b2 * slat * slat)
         / (a2 * clat * clat + b2 * slat * slat);
-    g_geocentricRadius = static_cast<float>(sqrt(radSq));
+    coordinates.radius = static_cast<float>(sqrt(radSq));
+    return coordinates;
 }
 
 void GeomagneticField::InitLegendreTable(int32_t expansionDegree, float thetaRad)
 {
-    polynomials[0].resize(1);
-    polynomials[0][0] = 1.0f;
-    polynomialsDerivative[0].resize(1);
-    polynomialsDerivative[0][0] = 0.0f;
+    const std::array<float, TRIANGLE_SIZE> &recursionFactors = GetExpansionFactors().legendreRecursion;
+    polynomials_[0] = 1.0f;
+    polynomialsDerivative_[0] = 0.0f;
     float cosValue = static_cast<float>(cos(thetaRad));
     float sinValue = static_cast<float>(sin(thetaRad));
     for (int32_t row = 1; row <= expansionDegree; row++) {
-        polynomials[row].resize(row + 1);
-        polynomialsDerivative[row].resize(row + 1);
         for (int32_t column = 0; column <= row; column++) {
+            int32_t index = TriangleIndex(row, column);
             if (row == column) {
-                polynomials[row][column] = sinValue * polynomials[row - 1][column - 1];
-                polynomialsDerivative[row][column] = cosValue * polynomials[row - 1][column - 1]
-                    + sinValue * polynomialsDerivative[row - 1][column - 1];
+                int32_t diagonal = TriangleIndex(row - 1, column - 1);
+                polynomials_[index] = sinValue * polynomials_[diagonal];
+                polynomialsDerivative_[index] = cosValue * polynomials_[diagonal]
+                    + sinValue * polynomialsDerivative_[diagonal];
             } else if (row == 1 || column == row - 1) {
-                polynomials[row][column] = cosValue * polynomials[row - 1][column];
-                polynomialsDerivative[row][column] = -sinValue * polynomials[row - 1][column]
-                    + cosValue * polynomialsDerivative[row - 1][column];
+                int32_t above = TriangleIndex(row - 1, column);
+                polynomials_[index] = cosValue * polynomials_[above];
+                polynomialsDerivative_[index] = -sinValue * polynomials_[above]
+                    + cosValue * polynomialsDerivative_[above];
             } else {
-                float k = ((row - 1) * (row - 1) - column * column)
-                    / static_cast<float>((2 * row - 1) * (2 * row - 3));
-                polynomials[row][column] = cosValue * polynomials[row - 1][column]
-                    - k * polynomials[row - 2][column];
-                polynomialsDerivative[row][column] = -sinValue * polynomials[row - 1][column]
-                    + cosValue * polynomialsDerivative[row - 1][column]
-                    - k * polynomialsDerivative[row - 2][column];
+                int32_t above = TriangleIndex(row - 1, column);
+                int32_t twoAbove = TriangleIndex(row - 2, column);
+                float k = recursionFactors[index];
+                polynomials_[index] = cosValue * polynomials_[above] - k * polynomials_[twoAbove];
+                polynomialsDerivative_[index] = -sinValue * polynomials_[above]
+                    + cosValue * polynomialsDerivative_[above]
+                    - k * polynomialsDerivative_[twoAbove];
             }
         }
     }
 }
 
-float GeomagneticField::ObtainX()
+float GeomagneticField::ObtainX() const
 {
-    std::lock_guard<std::mutex> geomagneticLock(g_mutex);
-    return g_northComponent;
+    return northComponent_;
 }
 
-float GeomagneticField::ObtainY()
+float GeomagneticField::ObtainY() const
 {
-    std::lock_guard<std::mutex> geomagneticLock(g_mutex);
-    return g_eastComponent;
+    return eastComponent_;
 }
 
-float GeomagneticField::ObtainZ()
+float GeomagneticField::ObtainZ() const
 {
-    std::lock_guard<std::mutex> geomagneticLock(g_mutex);
-    return g_downComponent;
+    return downComponent_;
 }
 
-float GeomagneticField::ObtainGeomagneticDip()
+float GeomagneticField::ObtainGeomagneticDip() const
 {
-    std::lock_guard<std::mutex> geomagneticLock(g_mutex);
-    float horizontalIntensity = hypot(g_northComponent, g_eastComponent);
-    return static_cast<float>(ToDegrees(atan2(g_downComponent, horizontalIntensity)));
+    return CalculateGeomagneticDip(northComponent_, eastComponent_, downComponent_);
 }
 
 double GeomagneticField::ToDegrees(double angrad)
@@ -290,25 +404,251 @@ double GeomagneticField::ToRadians(double angdeg)
     return angdeg / 180.0 * M_PI;
 }
 
-float GeomagneticField::ObtainDeflectionAngle()
+float GeomagneticField::ObtainDeflectionAngle() const
+{
+    return CalculateDeflectionAngle(northComponent_, eastComponent_);
+}
+
+float GeomagneticField::ObtainLevelIntensity() const
+{
+    return CalculateLevelIntensity(northComponent_, eastComponent_);
+}
+
+float GeomagneticField::ObtainTotalIntensity() const
+{
+    return CalculateTotalIntensity(northComponent_, eastComponent_, downComponent_);
+}
+
+float GeomagneticField::CalculateGeomagneticDip(float x, float y, float z)
+{
+    float horizontalIntensity = hypot(x, y);
+    return static_cast<float>(ToDegrees(atan2(z, horizontalIntensity)));
+}
+
+float GeomagneticField::CalculateDeflectionAngle(float x, float y)
 {
-    std::lock_guard<std::mutex> geomagneticLock(g_mutex);
-    return static_cast<float>(ToDegrees(atan2(g_eastComponent, g_northComponent)));
+    return static_cast<float>(ToDegrees(atan2(y, x)));
 }
 
-float GeomagneticField::ObtainLevelIntensity()
+float GeomagneticField::CalculateLevelIntensity(float x, float y)
 {
-    std::lock_guard<std::mutex> geomagneticLock(g_mutex);
-    float horizontalIntensity = hypot(g_northComponent, g_eastComponent);
+    float horizontalIntensity = hypot(x, y);
     return horizontalIntensity;
 }
 
-float GeomagneticField::ObtainTotalIntensity()
+float GeomagneticField::CalculateTotalIntensity(float x, float y, float z)
 {
-    std::lock_guard<std::mutex> geomagneticLock(g_mutex);
-    float sumOfSquares = g_northComponent * g_northComponent + g_eastComponent * g_eastComponent
-        + g_downComponent * g_downComponent;
+    float sumOfSquares = x * x + y * y + z * z;
     float totalIntensity = static_cast<float>(sqrt(sumOfSquares));
     return totalIntensity;
 }
 
+void GeomagneticField::SetCacheMode(const GeomagneticCacheConfig &config)
+{
+    GeomagneticCacheConfig sanitized = config;
+    sanitized.latitudeResolution = std::max(config.latitudeResolution, MIN_ANGLE_RESOLUTION);
+    sanitized.longitudeResolution = std::max(config.longitudeResolution, MIN_ANGLE_RESOLUTION);
+    sanitized.altitudeResolution = std::max(config.altitudeResolution, MIN_ALTITUDE_RESOLUTION);
+    sanitized.timeResolutionMillis = std::max<int64_t>(config.timeResolutionMillis, 1);
+    std::lock_guard<std::mutex> cacheConfigLock(g_cacheConfigMutex);
+    g_cacheConfig = sanitized;
+    g_cacheGeneration.fetch_add(1, std::memory_order_release);
+}
+
+GeomagneticCacheConfig GeomagneticField::GetCacheMode()
+{
+    std::lock_guard<std::mutex> cacheConfigLock(g_cacheConfigMutex);
+    return g_cacheConfig;
+}
+
+GeomagneticCacheConfig GeomagneticField::CreateCacheConfig(float maxErrorNanotesla, size_t capacity)
+{
+    GeomagneticCacheConfig config;
+    config.capacity = capacity;
+    if (!(maxErrorNanotesla > 0.0f)) {
+        SEN_HILOGW("Invalid error bound, cache disabled");
+        config.enable = false;
+        return config;
+    }
+    // Snapping to the cell center moves each coordinate by at most half a cell.
+    float share = 2.0f * maxErrorNanotesla / ERROR_AXES;
+    config.enable = true;
+    config.latitudeResolution = share / MAX_GRADIENT_PER_LATITUDE_DEGREE;
+    config.longitudeResolution = share / MAX_GRADIENT_PER_LONGITUDE_DEGREE;
+    config.altitudeResolution = share / MAX_GRADIENT_PER_METER;
+    int64_t days = std::max<int64_t>(static_cast<int64_t>(share / MAX_GRADIENT_PER_DAY), 1);
+    config.timeResolutionMillis = days * MILLIS_PER_DAY;
+    return config;
+}
+
+GeomagneticCacheStats GeomagneticField::GetCacheStats()
+{
+    GeomagneticCacheStats stats;
+    stats.hits = g_cacheHits.load(std::memory_order_relaxed);
+    stats.misses = g_cacheMisses.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void GeomagneticField::ResetCacheStats()
+{
+    g_cacheHits.store(0, std::memory_order_relaxed);
+    g_cacheMisses.store(0, std::memory_order_relaxed);
+}
+
+int32_t GeomagneticField::ObtainBatch(const GeomagneticPositions &positions, GeomagneticComponents &components)
+{
+    size_t count = positions.latitudes.size();
+    if ((positions.longitudes.size() != count) || (positions.altitudes.size() != count)) {
+        SEN_HILOGE("Position arrays differ in size");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    size_t timeCount = positions.timeMillis.size();
+    if ((timeCount != 1) && (timeCount != count)) {
+        SEN_HILOGE("Invalid timeMillis size:%{public}zu, count:%{public}zu", timeCount, count);
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    components.x.resize(count);
+    components.y.resize(count);
+    components.z.resize(count);
+    if (count == 0) {
+        return OHOS::Sensors::SUCCESS;
+    }
+    GaussCoefficients coefficients;
+    int64_t coefficientsTime = positions.timeMillis[0];
+    GetGaussCoefficients(coefficientsTime, coefficients);
+    BlockCoefficients blockCoefficients;
+    for (size_t lane = 0; lane < BATCH_LANES; ++lane) {
+        blockCoefficients.SetLane(lane, coefficients);
+    }
+    for (size_t first = 0; first < count; first += BATCH_LANES) {
+        size_t blockCount = std::min(BATCH_LANES, count - first);
+        if (timeCount != 1) {
+            for (size_t lane = 0; lane < BATCH_LANES; ++lane) {
+                int64_t timeMillis = positions.timeMillis[first + std::min(lane, blockCount - 1)];
+                if (timeMillis != coefficientsTime) {
+                    coefficientsTime = timeMillis;
+                    GetGaussCoefficients(coefficientsTime, coefficients);
+                }
+                blockCoefficients.SetLane(lane, coefficients);
+            }
+        }
+        CalculateBlock(positions, first, blockCount, blockCoefficients, components);
+    }
+    return OHOS::Sensors::SUCCESS;
+}
+
+void GeomagneticField::CalculateBlock(const GeomagneticPositions &positions, size_t first, size_t count,
+    const BlockCoefficients &coefficients, GeomagneticComponents &components)
+{
+    constexpr size_t lanes = BATCH_LANES;
+    constexpr int32_t powerCount = GAUSSIAN_COEFFICIENT_DIMENSION + 2;
+    const ExpansionFactors &factors = GetExpansionFactors();
+    float cosTheta[lanes];
+    float sinTheta[lanes];
+    float inverseCosLatitude[lanes];
+    double latDiffRad[lanes];
+    float radiusPower[powerCount][lanes];
+    float sinMLongitude[GAUSSIAN_COEFFICIENT_DIMENSION][lanes];
+    float cosMLongitude[GAUSSIAN_COEFFICIENT_DIMENSION][lanes];
+    // Trailing lanes of a short block repeat the last position and are not written back.
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        size_t i = first + std::min(lane, count - 1);
+        float gcLatitude = fmax(LATITUDE_MIN + PRECISION, fmin(LATITUDE_MAX - PRECISION, positions.latitudes[i]));
+        GeocentricCoordinates coordinates =
+            CalibrateGeocentricCoordinates(gcLatitude, positions.longitudes[i], positions.altitudes[i]);
+        float thetaRad = static_cast<float>(M_PI / 2.0 - coordinates.latitude);
+        cosTheta[lane] = static_cast<float>(cos(thetaRad));
+        sinTheta[lane] = static_cast<float>(sin(thetaRad));
+        float cosLatitude = static_cast<float>(cos(coordinates.latitude));
+        inverseCosLatitude[lane] = IsEqual(cosLatitude, 0.0f) ?
+            std::numeric_limits<float>::max() : DERIVATIVE_FACTOR / cosLatitude;
+        latDiffRad[lane] = ToRadians(gcLatitude) - coordinates.latitude;
+        radiusPower[0][lane] = 1.0f;
+        radiusPower[1][lane] = IsEqual(coordinates.radius, 0.0f) ? std::numeric_limits<float>::max() :
+            EARTH_REFERENCE_RADIUS / coordinates.radius;
+        sinMLongitude[0][lane] = 0.0f;
+        cosMLongitude[0][lane] = 1.0f;
+        sinMLongitude[1][lane] = static_cast<float>(sin(coordinates.longitude));
+        cosMLongitude[1][lane] = static_cast<float>(cos(coordinates.longitude));
+    }
+    for (int32_t index = 2; index < powerCount; ++index) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            radiusPower[index][lane] = radiusPower[index - 1][lane] * radiusPower[1][lane];
+        }
+    }
+    for (int32_t index = 2; index < GAUSSIAN_COEFFICIENT_DIMENSION; ++index) {
+        int32_t x = index >> 1;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            sinMLongitude[index][lane] = (sinMLongitude[index - x][lane] * cosMLongitude[x][lane]
+                + cosMLongitude[index - x][lane] * sinMLongitude[x][lane]);
+            cosMLongitude[index][lane] = (cosMLongitude[index - x][lane] * cosMLongitude[x][lane]
+                - sinMLongitude[index - x][lane] * sinMLongitude[x][lane]);
+        }
+    }
+    float polynomials[TRIANGLE_SIZE][lanes];
+    float polynomialsDerivative[TRIANGLE_SIZE][lanes];
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        polynomials[0][lane] = 1.0f;
+        polynomialsDerivative[0][lane] = 0.0f;
+    }
+    for (int32_t row = 1; row < GAUSSIAN_COEFFICIENT_DIMENSION; row++) {
+        for (int32_t column = 0; column <= row; column++) {
+            int32_t index = TriangleIndex(row, column);
+            if (row == column) {
+                int32_t diagonal = TriangleIndex(row - 1, column - 1);
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    polynomials[index][lane] = sinTheta[lane] * polynomials[diagonal][lane];
+                    polynomialsDerivative[index][lane] = cosTheta[lane] * polynomials[diagonal][lane]
+                        + sinTheta[lane] * polynomialsDerivative[diagonal][lane];
+                }
+            } else if (row == 1 || column == row - 1) {
+                int32_t above = TriangleIndex(row - 1, column);
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    polynomials[index][lane] = cosTheta[lane] * polynomials[above][lane];
+                    polynomialsDerivative[index][lane] = -sinTheta[lane] * polynomials[above][lane]
+                        + cosTheta[lane] * polynomialsDerivative[above][lane];
+                }
+            } else {
+                int32_t above = TriangleIndex(row - 1, column);
+                int32_t twoAbove = TriangleIndex(row - 2, column);
+                float k = factors.legendreRecursion[index];
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    polynomials[index][lane] = cosTheta[lane] * polynomials[above][lane]
+                        - k * polynomials[twoAbove][lane];
+                    polynomialsDerivative[index][lane] = -sinTheta[lane] * polynomials[above][lane]
+                        + cosTheta[lane] * polynomialsDerivative[above][lane]
+                        - k * polynomialsDerivative[twoAbove][lane];
+                }
+            }
+        }
+    }
+    float gcX[lanes] = { 0.0f };
+    float gcY[lanes] = { 0.0f };
+    float gcZ[lanes] = { 0.0f };
+    for (int32_t row = 1; row < GAUSSIAN_COEFFICIENT_DIMENSION; row++) {
+        for (int32_t column = 0; column <= row; column++) {
+            int32_t index = TriangleIndex(row, column);
+            float schmidtQuasiNormalFactor = factors.schmidtQuasiNormal[index];
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                float g = coefficients.g[index][lane];
+                float h = coefficients.h[index][lane];
+                float cosM = cosMLongitude[column][lane];
+                float sinM = sinMLongitude[column][lane];
+                gcX[lane] += radiusPower[row + 2][lane] * (g * cosM + h * sinM)
+                    * polynomialsDerivative[index][lane] * schmidtQuasiNormalFactor;
+                gcY[lane] += radiusPower[row + 2][lane] * column * (g * sinM - h * cosM)
+                    * polynomials[index][lane] * schmidtQuasiNormalFactor * inverseCosLatitude[lane];
+                gcZ[lane] -= (row + 1) * radiusPower[row + 2][lane] * (g * cosM + h * sinM)
+                    * polynomials[index][lane] * schmidtQuasiNormalFactor;
+            }
+        }
+    }
+    for (size_t lane = 0; lane < count; ++lane) {
+        components.x[first + lane] = static_cast<float>(gcX[lane] * cos(latDiffRad[lane])
+            + gcZ[lane] * sin(latDiffRad[lane]));
+        components.y[first + lane] = gcY[lane];
+        components.z[first + lane] = static_cast<float>(-gcX[lane] * sin(latDiffRad[lane])
+            + gcZ[lane] * cos(latDiffRad[lane]));
+    }
+}
+
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geomagnetic_field_cache.h"
+
+#include <functional>
+
+namespace {
+constexpr size_t HASH_MULTIPLIER = 0x9e3779b9;
+
+inline size_t HashCombine(size_t seed, int64_t value)
+{
+    return seed ^ (std::hash<int64_t>()(value) + HASH_MULTIPLIER + (seed << 6) + (seed >> 2));
+}
+}  // namespace
+
+size_t GeomagneticCacheKeyHash::operator()(const GeomagneticCacheKey &key) const
+{
+    size_t seed = std::hash<int64_t>()(key.latitude);
+    seed = HashCombine(seed, key.longitude);
+    seed = HashCombine(seed, key.altitude);
+    return HashCombine(seed, key.period);
+}
+
+GeomagneticFieldCache::GeomagneticFieldCache(size_t capacity) : capacity_(capacity)
+{
+    index_.reserve(capacity_);
+}
+
+bool GeomagneticFieldCache::Find(const GeomagneticCacheKey &key, GeomagneticCacheValue &value)
+{
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    value = it->second->second;
+    return true;
+}
+
+void GeomagneticFieldCache::Insert(const GeomagneticCacheKey &key, const GeomagneticCacheValue &value)
+{
+    if (capacity_ == 0) {
+        return;
+    }
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->second = value;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+    if (entries_.size() >= capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+    entries_.emplace_front(key, value);
+    index_.emplace(key, entries_.begin());
+}
+
+void GeomagneticFieldCache::Reset(size_t capacity)
+{
+    capacity_ = capacity;
+    entries_.clear();
+    index_.clear();
+    index_.reserve(capacity_);
+}
+
+size_t GeomagneticFieldCache::Size() const
+{
+    return entries_.size();
+}
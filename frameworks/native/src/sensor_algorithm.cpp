@@ -14,6 +14,7 @@
  */
 #include "sensor_algorithm.h"
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -24,18 +25,93 @@
 #define LOG_TAG "SensorAlgorithmAPI"
 using namespace OHOS::Sensors;
 
-int32_t SensorAlgorithm::CreateQuaternion(std::vector<float> rotationVector, std::vector<float> &quaternion)
+namespace {
+constexpr size_t ROTATION_VECTOR_LENGTH = SensorAlgorithm::ROTATION_VECTOR_LENGTH;
+constexpr size_t QUATERNION_LENGTH = SensorAlgorithm::QUATERNION_LENGTH;
+constexpr size_t THREE_DIMENSIONAL_MATRIX_LENGTH = SensorAlgorithm::THREE_DIMENSIONAL_MATRIX_LENGTH;
+constexpr size_t FOUR_DIMENSIONAL_MATRIX_LENGTH = SensorAlgorithm::FOUR_DIMENSIONAL_MATRIX_LENGTH;
+
+// Row stride of a row-major rotation matrix with N elements.
+template<size_t N>
+constexpr size_t MatrixDimension()
 {
-    if (static_cast<int32_t>(rotationVector.size()) < ROTATION_VECTOR_LENGTH
-        || static_cast<int32_t>(rotationVector.size()) > QUATERNION_LENGTH) {
-        SEN_HILOGE("Invalid input rotationVector parameter");
-        return OHOS::Sensors::PARAMETER_ERROR;
+    static_assert((N == THREE_DIMENSIONAL_MATRIX_LENGTH) || (N == FOUR_DIMENSIONAL_MATRIX_LENGTH),
+        "Rotation matrices hold 9 or 16 elements");
+    return (N == FOUR_DIMENSIONAL_MATRIX_LENGTH) ? QUATERNION_LENGTH : ROTATION_VECTOR_LENGTH;
+}
+
+// Position of element i of the 3x3 rotation in a matrix with N elements.
+template<size_t N>
+constexpr size_t MatrixIndex(size_t i)
+{
+    return i % ROTATION_VECTOR_LENGTH + (i / ROTATION_VECTOR_LENGTH) * MatrixDimension<N>();
+}
+
+template<size_t N>
+void FillHomogeneousPart(std::array<float, N> &matrix)
+{
+    if constexpr (N == FOUR_DIMENSIONAL_MATRIX_LENGTH) {
+        matrix[3] = matrix[7] = matrix[11] = matrix[12] = matrix[13] = matrix[14] = 0.0f;
+        matrix[15] = 1.0f;
     }
-    if (static_cast<int32_t>(quaternion.size()) < QUATERNION_LENGTH) {
-        SEN_HILOGE("Invalid input quaternion parameter");
-        return OHOS::Sensors::PARAMETER_ERROR;
+}
+
+bool IsMatrixLength(size_t length)
+{
+    return (length == THREE_DIMENSIONAL_MATRIX_LENGTH) || (length == FOUR_DIMENSIONAL_MATRIX_LENGTH);
+}
+
+template<size_t N>
+std::array<float, N> ToArray(const std::vector<float> &values)
+{
+    std::array<float, N> result {};
+    std::copy_n(values.begin(), std::min(N, values.size()), result.begin());
+    return result;
+}
+
+template<size_t N>
+void CopyToVector(const std::array<float, N> &values, std::vector<float> &result)
+{
+    std::copy_n(values.begin(), std::min(N, result.size()), result.begin());
+}
+
+// Call 'func' with 'matrix' copied into a std::array of its size, which must be 9 or 16.
+template<typename Func>
+int32_t DispatchMatrix(const std::vector<float> &matrix, Func func)
+{
+    if (matrix.size() == FOUR_DIMENSIONAL_MATRIX_LENGTH) {
+        return func(ToArray<FOUR_DIMENSIONAL_MATRIX_LENGTH>(matrix));
     }
-    if (static_cast<int32_t>(rotationVector.size()) == ROTATION_VECTOR_LENGTH) {
+    return func(ToArray<THREE_DIMENSIONAL_MATRIX_LENGTH>(matrix));
+}
+
+// Call 'func' with a std::array of the size of 'matrix' and copy it back into 'matrix' on success.
+template<typename Func>
+int32_t DispatchOutputMatrix(std::vector<float> &matrix, Func func)
+{
+    int32_t ret = OHOS::Sensors::SUCCESS;
+    if (matrix.size() == FOUR_DIMENSIONAL_MATRIX_LENGTH) {
+        auto result = ToArray<FOUR_DIMENSIONAL_MATRIX_LENGTH>(matrix);
+        ret = func(result);
+        if (ret == OHOS::Sensors::SUCCESS) {
+            CopyToVector(result, matrix);
+        }
+        return ret;
+    }
+    auto result = ToArray<THREE_DIMENSIONAL_MATRIX_LENGTH>(matrix);
+    ret = func(result);
+    if (ret == OHOS::Sensors::SUCCESS) {
+        CopyToVector(result, matrix);
+    }
+    return ret;
+}
+}  // namespace
+
+template<size_t V>
+int32_t SensorAlgorithm::CreateQuaternion(const std::array<float, V> &rotationVector, Quaternion &quaternion)
+{
+    static_assert((V == ROTATION_VECTOR_LENGTH) || (V == QUATERNION_LENGTH), "Rotation vectors hold 3 or 4 elements");
+    if constexpr (V == ROTATION_VECTOR_LENGTH) {
         quaternion[0] = 1 - static_cast<float>((pow(rotationVector[0], 2) + pow(rotationVector[1], 2)
             + pow(rotationVector[2], 2)));
         quaternion[0]  = (quaternion[0] > 0) ? static_cast<float>(std::sqrt(quaternion[0])) : 0;
@@ -48,8 +124,27 @@ int32_t SensorAlgorithm::CreateQuaternion(std::vector<float> rotationVector, std
     return OHOS::Sensors::SUCCESS;
 }
 
-int32_t SensorAlgorithm::TransformCoordinateSystemImpl(std::vector<float> inRotationMatrix, int32_t axisX,
-    int32_t axisY, std::vector<float> &outRotationMatrix)
+int32_t SensorAlgorithm::CreateQuaternion(std::vector<float> rotationVector, std::vector<float> &quaternion)
+{
+    if (rotationVector.size() < ROTATION_VECTOR_LENGTH || rotationVector.size() > QUATERNION_LENGTH) {
+        SEN_HILOGE("Invalid input rotationVector parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    if (quaternion.size() < QUATERNION_LENGTH) {
+        SEN_HILOGE("Invalid input quaternion parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    Quaternion result;
+    int32_t ret = (rotationVector.size() == ROTATION_VECTOR_LENGTH) ?
+        CreateQuaternion(ToArray<ROTATION_VECTOR_LENGTH>(rotationVector), result) :
+        CreateQuaternion(ToArray<QUATERNION_LENGTH>(rotationVector), result);
+    CopyToVector(result, quaternion);
+    return ret;
+}
+
+template<size_t N>
+int32_t SensorAlgorithm::TransformCoordinateSystemImpl(const std::array<float, N> &inRotationMatrix, int32_t axisX,
+    int32_t axisY, std::array<float, N> &outRotationMatrix)
 {
     if ((axisX & 0x7C) != 0 || (axisX & 0x3) == 0) {
         SEN_HILOGE("axisX is invalid parameter");
@@ -66,11 +161,9 @@ int32_t SensorAlgorithm::TransformCoordinateSystemImpl(std::vector<float> inRota
     if (((x ^ ((z + 1) % 3)) | (y ^ ((z + 2) % 3))) != 0) {
         axisZ ^= 0x80;
     }
-    int32_t inRotationMatrixLength = static_cast<int32_t>(inRotationMatrix.size());
-    int32_t matrixDimension = ((inRotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        ? QUATERNION_LENGTH : ROTATION_VECTOR_LENGTH);
-    for (int32_t j = 0; j < ROTATION_VECTOR_LENGTH; j++) {
-        int32_t offset = j * matrixDimension;
+    constexpr size_t matrixDimension = MatrixDimension<N>();
+    for (size_t j = 0; j < ROTATION_VECTOR_LENGTH; j++) {
+        size_t offset = j * matrixDimension;
         for (int32_t i = 0; i < 3; i++) {
             if (x == i) {
                 outRotationMatrix[offset + i] = (axisX >= 0x80) ? -inRotationMatrix[offset + 0] :
@@ -86,41 +179,45 @@ int32_t SensorAlgorithm::TransformCoordinateSystemImpl(std::vector<float> inRota
             }
         }
     }
-    if (inRotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH) {
-        outRotationMatrix[3] = outRotationMatrix[7] = outRotationMatrix[11] =
-            outRotationMatrix[12] = outRotationMatrix[13] = outRotationMatrix[14] = 0;
-        outRotationMatrix[15] = 1;
-    }
+    FillHomogeneousPart(outRotationMatrix);
     return OHOS::Sensors::SUCCESS;
 }
 
-int32_t SensorAlgorithm::TransformCoordinateSystem(std::vector<float> inRotationMatrix, int32_t axisX, int32_t axisY,
-    std::vector<float> &outRotationMatrix)
+template<size_t N>
+int32_t SensorAlgorithm::TransformCoordinateSystem(const std::array<float, N> &inRotationMatrix, int32_t axisX,
+    int32_t axisY, std::array<float, N> &outRotationMatrix)
+{
+    if (axisX < 0 || axisY < 0) {
+        SEN_HILOGE("Invalid axisX or axisY");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    if (&inRotationMatrix == &outRotationMatrix) {
+        // The source is read after parts of the destination are written, so in-place remapping needs a copy.
+        std::array<float, N> tempRotationMatrix = inRotationMatrix;
+        return TransformCoordinateSystemImpl(tempRotationMatrix, axisX, axisY, outRotationMatrix);
+    }
+    return TransformCoordinateSystemImpl(inRotationMatrix, axisX, axisY, outRotationMatrix);
+}
+
+int32_t SensorAlgorithm::TransformCoordinateSystem(std::vector<float> inRotationMatrix, int32_t axisX,
+    int32_t axisY, std::vector<float> &outRotationMatrix)
 {
     if (axisX < 0 || axisY < 0) {
         SEN_HILOGE("Invalid axisX or axisY");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
-    int32_t inRotationMatrixLength = static_cast<int32_t>(inRotationMatrix.size());
-    if (((inRotationMatrixLength != THREE_DIMENSIONAL_MATRIX_LENGTH) &&
-        (inRotationMatrixLength != FOUR_DIMENSIONAL_MATRIX_LENGTH)) ||
-        (inRotationMatrixLength != static_cast<int32_t>(outRotationMatrix.size()))) {
+    if (!IsMatrixLength(inRotationMatrix.size()) || (inRotationMatrix.size() != outRotationMatrix.size())) {
         SEN_HILOGE("Invalid input parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
-    if (inRotationMatrix == outRotationMatrix) {
-        std::vector<float> tempRotationMatrix(inRotationMatrixLength);
-        if (TransformCoordinateSystemImpl(inRotationMatrix, axisX, axisY, tempRotationMatrix)
-            != OHOS::Sensors::SUCCESS) {
-            SEN_HILOGE("TransformCoordinateSystemImpl failed");
-            return OHOS::Sensors::PARAMETER_ERROR;
-        }
-        for (int32_t i = 0; i < inRotationMatrixLength; i++) {
-            outRotationMatrix[i] = tempRotationMatrix[i];
+    return DispatchMatrix(inRotationMatrix, [&](const auto &in) {
+        auto out = in;
+        int32_t ret = TransformCoordinateSystem(in, axisX, axisY, out);
+        if (ret == OHOS::Sensors::SUCCESS) {
+            CopyToVector(out, outRotationMatrix);
         }
-        return OHOS::Sensors::SUCCESS;
-    }
-    return TransformCoordinateSystemImpl(inRotationMatrix, axisX, axisY, outRotationMatrix);
+        return ret;
+    });
 }
 
 int32_t SensorAlgorithm::GetAltitude(float seaPressure, float currentPressure, float *altitude)
@@ -137,55 +234,41 @@ int32_t SensorAlgorithm::GetAltitude(float seaPressure, float currentPressure, f
     return OHOS::Sensors::SUCCESS;
 }
 
-int32_t SensorAlgorithm::GetGeomagneticDip(std::vector<float> inclinationMatrix, float *geomagneticDip)
+template<size_t N>
+int32_t SensorAlgorithm::GetGeomagneticDip(const std::array<float, N> &inclinationMatrix, float *geomagneticDip)
 {
     if (geomagneticDip == nullptr) {
         SEN_HILOGE("Invalid parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
-    int32_t matrixLength = static_cast<int32_t>(inclinationMatrix.size());
-    if (matrixLength != THREE_DIMENSIONAL_MATRIX_LENGTH && matrixLength != FOUR_DIMENSIONAL_MATRIX_LENGTH) {
-        SEN_HILOGE("Invalid input parameter");
-        return OHOS::Sensors::PARAMETER_ERROR;
-    }
-    if (matrixLength == THREE_DIMENSIONAL_MATRIX_LENGTH) {
-        *geomagneticDip = std::atan2(inclinationMatrix[5], inclinationMatrix[4]);
-    } else {
-        *geomagneticDip = std::atan2(inclinationMatrix[6], inclinationMatrix[5]);
-    }
+    *geomagneticDip = std::atan2(inclinationMatrix[MatrixIndex<N>(5)], inclinationMatrix[MatrixIndex<N>(4)]);
     return OHOS::Sensors::SUCCESS;
 }
 
-int32_t SensorAlgorithm::GetAngleModify(std::vector<float> curRotationMatrix, std::vector<float> preRotationMatrix,
-    std::vector<float> &angleChange)
+int32_t SensorAlgorithm::GetGeomagneticDip(std::vector<float> inclinationMatrix, float *geomagneticDip)
 {
-    if (static_cast<int32_t>(angleChange.size()) < ROTATION_VECTOR_LENGTH) {
+    if (geomagneticDip == nullptr) {
         SEN_HILOGE("Invalid parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
-    int32_t curRotationMatrixLength = static_cast<int32_t>(curRotationMatrix.size());
-    int32_t preRotationMatrixLength = static_cast<int32_t>(preRotationMatrix.size());
-    if ((curRotationMatrixLength != FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        && (curRotationMatrixLength != THREE_DIMENSIONAL_MATRIX_LENGTH)) {
-        SEN_HILOGE("Invalid input curRotationMatrix parameter");
-        return OHOS::Sensors::PARAMETER_ERROR;
-    }
-    if ((preRotationMatrixLength != FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        && (preRotationMatrixLength != THREE_DIMENSIONAL_MATRIX_LENGTH)) {
-        SEN_HILOGE("Invalid input currotationMatrix parameter");
+    if (!IsMatrixLength(inclinationMatrix.size())) {
+        SEN_HILOGE("Invalid input parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
+    return DispatchMatrix(inclinationMatrix, [&](const auto &matrix) {
+        return GetGeomagneticDip(matrix, geomagneticDip);
+    });
+}
+
+template<size_t C, size_t P>
+int32_t SensorAlgorithm::GetAngleModify(const std::array<float, C> &curRotationMatrix,
+    const std::array<float, P> &preRotationMatrix, Vector3 &angleChange)
+{
     float curMatrix[THREE_DIMENSIONAL_MATRIX_LENGTH] = {0};
     float preMatrix[THREE_DIMENSIONAL_MATRIX_LENGTH] = {0};
-    int32_t curmatrixDimension = ((curRotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        ? QUATERNION_LENGTH : ROTATION_VECTOR_LENGTH);
-    int32_t prematrixDimension = ((preRotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        ? QUATERNION_LENGTH : ROTATION_VECTOR_LENGTH);
-    for (int32_t i = 0; i < THREE_DIMENSIONAL_MATRIX_LENGTH; i++) {
-        int32_t curMatrixIndex = i % ROTATION_VECTOR_LENGTH + (i / ROTATION_VECTOR_LENGTH) * curmatrixDimension;
-        curMatrix[i] = curRotationMatrix[curMatrixIndex];
-        int32_t preMatrixIndex = i % ROTATION_VECTOR_LENGTH + (i / ROTATION_VECTOR_LENGTH) * prematrixDimension;
-        preMatrix[i] = preRotationMatrix[preMatrixIndex];
+    for (size_t i = 0; i < THREE_DIMENSIONAL_MATRIX_LENGTH; i++) {
+        curMatrix[i] = curRotationMatrix[MatrixIndex<C>(i)];
+        preMatrix[i] = preRotationMatrix[MatrixIndex<P>(i)];
     }
     float radian[THREE_DIMENSIONAL_MATRIX_LENGTH] = {0};
     radian[1] = preMatrix[0] * curMatrix[1] + preMatrix[3] * curMatrix[4] + preMatrix[6] * curMatrix[7];
@@ -199,20 +282,35 @@ int32_t SensorAlgorithm::GetAngleModify(std::vector<float> curRotationMatrix, st
     return OHOS::Sensors::SUCCESS;
 }
 
-int32_t SensorAlgorithm::GetDirection(std::vector<float> rotationMatrix, std::vector<float> &rotationAngle)
+int32_t SensorAlgorithm::GetAngleModify(std::vector<float> curRotationMatrix,
+    std::vector<float> preRotationMatrix, std::vector<float> &angleChange)
 {
-    if (static_cast<int32_t>(rotationAngle.size()) < ROTATION_VECTOR_LENGTH) {
+    if (angleChange.size() < ROTATION_VECTOR_LENGTH) {
         SEN_HILOGE("Invalid parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
-    int32_t rotationMatrixLength = static_cast<int32_t>(rotationMatrix.size());
-    if ((rotationMatrixLength != FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        && (rotationMatrixLength != THREE_DIMENSIONAL_MATRIX_LENGTH)) {
-        SEN_HILOGE("Invalid input rotationMatrix parameter");
+    if (!IsMatrixLength(curRotationMatrix.size())) {
+        SEN_HILOGE("Invalid input curRotationMatrix parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    if (!IsMatrixLength(preRotationMatrix.size())) {
+        SEN_HILOGE("Invalid input currotationMatrix parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
-    int32_t dimension = ((rotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        ? QUATERNION_LENGTH : ROTATION_VECTOR_LENGTH);
+    Vector3 result;
+    int32_t ret = DispatchMatrix(curRotationMatrix, [&](const auto &cur) {
+        return DispatchMatrix(preRotationMatrix, [&](const auto &pre) {
+            return GetAngleModify(cur, pre, result);
+        });
+    });
+    CopyToVector(result, angleChange);
+    return ret;
+}
+
+template<size_t N>
+int32_t SensorAlgorithm::GetDirection(const std::array<float, N> &rotationMatrix, Vector3 &rotationAngle)
+{
+    constexpr size_t dimension = MatrixDimension<N>();
     rotationAngle[0] = static_cast<float>(std::atan2(rotationMatrix[1],
         rotationMatrix[dimension * 1 + 1]));
     rotationAngle[1] = static_cast<float>(std::atan2(-rotationMatrix[2 * dimension + 1],
@@ -222,16 +320,29 @@ int32_t SensorAlgorithm::GetDirection(std::vector<float> rotationMatrix, std::ve
     return OHOS::Sensors::SUCCESS;
 }
 
-int32_t SensorAlgorithm::CreateRotationMatrix(std::vector<float> rotationVector, std::vector<float> &rotationMatrix)
+int32_t SensorAlgorithm::GetDirection(std::vector<float> rotationMatrix, std::vector<float> &rotationAngle)
 {
-    int32_t rotationMatrixLength = static_cast<int32_t>(rotationMatrix.size());
-    if ((static_cast<int32_t>(rotationVector.size()) < ROTATION_VECTOR_LENGTH)
-        || ((rotationMatrixLength != FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        && (rotationMatrixLength != THREE_DIMENSIONAL_MATRIX_LENGTH))) {
+    if (rotationAngle.size() < ROTATION_VECTOR_LENGTH) {
+        SEN_HILOGE("Invalid parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    if (!IsMatrixLength(rotationMatrix.size())) {
         SEN_HILOGE("Invalid input rotationMatrix parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
-    std::vector<float> quaternion(4);
+    Vector3 result;
+    int32_t ret = DispatchMatrix(rotationMatrix, [&](const auto &matrix) {
+        return GetDirection(matrix, result);
+    });
+    CopyToVector(result, rotationAngle);
+    return ret;
+}
+
+template<size_t V, size_t N>
+int32_t SensorAlgorithm::CreateRotationMatrix(const std::array<float, V> &rotationVector,
+    std::array<float, N> &rotationMatrix)
+{
+    Quaternion quaternion;
     int32_t ret = CreateQuaternion(rotationVector, quaternion);
     if (ret != OHOS::Sensors::SUCCESS) {
         SEN_HILOGE("Create quaternion failed");
@@ -246,45 +357,45 @@ int32_t SensorAlgorithm::CreateRotationMatrix(std::vector<float> rotationVector,
     float productOfXZ = 2 * quaternion[1] * quaternion[3];
     float productOfWX = 2 * quaternion[0] * quaternion[1];
     float productOfYZ = 2 * quaternion[2] * quaternion[3];
-    int32_t rotationMatrixDimension =  ((rotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        ? QUATERNION_LENGTH : ROTATION_VECTOR_LENGTH);
-    rotationMatrix[0] = 1 - squareOfY - squareOfZ;
-    rotationMatrix[1] = productOfXY - productOfWZ;
-    rotationMatrix[2] = productOfXZ + productOfWY;
-    rotationMatrix[3 % ROTATION_VECTOR_LENGTH + (3 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension]
-        = productOfXY + productOfWZ;
-    rotationMatrix[4 % ROTATION_VECTOR_LENGTH + (4 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension]
-        = 1 - squareOfX - squareOfZ;
-    rotationMatrix[5 % ROTATION_VECTOR_LENGTH + (5 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension]
-        = productOfYZ - productOfWX;
-    rotationMatrix[6 % ROTATION_VECTOR_LENGTH + (6 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension]
-        = productOfXZ - productOfWY;
-    rotationMatrix[7 % ROTATION_VECTOR_LENGTH + (7 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension]
-        = productOfYZ + productOfWX;
-    rotationMatrix[8 % ROTATION_VECTOR_LENGTH + (8 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension]
-        = 1 - squareOfX - squareOfY;
-    if (rotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH) {
-        rotationMatrix[3] = rotationMatrix[7] = rotationMatrix[11] = rotationMatrix[12] = rotationMatrix[13]
-            = rotationMatrix[14] = 0.0f;
-        rotationMatrix[15] = 1.0f;
-    }
+    rotationMatrix[MatrixIndex<N>(0)] = 1 - squareOfY - squareOfZ;
+    rotationMatrix[MatrixIndex<N>(1)] = productOfXY - productOfWZ;
+    rotationMatrix[MatrixIndex<N>(2)] = productOfXZ + productOfWY;
+    rotationMatrix[MatrixIndex<N>(3)] = productOfXY + productOfWZ;
+    rotationMatrix[MatrixIndex<N>(4)] = 1 - squareOfX - squareOfZ;
+    rotationMatrix[MatrixIndex<N>(5)] = productOfYZ - productOfWX;
+    rotationMatrix[MatrixIndex<N>(6)] = productOfXZ - productOfWY;
+    rotationMatrix[MatrixIndex<N>(7)] = productOfYZ + productOfWX;
+    rotationMatrix[MatrixIndex<N>(8)] = 1 - squareOfX - squareOfY;
+    FillHomogeneousPart(rotationMatrix);
     return OHOS::Sensors::SUCCESS;
 }
 
-int32_t SensorAlgorithm::CreateRotationAndInclination(std::vector<float> gravity, std::vector<float> geomagnetic,
-    std::vector<float> &rotationMatrix, std::vector<float> &inclinationMatrix)
+int32_t SensorAlgorithm::CreateRotationMatrix(std::vector<float> rotationVector,
+    std::vector<float> &rotationMatrix)
 {
-    if (static_cast<int32_t>(gravity.size()) < ROTATION_VECTOR_LENGTH
-        || static_cast<int32_t>(geomagnetic.size()) < ROTATION_VECTOR_LENGTH) {
-        SEN_HILOGE("Invalid input parameter");
+    if ((rotationVector.size() < ROTATION_VECTOR_LENGTH) || (rotationVector.size() > QUATERNION_LENGTH) ||
+        !IsMatrixLength(rotationMatrix.size())) {
+        SEN_HILOGE("Invalid input rotationMatrix parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
+    return DispatchOutputMatrix(rotationMatrix, [&](auto &matrix) {
+        if (rotationVector.size() == ROTATION_VECTOR_LENGTH) {
+            return CreateRotationMatrix(ToArray<ROTATION_VECTOR_LENGTH>(rotationVector), matrix);
+        }
+        return CreateRotationMatrix(ToArray<QUATERNION_LENGTH>(rotationVector), matrix);
+    });
+}
+
+template<size_t R, size_t I>
+int32_t SensorAlgorithm::CreateRotationAndInclination(const Vector3 &gravity, const Vector3 &geomagnetic,
+    std::array<float, R> &rotationMatrix, std::array<float, I> &inclinationMatrix)
+{
     float totalGravity = pow(gravity[0], 2) + pow(gravity[1], 2) + pow(gravity[2], 2);
     if (totalGravity < (0.01f * pow(GRAVITATIONAL_ACCELERATION, 2))) {
         SEN_HILOGE("Invalid input gravity parameter");
         return OHOS::Sensors::PARAMETER_ERROR;
     }
-    std::vector<float> componentH(3);
+    Vector3 componentH;
     componentH[0] = geomagnetic[1] * gravity[2] - geomagnetic[2] * gravity[1];
     componentH[1] = geomagnetic[2] * gravity[0] - geomagnetic[0] * gravity[2];
     componentH[2] = geomagnetic[0] * gravity[1] - geomagnetic[1] * gravity[0];
@@ -299,61 +410,92 @@ int32_t SensorAlgorithm::CreateRotationAndInclination(std::vector<float> gravity
     componentH[1] *= reciprocalH;
     componentH[2] *= reciprocalH;
     float reciprocalA = 1.0f / static_cast<float>(std::sqrt(totalGravity));
-    gravity[0] *= reciprocalA;
-    gravity[1] *= reciprocalA;
-    gravity[2] *= reciprocalA;
+    Vector3 normalGravity;
+    normalGravity[0] = gravity[0] * reciprocalA;
+    normalGravity[1] = gravity[1] * reciprocalA;
+    normalGravity[2] = gravity[2] * reciprocalA;
 
-    std::vector<float> measuredValue(3);
-    measuredValue[0] = gravity[1] * componentH[2] - gravity[2] * componentH[1];
-    measuredValue[1] = gravity[2] * componentH[0] - gravity[0] * componentH[2];
-    measuredValue[2] = gravity[0] * componentH[1] - gravity[1] * componentH[0];
-    int32_t rotationMatrixLength = static_cast<int32_t>(rotationMatrix.size());
-    int32_t inclinationMatrixLength = static_cast<int32_t>(inclinationMatrix.size());
-    if ((rotationMatrixLength != 9 && rotationMatrixLength != 16) || (inclinationMatrixLength != 9
-        && inclinationMatrixLength != 16)) {
-        SEN_HILOGE("Invalid input parameter");
-        return OHOS::Sensors::PARAMETER_ERROR;
-    }
+    Vector3 measuredValue;
+    measuredValue[0] = normalGravity[1] * componentH[2] - normalGravity[2] * componentH[1];
+    measuredValue[1] = normalGravity[2] * componentH[0] - normalGravity[0] * componentH[2];
+    measuredValue[2] = normalGravity[0] * componentH[1] - normalGravity[1] * componentH[0];
     float e = static_cast<float>(std::sqrt(pow(geomagnetic[0], 2) + pow(geomagnetic[1], 2) + pow(geomagnetic[2], 2)));
     float reciprocalE = IsEqual(e, 0.0f) ? std::numeric_limits<float>::max() : 1.0f / e;
     float c = (geomagnetic[0] * measuredValue[0] + geomagnetic[1] * measuredValue[1]
         + geomagnetic[2] * measuredValue[2]) * reciprocalE;
-    float s = (geomagnetic[0] * gravity[0] + geomagnetic[1] * gravity[1] + geomagnetic[2] * gravity[2]) * reciprocalE;
+    float s = (geomagnetic[0] * normalGravity[0] + geomagnetic[1] * normalGravity[1]
+        + geomagnetic[2] * normalGravity[2]) * reciprocalE;
 
-    int32_t rotationMatrixDimension =  ((rotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        ? QUATERNION_LENGTH : ROTATION_VECTOR_LENGTH);
-    int32_t inclinationMatrixDimension =  ((inclinationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH)
-        ? QUATERNION_LENGTH : ROTATION_VECTOR_LENGTH);
-    rotationMatrix[0] = componentH[0];
-    rotationMatrix[1] = componentH[1];
-    rotationMatrix[2] = componentH[2];
-    rotationMatrix[3 % ROTATION_VECTOR_LENGTH + (3 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension] =
-        measuredValue[0];
-    rotationMatrix[4 % ROTATION_VECTOR_LENGTH + (4 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension] =
-        measuredValue[1];
-    rotationMatrix[5 % ROTATION_VECTOR_LENGTH + (5 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension] =
-        measuredValue[2];
-    rotationMatrix[6 % ROTATION_VECTOR_LENGTH + (6 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension] = gravity[0];
-    rotationMatrix[7 % ROTATION_VECTOR_LENGTH + (7 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension] = gravity[1];
-    rotationMatrix[8 % ROTATION_VECTOR_LENGTH + (8 / ROTATION_VECTOR_LENGTH) * rotationMatrixDimension] = gravity[2];
-    if (rotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH) {
-        rotationMatrix[3] = rotationMatrix[7] = rotationMatrix[11] = rotationMatrix[12]
-            = rotationMatrix[13] = rotationMatrix[14] = 0.0f;
-        rotationMatrix[15] = 1.0f;
+    rotationMatrix[MatrixIndex<R>(0)] = componentH[0];
+    rotationMatrix[MatrixIndex<R>(1)] = componentH[1];
+    rotationMatrix[MatrixIndex<R>(2)] = componentH[2];
+    rotationMatrix[MatrixIndex<R>(3)] = measuredValue[0];
+    rotationMatrix[MatrixIndex<R>(4)] = measuredValue[1];
+    rotationMatrix[MatrixIndex<R>(5)] = measuredValue[2];
+    rotationMatrix[MatrixIndex<R>(6)] = normalGravity[0];
+    rotationMatrix[MatrixIndex<R>(7)] = normalGravity[1];
+    rotationMatrix[MatrixIndex<R>(8)] = normalGravity[2];
+    FillHomogeneousPart(rotationMatrix);
+    inclinationMatrix[MatrixIndex<I>(0)] = 1;
+    inclinationMatrix[MatrixIndex<I>(1)] = 0;
+    inclinationMatrix[MatrixIndex<I>(2)] = 0;
+    inclinationMatrix[MatrixIndex<I>(3)] = 0;
+    inclinationMatrix[MatrixIndex<I>(4)] = c;
+    inclinationMatrix[MatrixIndex<I>(5)] = s;
+    inclinationMatrix[MatrixIndex<I>(6)] = 0;
+    inclinationMatrix[MatrixIndex<I>(7)] = -s;
+    inclinationMatrix[MatrixIndex<I>(8)] = c;
+    FillHomogeneousPart(inclinationMatrix);
+    return OHOS::Sensors::SUCCESS;
+}
+
+int32_t SensorAlgorithm::CreateRotationAndInclination(std::vector<float> gravity,
+    std::vector<float> geomagnetic, std::vector<float> &rotationMatrix, std::vector<float> &inclinationMatrix)
+{
+    if (gravity.size() < ROTATION_VECTOR_LENGTH || geomagnetic.size() < ROTATION_VECTOR_LENGTH) {
+        SEN_HILOGE("Invalid input parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
     }
-    inclinationMatrix[0] = 1;
-    inclinationMatrix[1] = 0;
-    inclinationMatrix[2] = 0;
-    inclinationMatrix[3 % ROTATION_VECTOR_LENGTH + (3 / ROTATION_VECTOR_LENGTH) * inclinationMatrixDimension] = 0;
-    inclinationMatrix[4 % ROTATION_VECTOR_LENGTH + (4 / ROTATION_VECTOR_LENGTH) * inclinationMatrixDimension] = c;
-    inclinationMatrix[5 % ROTATION_VECTOR_LENGTH + (5 / ROTATION_VECTOR_LENGTH) * inclinationMatrixDimension] = s;
-    inclinationMatrix[6 % ROTATION_VECTOR_LENGTH + (6 / ROTATION_VECTOR_LENGTH) * inclinationMatrixDimension] = 0;
-    inclinationMatrix[7 % ROTATION_VECTOR_LENGTH + (7 / ROTATION_VECTOR_LENGTH) * inclinationMatrixDimension] = -s;
-    inclinationMatrix[8 % ROTATION_VECTOR_LENGTH + (8 / ROTATION_VECTOR_LENGTH) * inclinationMatrixDimension] = c;
-    if (rotationMatrixLength == FOUR_DIMENSIONAL_MATRIX_LENGTH) {
-        inclinationMatrix[3] = inclinationMatrix[7] = inclinationMatrix[11] = inclinationMatrix[12]
-            = inclinationMatrix[13] = inclinationMatrix[14] = 0.0f;
-        inclinationMatrix[15] = 1.0f;
+    if (!IsMatrixLength(rotationMatrix.size()) || !IsMatrixLength(inclinationMatrix.size())) {
+        SEN_HILOGE("Invalid input parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
     }
-    return OHOS::Sensors::SUCCESS;
-}
\ No newline at end of file
+    Vector3 gravityValue = ToArray<ROTATION_VECTOR_LENGTH>(gravity);
+    Vector3 geomagneticValue = ToArray<ROTATION_VECTOR_LENGTH>(geomagnetic);
+    return DispatchOutputMatrix(rotationMatrix, [&](auto &rotation) {
+        return DispatchOutputMatrix(inclinationMatrix, [&](auto &inclination) {
+            return CreateRotationAndInclination(gravityValue, geomagneticValue, rotation, inclination);
+        });
+    });
+}
+
+template int32_t SensorAlgorithm::CreateQuaternion(const std::array<float, 3> &, Quaternion &);
+template int32_t SensorAlgorithm::CreateQuaternion(const std::array<float, 4> &, Quaternion &);
+template int32_t SensorAlgorithm::TransformCoordinateSystem(const std::array<float, 9> &, int32_t, int32_t,
+    std::array<float, 9> &);
+template int32_t SensorAlgorithm::TransformCoordinateSystem(const std::array<float, 16> &, int32_t, int32_t,
+    std::array<float, 16> &);
+template int32_t SensorAlgorithm::GetGeomagneticDip(const std::array<float, 9> &, float *);
+template int32_t SensorAlgorithm::GetGeomagneticDip(const std::array<float, 16> &, float *);
+template int32_t SensorAlgorithm::GetAngleModify(const std::array<float, 9> &, const std::array<float, 9> &,
+    Vector3 &);
+template int32_t SensorAlgorithm::GetAngleModify(const std::array<float, 9> &, const std::array<float, 16> &,
+    Vector3 &);
+template int32_t SensorAlgorithm::GetAngleModify(const std::array<float, 16> &, const std::array<float, 9> &,
+    Vector3 &);
+template int32_t SensorAlgorithm::GetAngleModify(const std::array<float, 16> &, const std::array<float, 16> &,
+    Vector3 &);
+template int32_t SensorAlgorithm::GetDirection(const std::array<float, 9> &, Vector3 &);
+template int32_t SensorAlgorithm::GetDirection(const std::array<float, 16> &, Vector3 &);
+template int32_t SensorAlgorithm::CreateRotationMatrix(const std::array<float, 3> &, std::array<float, 9> &);
+template int32_t SensorAlgorithm::CreateRotationMatrix(const std::array<float, 3> &, std::array<float, 16> &);
+template int32_t SensorAlgorithm::CreateRotationMatrix(const std::array<float, 4> &, std::array<float, 9> &);
+template int32_t SensorAlgorithm::CreateRotationMatrix(const std::array<float, 4> &, std::array<float, 16> &);
+template int32_t SensorAlgorithm::CreateRotationAndInclination(const Vector3 &, const Vector3 &,
+    std::array<float, 9> &, std::array<float, 9> &);
+template int32_t SensorAlgorithm::CreateRotationAndInclination(const Vector3 &, const Vector3 &,
+    std::array<float, 9> &, std::array<float, 16> &);
+template int32_t SensorAlgorithm::CreateRotationAndInclination(const Vector3 &, const Vector3 &,
+    std::array<float, 16> &, std::array<float, 9> &);
+template int32_t SensorAlgorithm::CreateRotationAndInclination(const Vector3 &, const Vector3 &,
+    std::array<float, 16> &, std::array<float, 16> &);
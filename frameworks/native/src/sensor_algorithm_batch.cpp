@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "sensor_algorithm.h"
+
+#include <cmath>
+#include <limits>
+
+#include "securec.h"
+#include "sensor_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorAlgorithmAPI"
+using namespace OHOS::Sensors;
+
+namespace {
+// Four lanes of float, lowered to NEON on aarch64 and SSE on x86_64.
+typedef float FloatX4 __attribute__((vector_size(16)));
+typedef int32_t IntX4 __attribute__((vector_size(16)));
+constexpr size_t LANES = 4;
+constexpr size_t MATRIX_LENGTH = SensorAlgorithm::THREE_DIMENSIONAL_MATRIX_LENGTH;
+constexpr size_t ANGLE_LENGTH = SensorAlgorithm::ROTATION_VECTOR_LENGTH;
+constexpr float PI = 3.14159265358979323846f;
+constexpr float HALF_PI = 1.57079632679489661923f;
+// Minimax fit of atan(a) / a over a in [0, 1] as a polynomial in a * a, the absolute error is below 4e-8.
+constexpr float ATAN_COEFFICIENTS[] = {
+    0.9999993356f, -0.3332986078f, 0.1994656566f, -0.1390862958f, 0.09642197409f, -0.05591232793f,
+    0.02186295871f, -0.004054567450f
+};
+
+inline FloatX4 Broadcast(float value)
+{
+    FloatX4 result = { value, value, value, value };
+    return result;
+}
+
+// The element wise forms are merged into one unaligned vector load and store.
+inline FloatX4 Load(const float *src)
+{
+    FloatX4 value = { src[0], src[1], src[2], src[3] };
+    return value;
+}
+
+inline void Store(float *dst, FloatX4 value)
+{
+    for (size_t i = 0; i < LANES; ++i) {
+        dst[i] = value[i];
+    }
+}
+
+// A cast between vector types of the same size keeps the bits.
+inline IntX4 AsInt(FloatX4 value)
+{
+    return (IntX4)value;
+}
+
+inline FloatX4 AsFloat(IntX4 value)
+{
+    return (FloatX4)value;
+}
+
+inline FloatX4 Select(IntX4 mask, FloatX4 onTrue, FloatX4 onFalse)
+{
+    return AsFloat((mask & AsInt(onTrue)) | (~mask & AsInt(onFalse)));
+}
+
+inline FloatX4 Abs(FloatX4 value)
+{
+    return AsFloat(AsInt(value) & std::numeric_limits<int32_t>::max());
+}
+
+inline FloatX4 Min(FloatX4 left, FloatX4 right)
+{
+    return Select(left < right, left, right);
+}
+
+inline FloatX4 Max(FloatX4 left, FloatX4 right)
+{
+    return Select(left > right, left, right);
+}
+
+inline FloatX4 Sqrt(FloatX4 value)
+{
+    FloatX4 result = { std::sqrt(value[0]), std::sqrt(value[1]), std::sqrt(value[2]), std::sqrt(value[3]) };
+    return result;
+}
+
+// The ratio of the smaller to the larger magnitude goes through the atan polynomial, then the octant is restored.
+FloatX4 Atan2(FloatX4 y, FloatX4 x)
+{
+    const FloatX4 zero = Broadcast(0.0f);
+    FloatX4 absY = Abs(y);
+    FloatX4 absX = Abs(x);
+    IntX4 steep = absY > absX;
+    FloatX4 numerator = Select(steep, absX, absY);
+    FloatX4 denominator = Select(steep, absY, absX);
+    denominator = Select(denominator > zero, denominator, Broadcast(1.0f));
+    FloatX4 ratio = numerator / denominator;
+    FloatX4 square = ratio * ratio;
+    constexpr size_t order = sizeof(ATAN_COEFFICIENTS) / sizeof(ATAN_COEFFICIENTS[0]);
+    FloatX4 poly = Broadcast(ATAN_COEFFICIENTS[order - 1]);
+    for (size_t i = order - 1; i > 0; --i) {
+        poly = poly * square + ATAN_COEFFICIENTS[i - 1];
+    }
+    FloatX4 angle = ratio * poly;
+    angle = Select(steep, HALF_PI - angle, angle);
+    angle = Select(x < zero, PI - angle, angle);
+    return Select(y < zero, -angle, angle);
+}
+
+// sqrt(a * a + b * b) without the squares underflowing or overflowing, as the double math of the scalar API.
+FloatX4 Hypot(FloatX4 a, FloatX4 b)
+{
+    FloatX4 absA = Abs(a);
+    FloatX4 absB = Abs(b);
+    FloatX4 larger = Max(absA, absB);
+    FloatX4 smaller = Min(absA, absB);
+    FloatX4 ratio = smaller / Select(larger > Broadcast(0.0f), larger, Broadcast(1.0f));
+    return larger * Sqrt(1.0f + ratio * ratio);
+}
+
+FloatX4 Asin(FloatX4 value)
+{
+    value = Min(Max(value, Broadcast(-1.0f)), Broadcast(1.0f));
+    // 1 - |value| is exact near 1, unlike 1 - value * value.
+    FloatX4 absValue = Abs(value);
+    return Atan2(value, Sqrt((1.0f - absValue) * (1.0f + absValue)));
+}
+
+// Scalar part of a unit quaternion whose vector part is (x, y, z), as in SensorAlgorithm::CreateQuaternion.
+inline FloatX4 QuaternionScalar(FloatX4 x, FloatX4 y, FloatX4 z)
+{
+    FloatX4 w = 1.0f - (x * x + y * y + z * z);
+    return Select(w > Broadcast(0.0f), Sqrt(w), Broadcast(0.0f));
+}
+
+void RotationMatrix(FloatX4 w, FloatX4 x, FloatX4 y, FloatX4 z, std::array<FloatX4, MATRIX_LENGTH> &matrix)
+{
+    FloatX4 squareOfX = 2.0f * x * x;
+    FloatX4 squareOfY = 2.0f * y * y;
+    FloatX4 squareOfZ = 2.0f * z * z;
+    FloatX4 productOfWZ = 2.0f * w * z;
+    FloatX4 productOfXY = 2.0f * x * y;
+    FloatX4 productOfWY = 2.0f * w * y;
+    FloatX4 productOfXZ = 2.0f * x * z;
+    FloatX4 productOfWX = 2.0f * w * x;
+    FloatX4 productOfYZ = 2.0f * y * z;
+    matrix[0] = 1.0f - squareOfY - squareOfZ;
+    matrix[1] = productOfXY - productOfWZ;
+    matrix[2] = productOfXZ + productOfWY;
+    matrix[3] = productOfXY + productOfWZ;
+    matrix[4] = 1.0f - squareOfX - squareOfZ;
+    matrix[5] = productOfYZ - productOfWX;
+    matrix[6] = productOfXZ - productOfWY;
+    matrix[7] = productOfYZ + productOfWX;
+    matrix[8] = 1.0f - squareOfX - squareOfY;
+}
+
+/*
+ * Run 'kernel' over 'count' samples, LANES at a time. The last partial block is padded with zeros, which every
+ * kernel here maps to finite values, and only the valid lanes are stored.
+ */
+template<size_t IN, size_t OUT, typename Kernel>
+void RunKernel(const std::array<const float *, IN> &inputs, const std::array<float *, OUT> &outputs, size_t count,
+    Kernel kernel)
+{
+    std::array<FloatX4, IN> in;
+    std::array<FloatX4, OUT> out;
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        for (size_t k = 0; k < IN; ++k) {
+            in[k] = Load(inputs[k] + i);
+        }
+        kernel(in, out);
+        for (size_t k = 0; k < OUT; ++k) {
+            Store(outputs[k] + i, out[k]);
+        }
+    }
+    if (i == count) {
+        return;
+    }
+    size_t tail = count - i;
+    for (size_t k = 0; k < IN; ++k) {
+        in[k] = Broadcast(0.0f);
+        for (size_t lane = 0; lane < tail; ++lane) {
+            in[k][lane] = inputs[k][i + lane];
+        }
+    }
+    kernel(in, out);
+    for (size_t k = 0; k < OUT; ++k) {
+        for (size_t lane = 0; lane < tail; ++lane) {
+            outputs[k][i + lane] = out[k][lane];
+        }
+    }
+}
+
+bool IsValidBatch(const RotationVectorBatch &batch)
+{
+    size_t count = batch.x.size();
+    return (batch.y.size() == count) && (batch.z.size() == count) && (batch.w.empty() || (batch.w.size() == count));
+}
+
+bool IsValidBatch(const RotationMatrixBatch &batch)
+{
+    for (const auto &element : batch.elements) {
+        if (element.size() != batch.elements[0].size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsRotationVectorSensor(int32_t sensorTypeId)
+{
+    return (sensorTypeId == SENSOR_TYPE_ID_ROTATION_VECTOR) || (sensorTypeId == SENSOR_TYPE_ID_GAME_ROTATION_VECTOR) ||
+        (sensorTypeId == SENSOR_TYPE_ID_GEOMAGNETIC_ROTATION_VECTOR);
+}
+}  // namespace
+
+int32_t SensorAlgorithm::LoadRotationVectors(const SensorEvent *events, int32_t num, RotationVectorBatch &batch)
+{
+    CHKPR(events, OHOS::Sensors::PARAMETER_ERROR);
+    if (num < 0) {
+        SEN_HILOGE("Invalid num:%{public}d", num);
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    if (!IsValidBatch(batch) || (batch.w.size() != batch.x.size())) {
+        SEN_HILOGE("Invalid input batch parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    for (int32_t i = 0; i < num; ++i) {
+        const SensorEvent &event = events[i];
+        if (!IsRotationVectorSensor(event.sensorTypeId) || (event.data == nullptr) ||
+            (event.dataLen < sizeof(RotationVectorData))) {
+            continue;
+        }
+        RotationVectorData data;
+        if (memcpy_s(&data, sizeof(data), event.data, sizeof(data)) != EOK) {
+            SEN_HILOGE("Copy rotation vector failed");
+            return OHOS::Sensors::ERROR;
+        }
+        batch.x.push_back(data.x);
+        batch.y.push_back(data.y);
+        batch.z.push_back(data.z);
+        batch.w.push_back(data.w);
+    }
+    return OHOS::Sensors::SUCCESS;
+}
+
+int32_t SensorAlgorithm::CreateQuaternionBatch(const RotationVectorBatch &rotationVectors,
+    QuaternionBatch &quaternions)
+{
+    if (!IsValidBatch(rotationVectors)) {
+        SEN_HILOGE("Invalid input rotationVectors parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    size_t count = rotationVectors.x.size();
+    quaternions.x.assign(rotationVectors.x.begin(), rotationVectors.x.end());
+    quaternions.y.assign(rotationVectors.y.begin(), rotationVectors.y.end());
+    quaternions.z.assign(rotationVectors.z.begin(), rotationVectors.z.end());
+    if (!rotationVectors.w.empty()) {
+        quaternions.w.assign(rotationVectors.w.begin(), rotationVectors.w.end());
+        return OHOS::Sensors::SUCCESS;
+    }
+    quaternions.w.resize(count);
+    RunKernel<ROTATION_VECTOR_LENGTH, 1>(
+        { rotationVectors.x.data(), rotationVectors.y.data(), rotationVectors.z.data() }, { quaternions.w.data() },
+        count, [](const auto &in, auto &out) {
+            out[0] = QuaternionScalar(in[0], in[1], in[2]);
+        });
+    return OHOS::Sensors::SUCCESS;
+}
+
+int32_t SensorAlgorithm::CreateRotationMatrixBatch(const RotationVectorBatch &rotationVectors,
+    RotationMatrixBatch &rotationMatrices)
+{
+    if (!IsValidBatch(rotationVectors)) {
+        SEN_HILOGE("Invalid input rotationVectors parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    size_t count = rotationVectors.x.size();
+    std::array<float *, MATRIX_LENGTH> outputs;
+    for (size_t i = 0; i < MATRIX_LENGTH; ++i) {
+        rotationMatrices.elements[i].resize(count);
+        outputs[i] = rotationMatrices.elements[i].data();
+    }
+    if (rotationVectors.w.empty()) {
+        RunKernel<ROTATION_VECTOR_LENGTH, MATRIX_LENGTH>(
+            { rotationVectors.x.data(), rotationVectors.y.data(), rotationVectors.z.data() }, outputs, count,
+            [](const auto &in, auto &out) {
+                RotationMatrix(QuaternionScalar(in[0], in[1], in[2]), in[0], in[1], in[2], out);
+            });
+        return OHOS::Sensors::SUCCESS;
+    }
+    RunKernel<QUATERNION_LENGTH, MATRIX_LENGTH>({ rotationVectors.x.data(), rotationVectors.y.data(),
+        rotationVectors.z.data(), rotationVectors.w.data() }, outputs, count, [](const auto &in, auto &out) {
+            RotationMatrix(in[3], in[0], in[1], in[2], out);
+        });
+    return OHOS::Sensors::SUCCESS;
+}
+
+int32_t SensorAlgorithm::GetDirectionBatch(const RotationMatrixBatch &rotationMatrices,
+    OrientationBatch &rotationAngles)
+{
+    if (!IsValidBatch(rotationMatrices)) {
+        SEN_HILOGE("Invalid input rotationMatrices parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    const auto &m = rotationMatrices.elements;
+    size_t count = m[0].size();
+    rotationAngles.z.resize(count);
+    rotationAngles.x.resize(count);
+    rotationAngles.y.resize(count);
+    RunKernel<MATRIX_LENGTH, ANGLE_LENGTH>({ m[0].data(), m[1].data(), m[2].data(), m[3].data(), m[4].data(),
+        m[5].data(), m[6].data(), m[7].data(), m[8].data() },
+        { rotationAngles.z.data(), rotationAngles.x.data(), rotationAngles.y.data() }, count,
+        [](const auto &in, auto &out) {
+            out[0] = Atan2(in[1], in[4]);
+            out[1] = Atan2(-in[7], Hypot(in[1], in[4]));
+            out[2] = Atan2(-in[6], in[8]);
+        });
+    return OHOS::Sensors::SUCCESS;
+}
+
+int32_t SensorAlgorithm::GetAngleModifyBatch(const RotationMatrixBatch &curRotationMatrices,
+    const RotationMatrixBatch &preRotationMatrices, OrientationBatch &angleChanges)
+{
+    if (!IsValidBatch(curRotationMatrices) || !IsValidBatch(preRotationMatrices) ||
+        (curRotationMatrices.elements[0].size() != preRotationMatrices.elements[0].size())) {
+        SEN_HILOGE("Invalid input rotationMatrices parameter");
+        return OHOS::Sensors::PARAMETER_ERROR;
+    }
+    const auto &cur = curRotationMatrices.elements;
+    const auto &pre = preRotationMatrices.elements;
+    size_t count = cur[0].size();
+    angleChanges.z.resize(count);
+    angleChanges.x.resize(count);
+    angleChanges.y.resize(count);
+    RunKernel<2 * MATRIX_LENGTH, ANGLE_LENGTH>({ cur[0].data(), cur[1].data(), cur[2].data(), cur[3].data(),
+        cur[4].data(), cur[5].data(), cur[6].data(), cur[7].data(), cur[8].data(), pre[0].data(), pre[1].data(),
+        pre[2].data(), pre[3].data(), pre[4].data(), pre[5].data(), pre[6].data(), pre[7].data(), pre[8].data() },
+        { angleChanges.z.data(), angleChanges.x.data(), angleChanges.y.data() }, count,
+        [](const auto &in, auto &out) {
+            const FloatX4 *c = in.data();
+            const FloatX4 *p = in.data() + MATRIX_LENGTH;
+            FloatX4 radian1 = p[0] * c[1] + p[3] * c[4] + p[6] * c[7];
+            FloatX4 radian4 = p[1] * c[1] + p[4] * c[4] + p[7] * c[7];
+            FloatX4 radian6 = p[2] * c[0] + p[5] * c[3] + p[8] * c[6];
+            FloatX4 radian7 = p[2] * c[1] + p[5] * c[4] + p[8] * c[7];
+            FloatX4 radian8 = p[2] * c[2] + p[5] * c[5] + p[8] * c[8];
+            out[0] = Atan2(radian1, radian4);
+            out[1] = Asin(-radian7);
+            out[2] = Atan2(-radian6, radian8);
+        });
+    return OHOS::Sensors::SUCCESS;
+}
@@ -18,6 +18,7 @@
 
 #include "hdi_service_impl.h"
 #include "i_sensor_hdi_connection.h"
+#include "sensor_state_restorer.h"
 
 namespace OHOS {
 namespace Sensors {
@@ -36,9 +37,14 @@ public:
 
 private:
     DISALLOW_COPY_AND_MOVE(CompatibleConnection);
-    static void ReportSensorDataCallback(SensorEvent *event);
-    static ReportDataCb reportDataCb_;
+    static bool ConvertSensorEvent(const SensorEvent &event, SensorData &sensorData);
+    static void ReportSensorDataBatchCallback(SensorEvent *events, size_t eventNum);
+    static void ProcessHdiDeath();
     static sptr<ReportDataCallback> reportDataCallback_;
+    // Touched by the mock data report thread only.
+    static std::vector<SensorData> batchData_;
+    // Static since the death callback of the mock service is a plain function.
+    static SensorStateRestorer sensorStateRestorer_;
     HdiServiceImpl &hdiServiceImpl_ = HdiServiceImpl::GetInstance();
 };
 } // namespace Sensors
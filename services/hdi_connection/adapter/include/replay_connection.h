@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef REPLAY_CONNECTION_H
+#define REPLAY_CONNECTION_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "i_sensor_hdi_connection.h"
+#include "sensor_trace_file.h"
+
+namespace OHOS {
+namespace Sensors {
+const std::string SENSOR_REPLAY_CONFIG_PATH = "/data/log/sensor/sensor_replay.cfg";
+
+enum ReplayMode {
+    // Events are reported at the recorded intervals.
+    REPLAY_MODE_ORIGINAL = 0,
+    // Events are reported at the recorded intervals divided by the time scale.
+    REPLAY_MODE_SCALED = 1,
+    // Events are reported without waiting, for throughput measurement.
+    REPLAY_MODE_FAST = 2,
+};
+
+struct ReplayConfig {
+    std::string tracePath;
+    ReplayMode mode { REPLAY_MODE_ORIGINAL };
+    double timeScale { 1.0 };
+    // Offset in ns from the start of the recording where the replay begins.
+    int64_t startOffsetNs { 0 };
+};
+
+/**
+ * Reports the events of a recorded trace instead of the sensor hardware. The sensor list is made of the sensors
+ * found in the trace, the replay starts when the first sensor is enabled and reports the events of the enabled
+ * sensors only. Once the trace is exhausted, the next enable replays it again from the start offset. The recorded
+ * timing is kept, SetBatch and SetMode have no effect. The fast mode reports the events in batches.
+ */
+class ReplayConnection : public ISensorHdiConnection {
+public:
+    ReplayConnection() = default;
+    virtual ~ReplayConnection();
+    int32_t ConnectHdi() override;
+    int32_t GetSensorList(std::vector<Sensor> &sensorList) override;
+    int32_t EnableSensor(int32_t sensorId) override;
+    int32_t DisableSensor(int32_t sensorId)  override;
+    int32_t SetBatch(int32_t sensorId, int64_t samplingInterval, int64_t reportInterval) override;
+    int32_t SetMode(int32_t sensorId, int32_t mode) override;
+    int32_t RegisterDataReport(ReportDataCb cb, sptr<ReportDataCallback> reportDataCallback) override;
+    int32_t DestroyHdiConnection() override;
+
+    /**
+     * @brief Check whether a replay is configured, see SENSOR_REPLAY_CONFIG_PATH.
+     *
+     * @return true if the configuration file exists, false otherwise.
+     */
+    static bool IsReplayConfigured();
+
+private:
+    DISALLOW_COPY_AND_MOVE(ReplayConnection);
+    bool LoadConfig();
+    void ReplayThread();
+    void ReplayRecords();
+    // Waits for the monotonic report time of a record, 0 for none, returns false once the replay is stopped.
+    bool WaitUntil(int64_t deadlineNs, int32_t sensorId, bool &isEnabled);
+    // Queues an event, the queue is reported once it holds a full batch or right away outside the fast mode.
+    void AddEvent(const SensorTraceRecord &record);
+    void ReportEvents();
+    void StopReplay();
+    ReplayConfig config_;
+    SensorTraceFile traceFile_;
+    std::set<int32_t> traceSensors_;
+    sptr<ReportDataCallback> reportDataCallback_ { nullptr };
+    // Events not reported yet and the stamp of the first of them, used by the replay thread only.
+    std::vector<SensorData> pendingEvents_;
+    int64_t pendingHdiTimeNs_ { 0 };
+    std::mutex replayMutex_;
+    std::condition_variable replayCondition_;
+    std::set<int32_t> enabledSensors_;
+    bool isStop_ { false };
+    // False once the replay thread is done, it is joined before the next replay starts.
+    bool isRunning_ { false };
+    std::thread replayThread_;
+};
+} // namespace Sensors
+} // namespace OHOS
+#endif // REPLAY_CONNECTION_H
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_STATE_RESTORER_H
+#define SENSOR_STATE_RESTORER_H
+
+#include <functional>
+#include <map>
+#include <mutex>
+
+#include "nocopyable.h"
+
+#include "sensor_basic_info.h"
+
+namespace OHOS {
+namespace Sensors {
+// Sets the batch and enables one sensor on the new HDI instance, returns ERR_OK on success.
+using RestoreSensorFunc = std::function<int32_t(int32_t sensorId, const SensorBasicInfo &info)>;
+
+/**
+ * Keeps the batch parameters and state of the sensors set through a connection, so they can be restored when the
+ * HDI service restarts. The restore re-enables the sensors on a few worker threads and reads the live state of each
+ * sensor right before restoring it, the connection keeps serving enable, disable and batch calls meanwhile.
+ */
+class SensorStateRestorer {
+public:
+    SensorStateRestorer() = default;
+    ~SensorStateRestorer() = default;
+    void UpdateBatch(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs);
+    void SetState(int32_t sensorId, bool state);
+    void Delete(int32_t sensorId);
+
+    /**
+     * @brief Restore the enabled sensors on at most four threads, the caller included. A sensor whose batch changed
+     * while its restore was in flight is restored again with the new values, a sensor disabled meanwhile is passed
+     * to the cancel function afterwards.
+     *
+     * @param restoreSensor Called with the live batch of each enabled sensor.
+     * @param cancelSensor Called for each restored sensor that is no longer enabled.
+     *
+     * @return Number of sensors restored.
+     */
+    size_t Restore(const RestoreSensorFunc &restoreSensor, const std::function<void(int32_t)> &cancelSensor);
+
+private:
+    DISALLOW_COPY_AND_MOVE(SensorStateRestorer);
+    bool GetEnabledInfo(int32_t sensorId, SensorBasicInfo &info);
+    bool RestoreSensor(int32_t sensorId, const RestoreSensorFunc &restoreSensor);
+    std::mutex infoMutex_;
+    std::map<int32_t, SensorBasicInfo> sensorBasicInfoMap_;
+};
+} // namespace Sensors
+} // namespace OHOS
+#endif // SENSOR_STATE_RESTORER_H
@@ -18,6 +18,8 @@
 
 #include "securec.h"
 #include "sensor_errors.h"
+#include "sensor_latency_tracker.h"
+#include "sensor_metrics.h"
 
 #undef LOG_TAG
 #define LOG_TAG "CompatibleConnection"
@@ -26,8 +28,9 @@ namespace OHOS {
 namespace Sensors {
 using namespace OHOS::HiviewDFX;
 
-ReportDataCb CompatibleConnection::reportDataCb_ = nullptr;
 sptr<ReportDataCallback> CompatibleConnection::reportDataCallback_ = nullptr;
+std::vector<SensorData> CompatibleConnection::batchData_;
+SensorStateRestorer CompatibleConnection::sensorStateRestorer_;
 int32_t CompatibleConnection::ConnectHdi()
 {
     SEN_HILOGI("Connect hdi success");
@@ -78,6 +81,7 @@ int32_t CompatibleConnection::EnableSensor(int32_t sensorId)
         SEN_HILOGE("Enable sensor failed, sensorId:%{public}d", sensorId);
         return ret;
     }
+    sensorStateRestorer_.SetState(sensorId, true);
     return ERR_OK;
 };
 
@@ -88,6 +92,7 @@ int32_t CompatibleConnection::DisableSensor(int32_t sensorId)
         SEN_HILOGE("Disable sensor failed, sensorId:%{public}d", sensorId);
         return ret;
     }
+    sensorStateRestorer_.Delete(sensorId);
     return ERR_OK;
 }
 
@@ -98,6 +103,7 @@ int32_t CompatibleConnection::SetBatch(int32_t sensorId, int64_t samplingInterva
         SEN_HILOGE("Set batch failed, sensorId:%{public}d", sensorId);
         return ret;
     }
+    sensorStateRestorer_.UpdateBatch(sensorId, samplingInterval, reportInterval);
     return ERR_OK;
 }
 
@@ -111,48 +117,88 @@ int32_t CompatibleConnection::SetMode(int32_t sensorId, int32_t mode)
     return ERR_OK;
 }
 
-void CompatibleConnection::ReportSensorDataCallback(SensorEvent *event)
+bool CompatibleConnection::ConvertSensorEvent(const SensorEvent &event, SensorData &sensorData)
 {
-    CHKPV(event);
-    if ((event->dataLen) == 0) {
+    if (event.dataLen == 0) {
         SEN_HILOGE("Event is NULL");
-        return;
+        return false;
     }
-
-    SensorData sensorData = {
-        .sensorTypeId = event->sensorTypeId,
-        .version = event->version,
-        .timestamp = event->timestamp,
-        .option = event->option,
-        .mode = event->mode,
-        .dataLen = event->dataLen
-    };
-    CHKPV(sensorData.data);
-    errno_t ret = memcpy_s(sensorData.data, sizeof(sensorData.data), event->data, event->dataLen);
+    sensorData.sensorTypeId = event.sensorTypeId;
+    sensorData.version = event.version;
+    sensorData.timestamp = event.timestamp;
+    sensorData.option = event.option;
+    sensorData.mode = event.mode;
+    sensorData.dataLen = event.dataLen;
+    errno_t ret = memcpy_s(sensorData.data, sizeof(sensorData.data), event.data, event.dataLen);
     if (ret != EOK) {
         SEN_HILOGE("Copy data failed");
-        return;
+        return false;
     }
+    return true;
+}
+
+void CompatibleConnection::ReportSensorDataBatchCallback(SensorEvent *events, size_t eventNum)
+{
+    CHKPV(events);
     CHKPV(reportDataCallback_);
-    CHKPV(reportDataCb_);
+    batchData_.resize(eventNum);
+    size_t validNum = 0;
+    int64_t hdiTimeNs = SensorLatencyTracker::GetStampNs();
+    for (size_t i = 0; i < eventNum; ++i) {
+        if (ConvertSensorEvent(events[i], batchData_[validNum])) {
+            ++validNum;
+        }
+    }
+    if (validNum == 0) {
+        return;
+    }
     std::unique_lock<std::mutex> lk(ISensorHdiConnection::dataMutex_);
-    (void)(reportDataCallback_->*reportDataCb_)(&sensorData, reportDataCallback_);
+    (void)reportDataCallback_->ReportEventsCallback(batchData_.data(), static_cast<int32_t>(validNum),
+        reportDataCallback_, hdiTimeNs);
     ISensorHdiConnection::dataCondition_.notify_one();
 }
 
 int32_t CompatibleConnection::RegisterDataReport(ReportDataCb cb, sptr<ReportDataCallback> reportDataCallback)
 {
     CHKPR(reportDataCallback, ERR_INVALID_VALUE);
-    int32_t ret = hdiServiceImpl_.Register(ReportSensorDataCallback);
+    int32_t ret = hdiServiceImpl_.RegisterBatch(ReportSensorDataBatchCallback);
     if (ret != 0) {
         SEN_HILOGE("Register is failed");
         return ret;
     }
-    reportDataCb_ = cb;
+    ret = hdiServiceImpl_.RegisterDeathCallback(ProcessHdiDeath);
+    if (ret != 0) {
+        SEN_HILOGE("Register death callback is failed");
+        return ret;
+    }
     reportDataCallback_ = reportDataCallback;
     return ERR_OK;
 }
 
+void CompatibleConnection::ProcessHdiDeath()
+{
+    SEN_HILOGI("Hdi service died, reconnect");
+    SensorMetrics::GetInstance().AddHdiDeath();
+    HdiServiceImpl &hdiServiceImpl = HdiServiceImpl::GetInstance();
+    if (hdiServiceImpl.RegisterBatch(ReportSensorDataBatchCallback) != ERR_OK) {
+        SEN_HILOGE("Register is failed");
+        return;
+    }
+    // Same restore as HdiConnection, the data thread and the client channels stay up meanwhile.
+    size_t restoredNum = sensorStateRestorer_.Restore(
+        [&hdiServiceImpl](int32_t sensorId, const SensorBasicInfo &info) {
+            int32_t ret = hdiServiceImpl.SetBatch(sensorId, info.GetSamplingPeriodNs(), info.GetMaxReportDelayNs());
+            if (ret != ERR_OK) {
+                SEN_HILOGE("Set batch failed, sensorId:%{public}d", sensorId);
+                return ret;
+            }
+            return hdiServiceImpl.EnableSensor(sensorId);
+        },
+        [&hdiServiceImpl](int32_t sensorId) { (void)hdiServiceImpl.DisableSensor(sensorId); });
+    SensorMetrics::GetInstance().AddHdiReconnect();
+    SEN_HILOGI("Reconnect done, restored:%{public}zu", restoredNum);
+}
+
 int32_t CompatibleConnection::DestroyHdiConnection()
 {
     int32_t ret = hdiServiceImpl_.Unregister();
@@ -14,8 +14,6 @@
  */
 #include "hdi_connection.h"
 
-#include <map>
-#include <mutex>
 #include <thread>
 
 #include "hisysevent.h"
@@ -25,6 +23,8 @@
 #include "sensor_agent_type.h"
 #include "sensor_errors.h"
 #include "sensor_event_callback.h"
+#include "sensor_metrics.h"
+#include "sensor_state_restorer.h"
 
 #undef LOG_TAG
 #define LOG_TAG "HdiConnection"
@@ -38,8 +38,7 @@ using OHOS::HDI::Sensor::V2_0::HdfSensorInformation;
 namespace {
 sptr<ISensorInterface> g_sensorInterface = nullptr;
 sptr<ISensorCallback> g_eventCallback = nullptr;
-std::map<int32_t, SensorBasicInfo> g_sensorBasicInfoMap;
-std::mutex g_sensorBasicInfoMutex;
+SensorStateRestorer g_sensorStateRestorer;
 constexpr int32_t GET_HDI_SERVICE_COUNT = 5;
 constexpr uint32_t WAIT_MS = 200;
 constexpr int32_t HEADPOSTURE_FIFO_COUNT = 5;
@@ -216,31 +215,17 @@ sptr<ReportDataCallback> HdiConnection::GetReportDataCallback()
 
 void HdiConnection::UpdateSensorBasicInfo(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs)
 {
-    std::lock_guard<std::mutex> sensorInfoLock(g_sensorBasicInfoMutex);
-    SensorBasicInfo sensorBasicInfo;
-    sensorBasicInfo.SetSamplingPeriodNs(samplingPeriodNs);
-    sensorBasicInfo.SetMaxReportDelayNs(maxReportDelayNs);
-    g_sensorBasicInfoMap[sensorId] = sensorBasicInfo;
+    g_sensorStateRestorer.UpdateBatch(sensorId, samplingPeriodNs, maxReportDelayNs);
 }
 
 void HdiConnection::SetSensorBasicInfoState(int32_t sensorId, bool state)
 {
-    std::lock_guard<std::mutex> sensorInfoLock(g_sensorBasicInfoMutex);
-    auto it = g_sensorBasicInfoMap.find(sensorId);
-    if (it == g_sensorBasicInfoMap.end()) {
-        SEN_HILOGW("Should set batch first");
-        return;
-    }
-    g_sensorBasicInfoMap[sensorId].SetSensorState(state);
+    g_sensorStateRestorer.SetState(sensorId, state);
 }
 
 void HdiConnection::DeleteSensorBasicInfoState(int32_t sensorId)
 {
-    std::lock_guard<std::mutex> sensorInfoLock(g_sensorBasicInfoMutex);
-    auto it = g_sensorBasicInfoMap.find(sensorId);
-    if (it != g_sensorBasicInfoMap.end()) {
-        g_sensorBasicInfoMap.erase(sensorId);
-    }
+    g_sensorStateRestorer.Delete(sensorId);
 }
 
 void HdiConnection::RegisterHdiDeathRecipient()
@@ -270,6 +255,7 @@ void HdiConnection::ProcessDeathObserver(const wptr<IRemoteObject> &object)
     CHKPV(hdiDeathObserver_);
     hdiService->RemoveDeathRecipient(hdiDeathObserver_);
     g_eventCallback = nullptr;
+    SensorMetrics::GetInstance().AddHdiDeath();
     Reconnect();
 }
 
@@ -286,30 +272,26 @@ void HdiConnection::Reconnect()
         SEN_HILOGE("Register callback fail");
         return;
     }
-    std::vector<Sensor> sensorList;
-    ret = GetSensorList(sensorList);
-    if (ret != 0) {
-        SEN_HILOGE("Get sensor list fail");
-        return;
-    }
-    std::lock_guard<std::mutex> sensorInfoLock(g_sensorBasicInfoMutex);
-    for (const auto &sensorInfo: g_sensorBasicInfoMap) {
-        int32_t sensorTypeId = sensorInfo.first;
-        SensorBasicInfo info = sensorInfo.second;
-        if (info.GetSensorState() != true) {
-            SEN_HILOGE("sensorTypeId:%{public}d don't need enable sensor", sensorTypeId);
-            continue;
-        }
-        ret = g_sensorInterface->SetBatch(sensorTypeId, info.GetSamplingPeriodNs(), info.GetMaxReportDelayNs());
-        if (ret != 0) {
-            SEN_HILOGE("sensorTypeId:%{public}d set batch fail, error:%{public}d", sensorTypeId, ret);
-            continue;
-        }
-        ret = g_sensorInterface->Enable(sensorTypeId);
-        if (ret != 0) {
-            SEN_HILOGE("Enable sensor fail, sensorTypeId:%{public}d, error:%{public}d", sensorTypeId, ret);
-        }
-    }
+    // The sensor list of the service stays valid, only the enabled sensors are restored. The data thread, the ring
+    // and the client channels are not touched, events flow again as soon as the first sensor is enabled.
+    sptr<ISensorInterface> sensorInterface = g_sensorInterface;
+    size_t restoredNum = g_sensorStateRestorer.Restore(
+        [sensorInterface](int32_t sensorId, const SensorBasicInfo &info) {
+            int32_t errCode = sensorInterface->SetBatch(sensorId, info.GetSamplingPeriodNs(),
+                info.GetMaxReportDelayNs());
+            if (errCode != 0) {
+                SEN_HILOGE("sensorTypeId:%{public}d set batch fail, error:%{public}d", sensorId, errCode);
+                return errCode;
+            }
+            errCode = sensorInterface->Enable(sensorId);
+            if (errCode != 0) {
+                SEN_HILOGE("Enable sensor fail, sensorTypeId:%{public}d, error:%{public}d", sensorId, errCode);
+            }
+            return errCode;
+        },
+        [sensorInterface](int32_t sensorId) { (void)sensorInterface->Disable(sensorId); });
+    SensorMetrics::GetInstance().AddHdiReconnect();
+    SEN_HILOGI("Reconnect done, restored:%{public}zu", restoredNum);
 }
 } // namespace Sensors
 } // namespace OHOS
@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "replay_connection.h"
+
+#include <sys/prctl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdlib>
+#include <fstream>
+#include <unordered_map>
+
+#include "sensor_errors.h"
+#include "sensor_latency_tracker.h"
+
+#undef LOG_TAG
+#define LOG_TAG "ReplayConnection"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+namespace {
+const std::string REPLAY_THREAD_NAME = "OS_SenReplay";
+const std::string REPLAY_SENSOR_VENDOR = "replay";
+const std::string REPLAY_VERSION_NAME = "1.0.0";
+constexpr float REPLAY_MAX_RANGE = 9999.0;
+constexpr int64_t REPLAY_MIN_SAMPLE_PERIOD_NS = 1000000;
+constexpr int64_t REPLAY_MAX_SAMPLE_PERIOD_NS = 1000000000;
+constexpr int64_t MS_NS = 1000000;
+// Events reported per data mutex hold in the fast mode, well below CIRCULAR_BUF_LEN so the data thread keeps up.
+constexpr size_t REPLAY_FAST_BATCH_NUM = 64;
+const std::unordered_map<std::string, ReplayMode> REPLAY_MODES = {
+    { "original", REPLAY_MODE_ORIGINAL },
+    { "scaled", REPLAY_MODE_SCALED },
+    { "fast", REPLAY_MODE_FAST },
+};
+} // namespace
+
+ReplayConnection::~ReplayConnection()
+{
+    StopReplay();
+}
+
+bool ReplayConnection::IsReplayConfigured()
+{
+    return access(SENSOR_REPLAY_CONFIG_PATH.c_str(), F_OK) == 0;
+}
+
+bool ReplayConnection::LoadConfig()
+{
+    // One key=value per line: trace=<path>, mode=original|scaled|fast, scale=<factor>, start_ms=<offset>.
+    std::ifstream configFile(SENSOR_REPLAY_CONFIG_PATH);
+    if (!configFile.is_open()) {
+        SEN_HILOGE("Open replay config failed");
+        return false;
+    }
+    std::string line;
+    while (std::getline(configFile, line)) {
+        size_t pos = line.find('=');
+        if (pos == std::string::npos) {
+            continue;
+        }
+        std::string key = line.substr(0, pos);
+        std::string value = line.substr(pos + 1);
+        if (key == "trace") {
+            config_.tracePath = value;
+        } else if (key == "mode") {
+            auto it = REPLAY_MODES.find(value);
+            if (it == REPLAY_MODES.end()) {
+                SEN_HILOGE("Invalid replay mode:%{public}s", value.c_str());
+                return false;
+            }
+            config_.mode = it->second;
+        } else if (key == "scale") {
+            config_.timeScale = strtod(value.c_str(), nullptr);
+        } else if (key == "start_ms") {
+            config_.startOffsetNs = strtoll(value.c_str(), nullptr, 10) * MS_NS;
+        }
+    }
+    if (config_.tracePath.empty() || (config_.timeScale <= 0.0) || (config_.startOffsetNs < 0)) {
+        SEN_HILOGE("Invalid replay config, scale:%{public}f", config_.timeScale);
+        return false;
+    }
+    if (config_.mode != REPLAY_MODE_SCALED) {
+        config_.timeScale = 1.0;
+    }
+    return true;
+}
+
+int32_t ReplayConnection::ConnectHdi()
+{
+    if (!LoadConfig()) {
+        return ERR_INVALID_VALUE;
+    }
+    int32_t ret = traceFile_.Open(config_.tracePath);
+    if (ret != ERR_OK) {
+        SEN_HILOGE("Open trace failed, ret:%{public}d", ret);
+        return ret;
+    }
+    for (size_t i = 0; i < traceFile_.GetRecordCount(); ++i) {
+        traceSensors_.insert(traceFile_.GetRecord(i).sensorTypeId);
+    }
+    SEN_HILOGI("Connect replay success, mode:%{public}d, scale:%{public}f, sensorCount:%{public}zu",
+        config_.mode, config_.timeScale, traceSensors_.size());
+    return ERR_OK;
+}
+
+int32_t ReplayConnection::GetSensorList(std::vector<Sensor> &sensorList)
+{
+    for (const auto &sensorId : traceSensors_) {
+        Sensor sensor;
+        sensor.SetSensorId(sensorId);
+        sensor.SetSensorTypeId(sensorId);
+        sensor.SetFirmwareVersion(REPLAY_VERSION_NAME);
+        sensor.SetHardwareVersion(REPLAY_VERSION_NAME);
+        sensor.SetMaxRange(REPLAY_MAX_RANGE);
+        sensor.SetSensorName("replay_" + std::to_string(sensorId));
+        sensor.SetVendorName(REPLAY_SENSOR_VENDOR);
+        sensor.SetMinSamplePeriodNs(REPLAY_MIN_SAMPLE_PERIOD_NS);
+        sensor.SetMaxSamplePeriodNs(REPLAY_MAX_SAMPLE_PERIOD_NS);
+        sensorList.push_back(sensor);
+    }
+    return ERR_OK;
+}
+
+int32_t ReplayConnection::EnableSensor(int32_t sensorId)
+{
+    if (traceSensors_.find(sensorId) == traceSensors_.end()) {
+        SEN_HILOGE("Sensor is not in the trace, sensorId:%{public}d", sensorId);
+        return ENABLE_SENSOR_ERR;
+    }
+    std::lock_guard<std::mutex> replayLock(replayMutex_);
+    enabledSensors_.insert(sensorId);
+    if (!isRunning_) {
+        // A replay that reached the end of the trace has exited, start over from the start offset.
+        if (replayThread_.joinable()) {
+            replayThread_.join();
+        }
+        isStop_ = false;
+        isRunning_ = true;
+        replayThread_ = std::thread([this] { ReplayThread(); });
+    }
+    return ERR_OK;
+}
+
+int32_t ReplayConnection::DisableSensor(int32_t sensorId)
+{
+    std::lock_guard<std::mutex> replayLock(replayMutex_);
+    enabledSensors_.erase(sensorId);
+    return ERR_OK;
+}
+
+int32_t ReplayConnection::SetBatch(int32_t sensorId, int64_t samplingInterval, int64_t reportInterval)
+{
+    SEN_HILOGD("Replay keeps the recorded rate, sensorId:%{public}d", sensorId);
+    return ERR_OK;
+}
+
+int32_t ReplayConnection::SetMode(int32_t sensorId, int32_t mode)
+{
+    return ERR_OK;
+}
+
+int32_t ReplayConnection::RegisterDataReport(ReportDataCb cb, sptr<ReportDataCallback> reportDataCallback)
+{
+    CHKPR(reportDataCallback, ERR_INVALID_VALUE);
+    reportDataCallback_ = reportDataCallback;
+    return ERR_OK;
+}
+
+int32_t ReplayConnection::DestroyHdiConnection()
+{
+    StopReplay();
+    traceFile_.Close();
+    return ERR_OK;
+}
+
+void ReplayConnection::StopReplay()
+{
+    {
+        std::lock_guard<std::mutex> replayLock(replayMutex_);
+        isStop_ = true;
+    }
+    replayCondition_.notify_all();
+    if (replayThread_.joinable()) {
+        replayThread_.join();
+    }
+}
+
+void ReplayConnection::ReplayThread()
+{
+    prctl(PR_SET_NAME, REPLAY_THREAD_NAME.c_str());
+    ReplayRecords();
+    std::lock_guard<std::mutex> replayLock(replayMutex_);
+    isRunning_ = false;
+}
+
+void ReplayConnection::ReplayRecords()
+{
+    size_t recordCount = traceFile_.GetRecordCount();
+    size_t first = traceFile_.LowerBound(config_.startOffsetNs);
+    if (first >= recordCount) {
+        SEN_HILOGW("Nothing to replay after the start offset");
+        return;
+    }
+    int64_t firstRecordTimeNs = traceFile_.GetRecord(first).recordTimeNs;
+    int64_t baseTimeNs = SensorLatencyTracker::GetMonotonicTimeNs();
+    SEN_HILOGI("Replay start, records:%{public}zu", recordCount - first);
+    pendingEvents_.clear();
+    pendingEvents_.reserve(REPLAY_FAST_BATCH_NUM);
+    size_t index = first;
+    for (; index < recordCount; ++index) {
+        const SensorTraceRecord &record = traceFile_.GetRecord(index);
+        int64_t deadlineNs = 0;
+        if (config_.mode != REPLAY_MODE_FAST) {
+            deadlineNs = baseTimeNs +
+                static_cast<int64_t>(static_cast<double>(record.recordTimeNs - firstRecordTimeNs) / config_.timeScale);
+        }
+        bool isEnabled = false;
+        if (!WaitUntil(deadlineNs, record.sensorTypeId, isEnabled)) {
+            break;
+        }
+        if (isEnabled) {
+            AddEvent(record);
+        }
+    }
+    ReportEvents();
+    SEN_HILOGI("Replay end, replayed:%{public}zu, elapsedNs:%{public}" PRId64, index - first,
+        SensorLatencyTracker::GetMonotonicTimeNs() - baseTimeNs);
+}
+
+bool ReplayConnection::WaitUntil(int64_t deadlineNs, int32_t sensorId, bool &isEnabled)
+{
+    std::unique_lock<std::mutex> replayLock(replayMutex_);
+    if (deadlineNs > 0) {
+        int64_t waitNs = deadlineNs - SensorLatencyTracker::GetMonotonicTimeNs();
+        if (waitNs > 0) {
+            replayCondition_.wait_for(replayLock, std::chrono::nanoseconds(waitNs), [this] { return isStop_; });
+        }
+    }
+    isEnabled = (enabledSensors_.find(sensorId) != enabledSensors_.end());
+    return !isStop_;
+}
+
+void ReplayConnection::AddEvent(const SensorTraceRecord &record)
+{
+    CHKPV(reportDataCallback_);
+    if (pendingEvents_.empty()) {
+        pendingHdiTimeNs_ = SensorLatencyTracker::GetStampNs();
+    }
+    pendingEvents_.emplace_back();
+    FromTraceRecord(record, pendingEvents_.back());
+    if ((config_.mode != REPLAY_MODE_FAST) || (pendingEvents_.size() >= REPLAY_FAST_BATCH_NUM)) {
+        ReportEvents();
+    }
+}
+
+void ReplayConnection::ReportEvents()
+{
+    if (pendingEvents_.empty()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lk(ISensorHdiConnection::dataMutex_);
+    (void)reportDataCallback_->ReportEventsCallback(pendingEvents_.data(), static_cast<int32_t>(pendingEvents_.size()),
+        reportDataCallback_, pendingHdiTimeNs_);
+    ISensorHdiConnection::dataCondition_.notify_one();
+    pendingEvents_.clear();
+}
+} // namespace Sensors
+} // namespace OHOS
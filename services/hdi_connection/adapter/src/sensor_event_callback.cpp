@@ -14,9 +14,12 @@
  */
 #include "sensor_event_callback.h"
 
+#include "securec.h"
+
 #include "hdi_connection.h"
 #include "sensor_agent_type.h"
 #include "sensor_errors.h"
+#include "sensor_latency_tracker.h"
 
 #undef LOG_TAG
 #define LOG_TAG "HdiConnection"
@@ -54,6 +57,7 @@ int32_t SensorEventCallback::OnDataEvent(const HdfSensorEvents &event)
         .mode = event.mode,
         .dataLen = event.dataLen
     };
+    int64_t hdiTimeNs = SensorLatencyTracker::GetStampNs();
     if (sensorData.sensorTypeId == SENSOR_TYPE_ID_PROXIMITY) {
         sensorData.mode = SENSOR_ON_CHANGE;
     }
@@ -72,13 +76,15 @@ int32_t SensorEventCallback::OnDataEvent(const HdfSensorEvents &event)
         outputFloatPtr[3] = *(inputFloatPtr + 5);
         outputFloatPtr[4] = *(inputFloatPtr + 6);
     } else {
-        for (int32_t i = 0; i < dataSize; i++) {
-            sensorData.data[i] = event.data[i];
+        errno_t ret = memcpy_s(sensorData.data, sizeof(sensorData.data), event.data.data(), dataSize);
+        if (ret != EOK) {
+            SEN_HILOGE("Copy data failed, sensorId:%{public}d, dataSize:%{public}d", event.sensorId, dataSize);
+            return ERR_INVALID_VALUE;
         }
     }
     ControlSensorPrint(sensorData);
     std::unique_lock<std::mutex> lk(ISensorHdiConnection::dataMutex_);
-    (void)(reportDataCallback_->*(reportDataCb_))(&sensorData, reportDataCallback_);
+    (void)(reportDataCallback_->*(reportDataCb_))(&sensorData, reportDataCallback_, hdiTimeNs);
     ISensorHdiConnection::dataCondition_.notify_one();
     return ERR_OK;
 }
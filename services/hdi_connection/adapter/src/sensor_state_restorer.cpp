@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_state_restorer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "sensor_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorStateRestorer"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+namespace {
+// The calling thread is one of the workers.
+constexpr size_t MAX_RESTORE_THREAD_NUM = 4;
+constexpr int32_t MAX_RESTORE_ATTEMPTS = 3;
+} // namespace
+
+void SensorStateRestorer::UpdateBatch(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs)
+{
+    std::lock_guard<std::mutex> infoLock(infoMutex_);
+    // A new batch of an enabled sensor keeps it enabled, a restore in flight then applies the new values.
+    SensorBasicInfo &sensorBasicInfo = sensorBasicInfoMap_[sensorId];
+    sensorBasicInfo.SetSamplingPeriodNs(samplingPeriodNs);
+    sensorBasicInfo.SetMaxReportDelayNs(maxReportDelayNs);
+}
+
+void SensorStateRestorer::SetState(int32_t sensorId, bool state)
+{
+    std::lock_guard<std::mutex> infoLock(infoMutex_);
+    auto it = sensorBasicInfoMap_.find(sensorId);
+    if (it == sensorBasicInfoMap_.end()) {
+        SEN_HILOGW("Should set batch first");
+        return;
+    }
+    it->second.SetSensorState(state);
+}
+
+void SensorStateRestorer::Delete(int32_t sensorId)
+{
+    std::lock_guard<std::mutex> infoLock(infoMutex_);
+    sensorBasicInfoMap_.erase(sensorId);
+}
+
+bool SensorStateRestorer::GetEnabledInfo(int32_t sensorId, SensorBasicInfo &info)
+{
+    std::lock_guard<std::mutex> infoLock(infoMutex_);
+    auto it = sensorBasicInfoMap_.find(sensorId);
+    if ((it == sensorBasicInfoMap_.end()) || !it->second.GetSensorState()) {
+        return false;
+    }
+    info = it->second;
+    return true;
+}
+
+bool SensorStateRestorer::RestoreSensor(int32_t sensorId, const RestoreSensorFunc &restoreSensor)
+{
+    SensorBasicInfo info;
+    if (!GetEnabledInfo(sensorId, info)) {
+        SEN_HILOGD("sensorId:%{public}d was disabled before restore", sensorId);
+        return false;
+    }
+    for (int32_t attempt = 0; attempt < MAX_RESTORE_ATTEMPTS; ++attempt) {
+        if (restoreSensor(sensorId, info) != ERR_OK) {
+            return false;
+        }
+        // A SetBatch that raced with the restore may have reached the HDI first, apply the newest values again.
+        SensorBasicInfo liveInfo;
+        if (!GetEnabledInfo(sensorId, liveInfo) ||
+            ((liveInfo.GetSamplingPeriodNs() == info.GetSamplingPeriodNs()) &&
+            (liveInfo.GetMaxReportDelayNs() == info.GetMaxReportDelayNs()))) {
+            return true;
+        }
+        info = liveInfo;
+    }
+    SEN_HILOGW("sensorId:%{public}d batch kept changing during restore", sensorId);
+    return true;
+}
+
+size_t SensorStateRestorer::Restore(const RestoreSensorFunc &restoreSensor,
+    const std::function<void(int32_t)> &cancelSensor)
+{
+    std::vector<int32_t> enabledSensors;
+    {
+        std::lock_guard<std::mutex> infoLock(infoMutex_);
+        for (const auto &it : sensorBasicInfoMap_) {
+            if (it.second.GetSensorState()) {
+                enabledSensors.push_back(it.first);
+            }
+        }
+    }
+    // Each sensor costs HDI round trips and possibly a hardware power up, a few workers share the sensors.
+    std::atomic<size_t> nextIndex { 0 };
+    std::vector<int32_t> restoredSensors;
+    std::mutex restoredMutex;
+    auto restoreWorker = [this, &restoreSensor, &enabledSensors, &nextIndex, &restoredSensors, &restoredMutex] {
+        for (size_t i = nextIndex++; i < enabledSensors.size(); i = nextIndex++) {
+            if (!RestoreSensor(enabledSensors[i], restoreSensor)) {
+                continue;
+            }
+            std::lock_guard<std::mutex> restoredLock(restoredMutex);
+            restoredSensors.push_back(enabledSensors[i]);
+        }
+    };
+    size_t workerNum = std::min(enabledSensors.size(), MAX_RESTORE_THREAD_NUM);
+    std::vector<std::thread> restoreThreads;
+    for (size_t i = 1; i < workerNum; ++i) {
+        restoreThreads.emplace_back(restoreWorker);
+    }
+    restoreWorker();
+    for (auto &restoreThread : restoreThreads) {
+        restoreThread.join();
+    }
+    for (int32_t sensorId : restoredSensors) {
+        SensorBasicInfo info;
+        if (!GetEnabledInfo(sensorId, info)) {
+            SEN_HILOGI("sensorId:%{public}d was disabled during restore", sensorId);
+            cancelSensor(sensorId);
+        }
+    }
+    return restoredSensors.size();
+}
+} // namespace Sensors
+} // namespace OHOS
@@ -1,56 +1,151 @@
-/*
- * Copyright (c) 2021 Huawei Device Co., Ltd.
- * Licensed under the Apache License, Version 2.0 (the "License");
- * you may not use this file except in compliance with the License.
- * You may obtain a copy of the License at
- *
- *     http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
- */
-
-#ifndef HDI_SERVICE_IMPL_H
-#define HDI_SERVICE_IMPL_H
-
-#include <atomic>
-#include <thread>
-#include <vector>
-#include "sensor_agent_type.h"
-#include "singleton.h"
-
-namespace OHOS {
-namespace Sensors {
-class HdiServiceImpl : public Singleton<HdiServiceImpl> {
-public:
-    HdiServiceImpl() = default;
-    virtual ~HdiServiceImpl() {}
-    int32_t GetSensorList(std::vector<SensorInfo> &sensorList);
-    int32_t EnableSensor(int32_t sensorId);
-    int32_t DisableSensor(int32_t sensorId);
-    int32_t SetBatch(int32_t sensorId, int64_t samplingInterval, int64_t reportInterval);
-    int32_t SetMode(int32_t sensorId, int32_t mode);
-    int32_t Register(RecordSensorCallback cb);
-    int32_t Unregister();
-
-private:
-    DISALLOW_COPY_AND_MOVE(HdiServiceImpl);
-    static void DataReportThread();
-    static void GenerateEvent();
-    static void GenerateAccelerometerEvent();
-    static void GenerateColorEvent();
-    static void GenerateSarEvent();
-    static void GenerateHeadPostureEvent();
-    static std::vector<int32_t> enableSensors_;
-    std::thread dataReportThread_;
-    static std::vector<RecordSensorCallback> callbacks_;
-    static int64_t samplingInterval_;
-    static int64_t reportInterval_;
-    static std::atomic_bool isStop_;
-};
-} // namespace Sensors
-} // namespace OHOS
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HDI_SERVICE_IMPL_H
+#define HDI_SERVICE_IMPL_H
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "sensor_agent_type.h"
+#include "singleton.h"
+
+namespace OHOS {
+namespace Sensors {
+constexpr size_t MAX_MOCK_DATA_DIMENSION = 5;
+// Receives the events flushed together, in timestamp order per sensor.
+using RecordSensorBatchCallback = void (*)(SensorEvent *events, size_t eventNum);
+// Notified after the mock service died, like a death recipient of the HDI service.
+using HdiDeathCallback = void (*)();
+
+struct LoadSensorConfig {
+    int32_t sensorId;
+    // Sampling period used instead of the one set through SetBatch.
+    int64_t samplingPeriodNs;
+    // Events held back and reported back to back like a hardware FIFO flush, 1 reports every event on time.
+    uint32_t fifoDepth;
+};
+
+struct LoadGeneratorConfig {
+    // Seeds the data of every sensor, the same seed gives the same event sequence per sensor.
+    uint32_t seed;
+    std::vector<LoadSensorConfig> sensors;
+};
+
+class HdiServiceImpl : public Singleton<HdiServiceImpl> {
+public:
+    HdiServiceImpl() = default;
+    virtual ~HdiServiceImpl();
+    int32_t GetSensorList(std::vector<SensorInfo> &sensorList);
+    int32_t EnableSensor(int32_t sensorId);
+    int32_t DisableSensor(int32_t sensorId);
+    int32_t SetBatch(int32_t sensorId, int64_t samplingInterval, int64_t reportInterval);
+    int32_t SetMode(int32_t sensorId, int32_t mode);
+    int32_t Register(RecordSensorCallback cb);
+
+    /**
+     * @brief Register a callback receiving all the events of a report cycle in one call, like a hardware FIFO flush
+     * delivered as a burst. Events are delivered to the batch callbacks after the per-event ones.
+     *
+     * @param cb Batch callback.
+     *
+     * @return Returns 0 if the operation is successful; returns a negative value otherwise.
+     */
+    int32_t RegisterBatch(RecordSensorBatchCallback cb);
+    int32_t RegisterDeathCallback(HdiDeathCallback cb);
+    int32_t Unregister();
+
+    /**
+     * @brief Emulate a crash and restart of the HDI service: the data thread stops, the sensors, their batch
+     * parameters, the events held in the FIFOs and the data callbacks are lost. The death callbacks are notified
+     * afterwards from the calling thread, the death callbacks themselves are kept.
+     */
+    void SimulateDeath();
+
+    /**
+     * @brief Switch the mock to load generator mode, for benchmarks through CompatibleConnection. The sensors
+     * listed run at their own period on absolute deadlines and report their events in FIFO bursts, the data comes
+     * from PRNGs seeded with the configured seed. Takes effect on enabled sensors immediately.
+     *
+     * @param config Sensors to drive and the seed.
+     *
+     * @return Returns 0 if the operation is successful; returns a negative value otherwise.
+     */
+    int32_t SetLoadGenerator(const LoadGeneratorConfig &config);
+    void ClearLoadGenerator();
+
+private:
+    DISALLOW_COPY_AND_MOVE(HdiServiceImpl);
+    struct MockEvent {
+        SensorEvent event;
+        std::array<float, MAX_MOCK_DATA_DIMENSION> data;
+    };
+    struct SensorBatch {
+        int64_t samplingIntervalNs { 0 };
+        int64_t reportIntervalNs { 0 };
+    };
+    struct SensorSchedule {
+        int64_t samplingPeriodNs { 0 };
+        uint32_t fifoDepth { 1 };
+        int64_t nextDeadlineNs { 0 };
+        std::mt19937 engine;
+        std::vector<MockEvent> fifo;
+    };
+    // Next deadline and sensorId, ordered so the earliest deadline is on top.
+    using ScheduleDeadline = std::pair<int64_t, int32_t>;
+    static void DataReportThread();
+    static void ConfigureSchedule(int32_t sensorId, SensorSchedule &schedule);
+    static void ApplyBatch(int32_t sensorId, SensorSchedule &schedule);
+    static bool IsLoadSensor(int32_t sensorId);
+    static void RebuildDeadlines();
+    static int64_t GetNextDeadline();
+    static void ProduceEvents(int64_t nowNs);
+    static void ProduceEvent(int32_t sensorId, SensorSchedule &schedule);
+    static void ReportEvents();
+    static uint32_t GenerateData(int32_t sensorId, std::mt19937 &engine, float *data);
+    static void GenerateAccelerometerData(std::mt19937 &engine, float *data);
+    static void GenerateColorData(std::mt19937 &engine, float *data);
+    static void GenerateSarData(std::mt19937 &engine, float *data);
+    static void GenerateHeadPostureData(std::mt19937 &engine, float *data);
+    std::thread dataReportThread_;
+    // Guards the start and the stop of the data report thread.
+    static std::mutex threadMutex_;
+    static std::vector<RecordSensorCallback> callbacks_;
+    static std::vector<RecordSensorBatchCallback> batchCallbacks_;
+    static std::vector<HdiDeathCallback> deathCallbacks_;
+    static std::atomic_bool isStop_;
+    // Guards the batches, the schedules, the deadlines and the load generator configuration.
+    static std::mutex scheduleMutex_;
+    // Set through SetBatch per sensor, kept while the sensor is disabled.
+    static std::map<int32_t, SensorBatch> batches_;
+    static std::map<int32_t, SensorSchedule> schedules_;
+    // One entry per enabled sensor, rebuilt whenever a schedule is added, removed or rescheduled.
+    static std::priority_queue<ScheduleDeadline, std::vector<ScheduleDeadline>, std::greater<ScheduleDeadline>>
+        deadlines_;
+    static bool isLoadGenerator_;
+    static LoadGeneratorConfig loadConfig_;
+    // Touched by the data report thread only.
+    static std::vector<MockEvent> reportEvents_;
+    static std::vector<SensorEvent> reportBatch_;
+};
+} // namespace Sensors
+} // namespace OHOS
 #endif // HDI_SERVICE_IMPL_H
\ No newline at end of file
@@ -12,283 +12,477 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
-#include "hdi_service_impl.h"
-
-#include <cmath>
-#include <random>
-#include <sys/prctl.h>
-#include <thread>
-#include <unistd.h>
-
-#include "sensor_errors.h"
-
-#undef LOG_TAG
-#define LOG_TAG "HdiServiceImpl"
-
-namespace OHOS {
-namespace Sensors {
-using namespace OHOS::HiviewDFX;
-
-namespace {
-constexpr int64_t SAMPLING_INTERVAL_NS = 200000000;
-constexpr float TARGET_SUM = 9.8F * 9.8F;
-constexpr float MAX_RANGE = 9999.0F;
-const std::string SENSOR_PRODUCE_THREAD_NAME = "OS_SenMock";
-std::vector<SensorInfo> g_sensorInfos = {
-    {"sensor_test", "default", "1.0.0", "1.0.0", 1, 1, 9999.0, 0.000001, 23.0, 100000000, 1000000000},
-};
-std::vector<int32_t> g_supportSensors = {
-    SENSOR_TYPE_ID_ACCELEROMETER,
-    SENSOR_TYPE_ID_COLOR,
-    SENSOR_TYPE_ID_SAR,
-    SENSOR_TYPE_ID_HEADPOSTURE
-};
-float g_accData[3];
-float g_colorData[2];
-float g_sarData[1];
-float g_headPostureData[5];
-SensorEvent g_accEvent = {
-    .sensorTypeId = SENSOR_TYPE_ID_ACCELEROMETER,
-    .option = 3,
-    .dataLen = 12
-};
-SensorEvent g_colorEvent = {
-    .sensorTypeId = SENSOR_TYPE_ID_COLOR,
-    .option = 3,
-    .dataLen = 8
-};
-SensorEvent g_sarEvent = {
-    .sensorTypeId = SENSOR_TYPE_ID_SAR,
-    .option = 3,
-    .dataLen = 4
-};
-SensorEvent g_headPostureEvent = {
-    .sensorTypeId = SENSOR_TYPE_ID_HEADPOSTURE,
-    .option = 3,
-    .dataLen = 20
-};
-} // namespace
-std::vector<int32_t> HdiServiceImpl::enableSensors_;
-std::vector<RecordSensorCallback> HdiServiceImpl::callbacks_;
-int64_t HdiServiceImpl::samplingInterval_ = -1;
-int64_t HdiServiceImpl::reportInterval_ = -1;
-std::atomic_bool HdiServiceImpl::isStop_ = false;
-
-void HdiServiceImpl::GenerateEvent()
-{
-    for (const auto &sensorId : enableSensors_) {
-        switch (sensorId) {
-            case SENSOR_TYPE_ID_ACCELEROMETER:
-                GenerateAccelerometerEvent();
-                break;
-            case SENSOR_TYPE_ID_COLOR:
-                GenerateColorEvent();
-                break;
-            case SENSOR_TYPE_ID_SAR:
-                GenerateSarEvent();
-                break;
-            case SENSOR_TYPE_ID_HEADPOSTURE:
-                GenerateHeadPostureEvent();
-                break;
-            default:
-                SEN_HILOGW("Unknown sensorId:%{public}d", sensorId);
-                break;
-        }
-    }
-}
-
-void HdiServiceImpl::GenerateAccelerometerEvent()
-{
-    std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_real_distribution<float> distr(0.0, TARGET_SUM);
-    float num1 = 0.0;
-    float num2 = 0.0;
-    while (true) {
-        num1 = distr(eng);
-        num2 = distr(eng);
-        if ((num1 > num2) && (std::fabs(num1 - num2) > std::numeric_limits<float>::epsilon())) {
-            float temp = num1;
-            num1 = num2;
-            num2 = temp;
-            break;
-        }
-    }
-    g_accData[0] = static_cast<float>(sqrt(num1));
-    g_accData[1] = static_cast<float>(sqrt(num2 - num1));
-    g_accData[2] = static_cast<float>(sqrt(TARGET_SUM - num2));
-    g_accEvent.data = reinterpret_cast<uint8_t *>(g_accData);
-}
-
-void HdiServiceImpl::GenerateColorEvent()
-{
-    std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_real_distribution<float> distr(0.0, MAX_RANGE);
-    g_colorData[0] = distr(eng);
-    g_colorData[1] = distr(eng);
-    g_colorEvent.data = reinterpret_cast<uint8_t *>(g_colorData);
-}
-
-void HdiServiceImpl::GenerateSarEvent()
-{
-    std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_real_distribution<float> distr(0.0, MAX_RANGE);
-    g_sarData[0] = distr(eng);
-    g_sarEvent.data = reinterpret_cast<uint8_t *>(g_sarData);
-}
-
-void HdiServiceImpl::GenerateHeadPostureEvent()
-{
-    std::random_device rd;
-    std::default_random_engine eng(rd());
-    std::uniform_real_distribution<float> distr(0.0, 1.0);
-    std::vector<float> nums(4);
-    while (true) {
-        nums[0] = distr(eng);
-        nums[1] = distr(eng);
-        nums[2] = distr(eng);
-        nums[3] = distr(eng);
-        sort(nums.begin(), nums.end());
-        if ((std::fabs(nums[1] - nums[0]) > std::numeric_limits<float>::epsilon()) &&
-            (std::fabs(nums[2] - nums[1]) > std::numeric_limits<float>::epsilon()) &&
-            (std::fabs(nums[3] - nums[2]) > std::numeric_limits<float>::epsilon())) {
-            break;
-        }
-    }
-    g_headPostureData[0] = static_cast<float>(sqrt(nums[0]));
-    g_headPostureData[1] = static_cast<float>(sqrt(nums[1] - nums[0]));
-    g_headPostureData[2] = static_cast<float>(sqrt(nums[2] - nums[1]));
-    g_headPostureData[3] = static_cast<float>(sqrt(nums[3] - nums[2]));
-    g_headPostureData[4] = static_cast<float>(sqrt(1.0 - nums[3]));
-    g_headPostureEvent.data = reinterpret_cast<uint8_t *>(g_headPostureData);
-}
-
-int32_t HdiServiceImpl::GetSensorList(std::vector<SensorInfo> &sensorList)
-{
-    CALL_LOG_ENTER;
-    sensorList.assign(g_sensorInfos.begin(), g_sensorInfos.end());
-    return ERR_OK;
-}
-
-void HdiServiceImpl::DataReportThread()
-{
-    CALL_LOG_ENTER;
-    prctl(PR_SET_NAME, SENSOR_PRODUCE_THREAD_NAME.c_str());
-    while (true) {
-        GenerateEvent();
-        std::this_thread::sleep_for(std::chrono::nanoseconds(samplingInterval_));
-        for (const auto &it : callbacks_) {
-            if (it == nullptr) {
-                SEN_HILOGW("RecordSensorCallback is null");
-                continue;
-            }
-            for (const auto &sensorId : enableSensors_) {
-                switch (sensorId) {
-                    case SENSOR_TYPE_ID_ACCELEROMETER:
-                        it(&g_accEvent);
-                        break;
-                    case SENSOR_TYPE_ID_COLOR:
-                        it(&g_colorEvent);
-                        break;
-                    case SENSOR_TYPE_ID_SAR:
-                        it(&g_sarEvent);
-                        break;
-                    case SENSOR_TYPE_ID_HEADPOSTURE:
-                        it(&g_headPostureEvent);
-                        break;
-                    default:
-                        SEN_HILOGW("Unknown sensorId:%{public}d", sensorId);
-                        break;
-                }
-            }
-        }
-        if (isStop_) {
-            break;
-        }
-    }
-    SEN_HILOGI("Thread stop");
-    return;
-}
-
-int32_t HdiServiceImpl::EnableSensor(int32_t sensorId)
-{
-    CALL_LOG_ENTER;
-    if (std::find(g_supportSensors.begin(), g_supportSensors.end(), sensorId) == g_supportSensors.end()) {
-        SEN_HILOGE("Not support enable sensorId:%{public}d", sensorId);
-        return ERR_NO_INIT;
-    }
-    if (std::find(enableSensors_.begin(), enableSensors_.end(), sensorId) != enableSensors_.end()) {
-        SEN_HILOGI("sensorId:%{public}d has been enabled", sensorId);
-        return ERR_OK;
-    }
-    enableSensors_.push_back(sensorId);
-    if (!dataReportThread_.joinable() || isStop_) {
-        if (dataReportThread_.joinable()) {
-            dataReportThread_.join();
-        }
-        std::thread senocdDataThread(HdiServiceImpl::DataReportThread);
-        dataReportThread_ = std::move(senocdDataThread);
-        isStop_ = false;
-    }
-    return ERR_OK;
-};
-
-int32_t HdiServiceImpl::DisableSensor(int32_t sensorId)
-{
-    CALL_LOG_ENTER;
-    if (std::find(g_supportSensors.begin(), g_supportSensors.end(), sensorId) == g_supportSensors.end()) {
-        SEN_HILOGE("Not support disable sensorId:%{public}d", sensorId);
-        return ERR_NO_INIT;
-    }
-    if (std::find(enableSensors_.begin(), enableSensors_.end(), sensorId) == enableSensors_.end()) {
-        SEN_HILOGE("sensorId:%{public}d should be enable first", sensorId);
-        return ERR_NO_INIT;
-    }
-    std::vector<int32_t>::iterator iter;
-    for (iter = enableSensors_.begin(); iter != enableSensors_.end();) {
-        if (*iter == sensorId) {
-            iter = enableSensors_.erase(iter);
-            break;
-        } else {
-            ++iter;
-        }
-    }
-    if (enableSensors_.empty()) {
-        isStop_ = true;
-    }
-    return ERR_OK;
-}
-
-int32_t HdiServiceImpl::SetBatch(int32_t sensorId, int64_t samplingInterval, int64_t reportInterval)
-{
-    CALL_LOG_ENTER;
-    if (samplingInterval < 0 || reportInterval < 0) {
-        samplingInterval = SAMPLING_INTERVAL_NS;
-        reportInterval = 0;
-    }
-    samplingInterval_ = samplingInterval;
-    reportInterval_ = reportInterval;
-    return ERR_OK;
-}
-
-int32_t HdiServiceImpl::SetMode(int32_t sensorId, int32_t mode)
-{
-    return ERR_OK;
-}
-
-int32_t HdiServiceImpl::Register(RecordSensorCallback cb)
-{
-    CHKPR(cb, ERROR);
-    callbacks_.push_back(cb);
-    return ERR_OK;
-}
-
-int32_t HdiServiceImpl::Unregister()
-{
-    isStop_ = true;
-    return ERR_OK;
-}
-} // namespace Sensors
-} // namespace OHOS
\ No newline at end of file
+
+#include "hdi_service_impl.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <ctime>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+#include "sensor_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "HdiServiceImpl"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr int64_t SAMPLING_INTERVAL_NS = 200000000;
+// The thread wakes up at least this often to pick up enabled sensors and new rates.
+constexpr int64_t MAX_WAIT_NS = 20000000;
+// A sensor lagging further behind skips the missed samples instead of catching up.
+constexpr int64_t MAX_LAG_NS = 1000000000;
+// Hardware FIFO size of the emulated sensors, a longer report interval flushes at this depth.
+constexpr uint32_t MAX_FIFO_DEPTH = 1000;
+constexpr int64_t SECOND_NS = 1000000000;
+constexpr float TARGET_SUM = 9.8F * 9.8F;
+constexpr float MAX_RANGE = 9999.0F;
+constexpr int32_t DATA_OPTION = 3;
+const std::string SENSOR_PRODUCE_THREAD_NAME = "OS_SenMock";
+std::vector<SensorInfo> g_sensorInfos = {
+    {"sensor_test", "default", "1.0.0", "1.0.0", 1, 1, 9999.0, 0.000001, 23.0, 100000000, 1000000000},
+    {"sensor_test_color", "default", "1.0.0", "1.0.0", 14, 14, 9999.0, 0.000001, 23.0, 100000000, 1000000000},
+    {"sensor_test_sar", "default", "1.0.0", "1.0.0", 15, 15, 9999.0, 0.000001, 23.0, 100000000, 1000000000},
+};
+std::vector<int32_t> g_supportSensors = {
+    SENSOR_TYPE_ID_ACCELEROMETER,
+    SENSOR_TYPE_ID_COLOR,
+    SENSOR_TYPE_ID_SAR,
+    SENSOR_TYPE_ID_HEADPOSTURE
+};
+enum {
+    SAR_DIMENSION = 1,
+    COLOR_DIMENSION = 2,
+    ACCELEROMETER_DIMENSION = 3,
+    HEADPOSTURE_DIMENSION = 5,
+};
+
+int64_t GetMonotonicTimeNs()
+{
+    timespec time = { 0, 0 };
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * SECOND_NS + time.tv_nsec;
+}
+} // namespace
+std::vector<RecordSensorCallback> HdiServiceImpl::callbacks_;
+std::vector<RecordSensorBatchCallback> HdiServiceImpl::batchCallbacks_;
+std::vector<HdiDeathCallback> HdiServiceImpl::deathCallbacks_;
+std::mutex HdiServiceImpl::threadMutex_;
+std::atomic_bool HdiServiceImpl::isStop_ = false;
+std::mutex HdiServiceImpl::scheduleMutex_;
+std::map<int32_t, HdiServiceImpl::SensorBatch> HdiServiceImpl::batches_;
+std::map<int32_t, HdiServiceImpl::SensorSchedule> HdiServiceImpl::schedules_;
+std::priority_queue<HdiServiceImpl::ScheduleDeadline, std::vector<HdiServiceImpl::ScheduleDeadline>,
+    std::greater<HdiServiceImpl::ScheduleDeadline>> HdiServiceImpl::deadlines_;
+bool HdiServiceImpl::isLoadGenerator_ = false;
+LoadGeneratorConfig HdiServiceImpl::loadConfig_;
+std::vector<HdiServiceImpl::MockEvent> HdiServiceImpl::reportEvents_;
+std::vector<SensorEvent> HdiServiceImpl::reportBatch_;
+
+HdiServiceImpl::~HdiServiceImpl()
+{
+    isStop_ = true;
+    if (dataReportThread_.joinable()) {
+        dataReportThread_.join();
+    }
+}
+
+uint32_t HdiServiceImpl::GenerateData(int32_t sensorId, std::mt19937 &engine, float *data)
+{
+    switch (sensorId) {
+        case SENSOR_TYPE_ID_ACCELEROMETER:
+            GenerateAccelerometerData(engine, data);
+            return ACCELEROMETER_DIMENSION * sizeof(float);
+        case SENSOR_TYPE_ID_COLOR:
+            GenerateColorData(engine, data);
+            return COLOR_DIMENSION * sizeof(float);
+        case SENSOR_TYPE_ID_SAR:
+            GenerateSarData(engine, data);
+            return SAR_DIMENSION * sizeof(float);
+        case SENSOR_TYPE_ID_HEADPOSTURE:
+            GenerateHeadPostureData(engine, data);
+            return HEADPOSTURE_DIMENSION * sizeof(float);
+        default:
+            SEN_HILOGW("Unknown sensorId:%{public}d", sensorId);
+            return 0;
+    }
+}
+
+void HdiServiceImpl::GenerateAccelerometerData(std::mt19937 &engine, float *data)
+{
+    std::uniform_real_distribution<float> distr(0.0, TARGET_SUM);
+    float num1 = 0.0;
+    float num2 = 0.0;
+    while (true) {
+        num1 = distr(engine);
+        num2 = distr(engine);
+        if ((num1 > num2) && (std::fabs(num1 - num2) > std::numeric_limits<float>::epsilon())) {
+            float temp = num1;
+            num1 = num2;
+            num2 = temp;
+            break;
+        }
+    }
+    data[0] = static_cast<float>(sqrt(num1));
+    data[1] = static_cast<float>(sqrt(num2 - num1));
+    data[2] = static_cast<float>(sqrt(TARGET_SUM - num2));
+}
+
+void HdiServiceImpl::GenerateColorData(std::mt19937 &engine, float *data)
+{
+    std::uniform_real_distribution<float> distr(0.0, MAX_RANGE);
+    data[0] = distr(engine);
+    data[1] = distr(engine);
+}
+
+void HdiServiceImpl::GenerateSarData(std::mt19937 &engine, float *data)
+{
+    std::uniform_real_distribution<float> distr(0.0, MAX_RANGE);
+    data[0] = distr(engine);
+}
+
+void HdiServiceImpl::GenerateHeadPostureData(std::mt19937 &engine, float *data)
+{
+    std::uniform_real_distribution<float> distr(0.0, 1.0);
+    std::array<float, 4> nums;
+    while (true) {
+        nums[0] = distr(engine);
+        nums[1] = distr(engine);
+        nums[2] = distr(engine);
+        nums[3] = distr(engine);
+        std::sort(nums.begin(), nums.end());
+        if ((std::fabs(nums[1] - nums[0]) > std::numeric_limits<float>::epsilon()) &&
+            (std::fabs(nums[2] - nums[1]) > std::numeric_limits<float>::epsilon()) &&
+            (std::fabs(nums[3] - nums[2]) > std::numeric_limits<float>::epsilon())) {
+            break;
+        }
+    }
+    data[0] = static_cast<float>(sqrt(nums[0]));
+    data[1] = static_cast<float>(sqrt(nums[1] - nums[0]));
+    data[2] = static_cast<float>(sqrt(nums[2] - nums[1]));
+    data[3] = static_cast<float>(sqrt(nums[3] - nums[2]));
+    data[4] = static_cast<float>(sqrt(1.0 - nums[3]));
+}
+
+int32_t HdiServiceImpl::GetSensorList(std::vector<SensorInfo> &sensorList)
+{
+    CALL_LOG_ENTER;
+    sensorList.assign(g_sensorInfos.begin(), g_sensorInfos.end());
+    return ERR_OK;
+}
+
+bool HdiServiceImpl::IsLoadSensor(int32_t sensorId)
+{
+    return isLoadGenerator_ && std::any_of(loadConfig_.sensors.begin(), loadConfig_.sensors.end(),
+        [sensorId](const LoadSensorConfig &config) { return config.sensorId == sensorId; });
+}
+
+void HdiServiceImpl::ApplyBatch(int32_t sensorId, SensorSchedule &schedule)
+{
+    schedule.samplingPeriodNs = SAMPLING_INTERVAL_NS;
+    schedule.fifoDepth = 1;
+    auto it = batches_.find(sensorId);
+    if ((it == batches_.end()) || (it->second.samplingIntervalNs <= 0)) {
+        return;
+    }
+    schedule.samplingPeriodNs = it->second.samplingIntervalNs;
+    // Like a hardware FIFO, events are held until the report interval is covered.
+    int64_t fifoDepth = it->second.reportIntervalNs / it->second.samplingIntervalNs;
+    schedule.fifoDepth = static_cast<uint32_t>(std::clamp<int64_t>(fifoDepth, 1, MAX_FIFO_DEPTH));
+}
+
+void HdiServiceImpl::ConfigureSchedule(int32_t sensorId, SensorSchedule &schedule)
+{
+    ApplyBatch(sensorId, schedule);
+    if (!isLoadGenerator_) {
+        schedule.engine.seed(std::random_device()());
+    } else {
+        schedule.engine.seed(loadConfig_.seed ^ static_cast<uint32_t>(sensorId));
+        auto it = std::find_if(loadConfig_.sensors.begin(), loadConfig_.sensors.end(),
+            [sensorId](const LoadSensorConfig &config) { return config.sensorId == sensorId; });
+        if (it != loadConfig_.sensors.end()) {
+            schedule.samplingPeriodNs = it->samplingPeriodNs;
+            schedule.fifoDepth = std::max(it->fifoDepth, 1u);
+        }
+    }
+    schedule.fifo.clear();
+    schedule.fifo.reserve(schedule.fifoDepth);
+}
+
+void HdiServiceImpl::RebuildDeadlines()
+{
+    std::vector<ScheduleDeadline> deadlines;
+    deadlines.reserve(schedules_.size());
+    for (const auto &it : schedules_) {
+        deadlines.emplace_back(it.second.nextDeadlineNs, it.first);
+    }
+    deadlines_ = decltype(deadlines_)(std::greater<ScheduleDeadline>(), std::move(deadlines));
+}
+
+int64_t HdiServiceImpl::GetNextDeadline()
+{
+    return deadlines_.empty() ? INT64_MAX : deadlines_.top().first;
+}
+
+void HdiServiceImpl::ProduceEvent(int32_t sensorId, SensorSchedule &schedule)
+{
+    // Each sample carries its deadline as timestamp, even when it is produced late.
+    MockEvent mockEvent;
+    mockEvent.event.sensorTypeId = sensorId;
+    mockEvent.event.timestamp = schedule.nextDeadlineNs;
+    mockEvent.event.option = DATA_OPTION;
+    mockEvent.event.dataLen = GenerateData(sensorId, schedule.engine, mockEvent.data.data());
+    schedule.fifo.push_back(mockEvent);
+    if (schedule.fifo.size() >= schedule.fifoDepth) {
+        reportEvents_.insert(reportEvents_.end(), schedule.fifo.begin(), schedule.fifo.end());
+        schedule.fifo.clear();
+    }
+}
+
+void HdiServiceImpl::ProduceEvents(int64_t nowNs)
+{
+    // Sensors are served in deadline order, so the events of different rates interleave by timestamp.
+    while (!deadlines_.empty() && (deadlines_.top().first <= nowNs)) {
+        int32_t sensorId = deadlines_.top().second;
+        deadlines_.pop();
+        auto it = schedules_.find(sensorId);
+        if (it == schedules_.end()) {
+            continue;
+        }
+        SensorSchedule &schedule = it->second;
+        if (nowNs - schedule.nextDeadlineNs > MAX_LAG_NS) {
+            SEN_HILOGW("Skip missed samples, sensorId:%{public}d", sensorId);
+            schedule.nextDeadlineNs = nowNs;
+        }
+        ProduceEvent(sensorId, schedule);
+        schedule.nextDeadlineNs += schedule.samplingPeriodNs;
+        deadlines_.emplace(schedule.nextDeadlineNs, sensorId);
+    }
+}
+
+void HdiServiceImpl::ReportEvents()
+{
+    if (reportEvents_.empty()) {
+        return;
+    }
+    for (auto &mockEvent : reportEvents_) {
+        mockEvent.event.data = reinterpret_cast<uint8_t *>(mockEvent.data.data());
+        for (const auto &it : callbacks_) {
+            if (it == nullptr) {
+                SEN_HILOGW("RecordSensorCallback is null");
+                continue;
+            }
+            it(&mockEvent.event);
+        }
+    }
+    if (!batchCallbacks_.empty()) {
+        reportBatch_.clear();
+        for (const auto &mockEvent : reportEvents_) {
+            reportBatch_.push_back(mockEvent.event);
+        }
+        for (const auto &it : batchCallbacks_) {
+            if (it == nullptr) {
+                SEN_HILOGW("RecordSensorBatchCallback is null");
+                continue;
+            }
+            it(reportBatch_.data(), reportBatch_.size());
+        }
+    }
+    reportEvents_.clear();
+}
+
+void HdiServiceImpl::DataReportThread()
+{
+    CALL_LOG_ENTER;
+    prctl(PR_SET_NAME, SENSOR_PRODUCE_THREAD_NAME.c_str());
+    while (!isStop_) {
+        int64_t deadlineNs = 0;
+        {
+            std::lock_guard<std::mutex> scheduleLock(scheduleMutex_);
+            deadlineNs = std::min(GetNextDeadline(), GetMonotonicTimeNs() + MAX_WAIT_NS);
+        }
+        timespec deadline = { static_cast<time_t>(deadlineNs / SECOND_NS), static_cast<long>(deadlineNs % SECOND_NS) };
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+        {
+            std::lock_guard<std::mutex> scheduleLock(scheduleMutex_);
+            ProduceEvents(GetMonotonicTimeNs());
+        }
+        ReportEvents();
+    }
+    SEN_HILOGI("Thread stop");
+    return;
+}
+
+int32_t HdiServiceImpl::EnableSensor(int32_t sensorId)
+{
+    CALL_LOG_ENTER;
+    if (std::find(g_supportSensors.begin(), g_supportSensors.end(), sensorId) == g_supportSensors.end()) {
+        SEN_HILOGE("Not support enable sensorId:%{public}d", sensorId);
+        return ERR_NO_INIT;
+    }
+    {
+        std::lock_guard<std::mutex> scheduleLock(scheduleMutex_);
+        if (schedules_.find(sensorId) != schedules_.end()) {
+            SEN_HILOGI("sensorId:%{public}d has been enabled", sensorId);
+            return ERR_OK;
+        }
+        SensorSchedule &schedule = schedules_[sensorId];
+        ConfigureSchedule(sensorId, schedule);
+        schedule.nextDeadlineNs = GetMonotonicTimeNs() + schedule.samplingPeriodNs;
+        deadlines_.emplace(schedule.nextDeadlineNs, sensorId);
+    }
+    std::lock_guard<std::mutex> threadLock(threadMutex_);
+    if (!dataReportThread_.joinable() || isStop_) {
+        if (dataReportThread_.joinable()) {
+            dataReportThread_.join();
+        }
+        isStop_ = false;
+        std::thread senocdDataThread(HdiServiceImpl::DataReportThread);
+        dataReportThread_ = std::move(senocdDataThread);
+    }
+    return ERR_OK;
+};
+
+int32_t HdiServiceImpl::DisableSensor(int32_t sensorId)
+{
+    CALL_LOG_ENTER;
+    if (std::find(g_supportSensors.begin(), g_supportSensors.end(), sensorId) == g_supportSensors.end()) {
+        SEN_HILOGE("Not support disable sensorId:%{public}d", sensorId);
+        return ERR_NO_INIT;
+    }
+    std::lock_guard<std::mutex> scheduleLock(scheduleMutex_);
+    auto it = schedules_.find(sensorId);
+    if (it == schedules_.end()) {
+        SEN_HILOGE("sensorId:%{public}d should be enable first", sensorId);
+        return ERR_NO_INIT;
+    }
+    // Events still held in the emulated FIFO are dropped like on hardware.
+    schedules_.erase(it);
+    RebuildDeadlines();
+    if (schedules_.empty()) {
+        isStop_ = true;
+    }
+    return ERR_OK;
+}
+
+int32_t HdiServiceImpl::SetBatch(int32_t sensorId, int64_t samplingInterval, int64_t reportInterval)
+{
+    CALL_LOG_ENTER;
+    if (samplingInterval < 0 || reportInterval < 0) {
+        samplingInterval = SAMPLING_INTERVAL_NS;
+        reportInterval = 0;
+    }
+    std::lock_guard<std::mutex> scheduleLock(scheduleMutex_);
+    batches_[sensorId] = { samplingInterval, reportInterval };
+    // Sensors under the load generator keep their own rate.
+    auto it = schedules_.find(sensorId);
+    if ((it == schedules_.end()) || IsLoadSensor(sensorId)) {
+        return ERR_OK;
+    }
+    // The new rate applies from the next sample, which is not later than one new period from now.
+    SensorSchedule &schedule = it->second;
+    ApplyBatch(sensorId, schedule);
+    schedule.fifo.reserve(schedule.fifoDepth);
+    schedule.nextDeadlineNs = std::min(schedule.nextDeadlineNs, GetMonotonicTimeNs() + schedule.samplingPeriodNs);
+    RebuildDeadlines();
+    return ERR_OK;
+}
+
+int32_t HdiServiceImpl::SetMode(int32_t sensorId, int32_t mode)
+{
+    return ERR_OK;
+}
+
+int32_t HdiServiceImpl::Register(RecordSensorCallback cb)
+{
+    CHKPR(cb, ERROR);
+    callbacks_.push_back(cb);
+    return ERR_OK;
+}
+
+int32_t HdiServiceImpl::RegisterBatch(RecordSensorBatchCallback cb)
+{
+    CHKPR(cb, ERROR);
+    batchCallbacks_.push_back(cb);
+    return ERR_OK;
+}
+
+int32_t HdiServiceImpl::RegisterDeathCallback(HdiDeathCallback cb)
+{
+    CHKPR(cb, ERROR);
+    deathCallbacks_.push_back(cb);
+    return ERR_OK;
+}
+
+int32_t HdiServiceImpl::Unregister()
+{
+    isStop_ = true;
+    return ERR_OK;
+}
+
+void HdiServiceImpl::SimulateDeath()
+{
+    CALL_LOG_ENTER;
+    {
+        // The thread is joined before the callbacks are dropped, it may be reporting through them.
+        std::lock_guard<std::mutex> threadLock(threadMutex_);
+        isStop_ = true;
+        if (dataReportThread_.joinable()) {
+            dataReportThread_.join();
+        }
+        std::lock_guard<std::mutex> scheduleLock(scheduleMutex_);
+        batches_.clear();
+        schedules_.clear();
+        deadlines_ = decltype(deadlines_)();
+        reportEvents_.clear();
+        callbacks_.clear();
+        batchCallbacks_.clear();
+    }
+    for (const auto &it : deathCallbacks_) {
+        it();
+    }
+}
+
+int32_t HdiServiceImpl::SetLoadGenerator(const LoadGeneratorConfig &config)
+{
+    CALL_LOG_ENTER;
+    for (const auto &sensor : config.sensors) {
+        if ((sensor.samplingPeriodNs <= 0) ||
+            (std::find(g_supportSensors.begin(), g_supportSensors.end(), sensor.sensorId) == g_supportSensors.end())) {
+            SEN_HILOGE("Invalid load, sensorId:%{public}d", sensor.sensorId);
+            return ERR_INVALID_VALUE;
+        }
+    }
+    std::lock_guard<std::mutex> scheduleLock(scheduleMutex_);
+    isLoadGenerator_ = true;
+    loadConfig_ = config;
+    int64_t nowNs = GetMonotonicTimeNs();
+    for (auto &it : schedules_) {
+        ConfigureSchedule(it.first, it.second);
+        it.second.nextDeadlineNs = nowNs + it.second.samplingPeriodNs;
+    }
+    RebuildDeadlines();
+    return ERR_OK;
+}
+
+void HdiServiceImpl::ClearLoadGenerator()
+{
+    CALL_LOG_ENTER;
+    std::lock_guard<std::mutex> scheduleLock(scheduleMutex_);
+    isLoadGenerator_ = false;
+    loadConfig_ = LoadGeneratorConfig();
+    // As with SetBatch, the rates set before apply from the next sample, not after a long load period ran out.
+    int64_t nowNs = GetMonotonicTimeNs();
+    for (auto &it : schedules_) {
+        ConfigureSchedule(it.first, it.second);
+        it.second.nextDeadlineNs = std::min(it.second.nextDeadlineNs, nowNs + it.second.samplingPeriodNs);
+    }
+    RebuildDeadlines();
+}
+} // namespace Sensors
+} // namespace OHOS
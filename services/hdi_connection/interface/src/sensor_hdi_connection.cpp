@@ -16,6 +16,7 @@
 
 #ifdef BUILD_VARIANT_ENG
 #include "compatible_connection.h"
+#include "replay_connection.h"
 #endif // BUILD_VARIANT_ENG
 
 #include "hdi_connection.h"
@@ -48,6 +49,21 @@ std::unordered_set<int32_t> g_supportMockSensors = {
 
 int32_t SensorHdiConnection::ConnectHdi()
 {
+#ifdef BUILD_VARIANT_ENG
+    if (ReplayConnection::IsReplayConfigured()) {
+        iSensorHdiConnection_ = std::make_unique<ReplayConnection>();
+        int32_t replayRet = ConnectHdiService();
+        if (replayRet == ERR_OK) {
+            SEN_HILOGI("Connect replay connection success, sensors come from the trace");
+            hdiConnectionStatus_ = false;
+            return ERR_OK;
+        }
+        SEN_HILOGE("Connect replay connection failed, try to connect hdi service, ret:%{public}d", replayRet);
+        std::lock_guard<std::mutex> sensorLock(sensorMutex_);
+        sensorList_.clear();
+        sensorSet_.clear();
+    }
+#endif // BUILD_VARIANT_ENG
     iSensorHdiConnection_ = std::make_unique<HdiConnection>();
     int32_t ret = ConnectHdiService();
     if (ret != ERR_OK) {
@@ -17,7 +17,6 @@
 #define CLIENT_INFO_H
 
 #include <map>
-#include <queue>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -31,14 +30,26 @@
 #include "nocopyable.h"
 
 #include "app_thread_info.h"
+#include "dump_data_ring.h"
 #include "sensor_basic_data_channel.h"
 #include "sensor_basic_info.h"
 #include "sensor_channel_info.h"
 #include "sensor_data_event.h"
+#include "sensor_metrics.h"
+#include "sensor_rate_arbiter.h"
+#include "sensor_slot_table.h"
 
 namespace OHOS {
 namespace Sensors {
 using Security::AccessToken::AccessTokenID;
+constexpr size_t MAX_DUMP_SENSOR_NUM = 32;
+
+struct ChannelPeriod {
+    // Sampling period requested through the channel and the one the sensor runs at.
+    int64_t clientPeriodNs;
+    int64_t sensorPeriodNs;
+};
+
 class ClientInfo : public Singleton<ClientInfo> {
 public:
     ClientInfo() = default;
@@ -58,7 +69,7 @@ public:
     bool DestroySensorChannel(int32_t pid);
     void DestroyAppThreadInfo(int32_t pid);
     SensorBasicInfo GetCurPidSensorInfo(int32_t sensorId, int32_t pid);
-    uint64_t ComputeBestPeriodCount(int32_t sensorId, sptr<SensorBasicDataChannel> &channel);
+    bool GetChannelPeriod(int32_t sensorId, sptr<SensorBasicDataChannel> &channel, ChannelPeriod &period);
     uint64_t ComputeBestFifoCount(int32_t sensorId, sptr<SensorBasicDataChannel> &channel);
     int32_t GetStoreEvent(int32_t sensorId, SensorData &data);
     void StoreEvent(const SensorData &data);
@@ -69,10 +80,18 @@ public:
     void DestroyClientPid(const sptr<IRemoteObject> &sensorClient);
     std::vector<int32_t> GetSensorIdByPid(int32_t pid);
     void GetSensorChannelInfo(std::vector<SensorChannelInfo> &channelInfo);
+    void GetChannelMetrics(std::vector<ChannelMetricsSnapshot> &channelMetrics);
+
+    /**
+     * @brief Get the deliveries recorded on every channel, with the period each pid requested.
+     *
+     * @param deliveries Delivery statistics per sensor and pid.
+     */
+    void GetDeliveryStats(std::vector<DeliverySnapshot> &deliveries);
     void UpdateCmd(int32_t sensorId, int32_t uid, int32_t cmdType);
     void DestroyCmd(int32_t uid);
     void UpdateDataQueue(int32_t sensorId, SensorData &data);
-    std::unordered_map<int32_t, std::queue<SensorData>> GetDumpQueue();
+    std::unordered_map<int32_t, std::vector<SensorData>> GetDumpData();
     void ClearDataQueue(int32_t sensorId);
     int32_t GetUidByPid(int32_t pid);
     AccessTokenID GetTokenIdByPid(int32_t pid);
@@ -93,14 +112,16 @@ private:
     std::mutex uidMutex_;
     std::mutex clientPidMutex_;
     std::mutex cmdMutex_;
-    std::mutex dataQueueMutex_;
     std::unordered_map<int32_t, std::unordered_map<int32_t, SensorBasicInfo>> clientMap_;
     std::unordered_map<int32_t, sptr<SensorBasicDataChannel>> channelMap_;
     std::unordered_map<int32_t, SensorData> storedEvent_;
     std::unordered_map<int32_t, AppThreadInfo> appThreadInfoMap_;
     std::map<sptr<IRemoteObject>, int32_t> clientPidMap_;
     std::unordered_map<int32_t, std::unordered_map<int32_t, std::vector<int32_t>>> cmdMap_;
-    std::unordered_map<int32_t, std::queue<SensorData>> dumpQueue_;
+    // Written by the data thread and read by the dump without locks.
+    SensorSlotTable<DumpDataRing, MAX_DUMP_SENSOR_NUM> dumpRings_;
+    // Mirrors the sampling periods and report delays of clientMap_, updated under clientMutex_.
+    SensorRateArbiter &rateArbiter_ = SensorRateArbiter::GetInstance();
     std::mutex activeInfoCBPidMutex_;
     std::unordered_set<int32_t> activeInfoCBPidSet_;
     static std::unordered_map<std::string, std::set<int32_t>> userGrantPermMap_;
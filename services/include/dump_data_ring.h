@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DUMP_DATA_RING_H
+#define DUMP_DATA_RING_H
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+#include "sensor_data_event.h"
+
+namespace OHOS {
+namespace Sensors {
+constexpr uint32_t MAX_DUMP_DATA_SIZE = 10;
+
+/**
+ * Last events of one sensor kept for dumping. The data thread is the only writer and overwrites the oldest event,
+ * readers copy the ring under a sequence lock and retry when a write overlapped, so neither side blocks the other.
+ */
+class DumpDataRing {
+public:
+    DumpDataRing() = default;
+    ~DumpDataRing() = default;
+
+    /**
+     * @brief Store an event, called by the data thread only.
+     *
+     * @param data Event to store.
+     */
+    void Push(const SensorData &data);
+
+    /**
+     * @brief Drop the stored events, safe to call from any thread.
+     */
+    void Clear();
+
+    /**
+     * @brief Copy the stored events, oldest first.
+     *
+     * @param events Receives the events, left empty if the writer kept overlapping the copy.
+     *
+     * @return true if the copy is consistent, false otherwise.
+     */
+    bool Read(std::vector<SensorData> &events) const;
+
+private:
+    // Odd while a write is in progress.
+    std::atomic<uint32_t> sequence_ { 0 };
+    std::atomic<uint64_t> writeCount_ { 0 };
+    // Events written before this count are cleared. Kept apart from the writer state so clearing needs no lock.
+    std::atomic<uint64_t> clearCount_ { 0 };
+    std::array<SensorData, MAX_DUMP_DATA_SIZE> events_ {};
+};
+} // namespace Sensors
+} // namespace OHOS
+#endif // DUMP_DATA_RING_H
@@ -29,8 +29,8 @@ class FifoCacheData : public RefBase {
 public:
     FifoCacheData();
     virtual ~FifoCacheData();
-    void SetPeriodCount(uint64_t periodCount);
-    uint64_t GetPeriodCount() const;
+    void SetNextDueTimestamp(int64_t nextDueNs);
+    int64_t GetNextDueTimestamp() const;
     void SetFifoCacheData(const std::vector<SensorData> &fifoCacheData);
     std::vector<SensorData> GetFifoCacheData() const;
     void SetChannel(const sptr<SensorBasicDataChannel> &channel);
@@ -39,7 +39,8 @@ public:
 
 private:
     DISALLOW_COPY_AND_MOVE(FifoCacheData);
-    uint64_t periodCount_;
+    // Timestamp from which the next event of the sensor is forwarded to the channel.
+    int64_t nextDueNs_;
     wptr<SensorBasicDataChannel> channel_;
     std::vector<SensorData> fifoCacheData_;
 };
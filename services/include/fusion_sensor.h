@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FUSION_SENSOR_H
+#define FUSION_SENSOR_H
+
+#include "orientation_filter.h"
+#include "virtual_sensor.h"
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * Derives rotation vector, game rotation vector, gravity and linear acceleration from the accelerometer, gyroscope
+ * and magnetometer. The gyroscope drives the filters, each gyroscope sample yields one event per enabled output.
+ */
+class FusionSensor : public VirtualSensor {
+public:
+    FusionSensor() = default;
+    ~FusionSensor() override = default;
+    std::vector<VirtualSensorOutput> Init(const std::vector<Sensor> &hdiSensors) override;
+    void Process(SensorDataSpan events, uint32_t activeOutputs, std::vector<SensorData> &outputs) override;
+
+private:
+    void ProcessEvent(const SensorData &data, uint32_t activeOutputs, std::vector<SensorData> &outputs);
+    // Outputs enabled at the previous batch, a filter that was idle holds a stale attitude and restarts.
+    uint32_t activeOutputs_ { 0 };
+    OrientationFilter filter_ { true };
+    OrientationFilter gameFilter_ { false };
+};
+}  // namespace Sensors
+}  // namespace OHOS
+#endif // FUSION_SENSOR_H
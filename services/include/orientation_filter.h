@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORIENTATION_FILTER_H
+#define ORIENTATION_FILTER_H
+
+#include <array>
+#include <cstdint>
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * Mahony complementary filter estimating the device attitude from gyroscope, accelerometer and optionally
+ * magnetometer samples. The gyroscope drives the integration, the latest accelerometer and magnetometer samples
+ * pull the estimate towards gravity and magnetic north. The state is a handful of fixed-size arrays, an update
+ * never allocates.
+ * The attitude rotates device coordinates into the world frame: x points east, y points north and z points up.
+ */
+class OrientationFilter {
+public:
+    using Vector3 = std::array<float, 3>;
+    // x, y, z, w, the layout of RotationVectorData.
+    using Quaternion = std::array<float, 4>;
+
+    explicit OrientationFilter(bool useMagnetometer);
+    ~OrientationFilter() = default;
+
+    /**
+     * @brief Drop the attitude and the buffered samples, the next update starts from scratch.
+     */
+    void Reset();
+
+    /**
+     * @param acc Accelerometer sample in m/s^2.
+     */
+    void SetAccelerometer(const Vector3 &acc);
+
+    /**
+     * @param mag Magnetometer sample in uT, ignored when the filter does not use the magnetometer.
+     */
+    void SetMagnetometer(const Vector3 &mag);
+
+    /**
+     * @brief Integrate one gyroscope sample.
+     *
+     * @param gyro Angular rate in rad/s.
+     * @param timestamp Sample time in ns.
+     *
+     * @return Returns <b>true</b> if the attitude is valid after the update; returns <b>false</b> while the filter
+     * still waits for the samples it needs to initialize.
+     */
+    bool Update(const Vector3 &gyro, int64_t timestamp);
+
+    /**
+     * @brief Attitude of the device, a unit quaternion with a non-negative w.
+     */
+    Quaternion GetQuaternion() const;
+
+    /**
+     * @brief Gravity in device coordinates, in m/s^2.
+     */
+    Vector3 GetGravity() const;
+
+    /**
+     * @brief Latest accelerometer sample minus gravity, in m/s^2.
+     */
+    Vector3 GetLinearAcceleration() const;
+
+private:
+    bool Initialize();
+    void Integrate(const Vector3 &gyro, float dt);
+    Vector3 RotateToWorld(const Vector3 &v) const;
+    Vector3 RotateToDevice(const Vector3 &v) const;
+
+private:
+    bool useMagnetometer_;
+    bool initialized_ { false };
+    bool hasAcc_ { false };
+    bool hasMag_ { false };
+    int64_t lastTimestamp_ { 0 };
+    Vector3 acc_ { 0.0f, 0.0f, 0.0f };
+    Vector3 mag_ { 0.0f, 0.0f, 0.0f };
+    // w, x, y, z, kept in this order internally to follow the textbook formulas.
+    std::array<float, 4> q_ { 1.0f, 0.0f, 0.0f, 0.0f };
+};
+}  // namespace Sensors
+}  // namespace OHOS
+#endif // ORIENTATION_FILTER_H
@@ -30,6 +30,10 @@
 #include "sensor.h"
 #include "sensor_hdi_connection.h"
 #include "sensor_data_event.h"
+#include "sensor_latency_tracker.h"
+#include "sensor_metrics.h"
+#include "sensor_trace_recorder.h"
+#include "virtual_sensor_manager.h"
 
 namespace OHOS {
 namespace Sensors {
@@ -42,21 +46,44 @@ public:
     static int DataThread(sptr<SensorDataProcesser> dataProcesser, sptr<ReportDataCallback> dataCallback);
     int32_t CacheSensorEvent(const SensorData &data, sptr<SensorBasicDataChannel> &channel);
 
+    /**
+     * @brief Check whether an event is due for a channel and advance its next due time if so.
+     *
+     * @param fifoCacheData Per channel state holding the next due time, 0 before the first event.
+     * @param data Event to check.
+     * @param period Sampling periods of the channel and of the sensor.
+     *
+     * @return Returns true if the event is to be forwarded to the channel.
+     */
+    static bool IsEventDue(const sptr<FifoCacheData> &fifoCacheData, const SensorData &data,
+                           const ChannelPeriod &period);
+
 private:
     DISALLOW_COPY_AND_MOVE(SensorDataProcesser);
     void ReportData(sptr<SensorBasicDataChannel> &channel, SensorData &data);
     bool ReportNotContinuousData(std::unordered_map<int32_t, SensorData> &cacheBuf,
                                  sptr<SensorBasicDataChannel> &channel, SensorData &data);
     void SendNoneFifoCacheData(std::unordered_map<int32_t, SensorData> &cacheBuf,
-                               sptr<SensorBasicDataChannel> &channel, SensorData &data, uint64_t periodCount);
+                               sptr<SensorBasicDataChannel> &channel, SensorData &data, const ChannelPeriod &period);
     void SendFifoCacheData(std::unordered_map<int32_t, SensorData> &cacheBuf,
-                           sptr<SensorBasicDataChannel> &channel, SensorData &data, uint64_t periodCount,
+                           sptr<SensorBasicDataChannel> &channel, SensorData &data, const ChannelPeriod &period,
                            uint64_t fifoCount);
     void SendRawData(std::unordered_map<int32_t, SensorData> &cacheBuf, sptr<SensorBasicDataChannel> channel,
                      std::vector<SensorData> events);
-    void EventFilter(CircularEventBuf &eventsBuf);
+    void EventFilter(SensorData &data);
+    void DispatchEvents(CircularEventBuf &eventsBuf);
     ClientInfo &clientInfo_ = ClientInfo::GetInstance();
+    VirtualSensorManager &virtualSensorManager_ = VirtualSensorManager::GetInstance();
+    // Events of the current batch consumed by virtual sensors, touched by the data thread only.
+    std::vector<SensorData> virtualInputs_;
+    // HDI callback time of the oldest tracked event in virtualInputs_, 0 if none is tracked.
+    int64_t virtualInputsHdiTimeNs_ { 0 };
+    // HDI callback time of the event being dispatched, 0 if it is not tracked. Touched by the data thread only.
+    int64_t dispatchHdiTimeNs_ { 0 };
     FlushInfoRecord &flushInfo_ = FlushInfoRecord::GetInstance();
+    SensorLatencyTracker &latencyTracker_ = SensorLatencyTracker::GetInstance();
+    SensorMetrics &metrics_ = SensorMetrics::GetInstance();
+    SensorTraceRecorder &traceRecorder_ = SensorTraceRecorder::GetInstance();
     std::mutex dataCountMutex_;
     std::unordered_map<int32_t, std::vector<sptr<FifoCacheData>>> dataCountMap_;
     std::mutex sensorMutex_;
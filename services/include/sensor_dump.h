@@ -16,6 +16,8 @@
 #ifndef SENSOR_DUMP_H
 #define SENSOR_DUMP_H
 
+#include <map>
+#include <mutex>
 #include <vector>
 
 #include "singleton.h"
@@ -25,6 +27,8 @@
 #include "client_info.h"
 #include "sensor.h"
 #include "sensor_agent_type.h"
+#include "sensor_latency_tracker.h"
+#include "sensor_metrics.h"
 
 namespace OHOS {
 namespace Sensors {
@@ -39,16 +43,30 @@ public:
     bool DumpSensorChannel(int32_t fd, ClientInfo &clientInfo);
     bool DumpOpeningSensor(int32_t fd, const std::vector<Sensor> &sensors, ClientInfo &clientInfo);
     bool DumpSensorData(int32_t fd, ClientInfo &clientInfo);
+    bool DumpStartRecord(int32_t fd);
+    bool DumpStopRecord(int32_t fd);
+    bool DumpSensorLatency(int32_t fd);
+    bool DumpLatencySnapshot(int32_t fd);
+    bool DumpMetrics(int32_t fd, ClientInfo &clientInfo);
 
 private:
     DISALLOW_COPY_AND_MOVE(SensorDump);
     void DumpCurrentTime(int32_t fd);
+    // Called with metricsMutex_ held.
+    void DumpDeliveries(int32_t fd, const std::vector<DeliverySnapshot> &deliveries);
     int32_t GetDataDimension(int32_t sensorId);
     std::string GetDataBySensorId(int32_t sensorId, SensorData &sensorData);
     static std::unordered_map<int32_t, std::string> sensorMap_;
     void RunSensorDump(int32_t fd, int32_t optionIndex, const std::vector<std::string> &args, char **argv);
     std::vector<Sensor> sensors_;
     ClientInfo &clientInfo_ = ClientInfo::GetInstance();
+    SensorLatencyTracker &latencyTracker_ = SensorLatencyTracker::GetInstance();
+    // Counters of the previous metrics dump, rates are computed against them.
+    std::mutex metricsMutex_;
+    DataPathMetricsSnapshot lastMetrics_ {};
+    std::unordered_map<int32_t, ChannelMetricsSnapshot> lastChannelMetrics_;
+    // Deliveries at the last dump by pid and sensor id.
+    std::map<std::pair<int32_t, int32_t>, DeliveryStats> lastDeliveries_;
 };
 } // namespace Sensors
 } // namespace OHOS
@@ -22,9 +22,11 @@
 
 #include "client_info.h"
 #include "flush_info_record.h"
+#include "sensor_rate_arbiter.h"
 #ifdef HDF_DRIVERS_INTERFACE_SENSOR
 #include "sensor_data_processer.h"
 #include "sensor_hdi_connection.h"
+#include "virtual_sensor_manager.h"
 #else
 #include "sensor.h"
 #endif // HDF_DRIVERS_INTERFACE_SENSOR
@@ -51,7 +53,11 @@ public:
 
 private:
 #ifdef HDF_DRIVERS_INTERFACE_SENSOR
+    int32_t SetBatch(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs);
+    bool ApplySensorParams(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs);
+    SensorRateArbiter &rateArbiter_ = SensorRateArbiter::GetInstance();
     SensorHdiConnection &sensorHdiConnection_ = SensorHdiConnection::GetInstance();
+    VirtualSensorManager &virtualSensorManager_ = VirtualSensorManager::GetInstance();
     std::thread dataThread_;
     sptr<SensorDataProcesser> sensorDataProcesser_ = nullptr;
     sptr<ReportDataCallback> reportDataCallback_ = nullptr;
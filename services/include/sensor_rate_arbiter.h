@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_RATE_ARBITER_H
+#define SENSOR_RATE_ARBITER_H
+
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "nocopyable.h"
+#include "singleton.h"
+
+#include "sensor_basic_info.h"
+
+namespace OHOS {
+namespace Sensors {
+struct SensorRateSnapshot {
+    int32_t sensorId;
+    size_t requestCount;
+    bool isApplied;
+    int64_t appliedSamplingPeriodNs;
+    int64_t appliedReportDelayNs;
+    // Batch parameters set on the sensor, and changes absorbed because the applied parameters still served everyone.
+    uint64_t reconfigCount;
+    uint64_t skippedCount;
+};
+
+/**
+ * Arbitrates the batch parameters of each sensor among its subscribers. The requested sampling periods and report
+ * delays are kept in ordered multisets, so a subscribe or unsubscribe costs O(log n) and the effective value is the
+ * smallest element. The parameters last set on the sensor are remembered: a faster rate or a shorter delay is
+ * applied at once, a slower one only when it moves past a hysteresis margin, so client churn does not restart the
+ * sensor for every change. Events are forwarded by timestamp, so every subscriber gets its requested rate on
+ * average even when its period is not a multiple of the sensor period.
+ */
+class SensorRateArbiter : public Singleton<SensorRateArbiter> {
+public:
+    SensorRateArbiter() = default;
+    virtual ~SensorRateArbiter() = default;
+    void UpdateRequest(int32_t sensorId, int32_t pid, int64_t samplingPeriodNs, int64_t maxReportDelayNs);
+    void RemoveRequest(int32_t sensorId, int32_t pid);
+
+    /**
+     * @brief Drop the requests and the applied parameters of a sensor once it is disabled, the counters are kept.
+     *
+     * @param sensorId Sensor id.
+     */
+    void RemoveSensor(int32_t sensorId);
+
+    /**
+     * @brief Get the smallest requested sampling period and report delay, LLONG_MAX when nobody subscribed.
+     *
+     * @param sensorId Sensor id.
+     *
+     * @return Returns the effective parameters.
+     */
+    SensorBasicInfo GetBestSensorInfo(int32_t sensorId);
+
+    /**
+     * @brief Get the sampling period the sensor runs at, the best requested one until parameters are applied.
+     *
+     * @param sensorId Sensor id.
+     *
+     * @return Returns the sampling period in ns.
+     */
+    int64_t GetAppliedSamplingPeriod(int32_t sensorId);
+
+    /**
+     * @brief Check whether the sensor has to be reconfigured to serve the given parameters. A skipped change is
+     * counted.
+     *
+     * @param sensorId Sensor id.
+     * @param samplingPeriodNs Sampling period to serve.
+     * @param maxReportDelayNs Report delay to serve.
+     *
+     * @return Returns true if the batch parameters have to be set.
+     */
+    bool NeedReconfigure(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs);
+
+    /**
+     * @brief Record the batch parameters successfully set on the sensor.
+     *
+     * @param sensorId Sensor id.
+     * @param samplingPeriodNs Sampling period set.
+     * @param maxReportDelayNs Report delay set.
+     */
+    void CommitReconfigure(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs);
+    void GetRateSnapshots(std::vector<SensorRateSnapshot> &snapshots);
+
+private:
+    DISALLOW_COPY_AND_MOVE(SensorRateArbiter);
+    struct SensorRate {
+        // Sampling period and report delay requested per pid, mirrored in the multisets.
+        std::unordered_map<int32_t, std::pair<int64_t, int64_t>> requests;
+        std::multiset<int64_t> samplingPeriods;
+        std::multiset<int64_t> reportDelays;
+        bool isApplied { false };
+        int64_t appliedSamplingPeriodNs { 0 };
+        int64_t appliedReportDelayNs { 0 };
+        uint64_t reconfigCount { 0 };
+        uint64_t skippedCount { 0 };
+    };
+    void EraseRequest(SensorRate &sensorRate, int32_t pid);
+    static bool IsBeyondHysteresis(int64_t value, int64_t appliedValue);
+    std::mutex rateMutex_;
+    std::unordered_map<int32_t, SensorRate> sensorRates_;
+};
+} // namespace Sensors
+} // namespace OHOS
+#endif // SENSOR_RATE_ARBITER_H
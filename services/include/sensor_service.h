@@ -33,6 +33,7 @@
 #include "stream_server.h"
 #ifdef HDF_DRIVERS_INTERFACE_SENSOR
 #include "sensor_hdi_connection.h"
+#include "virtual_sensor_manager.h"
 #endif // HDF_DRIVERS_INTERFACE_SENSOR
 
 namespace OHOS {
@@ -101,6 +102,7 @@ private:
     bool InitDataCallback();
     bool InitSensorList();
     SensorHdiConnection &sensorHdiConnection_ = SensorHdiConnection::GetInstance();
+    VirtualSensorManager &virtualSensorManager_ = VirtualSensorManager::GetInstance();
     sptr<SensorDataProcesser> sensorDataProcesser_ = nullptr;
     sptr<ReportDataCallback> reportDataCallback_ = nullptr;
 #endif // HDF_DRIVERS_INTERFACE_SENSOR
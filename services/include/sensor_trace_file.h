@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_TRACE_FILE_H
+#define SENSOR_TRACE_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "nocopyable.h"
+
+#include "sensor_data_event.h"
+
+namespace OHOS {
+namespace Sensors {
+constexpr uint32_t SENSOR_TRACE_MAGIC = 0x43525453;
+constexpr uint32_t SENSOR_TRACE_VERSION = 1;
+
+/**
+ * Trace file layout: one header followed by fixed size records in recording order. The record time is taken when
+ * the event is recorded, so the records are sorted by it and a record is found by binary search without an index.
+ */
+struct SensorTraceHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t recordSize;
+    // 0 while recording, the reader then counts the complete records in the file.
+    uint64_t recordCount;
+    // Monotonic time in ns when the recording started.
+    int64_t startTimeNs;
+};
+
+struct SensorTraceRecord {
+    // Monotonic time in ns when the event was recorded.
+    int64_t recordTimeNs;
+    int64_t timestamp;
+    int32_t sensorTypeId;
+    int32_t version;
+    int32_t option;
+    int32_t mode;
+    uint32_t dataLen;
+    uint32_t reserved;
+    uint8_t data[SENSOR_MAX_LENGTH];
+};
+
+/**
+ * Read only view of a trace file. The file is memory mapped, records are read in place without copying.
+ */
+class SensorTraceFile {
+public:
+    SensorTraceFile() = default;
+    ~SensorTraceFile();
+
+    /**
+     * @brief Map a trace file and check its header.
+     *
+     * @param path Trace file path.
+     *
+     * @return ERR_OK on success, an error code otherwise.
+     */
+    int32_t Open(const std::string &path);
+    void Close();
+    size_t GetRecordCount() const;
+    const SensorTraceRecord &GetRecord(size_t index) const;
+
+    /**
+     * @brief Find the first record at or after an offset from the start of the recording.
+     *
+     * @param offsetNs Offset in ns from the start of the recording.
+     *
+     * @return Index of the record, GetRecordCount() if the offset is past the end.
+     */
+    size_t LowerBound(int64_t offsetNs) const;
+    int64_t GetStartTimeNs() const;
+
+private:
+    DISALLOW_COPY_AND_MOVE(SensorTraceFile);
+    void *mapAddr_ { nullptr };
+    size_t mapSize_ { 0 };
+    const SensorTraceRecord *records_ { nullptr };
+    size_t recordCount_ { 0 };
+    int64_t startTimeNs_ { 0 };
+};
+
+/**
+ * @brief Build the trace record of an event.
+ *
+ * @param data Event to record.
+ * @param recordTimeNs Monotonic time in ns of the recording.
+ * @param record Receives the record.
+ */
+void ToTraceRecord(const SensorData &data, int64_t recordTimeNs, SensorTraceRecord &record);
+
+/**
+ * @brief Build the event of a trace record.
+ *
+ * @param record Record to replay.
+ * @param data Receives the event.
+ */
+void FromTraceRecord(const SensorTraceRecord &record, SensorData &data);
+} // namespace Sensors
+} // namespace OHOS
+#endif // SENSOR_TRACE_FILE_H
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_TRACE_RECORDER_H
+#define SENSOR_TRACE_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "nocopyable.h"
+#include "singleton.h"
+
+#include "sensor_trace_file.h"
+
+namespace OHOS {
+namespace Sensors {
+const std::string SENSOR_TRACE_RECORD_PATH = "/data/log/sensor/sensor_record.trace";
+
+struct SensorTraceRecordStats {
+    bool isRecording;
+    uint64_t writtenRecords;
+    uint64_t droppedRecords;
+};
+
+/**
+ * Records the events of the data thread into a trace file readable by SensorTraceFile. The data thread only appends
+ * the record to a memory buffer, full buffers are written by a writer thread. When the writer falls behind by more
+ * than a fixed number of buffers new events are dropped and counted rather than blocking the data thread.
+ */
+class SensorTraceRecorder : public Singleton<SensorTraceRecorder> {
+public:
+    SensorTraceRecorder() = default;
+    virtual ~SensorTraceRecorder();
+
+    /**
+     * @brief Start recording into a new trace file, an existing file is overwritten.
+     *
+     * @param path Trace file path.
+     *
+     * @return ERR_OK on success, an error code otherwise.
+     */
+    int32_t Start(const std::string &path);
+
+    /**
+     * @brief Stop recording, write the buffered records and complete the header.
+     *
+     * @return ERR_OK on success, an error code otherwise.
+     */
+    int32_t Stop();
+
+    /**
+     * @brief Record an event, a no-op when not recording.
+     *
+     * @param data Event to record.
+     */
+    void Record(const SensorData &data);
+    SensorTraceRecordStats GetStats();
+
+private:
+    DISALLOW_COPY_AND_MOVE(SensorTraceRecorder);
+    void WriteThread();
+    bool WriteRecords(const std::vector<SensorTraceRecord> &records);
+    std::mutex controlMutex_;
+    std::atomic_bool isRecording_ { false };
+    std::thread writeThread_;
+    int32_t fd_ { -1 };
+    // Touched by the writer thread only while recording.
+    bool writeFailed_ { false };
+    // Below are guarded by recordMutex_.
+    std::mutex recordMutex_;
+    std::condition_variable recordCondition_;
+    bool isStop_ { false };
+    std::vector<SensorTraceRecord> buffer_;
+    std::deque<std::vector<SensorTraceRecord>> pendingBuffers_;
+    std::vector<std::vector<SensorTraceRecord>> freeBuffers_;
+    std::atomic<uint64_t> writtenRecords_ { 0 };
+    std::atomic<uint64_t> droppedRecords_ { 0 };
+};
+} // namespace Sensors
+} // namespace OHOS
+#endif // SENSOR_TRACE_RECORDER_H
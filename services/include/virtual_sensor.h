@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VIRTUAL_SENSOR_H
+#define VIRTUAL_SENSOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include "sensor.h"
+#include "sensor_data_event.h"
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * Read-only view over consecutive events.
+ */
+class SensorDataSpan {
+public:
+    SensorDataSpan(const SensorData *data, size_t size) : data_(data), size_(size) {}
+    const SensorData *begin() const
+    {
+        return data_;
+    }
+    const SensorData *end() const
+    {
+        return data_ + size_;
+    }
+    size_t size() const
+    {
+        return size_;
+    }
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+    const SensorData &operator[](size_t index) const
+    {
+        return data_[index];
+    }
+
+private:
+    const SensorData *data_;
+    size_t size_;
+};
+
+struct VirtualSensorInput {
+    // A sensor reported by the HDI.
+    int32_t sensorId;
+    // Fixed sampling period of the input, or 0 to run it at the period requested for the derived sensor.
+    int64_t samplingPeriodNs;
+};
+
+struct VirtualSensorOutput {
+    // Attributes listed by GetSensorList, the sensor id is the id of the derived events.
+    Sensor sensor;
+    std::vector<VirtualSensorInput> inputs;
+};
+
+/**
+ * A plugin computing derived sensors in the service from hardware sensors. The service subscribes to the
+ * inputs while any output of the plugin is enabled and hands the input events over in batches, the derived events
+ * are reported through ReportDataCallback and reach the clients like hardware events.
+ */
+class VirtualSensor {
+public:
+    virtual ~VirtualSensor() = default;
+
+    /**
+     * @brief Declare the derived sensors the plugin provides.
+     *
+     * @param hdiSensors Sensor list reported by the HDI.
+     *
+     * @return Derived sensors, output i is addressed by bit i of the active mask in {@link Process}. An output
+     * whose id the HDI already reports or whose inputs are missing is not published.
+     */
+    virtual std::vector<VirtualSensorOutput> Init(const std::vector<Sensor> &hdiSensors) = 0;
+
+    /**
+     * @brief Consume one batch of input events, called on the data thread only.
+     *
+     * @param events Events in arrival order, events of sensors the plugin did not declare may be included.
+     * @param activeOutputs Bit i is set while output i is enabled, never 0.
+     * @param outputs Derived events are appended here.
+     */
+    virtual void Process(SensorDataSpan events, uint32_t activeOutputs, std::vector<SensorData> &outputs) = 0;
+};
+}  // namespace Sensors
+}  // namespace OHOS
+#endif // VIRTUAL_SENSOR_H
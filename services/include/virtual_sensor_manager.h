@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VIRTUAL_SENSOR_MANAGER_H
+#define VIRTUAL_SENSOR_MANAGER_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "nocopyable.h"
+#include "refbase.h"
+#include "singleton.h"
+
+#include "report_data_callback.h"
+#include "virtual_sensor.h"
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * Owns the virtual sensor plugins. Derived sensors are listed, enabled and batched like hardware sensors. While
+ * any of them is enabled the manager holds its inputs as a subscriber of its own, keyed by the service pid, so
+ * the input rates are negotiated together with the clients of the same sensors and every input is read once
+ * however many plugins and clients use it.
+ */
+class VirtualSensorManager : public Singleton<VirtualSensorManager> {
+public:
+    VirtualSensorManager() = default;
+    virtual ~VirtualSensorManager() = default;
+
+    /**
+     * @brief Create the plugins and pick the derived sensors to publish, must be called before any other method.
+     *
+     * @param hdiSensors Sensor list reported by the HDI.
+     */
+    void Init(const std::vector<Sensor> &hdiSensors);
+    std::vector<Sensor> GetVirtualSensors();
+    bool IsVirtualSensor(int32_t sensorId) const;
+    bool IsInputSensor(int32_t sensorId) const;
+    int32_t EnableSensor(int32_t sensorId);
+    int32_t DisableSensor(int32_t sensorId);
+    int32_t SetBatch(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs);
+
+    /**
+     * @brief Run the plugins over one batch of events and report the derived events, called on the data thread
+     * with ISensorHdiConnection::dataMutex_ held.
+     *
+     * @param events Input events gathered from the batch.
+     * @param dataCallback Receives the derived events.
+     * @param hdiTimeNs HDI callback time of the oldest tracked input, the derived events count their latency from it,
+     * 0 if no input is tracked.
+     *
+     * @return Number of derived events reported.
+     */
+    size_t Process(SensorDataSpan events, sptr<ReportDataCallback> dataCallback, int64_t hdiTimeNs = 0);
+
+private:
+    DISALLOW_COPY_AND_MOVE(VirtualSensorManager);
+    struct OutputState {
+        size_t plugin { 0 };
+        uint32_t index { 0 };
+        Sensor sensor;
+        std::vector<VirtualSensorInput> inputs;
+        bool enabled { false };
+        int64_t samplingPeriodNs { 0 };
+        int64_t maxReportDelayNs { 0 };
+    };
+    struct InputState {
+        bool subscribed { false };
+        int64_t samplingPeriodNs { 0 };
+        int64_t maxReportDelayNs { 0 };
+    };
+    int32_t UpdateSubscriptions();
+    int32_t Subscribe(int32_t sensorId, InputState &state, int64_t samplingPeriodNs, int64_t maxReportDelayNs);
+    int32_t Unsubscribe(int32_t sensorId, InputState &state);
+    void UpdateActiveOutputs(size_t plugin);
+
+    std::mutex managerMutex_;
+    std::vector<std::unique_ptr<VirtualSensor>> plugins_;
+    std::vector<Sensor> virtualSensors_;
+    // Fixed after Init, looked up without the lock.
+    std::unordered_map<int32_t, OutputState> outputs_;
+    std::unordered_set<int32_t> inputIds_;
+    std::map<int32_t, InputState> inputStates_;
+    // Per plugin, written under managerMutex_ and read by the data thread.
+    std::vector<std::atomic<uint32_t>> activeOutputs_;
+    // Touched by the data thread only.
+    std::vector<SensorData> derivedEvents_;
+};
+}  // namespace Sensors
+}  // namespace OHOS
+#endif // VIRTUAL_SENSOR_MANAGER_H
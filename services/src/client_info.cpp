@@ -39,7 +39,6 @@ constexpr int32_t INVALID_UID = -1;
 constexpr int32_t MIN_MAP_SIZE = 0;
 constexpr uint32_t NO_STORE_EVENT = -2;
 constexpr uint32_t MAX_SUPPORT_CHANNEL = 200;
-constexpr uint32_t MAX_DUMP_DATA_SIZE = 10;
 } // namespace
 
 std::unordered_map<std::string, std::set<int32_t>> ClientInfo::userGrantPermMap_ = {
@@ -71,31 +70,14 @@ bool ClientInfo::GetSensorState(int32_t sensorId)
 
 SensorBasicInfo ClientInfo::GetBestSensorInfo(int32_t sensorId)
 {
-    int64_t minSamplingPeriodNs = LLONG_MAX;
-    int64_t minReportDelayNs = LLONG_MAX;
-    SensorBasicInfo sensorInfo;
-    sensorInfo.SetSamplingPeriodNs(minSamplingPeriodNs);
-    sensorInfo.SetMaxReportDelayNs(minReportDelayNs);
     if (sensorId == INVALID_SENSOR_ID) {
         SEN_HILOGE("sensorId is invalid");
+        SensorBasicInfo sensorInfo;
+        sensorInfo.SetSamplingPeriodNs(LLONG_MAX);
+        sensorInfo.SetMaxReportDelayNs(LLONG_MAX);
         return sensorInfo;
     }
-
-    std::lock_guard<std::mutex> clientLock(clientMutex_);
-    auto it = clientMap_.find(sensorId);
-    if (it == clientMap_.end()) {
-        SEN_HILOGE("Can't find sensorId:%{public}d", sensorId);
-        return sensorInfo;
-    }
-    for (const auto &pidIt : it->second) {
-        int64_t curSamplingPeriodNs = pidIt.second.GetSamplingPeriodNs();
-        int64_t curReportDelayNs = pidIt.second.GetMaxReportDelayNs();
-        minSamplingPeriodNs = (curSamplingPeriodNs < minSamplingPeriodNs) ? curSamplingPeriodNs : minSamplingPeriodNs;
-        minReportDelayNs = (curReportDelayNs < minReportDelayNs) ? curReportDelayNs : minReportDelayNs;
-    }
-    sensorInfo.SetSamplingPeriodNs(minSamplingPeriodNs);
-    sensorInfo.SetMaxReportDelayNs(minReportDelayNs);
-    return sensorInfo;
+    return rateArbiter_.GetBestSensorInfo(sensorId);
 }
 
 bool ClientInfo::OnlyCurPidSensorEnabled(int32_t sensorId, int32_t pid)
@@ -237,6 +219,7 @@ bool ClientInfo::UpdateSensorInfo(int32_t sensorId, int32_t pid, const SensorBas
         return false;
     }
     std::lock_guard<std::mutex> clientLock(clientMutex_);
+    rateArbiter_.UpdateRequest(sensorId, pid, sensorInfo.GetSamplingPeriodNs(), sensorInfo.GetMaxReportDelayNs());
     auto it = clientMap_.find(sensorId);
     if (it == clientMap_.end()) {
         std::unordered_map<int32_t, SensorBasicInfo> pidMap;
@@ -265,6 +248,7 @@ void ClientInfo::RemoveSubscriber(int32_t sensorId, uint32_t pid)
     if (pidIt != it->second.end()) {
         it->second.erase(pidIt);
     }
+    rateArbiter_.RemoveRequest(sensorId, static_cast<int32_t>(pid));
 }
 
 bool ClientInfo::UpdateSensorChannel(int32_t pid, const sptr<SensorBasicDataChannel> &channel)
@@ -298,6 +282,7 @@ void ClientInfo::ClearSensorInfo(int32_t sensorId)
         return;
     }
     std::lock_guard<std::mutex> clientLock(clientMutex_);
+    rateArbiter_.RemoveSensor(sensorId);
     auto it = clientMap_.find(sensorId);
     if (it == clientMap_.end()) {
         SEN_HILOGD("sensorId not exist, no need to clear it");
@@ -325,6 +310,7 @@ void ClientInfo::ClearCurPidSensorInfo(int32_t sensorId, int32_t pid)
         return;
     }
     pidIt = it->second.erase(pidIt);
+    rateArbiter_.RemoveRequest(sensorId, pid);
     if (it->second.size() == MIN_MAP_SIZE) {
         it = clientMap_.erase(it);
     }
@@ -345,6 +331,7 @@ bool ClientInfo::DestroySensorChannel(int32_t pid)
             continue;
         }
         pidIt = it->second.erase(pidIt);
+        rateArbiter_.RemoveRequest(it->first, pid);
         if (it->second.size() != MIN_MAP_SIZE) {
             it++;
             continue;
@@ -389,11 +376,11 @@ SensorBasicInfo ClientInfo::GetCurPidSensorInfo(int32_t sensorId, int32_t pid)
     return sensorInfo;
 }
 
-uint64_t ClientInfo::ComputeBestPeriodCount(int32_t sensorId, sptr<SensorBasicDataChannel> &channel)
+bool ClientInfo::GetChannelPeriod(int32_t sensorId, sptr<SensorBasicDataChannel> &channel, ChannelPeriod &period)
 {
     if (sensorId == INVALID_SENSOR_ID || channel == nullptr) {
         SEN_HILOGE("sensorId is invalid or channel cannot be null");
-        return 0UL;
+        return false;
     }
     int32_t pid = INVALID_PID;
     {
@@ -404,14 +391,14 @@ uint64_t ClientInfo::ComputeBestPeriodCount(int32_t sensorId, sptr<SensorBasicDa
             }
         }
     }
-    int64_t bestSamplingPeriod = GetBestSensorInfo(sensorId).GetSamplingPeriodNs();
-    int64_t curSamplingPeriod = GetCurPidSensorInfo(sensorId, pid).GetSamplingPeriodNs();
-    if (bestSamplingPeriod == 0L) {
-        SEN_HILOGE("Best sensor sampling period is 0");
-        return 0UL;
+    // The sensor may run faster than the best requested period, within the hysteresis of the arbiter.
+    period.sensorPeriodNs = rateArbiter_.GetAppliedSamplingPeriod(sensorId);
+    period.clientPeriodNs = GetCurPidSensorInfo(sensorId, pid).GetSamplingPeriodNs();
+    if ((period.clientPeriodNs == LLONG_MAX) || (period.sensorPeriodNs == LLONG_MAX)) {
+        SEN_HILOGE("Channel did not subscribe to sensorId:%{public}d", sensorId);
+        return false;
     }
-    int64_t ret = curSamplingPeriod / bestSamplingPeriod;
-    return (ret <= 0L) ? 0UL : ret;
+    return true;
 }
 
 uint64_t ClientInfo::ComputeBestFifoCount(int32_t sensorId, sptr<SensorBasicDataChannel> &channel)
@@ -607,6 +594,47 @@ void ClientInfo::GetSensorChannelInfo(std::vector<SensorChannelInfo> &channelInf
     }
 }
 
+void ClientInfo::GetChannelMetrics(std::vector<ChannelMetricsSnapshot> &channelMetrics)
+{
+    std::unordered_map<int32_t, sptr<SensorBasicDataChannel>> channelMap;
+    {
+        std::lock_guard<std::mutex> channelLock(channelMutex_);
+        channelMap = channelMap_;
+    }
+    // uidMutex_ is taken before channelMutex_ elsewhere, look the uid up after releasing it.
+    for (const auto &channelIt : channelMap) {
+        if (channelIt.second == nullptr) {
+            continue;
+        }
+        ChannelMetrics &metrics = channelIt.second->GetMetrics();
+        channelMetrics.push_back({ channelIt.first, GetUidByPid(channelIt.first),
+            metrics.sentEvents.load(std::memory_order_relaxed),
+            metrics.failedEvents.load(std::memory_order_relaxed),
+            metrics.cachedEvents.load(std::memory_order_relaxed),
+            metrics.eagainCount.load(std::memory_order_relaxed) });
+    }
+}
+
+void ClientInfo::GetDeliveryStats(std::vector<DeliverySnapshot> &deliveries)
+{
+    std::unordered_map<int32_t, sptr<SensorBasicDataChannel>> channelMap;
+    {
+        std::lock_guard<std::mutex> channelLock(channelMutex_);
+        channelMap = channelMap_;
+    }
+    for (const auto &channelIt : channelMap) {
+        if (channelIt.second == nullptr) {
+            continue;
+        }
+        std::unordered_map<int32_t, DeliveryStats> deliveryStats;
+        channelIt.second->GetDeliveryStats(deliveryStats);
+        for (const auto &statsIt : deliveryStats) {
+            int64_t requestedPeriodNs = GetCurPidSensorInfo(statsIt.first, channelIt.first).GetSamplingPeriodNs();
+            deliveries.push_back({ statsIt.first, channelIt.first, requestedPeriodNs, statsIt.second });
+        }
+    }
+}
+
 int32_t ClientInfo::GetUidByPid(int32_t pid)
 {
     std::lock_guard<std::mutex> uidLock(uidMutex_);
@@ -676,31 +704,31 @@ void ClientInfo::UpdateDataQueue(int32_t sensorId, SensorData &data)
     if (sensorId == SENSOR_TYPE_ID_HEART_RATE) {
         return;
     }
-    std::lock_guard<std::mutex> queueLock(dataQueueMutex_);
-    auto it = dumpQueue_.find(sensorId);
-    if (it == dumpQueue_.end()) {
-        std::queue<SensorData> q;
-        q.push(data);
-        dumpQueue_.insert(std::make_pair(sensorId, q));
+    DumpDataRing *dumpRing = dumpRings_.Get(sensorId);
+    if (dumpRing == nullptr) {
+        SEN_HILOGD("Dump rings are used up, sensorId:%{public}d", sensorId);
         return;
     }
-    it->second.push(data);
-    if (it->second.size() > MAX_DUMP_DATA_SIZE) {
-        it->second.pop();
-    }
+    dumpRing->Push(data);
 }
 
-std::unordered_map<int32_t, std::queue<SensorData>> ClientInfo::GetDumpQueue()
+std::unordered_map<int32_t, std::vector<SensorData>> ClientInfo::GetDumpData()
 {
-    return dumpQueue_;
+    std::unordered_map<int32_t, std::vector<SensorData>> dumpData;
+    dumpRings_.ForEach([&dumpData](int32_t sensorId, const DumpDataRing &dumpRing) {
+        std::vector<SensorData> events;
+        if (dumpRing.Read(events) && !events.empty()) {
+            dumpData.emplace(sensorId, std::move(events));
+        }
+    });
+    return dumpData;
 }
 
 void ClientInfo::ClearDataQueue(int32_t sensorId)
 {
-    std::lock_guard<std::mutex> queueLock(dataQueueMutex_);
-    auto it = dumpQueue_.find(sensorId);
-    if (it != dumpQueue_.end()) {
-        dumpQueue_.erase(it);
+    DumpDataRing *dumpRing = dumpRings_.Find(sensorId);
+    if (dumpRing != nullptr) {
+        dumpRing->Clear();
     }
 }
 
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dump_data_ring.h"
+
+#include <algorithm>
+
+#include "sensor_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "DumpDataRing"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+namespace {
+constexpr int32_t MAX_READ_RETRY_TIMES = 100;
+} // namespace
+
+void DumpDataRing::Push(const SensorData &data)
+{
+    uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    uint64_t writeCount = writeCount_.load(std::memory_order_relaxed);
+    events_[writeCount % MAX_DUMP_DATA_SIZE] = data;
+    writeCount_.store(writeCount + 1, std::memory_order_relaxed);
+    sequence_.store(sequence + 2, std::memory_order_release);
+}
+
+void DumpDataRing::Clear()
+{
+    clearCount_.store(writeCount_.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+bool DumpDataRing::Read(std::vector<SensorData> &events) const
+{
+    std::array<SensorData, MAX_DUMP_DATA_SIZE> copy;
+    for (int32_t i = 0; i < MAX_READ_RETRY_TIMES; ++i) {
+        uint32_t sequence = sequence_.load(std::memory_order_acquire);
+        if ((sequence & 1) != 0) {
+            continue;
+        }
+        uint64_t writeCount = writeCount_.load(std::memory_order_relaxed);
+        copy = events_;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence_.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        uint64_t firstCount = std::max(clearCount_.load(std::memory_order_acquire),
+            (writeCount > MAX_DUMP_DATA_SIZE) ? (writeCount - MAX_DUMP_DATA_SIZE) : 0);
+        events.clear();
+        for (uint64_t count = firstCount; count < writeCount; ++count) {
+            events.push_back(copy[count % MAX_DUMP_DATA_SIZE]);
+        }
+        return true;
+    }
+    SEN_HILOGW("Dump data keeps changing, skip it");
+    events.clear();
+    return false;
+}
+} // namespace Sensors
+} // namespace OHOS
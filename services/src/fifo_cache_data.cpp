@@ -17,7 +17,7 @@
 namespace OHOS {
 namespace Sensors {
 
-FifoCacheData::FifoCacheData() : periodCount_(0), channel_(nullptr)
+FifoCacheData::FifoCacheData() : nextDueNs_(0), channel_(nullptr)
 {}
 
 FifoCacheData::~FifoCacheData()
@@ -27,18 +27,17 @@ FifoCacheData::~FifoCacheData()
 
 void FifoCacheData::InitFifoCache()
 {
-    periodCount_ = 0;
     fifoCacheData_.clear();
 }
 
-void FifoCacheData::SetPeriodCount(uint64_t periodCount)
+void FifoCacheData::SetNextDueTimestamp(int64_t nextDueNs)
 {
-    periodCount_ = periodCount;
+    nextDueNs_ = nextDueNs;
 }
 
-uint64_t FifoCacheData::GetPeriodCount() const
+int64_t FifoCacheData::GetNextDueTimestamp() const
 {
-    return periodCount_;
+    return nextDueNs_;
 }
 
 void FifoCacheData::SetFifoCacheData(const std::vector<SensorData> &fifoCacheData)
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fusion_sensor.h"
+
+#include <algorithm>
+#include <array>
+
+#include "sensor_agent_type.h"
+
+namespace OHOS {
+namespace Sensors {
+namespace {
+enum : uint32_t {
+    OUTPUT_ROTATION_VECTOR = 0,
+    OUTPUT_GAME_ROTATION_VECTOR = 1,
+    OUTPUT_GRAVITY = 2,
+    OUTPUT_LINEAR_ACCELERATION = 3,
+};
+
+constexpr uint32_t Bit(uint32_t index)
+{
+    return 1u << index;
+}
+
+struct FusionOutput {
+    int32_t sensorId;
+    bool useMagnetometer;
+    const char *sensorName;
+    float maxRange;
+};
+
+constexpr float GRAVITY_RANGE = 19.6133f;
+// Same order as the OUTPUT_ enumeration. A maximum range of 0 takes the range of the accelerometer.
+constexpr std::array<FusionOutput, 4> FUSION_OUTPUTS = {{
+    { SENSOR_TYPE_ID_ROTATION_VECTOR, true, "sensor_fusion_rotation_vector", 1.0f },
+    { SENSOR_TYPE_ID_GAME_ROTATION_VECTOR, false, "sensor_fusion_game_rotation_vector", 1.0f },
+    { SENSOR_TYPE_ID_GRAVITY, false, "sensor_fusion_gravity", GRAVITY_RANGE },
+    { SENSOR_TYPE_ID_LINEAR_ACCELERATION, false, "sensor_fusion_linear_acceleration", 0.0f },
+}};
+// Outputs served by the filter without magnetometer.
+constexpr uint32_t GAME_FILTER_OUTPUTS = Bit(OUTPUT_GAME_ROTATION_VECTOR) | Bit(OUTPUT_GRAVITY) |
+    Bit(OUTPUT_LINEAR_ACCELERATION);
+const std::string VENDOR_NAME = "default_fusion";
+const std::string VERSION_NAME = "1.0.0";
+constexpr float RESOLUTION = 0.000001f;
+constexpr size_t VECTOR_LENGTH = 3;
+
+const Sensor *FindSensor(const std::vector<Sensor> &sensors, int32_t sensorId)
+{
+    auto it = std::find_if(sensors.begin(), sensors.end(),
+        [sensorId](const Sensor &sensor) { return sensor.GetSensorId() == sensorId; });
+    return (it == sensors.end()) ? nullptr : &(*it);
+}
+
+template<size_t N>
+void AppendEvent(std::vector<SensorData> &outputs, const SensorData &source, int32_t sensorId,
+    const std::array<float, N> &values)
+{
+    static_assert(sizeof(values) <= SENSOR_MAX_LENGTH, "Derived data exceeds the event payload");
+    SensorData event = {};
+    event.sensorTypeId = sensorId;
+    event.version = source.version;
+    event.timestamp = source.timestamp;
+    event.option = source.option;
+    event.mode = SENSOR_REALTIME_MODE;
+    event.dataLen = sizeof(values);
+    std::copy(values.begin(), values.end(), reinterpret_cast<float *>(event.data));
+    outputs.push_back(event);
+}
+}  // namespace
+
+std::vector<VirtualSensorOutput> FusionSensor::Init(const std::vector<Sensor> &hdiSensors)
+{
+    const Sensor *acc = FindSensor(hdiSensors, SENSOR_TYPE_ID_ACCELEROMETER);
+    const Sensor *gyro = FindSensor(hdiSensors, SENSOR_TYPE_ID_GYROSCOPE);
+    const Sensor *mag = FindSensor(hdiSensors, SENSOR_TYPE_ID_MAGNETIC_FIELD);
+    std::vector<VirtualSensorOutput> outputs;
+    for (const auto &fusionOutput : FUSION_OUTPUTS) {
+        VirtualSensorOutput output;
+        // All inputs run at the rate of the derived sensor.
+        output.inputs = { { SENSOR_TYPE_ID_ACCELEROMETER, 0 }, { SENSOR_TYPE_ID_GYROSCOPE, 0 } };
+        std::vector<const Sensor *> inputSensors = { acc, gyro };
+        if (fusionOutput.useMagnetometer) {
+            output.inputs.push_back({ SENSOR_TYPE_ID_MAGNETIC_FIELD, 0 });
+            inputSensors.push_back(mag);
+        }
+        float power = 0.0f;
+        int64_t minSamplePeriodNs = 0;
+        int64_t maxSamplePeriodNs = 0;
+        for (const Sensor *input : inputSensors) {
+            if (input == nullptr) {
+                continue;
+            }
+            // The slowest input bounds the rate of the derived sensor.
+            power += input->GetPower();
+            minSamplePeriodNs = std::max(minSamplePeriodNs, input->GetMinSamplePeriodNs());
+            int64_t inputMaxPeriodNs = input->GetMaxSamplePeriodNs();
+            if ((inputMaxPeriodNs != 0) && ((maxSamplePeriodNs == 0) || (inputMaxPeriodNs < maxSamplePeriodNs))) {
+                maxSamplePeriodNs = inputMaxPeriodNs;
+            }
+        }
+        float maxRange = fusionOutput.maxRange;
+        if ((maxRange == 0.0f) && (acc != nullptr)) {
+            maxRange = acc->GetMaxRange();
+        }
+        Sensor &sensor = output.sensor;
+        sensor.SetSensorId(fusionOutput.sensorId);
+        sensor.SetSensorTypeId(fusionOutput.sensorId);
+        sensor.SetFirmwareVersion(VERSION_NAME);
+        sensor.SetHardwareVersion(VERSION_NAME);
+        sensor.SetMaxRange(maxRange);
+        sensor.SetSensorName(fusionOutput.sensorName);
+        sensor.SetVendorName(VENDOR_NAME);
+        sensor.SetResolution(RESOLUTION);
+        sensor.SetPower(power);
+        sensor.SetMinSamplePeriodNs(minSamplePeriodNs);
+        sensor.SetMaxSamplePeriodNs(maxSamplePeriodNs);
+        outputs.push_back(output);
+    }
+    return outputs;
+}
+
+void FusionSensor::Process(SensorDataSpan events, uint32_t activeOutputs, std::vector<SensorData> &outputs)
+{
+    if (((activeOutputs & Bit(OUTPUT_ROTATION_VECTOR)) != 0) &&
+        ((activeOutputs_ & Bit(OUTPUT_ROTATION_VECTOR)) == 0)) {
+        filter_.Reset();
+    }
+    if (((activeOutputs & GAME_FILTER_OUTPUTS) != 0) && ((activeOutputs_ & GAME_FILTER_OUTPUTS) == 0)) {
+        gameFilter_.Reset();
+    }
+    activeOutputs_ = activeOutputs;
+    for (const auto &event : events) {
+        ProcessEvent(event, activeOutputs, outputs);
+    }
+}
+
+void FusionSensor::ProcessEvent(const SensorData &data, uint32_t activeOutputs, std::vector<SensorData> &outputs)
+{
+    if (data.dataLen < VECTOR_LENGTH * sizeof(float)) {
+        return;
+    }
+    auto values = reinterpret_cast<const float *>(data.data);
+    OrientationFilter::Vector3 sample = { values[0], values[1], values[2] };
+    switch (data.sensorTypeId) {
+        case SENSOR_TYPE_ID_ACCELEROMETER: {
+            filter_.SetAccelerometer(sample);
+            gameFilter_.SetAccelerometer(sample);
+            return;
+        }
+        case SENSOR_TYPE_ID_MAGNETIC_FIELD: {
+            filter_.SetMagnetometer(sample);
+            return;
+        }
+        case SENSOR_TYPE_ID_GYROSCOPE: {
+            break;
+        }
+        default: {
+            return;
+        }
+    }
+    if (((activeOutputs & Bit(OUTPUT_ROTATION_VECTOR)) != 0) && filter_.Update(sample, data.timestamp)) {
+        AppendEvent(outputs, data, SENSOR_TYPE_ID_ROTATION_VECTOR, filter_.GetQuaternion());
+    }
+    if (((activeOutputs & GAME_FILTER_OUTPUTS) == 0) || !gameFilter_.Update(sample, data.timestamp)) {
+        return;
+    }
+    if ((activeOutputs & Bit(OUTPUT_GAME_ROTATION_VECTOR)) != 0) {
+        AppendEvent(outputs, data, SENSOR_TYPE_ID_GAME_ROTATION_VECTOR, gameFilter_.GetQuaternion());
+    }
+    if ((activeOutputs & Bit(OUTPUT_GRAVITY)) != 0) {
+        AppendEvent(outputs, data, SENSOR_TYPE_ID_GRAVITY, gameFilter_.GetGravity());
+    }
+    if ((activeOutputs & Bit(OUTPUT_LINEAR_ACCELERATION)) != 0) {
+        AppendEvent(outputs, data, SENSOR_TYPE_ID_LINEAR_ACCELERATION, gameFilter_.GetLinearAcceleration());
+    }
+}
+}  // namespace Sensors
+}  // namespace OHOS
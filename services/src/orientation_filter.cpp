@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orientation_filter.h"
+
+#include <cmath>
+
+namespace OHOS {
+namespace Sensors {
+namespace {
+constexpr float GRAVITY_EARTH = 9.80665f;
+// Proportional gain of the attitude correction, in rad/s per unit of direction error.
+constexpr float CORRECTION_GAIN = 0.5f;
+constexpr float HALF = 0.5f;
+constexpr float QUARTER = 0.25f;
+constexpr float EPSILON = 1e-6f;
+// Below this the reference axis is too close to gravity to define a heading.
+constexpr float MIN_HEADING_NORM = 0.1f;
+constexpr float NS_PER_SECOND = 1e9f;
+// Longer gyroscope gaps restart the integration instead of extrapolating a stale rate.
+constexpr int64_t MAX_INTEGRATION_STEP_NS = 200000000;
+enum {
+    W = 0,
+    X = 1,
+    Y = 2,
+    Z = 3,
+};
+
+using Vector3 = OrientationFilter::Vector3;
+
+Vector3 Cross(const Vector3 &a, const Vector3 &b)
+{
+    return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+float Norm(const Vector3 &v)
+{
+    return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+}
+
+bool Normalize(Vector3 &v)
+{
+    float norm = Norm(v);
+    if (norm < EPSILON) {
+        return false;
+    }
+    for (auto &value : v) {
+        value /= norm;
+    }
+    return true;
+}
+}  // namespace
+
+OrientationFilter::OrientationFilter(bool useMagnetometer) : useMagnetometer_(useMagnetometer) {}
+
+void OrientationFilter::Reset()
+{
+    initialized_ = false;
+    hasAcc_ = false;
+    hasMag_ = false;
+    lastTimestamp_ = 0;
+    q_ = { 1.0f, 0.0f, 0.0f, 0.0f };
+}
+
+void OrientationFilter::SetAccelerometer(const Vector3 &acc)
+{
+    acc_ = acc;
+    hasAcc_ = true;
+}
+
+void OrientationFilter::SetMagnetometer(const Vector3 &mag)
+{
+    if (!useMagnetometer_) {
+        return;
+    }
+    mag_ = mag;
+    hasMag_ = true;
+}
+
+bool OrientationFilter::Update(const Vector3 &gyro, int64_t timestamp)
+{
+    if (!initialized_ && !Initialize()) {
+        return false;
+    }
+    int64_t step = timestamp - lastTimestamp_;
+    lastTimestamp_ = timestamp;
+    if ((step > 0) && (step <= MAX_INTEGRATION_STEP_NS)) {
+        Integrate(gyro, static_cast<float>(step) / NS_PER_SECOND);
+    }
+    return true;
+}
+
+// Seed the attitude from gravity and, if used, the magnetic field so that the filter does not have to converge
+// from an arbitrary start. Without a magnetometer the device y axis defines north.
+bool OrientationFilter::Initialize()
+{
+    if (!hasAcc_ || (useMagnetometer_ && !hasMag_)) {
+        return false;
+    }
+    Vector3 up = acc_;
+    if (!Normalize(up)) {
+        return false;
+    }
+    Vector3 east = Cross(useMagnetometer_ ? mag_ : Vector3 { 0.0f, 1.0f, 0.0f }, up);
+    if (!useMagnetometer_ && (Norm(east) < MIN_HEADING_NORM)) {
+        east = Cross(Vector3 { 1.0f, 0.0f, 0.0f }, up);
+    }
+    if (!Normalize(east)) {
+        return false;
+    }
+    Vector3 north = Cross(up, east);
+    // Rows east, north, up: the matrix rotating device coordinates into the world frame.
+    float r[3][3] = {
+        { east[0], east[1], east[2] },
+        { north[0], north[1], north[2] },
+        { up[0], up[1], up[2] },
+    };
+    float trace = r[0][0] + r[1][1] + r[2][2];
+    if (trace > 0.0f) {
+        float s = std::sqrt(trace + 1.0f) * 2.0f;
+        q_ = { QUARTER * s, (r[2][1] - r[1][2]) / s, (r[0][2] - r[2][0]) / s, (r[1][0] - r[0][1]) / s };
+    } else if ((r[0][0] > r[1][1]) && (r[0][0] > r[2][2])) {
+        float s = std::sqrt(1.0f + r[0][0] - r[1][1] - r[2][2]) * 2.0f;
+        q_ = { (r[2][1] - r[1][2]) / s, QUARTER * s, (r[0][1] + r[1][0]) / s, (r[0][2] + r[2][0]) / s };
+    } else if (r[1][1] > r[2][2]) {
+        float s = std::sqrt(1.0f + r[1][1] - r[0][0] - r[2][2]) * 2.0f;
+        q_ = { (r[0][2] - r[2][0]) / s, (r[0][1] + r[1][0]) / s, QUARTER * s, (r[1][2] + r[2][1]) / s };
+    } else {
+        float s = std::sqrt(1.0f + r[2][2] - r[0][0] - r[1][1]) * 2.0f;
+        q_ = { (r[1][0] - r[0][1]) / s, (r[0][2] + r[2][0]) / s, (r[1][2] + r[2][1]) / s, QUARTER * s };
+    }
+    lastTimestamp_ = 0;
+    initialized_ = true;
+    return true;
+}
+
+void OrientationFilter::Integrate(const Vector3 &gyro, float dt)
+{
+    Vector3 rate = gyro;
+    Vector3 acc = acc_;
+    if (hasAcc_ && Normalize(acc)) {
+        // The accelerometer measures the reaction to gravity, which points up.
+        Vector3 error = Cross(acc, RotateToDevice({ 0.0f, 0.0f, 1.0f }));
+        Vector3 mag = mag_;
+        if (hasMag_ && Normalize(mag)) {
+            // Keep only the inclination of the measured field, the heading is what the correction is after.
+            Vector3 field = RotateToWorld(mag);
+            Vector3 reference = { 0.0f, std::sqrt(field[0] * field[0] + field[1] * field[1]), field[2] };
+            Vector3 magError = Cross(mag, RotateToDevice(reference));
+            for (size_t i = 0; i < error.size(); ++i) {
+                error[i] += magError[i];
+            }
+        }
+        for (size_t i = 0; i < rate.size(); ++i) {
+            rate[i] += CORRECTION_GAIN * error[i];
+        }
+    }
+    float halfDt = HALF * dt;
+    float w = q_[W];
+    float x = q_[X];
+    float y = q_[Y];
+    float z = q_[Z];
+    q_[W] += (-x * rate[0] - y * rate[1] - z * rate[2]) * halfDt;
+    q_[X] += (w * rate[0] + y * rate[2] - z * rate[1]) * halfDt;
+    q_[Y] += (w * rate[1] - x * rate[2] + z * rate[0]) * halfDt;
+    q_[Z] += (w * rate[2] + x * rate[1] - y * rate[0]) * halfDt;
+    float norm = std::sqrt(q_[W] * q_[W] + q_[X] * q_[X] + q_[Y] * q_[Y] + q_[Z] * q_[Z]);
+    if (norm < EPSILON) {
+        Reset();
+        return;
+    }
+    for (auto &value : q_) {
+        value /= norm;
+    }
+}
+
+OrientationFilter::Vector3 OrientationFilter::RotateToWorld(const Vector3 &v) const
+{
+    float w = q_[W];
+    float x = q_[X];
+    float y = q_[Y];
+    float z = q_[Z];
+    return {
+        (1.0f - 2.0f * (y * y + z * z)) * v[0] + 2.0f * (x * y - w * z) * v[1] + 2.0f * (x * z + w * y) * v[2],
+        2.0f * (x * y + w * z) * v[0] + (1.0f - 2.0f * (x * x + z * z)) * v[1] + 2.0f * (y * z - w * x) * v[2],
+        2.0f * (x * z - w * y) * v[0] + 2.0f * (y * z + w * x) * v[1] + (1.0f - 2.0f * (x * x + y * y)) * v[2],
+    };
+}
+
+OrientationFilter::Vector3 OrientationFilter::RotateToDevice(const Vector3 &v) const
+{
+    float w = q_[W];
+    float x = q_[X];
+    float y = q_[Y];
+    float z = q_[Z];
+    return {
+        (1.0f - 2.0f * (y * y + z * z)) * v[0] + 2.0f * (x * y + w * z) * v[1] + 2.0f * (x * z - w * y) * v[2],
+        2.0f * (x * y - w * z) * v[0] + (1.0f - 2.0f * (x * x + z * z)) * v[1] + 2.0f * (y * z + w * x) * v[2],
+        2.0f * (x * z + w * y) * v[0] + 2.0f * (y * z - w * x) * v[1] + (1.0f - 2.0f * (x * x + y * y)) * v[2],
+    };
+}
+
+OrientationFilter::Quaternion OrientationFilter::GetQuaternion() const
+{
+    float sign = (q_[W] < 0.0f) ? -1.0f : 1.0f;
+    return { sign * q_[X], sign * q_[Y], sign * q_[Z], sign * q_[W] };
+}
+
+OrientationFilter::Vector3 OrientationFilter::GetGravity() const
+{
+    return RotateToDevice({ 0.0f, 0.0f, GRAVITY_EARTH });
+}
+
+OrientationFilter::Vector3 OrientationFilter::GetLinearAcceleration() const
+{
+    Vector3 gravity = GetGravity();
+    return { acc_[0] - gravity[0], acc_[1] - gravity[1], acc_[2] - gravity[2] };
+}
+}  // namespace Sensors
+}  // namespace OHOS
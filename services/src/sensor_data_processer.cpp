@@ -15,6 +15,7 @@
 
 #include "sensor_data_processer.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <sys/prctl.h>
 #include <sys/socket.h>
@@ -25,6 +26,7 @@
 #include "securec.h"
 #include "sensor_basic_data_channel.h"
 #include "sensor_errors.h"
+#include "sensor_latency_tracker.h"
 #include "system_ability_definition.h"
 
 #undef LOG_TAG
@@ -41,6 +43,7 @@ const std::string SENSOR_REPORT_THREAD_NAME = "OS_SenProducer";
 SensorDataProcesser::SensorDataProcesser(const std::unordered_map<int32_t, Sensor> &sensorMap)
 {
     sensorMap_.insert(sensorMap.begin(), sensorMap.end());
+    virtualInputs_.reserve(CIRCULAR_BUF_LEN);
     SEN_HILOGD("sensorMap_.size:%{public}d", int32_t { sensorMap_.size() });
 }
 
@@ -50,9 +53,31 @@ SensorDataProcesser::~SensorDataProcesser()
     sensorMap_.clear();
 }
 
+bool SensorDataProcesser::IsEventDue(const sptr<FifoCacheData> &fifoCacheData, const SensorData &data,
+                                     const ChannelPeriod &period)
+{
+    // The event closest to the due time is forwarded, so a sensor jittering by less than half its period loses none.
+    int64_t halfSensorPeriodNs = std::max<int64_t>(period.sensorPeriodNs, 0) / 2;
+    int64_t nextDueNs = fifoCacheData->GetNextDueTimestamp();
+    int64_t earlyNs = nextDueNs - data.timestamp;
+    // An event earlier than a whole client period means the timestamps restarted.
+    bool isRestarted = (earlyNs > period.clientPeriodNs);
+    if ((earlyNs > halfSensorPeriodNs) && !isRestarted) {
+        return false;
+    }
+    // Due times advance by the client period, so the average rate does not depend on the rate of the sensor.
+    nextDueNs += period.clientPeriodNs;
+    // The first event, a gap or a slower sensor: restart from this event instead of catching up in a burst.
+    if (isRestarted || ((nextDueNs - data.timestamp) <= halfSensorPeriodNs)) {
+        nextDueNs = data.timestamp + period.clientPeriodNs;
+    }
+    fifoCacheData->SetNextDueTimestamp(nextDueNs);
+    return true;
+}
+
 void SensorDataProcesser::SendNoneFifoCacheData(std::unordered_map<int32_t, SensorData> &cacheBuf,
                                                 sptr<SensorBasicDataChannel> &channel, SensorData &data,
-                                                uint64_t periodCount)
+                                                const ChannelPeriod &period)
 {
     std::vector<SensorData> sendEvents;
     std::lock_guard<std::mutex> dataCountLock(dataCountMutex_);
@@ -65,6 +90,7 @@ void SensorDataProcesser::SendNoneFifoCacheData(std::unordered_map<int32_t, Sens
         fifoCacheData->SetChannel(channel);
         channelFifoList.push_back(fifoCacheData);
         dataCountMap_.insert(std::make_pair(data.sensorTypeId, channelFifoList));
+        (void)IsEventDue(fifoCacheData, data, period);
         SendRawData(cacheBuf, channel, sendEvents);
         return;
     }
@@ -82,14 +108,10 @@ void SensorDataProcesser::SendNoneFifoCacheData(std::unordered_map<int32_t, Sens
             continue;
         }
         channelExist = true;
-        uint64_t curCount = fifoCacheData->GetPeriodCount();
-        curCount++;
-        fifoCacheData->SetPeriodCount(curCount);
-        if (periodCount != 0 && fifoCacheData->GetPeriodCount() % periodCount != 0UL) {
+        if (!IsEventDue(fifoCacheData, data, period)) {
             continue;
         }
         SendRawData(cacheBuf, channel, sendEvents);
-        fifoCacheData->SetPeriodCount(0);
         return;
     }
     if (!channelExist) {
@@ -97,13 +119,14 @@ void SensorDataProcesser::SendNoneFifoCacheData(std::unordered_map<int32_t, Sens
         CHKPV(fifoCacheData);
         fifoCacheData->SetChannel(channel);
         dataCountIt->second.push_back(fifoCacheData);
+        (void)IsEventDue(fifoCacheData, data, period);
         SendRawData(cacheBuf, channel, sendEvents);
     }
 }
 
 void SensorDataProcesser::SendFifoCacheData(std::unordered_map<int32_t, SensorData> &cacheBuf,
                                             sptr<SensorBasicDataChannel> &channel, SensorData &data,
-                                            uint64_t periodCount, uint64_t fifoCount)
+                                            const ChannelPeriod &period, uint64_t fifoCount)
 {
     std::lock_guard<std::mutex> dataCountLock(dataCountMutex_);
     auto dataCountIt = dataCountMap_.find(data.sensorTypeId);
@@ -132,13 +155,9 @@ void SensorDataProcesser::SendFifoCacheData(std::unordered_map<int32_t, SensorDa
             continue;
         }
         channelExist = true;
-        uint64_t curCount = fifoData->GetPeriodCount();
-        curCount++;
-        fifoData->SetPeriodCount(curCount);
-        if (fifoData->GetPeriodCount() % periodCount != 0UL) {
+        if (!IsEventDue(fifoData, data, period)) {
             continue;
         }
-        fifoData->SetPeriodCount(0);
         std::vector<SensorData> fifoDataList = fifoData->GetFifoCacheData();
         fifoDataList.push_back(data);
         fifoData->SetFifoCacheData(fifoDataList);
@@ -166,16 +185,16 @@ void SensorDataProcesser::ReportData(sptr<SensorBasicDataChannel> &channel, Sens
     if (ReportNotContinuousData(cacheBuf, channel, data)) {
         return;
     }
-    uint64_t periodCount = clientInfo_.ComputeBestPeriodCount(sensorId, channel);
-    if (periodCount == 0UL) {
+    ChannelPeriod period;
+    if (!clientInfo_.GetChannelPeriod(sensorId, channel, period)) {
         return;
     }
     auto fifoCount = clientInfo_.ComputeBestFifoCount(sensorId, channel);
     if (fifoCount <= 1) {
-        SendNoneFifoCacheData(cacheBuf, channel, data, periodCount);
+        SendNoneFifoCacheData(cacheBuf, channel, data, period);
         return;
     }
-    SendFifoCacheData(cacheBuf, channel, data, periodCount, fifoCount);
+    SendFifoCacheData(cacheBuf, channel, data, period, fifoCount);
 }
 
 bool SensorDataProcesser::ReportNotContinuousData(std::unordered_map<int32_t, SensorData> &cacheBuf,
@@ -207,13 +226,19 @@ void SensorDataProcesser::SendRawData(std::unordered_map<int32_t, SensorData> &c
         return;
     }
     size_t eventSize = events.size();
+    int64_t sendTimeNs = SensorLatencyTracker::GetMonotonicTimeNs();
     auto ret = channel->SendData(events.data(), eventSize * sizeof(SensorData));
+    int32_t sensorId = events[eventSize - 1].sensorTypeId;
     if (ret != ERR_OK) {
         SEN_HILOGE("Send data failed, ret:%{public}d, sensorId:%{public}d, timestamp:%{public}" PRId64,
-            ret, events[eventSize - 1].sensorTypeId, events[eventSize - 1].timestamp);
-        int32_t sensorId = events[eventSize - 1].sensorTypeId;
+            ret, sensorId, events[eventSize - 1].timestamp);
         cacheBuf[sensorId] = events[eventSize - 1];
+        channel->GetMetrics().cachedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
     }
+    channel->RecordDelivery(sensorId, eventSize, sendTimeNs);
+    latencyTracker_.RecordSend(sensorId, dispatchHdiTimeNs_, sendTimeNs);
+    metrics_.AddEventOut(sensorId, eventSize);
 }
 
 int32_t SensorDataProcesser::CacheSensorEvent(const SensorData &data, sptr<SensorBasicDataChannel> &channel)
@@ -230,37 +255,83 @@ int32_t SensorDataProcesser::CacheSensorEvent(const SensorData &data, sptr<Senso
         if (ret != ERR_OK) {
             SEN_HILOGE("retry send cache data failed, ret:%{public}d, sensorId:%{public}d, timestamp:%{public}" PRId64,
                 ret, cacheData.sensorTypeId, cacheData.timestamp);
+        } else {
+            channel->RecordDelivery(sensorId, 1, SensorLatencyTracker::GetMonotonicTimeNs());
         }
+        int64_t sendTimeNs = SensorLatencyTracker::GetMonotonicTimeNs();
         ret = channel->SendData(&data, sizeof(SensorData));
         if (ret != ERR_OK) {
             SEN_HILOGE("retry send data failed, ret:%{public}d, sensorId:%{public}d, timestamp:%{public}" PRId64,
                 ret, data.sensorTypeId, data.timestamp);
             cacheBuf[sensorId] = data;
+            channel->GetMetrics().cachedEvents.fetch_add(1, std::memory_order_relaxed);
         } else {
             cacheBuf.erase(cacheEvent);
+            channel->RecordDelivery(sensorId, 1, sendTimeNs);
+            latencyTracker_.RecordSend(sensorId, dispatchHdiTimeNs_, sendTimeNs);
+            metrics_.AddEventOut(sensorId, 1);
         }
     } else {
+        int64_t sendTimeNs = SensorLatencyTracker::GetMonotonicTimeNs();
         ret = channel->SendData(&data, sizeof(SensorData));
         if (ret != ERR_OK) {
             SEN_HILOGE("directly retry failed, ret:%{public}d, sensorId:%{public}d, timestamp:%{public}" PRId64,
                 ret, data.sensorTypeId, data.timestamp);
             cacheBuf[sensorId] = data;
+            channel->GetMetrics().cachedEvents.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            channel->RecordDelivery(sensorId, 1, sendTimeNs);
+            latencyTracker_.RecordSend(sensorId, dispatchHdiTimeNs_, sendTimeNs);
+            metrics_.AddEventOut(sensorId, 1);
         }
     }
     return ret;
 }
 
-void SensorDataProcesser::EventFilter(CircularEventBuf &eventsBuf)
+void SensorDataProcesser::EventFilter(SensorData &data)
 {
-    int32_t sensorId = eventsBuf.circularBuf[eventsBuf.readPos].sensorTypeId;
-    std::vector<sptr<SensorBasicDataChannel>> channelList = clientInfo_.GetSensorChannel(sensorId);
+    std::vector<sptr<SensorBasicDataChannel>> channelList = clientInfo_.GetSensorChannel(data.sensorTypeId);
     for (auto &channel : channelList) {
         if (channel->GetSensorStatus()) {
-            SendEvents(channel, eventsBuf.circularBuf[eventsBuf.readPos]);
+            SendEvents(channel, data);
         }
     }
 }
 
+void SensorDataProcesser::DispatchEvents(CircularEventBuf &eventsBuf)
+{
+    virtualInputs_.clear();
+    virtualInputsHdiTimeNs_ = 0;
+    int32_t eventNum = eventsBuf.eventNum;
+    if (eventNum > 0) {
+        metrics_.AddBatch(static_cast<uint32_t>(eventNum));
+    }
+    for (int32_t i = 0; i < eventNum; i++) {
+        SensorData &data = eventsBuf.circularBuf[eventsBuf.readPos];
+        dispatchHdiTimeNs_ = latencyTracker_.RecordDispatch(data.sensorTypeId,
+            eventsBuf.latencyStamps[eventsBuf.readPos]);
+        metrics_.AddEventIn(data.sensorTypeId);
+        // Derived events are computed again on replay, only the hardware events are recorded.
+        if (!virtualSensorManager_.IsVirtualSensor(data.sensorTypeId)) {
+            traceRecorder_.Record(data);
+        }
+        EventFilter(data);
+        if (virtualSensorManager_.IsInputSensor(data.sensorTypeId)) {
+            virtualInputs_.push_back(data);
+            if ((dispatchHdiTimeNs_ > 0) && ((virtualInputsHdiTimeNs_ == 0) ||
+                (dispatchHdiTimeNs_ < virtualInputsHdiTimeNs_))) {
+                virtualInputsHdiTimeNs_ = dispatchHdiTimeNs_;
+            }
+        }
+        dispatchHdiTimeNs_ = 0;
+        eventsBuf.readPos++;
+        if (eventsBuf.readPos == CIRCULAR_BUF_LEN) {
+            eventsBuf.readPos = 0;
+        }
+        eventsBuf.eventNum--;
+    }
+}
+
 int32_t SensorDataProcesser::ProcessEvents(sptr<ReportDataCallback> dataCallback)
 {
     CHKPR(dataCallback, INVALID_POINTER);
@@ -271,16 +342,11 @@ int32_t SensorDataProcesser::ProcessEvents(sptr<ReportDataCallback> dataCallback
         SEN_HILOGE("Data cannot be empty");
         return NO_EVENT;
     }
-    int32_t eventNum = eventsBuf.eventNum;
-    for (int32_t i = 0; i < eventNum; i++) {
-        EventFilter(eventsBuf);
-
-        eventsBuf.readPos++;
-        if (eventsBuf.readPos == CIRCULAR_BUF_LEN) {
-            eventsBuf.readPos = 0;
-        }
-        eventsBuf.eventNum--;
-    }
+    // Derived events are reported into the same buffer, drain them in the same wakeup.
+    do {
+        DispatchEvents(eventsBuf);
+    } while (virtualSensorManager_.Process(SensorDataSpan(virtualInputs_.data(), virtualInputs_.size()),
+        dataCallback, virtualInputsHdiTimeNs_) > 0);
     return SUCCESS;
 }
 
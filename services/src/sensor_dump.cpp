@@ -17,14 +17,19 @@
 
 #include <getopt.h>
 
+#include <algorithm>
 #include <cinttypes>
+#include <climits>
 #include <cstring>
 #include <ctime>
-#include <queue>
+#include <unistd.h>
 
+#include "report_data_callback.h"
 #include "securec.h"
 #include "sensor_agent_type.h"
 #include "sensor_errors.h"
+#include "sensor_rate_arbiter.h"
+#include "sensor_trace_recorder.h"
 
 #undef LOG_TAG
 #define LOG_TAG "SensorDump"
@@ -34,10 +39,9 @@ namespace Sensors {
 using namespace OHOS::HiviewDFX;
 namespace {
 constexpr int32_t MAX_DUMP_PARAMETERS = 32;
-#ifdef BUILD_VARIANT_ENG
-constexpr uint32_t MAX_DUMP_DATA_SIZE = 10;
-#endif // BUILD_VARIANT_ENG
 constexpr uint32_t MS_NS = 1000000;
+constexpr double SECOND_NS = 1e9;
+constexpr double PERCENT = 100.0;
 
 enum {
     SOLITARIES_DIMENSION = 1,
@@ -49,6 +53,18 @@ enum {
     POSE_6DOF_DIMENSION = 15,
     DEFAULT_DIMENSION = 16,
 };
+
+const std::unordered_map<int32_t, std::string> LATENCY_STAGE_NAMES = {
+    { LATENCY_STAGE_ENQUEUE, "enqueue" },
+    { LATENCY_STAGE_DEQUEUE, "dequeue" },
+    { LATENCY_STAGE_SEND, "send" },
+};
+
+// A counter below its last value belongs to a new channel of a reused pid and counts from 0.
+uint64_t GetDelta(uint64_t current, uint64_t last)
+{
+    return (current >= last) ? (current - last) : current;
+}
 } // namespace
 
 std::unordered_map<int32_t, std::string> SensorDump::sensorMap_ = {
@@ -94,15 +110,22 @@ void SensorDump::RunSensorDump(int32_t fd, int32_t optionIndex, const std::vecto
         {"channel", no_argument, 0, 'c'},
 #ifdef BUILD_VARIANT_ENG
         {"data", no_argument, 0, 'd'},
+        {"record", no_argument, 0, 'r'},
+        {"stop-record", no_argument, 0, 's'},
 #endif // BUILD_VARIANT_ENG
         {"open", no_argument, 0, 'o'},
         {"help", no_argument, 0, 'h'},
         {"list", no_argument, 0, 'l'},
+        {"latency", no_argument, 0, 't'},
+        {"latency-snapshot", no_argument, 0, 'b'},
+        {"latency-on", no_argument, 0, 'e'},
+        {"latency-off", no_argument, 0, 'f'},
+        {"metrics", no_argument, 0, 'm'},
         {NULL, 0, 0, 0}
     };
     optind = 1;
     int32_t c;
-    while ((c = getopt_long(args.size(), argv, "cdohl", dumpOptions, &optionIndex)) != -1) {
+    while ((c = getopt_long(args.size(), argv, "cdohltbefmrs", dumpOptions, &optionIndex)) != -1) {
         switch (c) {
             case 'c': {
                 DumpSensorChannel(fd, clientInfo_);
@@ -113,6 +136,14 @@ void SensorDump::RunSensorDump(int32_t fd, int32_t optionIndex, const std::vecto
                 DumpSensorData(fd, clientInfo_);
                 break;
             }
+            case 'r': {
+                DumpStartRecord(fd);
+                break;
+            }
+            case 's': {
+                DumpStopRecord(fd);
+                break;
+            }
 #endif // BUILD_VARIANT_ENG
             case 'o': {
                 DumpOpeningSensor(fd, sensors_, clientInfo_);
@@ -126,6 +157,28 @@ void SensorDump::RunSensorDump(int32_t fd, int32_t optionIndex, const std::vecto
                 DumpSensorList(fd, sensors_);
                 break;
             }
+            case 't': {
+                DumpSensorLatency(fd);
+                break;
+            }
+            case 'b': {
+                DumpLatencySnapshot(fd);
+                break;
+            }
+            case 'e': {
+                SensorLatencyTracker::SetEnabled(true);
+                dprintf(fd, "Latency stamping on\n");
+                break;
+            }
+            case 'f': {
+                SensorLatencyTracker::SetEnabled(false);
+                dprintf(fd, "Latency stamping off\n");
+                break;
+            }
+            case 'm': {
+                DumpMetrics(fd, clientInfo_);
+                break;
+            }
             default: {
                 dprintf(fd, "Unrecognized option, More info with: \"hidumper -s 3601 -a -h\"\n");
                 break;
@@ -190,8 +243,16 @@ void SensorDump::DumpHelp(int32_t fd)
     dprintf(fd, "      -l, --list: dump the sensor list\n");
     dprintf(fd, "      -c, --channel: dump the sensor data channel info\n");
     dprintf(fd, "      -o, --open: dump the opening sensors\n");
+    dprintf(fd, "      -t, --latency: dump the p50/p99/max latency since the HDI callback per service stage, "
+        "send counts every channel\n");
+    dprintf(fd, "      -b, --latency-snapshot: dump the latency histograms in binary\n");
+    dprintf(fd, "      -e, --latency-on: start stamping the events for the latency histograms\n");
+    dprintf(fd, "      -f, --latency-off: stop stamping the events\n");
+    dprintf(fd, "      -m, --metrics: dump the data path counters and their rates since the last metrics dump\n");
 #ifdef BUILD_VARIANT_ENG 
     dprintf(fd, "      -d, --data: dump the last 10 packages sensor data\n");
+    dprintf(fd, "      -r, --record: start recording the sensor data to %s\n", SENSOR_TRACE_RECORD_PATH.c_str());
+    dprintf(fd, "      -s, --stop-record: stop recording the sensor data\n");
 #endif // BUILD_VARIANT_ENG
 }
 
@@ -255,7 +316,7 @@ bool SensorDump::DumpOpeningSensor(int32_t fd, const std::vector<Sensor> &sensor
 bool SensorDump::DumpSensorData(int32_t fd, ClientInfo &clientInfo)
 {
     dprintf(fd, "Last 10 packages sensor data:\n");
-    auto dataMap = clientInfo.GetDumpQueue();
+    auto dataMap = clientInfo.GetDumpData();
     int32_t j = 0;
     for (auto &sensorData : dataMap) {
         int32_t sensorId = sensorData.first;
@@ -263,9 +324,7 @@ bool SensorDump::DumpSensorData(int32_t fd, ClientInfo &clientInfo)
             continue;
         }
         dprintf(fd, "sensorId: %8u | sensorType: %s:\n", sensorId, sensorMap_[sensorId].c_str());
-        for (uint32_t i = 0; i < MAX_DUMP_DATA_SIZE && (!sensorData.second.empty()); i++) {
-            auto data = sensorData.second.front();
-            sensorData.second.pop();
+        for (auto &data : sensorData.second) {
             timespec time = { 0, 0 };
             clock_gettime(CLOCK_REALTIME, &time);
             struct tm *timeinfo = localtime(&(time.tv_sec));
@@ -277,8 +336,170 @@ bool SensorDump::DumpSensorData(int32_t fd, ClientInfo &clientInfo)
     }
     return true;
 }
+
+bool SensorDump::DumpStartRecord(int32_t fd)
+{
+    int32_t ret = SensorTraceRecorder::GetInstance().Start(SENSOR_TRACE_RECORD_PATH);
+    if (ret != ERR_OK) {
+        dprintf(fd, "Start recording failed, ret:%d\n", ret);
+        return false;
+    }
+    dprintf(fd, "Recording the sensor data to %s\n", SENSOR_TRACE_RECORD_PATH.c_str());
+    return true;
+}
+
+bool SensorDump::DumpStopRecord(int32_t fd)
+{
+    auto &recorder = SensorTraceRecorder::GetInstance();
+    int32_t ret = recorder.Stop();
+    SensorTraceRecordStats stats = recorder.GetStats();
+    dprintf(fd, "Recording stopped, ret:%d | written:%" PRIu64 " | dropped:%" PRIu64 "\n", ret,
+            stats.writtenRecords, stats.droppedRecords);
+    return ret == ERR_OK;
+}
 #endif // BUILD_VARIANT_ENG
 
+bool SensorDump::DumpSensorLatency(int32_t fd)
+{
+    DumpCurrentTime(fd);
+    dprintf(fd, "Sensor latency since the HDI callback in us:\n");
+    for (const auto &stats : latencyTracker_.GetStats()) {
+        auto sensorId = stats.sensorId;
+        auto stageName = LATENCY_STAGE_NAMES.find(stats.stage);
+        if ((sensorMap_.find(sensorId) == sensorMap_.end()) || (stageName == LATENCY_STAGE_NAMES.end())) {
+            continue;
+        }
+        dprintf(fd,
+                "sensorId:%8u | sensorType:%s | stage:%s | count:%" PRIu64 " | p50:%" PRIu64 " | p99:%" PRIu64 ""
+                " | max:%" PRIu64 "\n",
+                sensorId, sensorMap_[sensorId].c_str(), stageName->second.c_str(), stats.count, stats.p50Us,
+                stats.p99Us, stats.maxUs);
+    }
+    return true;
+}
+
+bool SensorDump::DumpLatencySnapshot(int32_t fd)
+{
+    std::vector<uint8_t> snapshot = latencyTracker_.GetSnapshot();
+    size_t written = 0;
+    while (written < snapshot.size()) {
+        ssize_t ret = write(fd, snapshot.data() + written, snapshot.size() - written);
+        if (ret <= 0) {
+            SEN_HILOGE("Write latency snapshot failed, written:%{public}zu", written);
+            return false;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool SensorDump::DumpMetrics(int32_t fd, ClientInfo &clientInfo)
+{
+    DumpCurrentTime(fd);
+    DataPathMetricsSnapshot metrics = SensorMetrics::GetInstance().GetSnapshot();
+    std::vector<ChannelMetricsSnapshot> channelMetrics;
+    clientInfo.GetChannelMetrics(channelMetrics);
+    std::vector<DeliverySnapshot> deliveries;
+    clientInfo.GetDeliveryStats(deliveries);
+    std::lock_guard<std::mutex> metricsLock(metricsMutex_);
+    // The first dump computes the rates since the service started.
+    int64_t lastTimestampNs = (lastMetrics_.timestampNs == 0) ? metrics.startTimeNs : lastMetrics_.timestampNs;
+    double interval = std::max<double>(static_cast<double>(metrics.timestampNs - lastTimestampNs), 1.0) / SECOND_NS;
+    uint64_t batchCount = GetDelta(metrics.batchCount, lastMetrics_.batchCount);
+    uint64_t batchEvents = GetDelta(metrics.batchEvents, lastMetrics_.batchEvents);
+    dprintf(fd, "Data path metrics, interval:%.3fs:\n", interval);
+    dprintf(fd,
+            "ring | enqueued:%" PRIu64 " (%.1f/s) | overwritten:%" PRIu64 " (%.1f/s) | highWater:%" PRIu64 "/%d\n",
+            metrics.enqueuedEvents, GetDelta(metrics.enqueuedEvents, lastMetrics_.enqueuedEvents) / interval,
+            metrics.overwrittenEvents, GetDelta(metrics.overwrittenEvents, lastMetrics_.overwrittenEvents) / interval,
+            metrics.ringHighWater, CIRCULAR_BUF_LEN);
+    dprintf(fd, "batch | count:%" PRIu64 " (%.1f/s) | averageSize:%.1f | maxSize:%" PRIu64 "\n",
+            metrics.batchCount, batchCount / interval,
+            (batchCount == 0) ? 0.0 : static_cast<double>(batchEvents) / batchCount, metrics.maxBatchSize);
+    dprintf(fd,
+            "hdi | deaths:%" PRIu64 " | reconnects:%" PRIu64 " | lastReconnect:%.3fms | maxReconnect:%.3fms"
+            " | lastDataGap:%.3fms | maxDataGap:%.3fms\n",
+            metrics.hdiDeathCount, metrics.hdiReconnectCount, static_cast<double>(metrics.lastReconnectNs) / MS_NS,
+            static_cast<double>(metrics.maxReconnectNs) / MS_NS, static_cast<double>(metrics.lastDataGapNs) / MS_NS,
+            static_cast<double>(metrics.maxDataGapNs) / MS_NS);
+    for (const auto &sensor : metrics.sensors) {
+        auto sensorId = sensor.sensorId;
+        if (sensorMap_.find(sensorId) == sensorMap_.end()) {
+            continue;
+        }
+        auto last = std::find_if(lastMetrics_.sensors.begin(), lastMetrics_.sensors.end(),
+            [sensorId](const SensorMetricsSnapshot &lastSensor) { return lastSensor.sensorId == sensorId; });
+        SensorMetricsSnapshot lastSensor = (last == lastMetrics_.sensors.end()) ?
+            SensorMetricsSnapshot { sensorId, 0, 0 } : *last;
+        dprintf(fd, "sensorId:%8u | sensorType:%s | in:%" PRIu64 " (%.1f/s) | out:%" PRIu64 " (%.1f/s)\n",
+                sensorId, sensorMap_[sensorId].c_str(), sensor.eventsIn,
+                GetDelta(sensor.eventsIn, lastSensor.eventsIn) / interval, sensor.eventsOut,
+                GetDelta(sensor.eventsOut, lastSensor.eventsOut) / interval);
+    }
+    std::vector<SensorRateSnapshot> rateSnapshots;
+    SensorRateArbiter::GetInstance().GetRateSnapshots(rateSnapshots);
+    for (const auto &rate : rateSnapshots) {
+        if (sensorMap_.find(rate.sensorId) == sensorMap_.end()) {
+            continue;
+        }
+        dprintf(fd,
+                "rate | sensorId:%8u | sensorType:%s | subscribers:%zu | period:%" PRId64 "ns | delay:%" PRId64 "ns"
+                " | reconfigs:%" PRIu64 " | skipped:%" PRIu64 "\n",
+                rate.sensorId, sensorMap_[rate.sensorId].c_str(), rate.requestCount,
+                rate.isApplied ? rate.appliedSamplingPeriodNs : 0, rate.isApplied ? rate.appliedReportDelayNs : 0,
+                rate.reconfigCount, rate.skippedCount);
+    }
+    DumpDeliveries(fd, deliveries);
+    std::unordered_map<int32_t, ChannelMetricsSnapshot> lastChannelMetrics;
+    for (const auto &channel : channelMetrics) {
+        auto last = lastChannelMetrics_.find(channel.pid);
+        ChannelMetricsSnapshot lastChannel = (last == lastChannelMetrics_.end()) ?
+            ChannelMetricsSnapshot { channel.pid, channel.uid, 0, 0, 0, 0 } : last->second;
+        dprintf(fd,
+                "pid:%d | uid:%d | sent:%" PRIu64 " (%.1f/s) | failed:%" PRIu64 " (%.1f/s) | cached:%" PRIu64 ""
+                " | eagain:%" PRIu64 "\n",
+                channel.pid, channel.uid, channel.sentEvents,
+                GetDelta(channel.sentEvents, lastChannel.sentEvents) / interval, channel.failedEvents,
+                GetDelta(channel.failedEvents, lastChannel.failedEvents) / interval, channel.cachedEvents,
+                channel.eagainCount);
+        lastChannelMetrics.emplace(channel.pid, channel);
+    }
+    lastMetrics_ = std::move(metrics);
+    lastChannelMetrics_ = std::move(lastChannelMetrics);
+    return true;
+}
+
+void SensorDump::DumpDeliveries(int32_t fd, const std::vector<DeliverySnapshot> &deliveries)
+{
+    std::map<std::pair<int32_t, int32_t>, DeliveryStats> lastDeliveries;
+    for (const auto &delivery : deliveries) {
+        const DeliveryStats &stats = delivery.stats;
+        auto key = std::make_pair(delivery.pid, delivery.sensorId);
+        lastDeliveries.emplace(key, stats);
+        if ((sensorMap_.find(delivery.sensorId) == sensorMap_.end()) || (delivery.requestedPeriodNs <= 0) ||
+            (delivery.requestedPeriodNs == LLONG_MAX)) {
+            continue;
+        }
+        // Measured from the send times since the last dump, or since the first send of a new channel.
+        auto last = lastDeliveries_.find(key);
+        bool hasLast = (last != lastDeliveries_.end()) && (last->second.eventCount <= stats.eventCount);
+        uint64_t eventCount = hasLast ? (stats.eventCount - last->second.eventCount) : (stats.eventCount - 1);
+        int64_t startNs = hasLast ? last->second.lastSendNs : stats.firstSendNs;
+        if (eventCount == 0) {
+            continue;
+        }
+        double deliveredPeriodNs = static_cast<double>(stats.lastSendNs - startNs) / eventCount;
+        // Positive when the subscriber gets events less often than requested.
+        double error = (deliveredPeriodNs - delivery.requestedPeriodNs) * PERCENT / delivery.requestedPeriodNs;
+        int64_t minSpacingNs = (stats.minSpacingNs == LLONG_MAX) ? 0 : stats.minSpacingNs;
+        dprintf(fd, "accuracy | sensorId:%8u | pid:%d | events:%" PRIu64 " | requested:%.3fms | delivered:%.3fms"
+                " | error:%+.1f%% | spacing:%.3f-%.3fms\n", delivery.sensorId, delivery.pid, eventCount,
+                static_cast<double>(delivery.requestedPeriodNs) / MS_NS, deliveredPeriodNs / MS_NS, error,
+                static_cast<double>(minSpacingNs) / MS_NS, static_cast<double>(stats.maxSpacingNs) / MS_NS);
+    }
+    lastDeliveries_ = std::move(lastDeliveries);
+}
+
 void SensorDump::DumpCurrentTime(int32_t fd)
 {
     timespec curTime = { 0, 0 };
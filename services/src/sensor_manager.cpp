@@ -58,19 +58,9 @@ bool SensorManager::SetBestSensorParams(int32_t sensorId, int64_t samplingPeriod
     SensorBasicInfo sensorInfo = clientInfo_.GetBestSensorInfo(sensorId);
     int64_t bestSamplingPeriodNs = sensorInfo.GetSamplingPeriodNs();
     int64_t bestReportDelayNs = sensorInfo.GetMaxReportDelayNs();
-    if ((samplingPeriodNs > bestSamplingPeriodNs) && (maxReportDelayNs > bestReportDelayNs)) {
-        SEN_HILOGD("No need to reset sensor params");
-        return true;
-    }
     bestSamplingPeriodNs = (samplingPeriodNs < bestSamplingPeriodNs) ? samplingPeriodNs : bestSamplingPeriodNs;
     bestReportDelayNs = (maxReportDelayNs < bestReportDelayNs) ? maxReportDelayNs : bestReportDelayNs;
-    SEN_HILOGD("bestSamplingPeriodNs : %{public}" PRId64, bestSamplingPeriodNs);
-    auto ret = sensorHdiConnection_.SetBatch(sensorId, bestSamplingPeriodNs, bestReportDelayNs);
-    if (ret != ERR_OK) {
-        SEN_HILOGE("SetBatch is failed");
-        return false;
-    }
-    return true;
+    return ApplySensorParams(sensorId, bestSamplingPeriodNs, bestReportDelayNs);
 }
 
 bool SensorManager::ResetBestSensorParams(int32_t sensorId)
@@ -81,15 +71,33 @@ bool SensorManager::ResetBestSensorParams(int32_t sensorId)
         return false;
     }
     SensorBasicInfo sensorInfo = clientInfo_.GetBestSensorInfo(sensorId);
-    auto ret = sensorHdiConnection_.SetBatch(sensorId,
-        sensorInfo.GetSamplingPeriodNs(), sensorInfo.GetMaxReportDelayNs());
+    return ApplySensorParams(sensorId, sensorInfo.GetSamplingPeriodNs(), sensorInfo.GetMaxReportDelayNs());
+}
+
+bool SensorManager::ApplySensorParams(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs)
+{
+    if (!rateArbiter_.NeedReconfigure(sensorId, samplingPeriodNs, maxReportDelayNs)) {
+        SEN_HILOGD("No need to reset sensor params");
+        return true;
+    }
+    SEN_HILOGD("bestSamplingPeriodNs:%{public}" PRId64, samplingPeriodNs);
+    auto ret = SetBatch(sensorId, samplingPeriodNs, maxReportDelayNs);
     if (ret != ERR_OK) {
         SEN_HILOGE("SetBatch is failed");
         return false;
     }
+    rateArbiter_.CommitReconfigure(sensorId, samplingPeriodNs, maxReportDelayNs);
     return true;
 }
 
+int32_t SensorManager::SetBatch(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs)
+{
+    if (virtualSensorManager_.IsVirtualSensor(sensorId)) {
+        return virtualSensorManager_.SetBatch(sensorId, samplingPeriodNs, maxReportDelayNs);
+    }
+    return sensorHdiConnection_.SetBatch(sensorId, samplingPeriodNs, maxReportDelayNs);
+}
+
 void SensorManager::StartDataReportThread()
 {
     CALL_LOG_ENTER;
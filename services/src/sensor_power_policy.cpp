@@ -34,6 +34,7 @@ ClientInfo &clientInfo_ = ClientInfo::GetInstance();
 SensorManager &sensorManager_ = SensorManager::GetInstance();
 #ifdef HDF_DRIVERS_INTERFACE_SENSOR
 SensorHdiConnection &sensorHdiConnection_ = SensorHdiConnection::GetInstance();
+VirtualSensorManager &virtualSensorManager_ = VirtualSensorManager::GetInstance();
 #endif // HDF_DRIVERS_INTERFACE_SENSOR
 } // namespace
 
@@ -89,7 +90,8 @@ bool SensorPowerPolicy::Suspend(int32_t pid, const std::vector<int32_t> &sensorI
             continue;
         }
 #ifdef HDF_DRIVERS_INTERFACE_SENSOR
-        auto ret = sensorHdiConnection_.DisableSensor(sensorId);
+        auto ret = virtualSensorManager_.IsVirtualSensor(sensorId) ? virtualSensorManager_.DisableSensor(sensorId)
+                                                                   : sensorHdiConnection_.DisableSensor(sensorId);
         if (ret != ERR_OK) {
             isAllSuspend = false;
             SEN_HILOGE("Hdi disable sensor failed, sensorId:%{public}d, ret:%{public}d", sensorId, ret);
@@ -157,7 +159,8 @@ bool SensorPowerPolicy::Resume(int32_t pid, int32_t sensorId, int64_t samplingPe
         return false;
     }
 #ifdef HDF_DRIVERS_INTERFACE_SENSOR
-    ret = sensorHdiConnection_.EnableSensor(sensorId);
+    ret = virtualSensorManager_.IsVirtualSensor(sensorId) ? virtualSensorManager_.EnableSensor(sensorId)
+                                                           : sensorHdiConnection_.EnableSensor(sensorId);
     if (ret != ERR_OK) {
         SEN_HILOGE("Hdi enable sensor failed, sensorId:%{public}d, ret:%{public}d", sensorId, ret);
         clientInfo_.RemoveSubscriber(sensorId, pid);
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_rate_arbiter.h"
+
+#include <climits>
+
+#include "sensor_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorRateArbiter"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+
+namespace {
+// A slower rate or a longer delay is applied once it differs from the applied one by more than 1/10 of it.
+constexpr int64_t HYSTERESIS_DIVISOR = 10;
+} // namespace
+
+void SensorRateArbiter::UpdateRequest(int32_t sensorId, int32_t pid, int64_t samplingPeriodNs,
+    int64_t maxReportDelayNs)
+{
+    std::lock_guard<std::mutex> rateLock(rateMutex_);
+    SensorRate &sensorRate = sensorRates_[sensorId];
+    EraseRequest(sensorRate, pid);
+    sensorRate.requests.emplace(pid, std::make_pair(samplingPeriodNs, maxReportDelayNs));
+    sensorRate.samplingPeriods.insert(samplingPeriodNs);
+    sensorRate.reportDelays.insert(maxReportDelayNs);
+}
+
+void SensorRateArbiter::RemoveRequest(int32_t sensorId, int32_t pid)
+{
+    std::lock_guard<std::mutex> rateLock(rateMutex_);
+    auto it = sensorRates_.find(sensorId);
+    if (it == sensorRates_.end()) {
+        return;
+    }
+    EraseRequest(it->second, pid);
+}
+
+void SensorRateArbiter::EraseRequest(SensorRate &sensorRate, int32_t pid)
+{
+    auto it = sensorRate.requests.find(pid);
+    if (it == sensorRate.requests.end()) {
+        return;
+    }
+    // Erase a single element, other pids may request the same value.
+    sensorRate.samplingPeriods.erase(sensorRate.samplingPeriods.find(it->second.first));
+    sensorRate.reportDelays.erase(sensorRate.reportDelays.find(it->second.second));
+    sensorRate.requests.erase(it);
+}
+
+void SensorRateArbiter::RemoveSensor(int32_t sensorId)
+{
+    std::lock_guard<std::mutex> rateLock(rateMutex_);
+    auto it = sensorRates_.find(sensorId);
+    if (it == sensorRates_.end()) {
+        return;
+    }
+    SensorRate &sensorRate = it->second;
+    sensorRate.requests.clear();
+    sensorRate.samplingPeriods.clear();
+    sensorRate.reportDelays.clear();
+    sensorRate.isApplied = false;
+}
+
+SensorBasicInfo SensorRateArbiter::GetBestSensorInfo(int32_t sensorId)
+{
+    SensorBasicInfo sensorInfo;
+    sensorInfo.SetSamplingPeriodNs(LLONG_MAX);
+    sensorInfo.SetMaxReportDelayNs(LLONG_MAX);
+    std::lock_guard<std::mutex> rateLock(rateMutex_);
+    auto it = sensorRates_.find(sensorId);
+    if ((it == sensorRates_.end()) || it->second.requests.empty()) {
+        SEN_HILOGE("Can't find sensorId:%{public}d", sensorId);
+        return sensorInfo;
+    }
+    sensorInfo.SetSamplingPeriodNs(*it->second.samplingPeriods.begin());
+    sensorInfo.SetMaxReportDelayNs(*it->second.reportDelays.begin());
+    return sensorInfo;
+}
+
+int64_t SensorRateArbiter::GetAppliedSamplingPeriod(int32_t sensorId)
+{
+    std::lock_guard<std::mutex> rateLock(rateMutex_);
+    auto it = sensorRates_.find(sensorId);
+    if (it == sensorRates_.end()) {
+        return LLONG_MAX;
+    }
+    if (it->second.isApplied) {
+        return it->second.appliedSamplingPeriodNs;
+    }
+    return it->second.samplingPeriods.empty() ? LLONG_MAX : *it->second.samplingPeriods.begin();
+}
+
+bool SensorRateArbiter::IsBeyondHysteresis(int64_t value, int64_t appliedValue)
+{
+    return (value - appliedValue) > (appliedValue / HYSTERESIS_DIVISOR);
+}
+
+bool SensorRateArbiter::NeedReconfigure(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs)
+{
+    std::lock_guard<std::mutex> rateLock(rateMutex_);
+    SensorRate &sensorRate = sensorRates_[sensorId];
+    if (!sensorRate.isApplied) {
+        return true;
+    }
+    int64_t appliedPeriodNs = sensorRate.appliedSamplingPeriodNs;
+    int64_t appliedDelayNs = sensorRate.appliedReportDelayNs;
+    // A subscriber needs a faster rate or a shorter delay than the sensor runs at.
+    if ((samplingPeriodNs < appliedPeriodNs) || (maxReportDelayNs < appliedDelayNs)) {
+        return true;
+    }
+    if (IsBeyondHysteresis(samplingPeriodNs, appliedPeriodNs) || IsBeyondHysteresis(maxReportDelayNs, appliedDelayNs)) {
+        return true;
+    }
+    if ((samplingPeriodNs != appliedPeriodNs) || (maxReportDelayNs != appliedDelayNs)) {
+        ++sensorRate.skippedCount;
+        SEN_HILOGD("Keep the applied params, sensorId:%{public}d", sensorId);
+    }
+    return false;
+}
+
+void SensorRateArbiter::CommitReconfigure(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs)
+{
+    std::lock_guard<std::mutex> rateLock(rateMutex_);
+    SensorRate &sensorRate = sensorRates_[sensorId];
+    sensorRate.isApplied = true;
+    sensorRate.appliedSamplingPeriodNs = samplingPeriodNs;
+    sensorRate.appliedReportDelayNs = maxReportDelayNs;
+    ++sensorRate.reconfigCount;
+}
+
+void SensorRateArbiter::GetRateSnapshots(std::vector<SensorRateSnapshot> &snapshots)
+{
+    std::lock_guard<std::mutex> rateLock(rateMutex_);
+    for (const auto &it : sensorRates_) {
+        const SensorRate &sensorRate = it.second;
+        snapshots.push_back({ it.first, sensorRate.requests.size(), sensorRate.isApplied,
+            sensorRate.appliedSamplingPeriodNs, sensorRate.appliedReportDelayNs, sensorRate.reconfigCount,
+            sensorRate.skippedCount });
+    }
+}
+} // namespace Sensors
+} // namespace OHOS
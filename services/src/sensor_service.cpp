@@ -123,6 +123,9 @@ bool SensorService::InitSensorList()
         SEN_HILOGE("GetSensorList is failed");
         return false;
     }
+    virtualSensorManager_.Init(sensors_);
+    std::vector<Sensor> virtualSensors = virtualSensorManager_.GetVirtualSensors();
+    sensors_.insert(sensors_.end(), virtualSensors.begin(), virtualSensors.end());
     {
         std::lock_guard<std::mutex> sensorMapLock(sensorMapMutex_);
         for (const auto &it : sensors_) {
@@ -264,7 +267,8 @@ ErrCode SensorService::EnableSensor(int32_t sensorId, int64_t samplingPeriodNs,
         return ret;
     }
 #ifdef HDF_DRIVERS_INTERFACE_SENSOR
-    ret = sensorHdiConnection_.EnableSensor(sensorId);
+    ret = virtualSensorManager_.IsVirtualSensor(sensorId) ? virtualSensorManager_.EnableSensor(sensorId)
+                                                           : sensorHdiConnection_.EnableSensor(sensorId);
     if (ret != ERR_OK) {
         SEN_HILOGE("EnableSensor failed");
         clientInfo_.RemoveSubscriber(sensorId, GetCallingPid());
@@ -299,7 +303,9 @@ ErrCode SensorService::DisableSensor(int32_t sensorId, int32_t pid)
         return ERR_OK;
     }
 #ifdef HDF_DRIVERS_INTERFACE_SENSOR
-    if (sensorHdiConnection_.DisableSensor(sensorId) != ERR_OK) {
+    ErrCode ret = virtualSensorManager_.IsVirtualSensor(sensorId) ? virtualSensorManager_.DisableSensor(sensorId)
+                                                                  : sensorHdiConnection_.DisableSensor(sensorId);
+    if (ret != ERR_OK) {
         SEN_HILOGE("DisableSensor is failed");
         return DISABLE_SENSOR_ERR;
     }
@@ -325,6 +331,8 @@ std::vector<Sensor> SensorService::GetSensorList()
         SEN_HILOGE("GetSensorList is failed");
         return sensors_;
     }
+    std::vector<Sensor> virtualSensors = virtualSensorManager_.GetVirtualSensors();
+    sensors_.insert(sensors_.end(), virtualSensors.begin(), virtualSensors.end());
 #endif // HDF_DRIVERS_INTERFACE_SENSOR
     for (const auto &it : sensors_) {
         std::lock_guard<std::mutex> sensorMapLock(sensorMapMutex_);
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_trace_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "securec.h"
+#include "sensor_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorTraceFile"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+
+SensorTraceFile::~SensorTraceFile()
+{
+    Close();
+}
+
+int32_t SensorTraceFile::Open(const std::string &path)
+{
+    Close();
+    int32_t fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        SEN_HILOGE("Open trace file failed, errno:%{public}d", errno);
+        return FILE_OPEN_FAIL;
+    }
+    struct stat fileStat;
+    if ((fstat(fd, &fileStat) != 0) || (static_cast<size_t>(fileStat.st_size) < sizeof(SensorTraceHeader))) {
+        SEN_HILOGE("Trace file is too small");
+        close(fd);
+        return FILE_OPEN_FAIL;
+    }
+    size_t fileSize = static_cast<size_t>(fileStat.st_size);
+    void *addr = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        SEN_HILOGE("Map trace file failed, errno:%{public}d", errno);
+        return FILE_OPEN_FAIL;
+    }
+    mapAddr_ = addr;
+    mapSize_ = fileSize;
+    const SensorTraceHeader *header = static_cast<const SensorTraceHeader *>(addr);
+    if ((header->magic != SENSOR_TRACE_MAGIC) || (header->version != SENSOR_TRACE_VERSION) ||
+        (header->headerSize != sizeof(SensorTraceHeader)) || (header->recordSize != sizeof(SensorTraceRecord))) {
+        SEN_HILOGE("Trace file format mismatch, magic:%{public}x, version:%{public}u", header->magic,
+            header->version);
+        Close();
+        return FILE_OPEN_FAIL;
+    }
+    size_t fileRecordCount = (fileSize - sizeof(SensorTraceHeader)) / sizeof(SensorTraceRecord);
+    recordCount_ = (header->recordCount == 0) ? fileRecordCount :
+        std::min(fileRecordCount, static_cast<size_t>(header->recordCount));
+    startTimeNs_ = header->startTimeNs;
+    records_ = reinterpret_cast<const SensorTraceRecord *>(static_cast<const uint8_t *>(addr) +
+        sizeof(SensorTraceHeader));
+    // Replay reads the records front to back.
+    (void)madvise(addr, fileSize, MADV_SEQUENTIAL);
+    SEN_HILOGI("Open trace file success, recordCount:%{public}zu", recordCount_);
+    return ERR_OK;
+}
+
+void SensorTraceFile::Close()
+{
+    if (mapAddr_ != nullptr) {
+        (void)munmap(mapAddr_, mapSize_);
+    }
+    mapAddr_ = nullptr;
+    mapSize_ = 0;
+    records_ = nullptr;
+    recordCount_ = 0;
+    startTimeNs_ = 0;
+}
+
+size_t SensorTraceFile::GetRecordCount() const
+{
+    return recordCount_;
+}
+
+const SensorTraceRecord &SensorTraceFile::GetRecord(size_t index) const
+{
+    return records_[index];
+}
+
+size_t SensorTraceFile::LowerBound(int64_t offsetNs) const
+{
+    if (records_ == nullptr) {
+        return 0;
+    }
+    int64_t recordTimeNs = startTimeNs_ + offsetNs;
+    const SensorTraceRecord *record = std::lower_bound(records_, records_ + recordCount_, recordTimeNs,
+        [](const SensorTraceRecord &left, int64_t right) {
+            return left.recordTimeNs < right;
+        });
+    return static_cast<size_t>(record - records_);
+}
+
+int64_t SensorTraceFile::GetStartTimeNs() const
+{
+    return startTimeNs_;
+}
+
+void ToTraceRecord(const SensorData &data, int64_t recordTimeNs, SensorTraceRecord &record)
+{
+    record.recordTimeNs = recordTimeNs;
+    record.timestamp = data.timestamp;
+    record.sensorTypeId = data.sensorTypeId;
+    record.version = data.version;
+    record.option = data.option;
+    record.mode = data.mode;
+    record.dataLen = std::min(data.dataLen, static_cast<uint32_t>(SENSOR_MAX_LENGTH));
+    record.reserved = 0;
+    if (memcpy_s(record.data, sizeof(record.data), data.data, sizeof(data.data)) != EOK) {
+        SEN_HILOGE("Copy data failed");
+    }
+}
+
+void FromTraceRecord(const SensorTraceRecord &record, SensorData &data)
+{
+    data.sensorTypeId = record.sensorTypeId;
+    data.version = record.version;
+    data.timestamp = record.timestamp;
+    data.option = record.option;
+    data.mode = record.mode;
+    data.dataLen = std::min(record.dataLen, static_cast<uint32_t>(SENSOR_MAX_LENGTH));
+    if (memcpy_s(data.data, sizeof(data.data), record.data, sizeof(record.data)) != EOK) {
+        SEN_HILOGE("Copy data failed");
+    }
+}
+} // namespace Sensors
+} // namespace OHOS
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_trace_recorder.h"
+
+#include <fcntl.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cinttypes>
+#include <cstddef>
+
+#include "sensor_errors.h"
+#include "sensor_latency_tracker.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorTraceRecorder"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+namespace {
+const std::string TRACE_WRITE_THREAD_NAME = "OS_SenTraceRec";
+constexpr size_t RECORD_BUFFER_SIZE = 512;
+constexpr size_t MAX_PENDING_BUFFERS = 64;
+// A partly filled buffer is written after this time so a stopped data flow still reaches the file.
+constexpr std::chrono::milliseconds FLUSH_INTERVAL { 1000 };
+constexpr mode_t TRACE_FILE_MODE = 0640;
+} // namespace
+
+SensorTraceRecorder::~SensorTraceRecorder()
+{
+    (void)Stop();
+}
+
+int32_t SensorTraceRecorder::Start(const std::string &path)
+{
+    std::lock_guard<std::mutex> controlLock(controlMutex_);
+    if (isRecording_.load()) {
+        SEN_HILOGW("Recording is already started");
+        return ERR_OK;
+    }
+    int32_t fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, TRACE_FILE_MODE);
+    if (fd < 0) {
+        SEN_HILOGE("Open trace file failed, errno:%{public}d", errno);
+        return FILE_OPEN_FAIL;
+    }
+    SensorTraceHeader header = {
+        .magic = SENSOR_TRACE_MAGIC,
+        .version = SENSOR_TRACE_VERSION,
+        .headerSize = sizeof(SensorTraceHeader),
+        .recordSize = sizeof(SensorTraceRecord),
+        .recordCount = 0,
+        .startTimeNs = SensorLatencyTracker::GetMonotonicTimeNs(),
+    };
+    if (write(fd, &header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+        SEN_HILOGE("Write trace header failed, errno:%{public}d", errno);
+        close(fd);
+        return ERROR;
+    }
+    fd_ = fd;
+    writeFailed_ = false;
+    {
+        std::lock_guard<std::mutex> recordLock(recordMutex_);
+        isStop_ = false;
+        buffer_.clear();
+        buffer_.reserve(RECORD_BUFFER_SIZE);
+        pendingBuffers_.clear();
+    }
+    writtenRecords_.store(0);
+    droppedRecords_.store(0);
+    writeThread_ = std::thread([this] { WriteThread(); });
+    isRecording_.store(true, std::memory_order_release);
+    SEN_HILOGI("Start recording");
+    return ERR_OK;
+}
+
+int32_t SensorTraceRecorder::Stop()
+{
+    std::lock_guard<std::mutex> controlLock(controlMutex_);
+    if (!isRecording_.load()) {
+        return ERR_OK;
+    }
+    isRecording_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> recordLock(recordMutex_);
+        isStop_ = true;
+    }
+    recordCondition_.notify_one();
+    if (writeThread_.joinable()) {
+        writeThread_.join();
+    }
+    uint64_t recordCount = writtenRecords_.load();
+    int32_t ret = ERR_OK;
+    if (pwrite(fd_, &recordCount, sizeof(recordCount), offsetof(SensorTraceHeader, recordCount)) !=
+        static_cast<ssize_t>(sizeof(recordCount))) {
+        SEN_HILOGE("Write trace record count failed, errno:%{public}d", errno);
+        ret = ERROR;
+    }
+    (void)fsync(fd_);
+    close(fd_);
+    fd_ = -1;
+    SEN_HILOGI("Stop recording, written:%{public}" PRIu64 ", dropped:%{public}" PRIu64, recordCount,
+        droppedRecords_.load());
+    return ret;
+}
+
+void SensorTraceRecorder::Record(const SensorData &data)
+{
+    if (!isRecording_.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::unique_lock<std::mutex> recordLock(recordMutex_);
+    if (isStop_) {
+        return;
+    }
+    if (buffer_.size() >= RECORD_BUFFER_SIZE) {
+        if (pendingBuffers_.size() >= MAX_PENDING_BUFFERS) {
+            droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        pendingBuffers_.push_back(std::move(buffer_));
+        if (freeBuffers_.empty()) {
+            buffer_ = std::vector<SensorTraceRecord>();
+            buffer_.reserve(RECORD_BUFFER_SIZE);
+        } else {
+            buffer_ = std::move(freeBuffers_.back());
+            freeBuffers_.pop_back();
+        }
+        recordCondition_.notify_one();
+    }
+    // The record time is taken under the lock so the records stay sorted by it.
+    buffer_.emplace_back();
+    ToTraceRecord(data, SensorLatencyTracker::GetMonotonicTimeNs(), buffer_.back());
+}
+
+SensorTraceRecordStats SensorTraceRecorder::GetStats()
+{
+    return { isRecording_.load(), writtenRecords_.load(), droppedRecords_.load() };
+}
+
+void SensorTraceRecorder::WriteThread()
+{
+    prctl(PR_SET_NAME, TRACE_WRITE_THREAD_NAME.c_str());
+    std::vector<std::vector<SensorTraceRecord>> writeBuffers;
+    std::unique_lock<std::mutex> recordLock(recordMutex_);
+    while (true) {
+        recordCondition_.wait_for(recordLock, FLUSH_INTERVAL, [this] {
+            return isStop_ || !pendingBuffers_.empty();
+        });
+        if ((pendingBuffers_.empty() || isStop_) && !buffer_.empty()) {
+            pendingBuffers_.push_back(std::move(buffer_));
+            buffer_ = std::vector<SensorTraceRecord>();
+            buffer_.reserve(RECORD_BUFFER_SIZE);
+        }
+        while (!pendingBuffers_.empty()) {
+            writeBuffers.push_back(std::move(pendingBuffers_.front()));
+            pendingBuffers_.pop_front();
+        }
+        bool isStop = isStop_;
+        recordLock.unlock();
+        for (auto &records : writeBuffers) {
+            if (!WriteRecords(records)) {
+                droppedRecords_.fetch_add(records.size(), std::memory_order_relaxed);
+            }
+            records.clear();
+        }
+        recordLock.lock();
+        for (auto &records : writeBuffers) {
+            if (freeBuffers_.size() < MAX_PENDING_BUFFERS) {
+                freeBuffers_.push_back(std::move(records));
+            }
+        }
+        writeBuffers.clear();
+        if (isStop) {
+            break;
+        }
+    }
+}
+
+bool SensorTraceRecorder::WriteRecords(const std::vector<SensorTraceRecord> &records)
+{
+    // A partly written record would shift every later one, nothing more is written after a failure.
+    if (writeFailed_) {
+        return false;
+    }
+    const uint8_t *buf = reinterpret_cast<const uint8_t *>(records.data());
+    size_t remain = records.size() * sizeof(SensorTraceRecord);
+    while (remain > 0) {
+        ssize_t len = write(fd_, buf, remain);
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            SEN_HILOGE("Write trace records failed, errno:%{public}d", errno);
+            writeFailed_ = true;
+            return false;
+        }
+        buf += len;
+        remain -= static_cast<size_t>(len);
+    }
+    writtenRecords_.fetch_add(records.size(), std::memory_order_relaxed);
+    return true;
+}
+} // namespace Sensors
+} // namespace OHOS
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "virtual_sensor_manager.h"
+
+#include <algorithm>
+#include <unistd.h>
+
+#include "fusion_sensor.h"
+#include "sensor_errors.h"
+#include "sensor_manager.h"
+
+#undef LOG_TAG
+#define LOG_TAG "VirtualSensorManager"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+namespace {
+// An active mask has one bit per output.
+constexpr size_t MAX_PLUGIN_OUTPUTS = 32;
+
+std::vector<std::unique_ptr<VirtualSensor>> CreatePlugins()
+{
+    std::vector<std::unique_ptr<VirtualSensor>> plugins;
+    plugins.push_back(std::make_unique<FusionSensor>());
+    return plugins;
+}
+}  // namespace
+
+void VirtualSensorManager::Init(const std::vector<Sensor> &hdiSensors)
+{
+    CALL_LOG_ENTER;
+    std::lock_guard<std::mutex> managerLock(managerMutex_);
+    std::unordered_set<int32_t> hdiIds;
+    for (const auto &sensor : hdiSensors) {
+        hdiIds.insert(sensor.GetSensorId());
+    }
+    plugins_ = CreatePlugins();
+    activeOutputs_ = std::vector<std::atomic<uint32_t>>(plugins_.size());
+    for (size_t plugin = 0; plugin < plugins_.size(); ++plugin) {
+        std::vector<VirtualSensorOutput> pluginOutputs = plugins_[plugin]->Init(hdiSensors);
+        size_t outputCount = std::min(pluginOutputs.size(), MAX_PLUGIN_OUTPUTS);
+        for (size_t index = 0; index < outputCount; ++index) {
+            VirtualSensorOutput &output = pluginOutputs[index];
+            int32_t sensorId = output.sensor.GetSensorId();
+            if ((hdiIds.find(sensorId) != hdiIds.end()) || (outputs_.find(sensorId) != outputs_.end())) {
+                SEN_HILOGD("Sensor is reported already, sensorId:%{public}d", sensorId);
+                continue;
+            }
+            bool hasInputs = std::all_of(output.inputs.begin(), output.inputs.end(),
+                [&hdiIds](const VirtualSensorInput &input) { return hdiIds.find(input.sensorId) != hdiIds.end(); });
+            if (!hasInputs || output.inputs.empty()) {
+                SEN_HILOGD("Inputs are missing, sensorId:%{public}d", sensorId);
+                continue;
+            }
+            for (const auto &input : output.inputs) {
+                inputIds_.insert(input.sensorId);
+            }
+            OutputState state;
+            state.plugin = plugin;
+            state.index = static_cast<uint32_t>(index);
+            state.sensor = output.sensor;
+            state.inputs = std::move(output.inputs);
+            outputs_.emplace(sensorId, std::move(state));
+            virtualSensors_.push_back(output.sensor);
+        }
+    }
+    derivedEvents_.reserve(CIRCULAR_BUF_LEN);
+    SEN_HILOGI("Virtual sensors count:%{public}zu", virtualSensors_.size());
+}
+
+std::vector<Sensor> VirtualSensorManager::GetVirtualSensors()
+{
+    std::lock_guard<std::mutex> managerLock(managerMutex_);
+    return virtualSensors_;
+}
+
+bool VirtualSensorManager::IsVirtualSensor(int32_t sensorId) const
+{
+    return outputs_.find(sensorId) != outputs_.end();
+}
+
+bool VirtualSensorManager::IsInputSensor(int32_t sensorId) const
+{
+    return inputIds_.find(sensorId) != inputIds_.end();
+}
+
+int32_t VirtualSensorManager::EnableSensor(int32_t sensorId)
+{
+    CALL_LOG_ENTER;
+    std::lock_guard<std::mutex> managerLock(managerMutex_);
+    auto it = outputs_.find(sensorId);
+    if (it == outputs_.end()) {
+        SEN_HILOGE("Not a virtual sensor, sensorId:%{public}d", sensorId);
+        return ENABLE_SENSOR_ERR;
+    }
+    it->second.enabled = true;
+    if (UpdateSubscriptions() != ERR_OK) {
+        SEN_HILOGE("Subscribe inputs failed, sensorId:%{public}d", sensorId);
+        it->second.enabled = false;
+        UpdateSubscriptions();
+        return ENABLE_SENSOR_ERR;
+    }
+    UpdateActiveOutputs(it->second.plugin);
+    return ERR_OK;
+}
+
+int32_t VirtualSensorManager::DisableSensor(int32_t sensorId)
+{
+    CALL_LOG_ENTER;
+    std::lock_guard<std::mutex> managerLock(managerMutex_);
+    auto it = outputs_.find(sensorId);
+    if (it == outputs_.end()) {
+        SEN_HILOGE("Not a virtual sensor, sensorId:%{public}d", sensorId);
+        return DISABLE_SENSOR_ERR;
+    }
+    it->second.enabled = false;
+    UpdateActiveOutputs(it->second.plugin);
+    if (UpdateSubscriptions() != ERR_OK) {
+        SEN_HILOGE("Unsubscribe inputs failed, sensorId:%{public}d", sensorId);
+        return DISABLE_SENSOR_ERR;
+    }
+    return ERR_OK;
+}
+
+int32_t VirtualSensorManager::SetBatch(int32_t sensorId, int64_t samplingPeriodNs, int64_t maxReportDelayNs)
+{
+    std::lock_guard<std::mutex> managerLock(managerMutex_);
+    auto it = outputs_.find(sensorId);
+    if (it == outputs_.end()) {
+        SEN_HILOGE("Not a virtual sensor, sensorId:%{public}d", sensorId);
+        return SET_SENSOR_CONFIG_ERR;
+    }
+    it->second.samplingPeriodNs = samplingPeriodNs;
+    it->second.maxReportDelayNs = maxReportDelayNs;
+    // Before the sensor is enabled the parameters are only recorded, EnableSensor applies them.
+    if (it->second.enabled && (UpdateSubscriptions() != ERR_OK)) {
+        SEN_HILOGE("Update inputs failed, sensorId:%{public}d", sensorId);
+        return SET_SENSOR_CONFIG_ERR;
+    }
+    return ERR_OK;
+}
+
+int32_t VirtualSensorManager::UpdateSubscriptions()
+{
+    int32_t result = ERR_OK;
+    for (int32_t inputId : inputIds_) {
+        bool needed = false;
+        int64_t samplingPeriodNs = INT64_MAX;
+        int64_t maxReportDelayNs = INT64_MAX;
+        for (const auto &outputIt : outputs_) {
+            const OutputState &output = outputIt.second;
+            if (!output.enabled) {
+                continue;
+            }
+            for (const auto &input : output.inputs) {
+                if (input.sensorId != inputId) {
+                    continue;
+                }
+                needed = true;
+                int64_t periodNs = (input.samplingPeriodNs != 0) ? input.samplingPeriodNs : output.samplingPeriodNs;
+                samplingPeriodNs = std::min(samplingPeriodNs, periodNs);
+                maxReportDelayNs = std::min(maxReportDelayNs, output.maxReportDelayNs);
+            }
+        }
+        InputState &state = inputStates_[inputId];
+        int32_t ret = ERR_OK;
+        if (needed && (!state.subscribed || (state.samplingPeriodNs != samplingPeriodNs) ||
+            (state.maxReportDelayNs != maxReportDelayNs))) {
+            ret = Subscribe(inputId, state, samplingPeriodNs, maxReportDelayNs);
+        } else if (!needed && state.subscribed) {
+            ret = Unsubscribe(inputId, state);
+        }
+        if (ret != ERR_OK) {
+            result = ret;
+        }
+    }
+    return result;
+}
+
+int32_t VirtualSensorManager::Subscribe(int32_t sensorId, InputState &state, int64_t samplingPeriodNs,
+    int64_t maxReportDelayNs)
+{
+    int32_t pid = static_cast<int32_t>(getpid());
+    ClientInfo &clientInfo = ClientInfo::GetInstance();
+    SensorManager &sensorManager = SensorManager::GetInstance();
+    bool sensorEnabled = clientInfo.GetSensorState(sensorId);
+    if (!sensorManager.SaveSubscriber(sensorId, pid, samplingPeriodNs, maxReportDelayNs)) {
+        SEN_HILOGE("SaveSubscriber failed, sensorId:%{public}d", sensorId);
+        return UPDATE_SENSOR_INFO_ERR;
+    }
+    if (state.subscribed) {
+        // The service may have set the fastest rate so far, recompute it instead of only lowering it.
+        if (!sensorManager.ResetBestSensorParams(sensorId)) {
+            SEN_HILOGE("ResetBestSensorParams failed, sensorId:%{public}d", sensorId);
+            return SET_SENSOR_CONFIG_ERR;
+        }
+    } else {
+        SensorBasicInfo sensorInfo = clientInfo.GetCurPidSensorInfo(sensorId, pid);
+        if (!sensorManager.SetBestSensorParams(sensorId, sensorInfo.GetSamplingPeriodNs(),
+            sensorInfo.GetMaxReportDelayNs())) {
+            SEN_HILOGE("SetBestSensorParams failed, sensorId:%{public}d", sensorId);
+            clientInfo.RemoveSubscriber(sensorId, pid);
+            return SET_SENSOR_CONFIG_ERR;
+        }
+        if (!sensorEnabled && (SensorHdiConnection::GetInstance().EnableSensor(sensorId) != ERR_OK)) {
+            SEN_HILOGE("EnableSensor failed, sensorId:%{public}d", sensorId);
+            clientInfo.RemoveSubscriber(sensorId, pid);
+            return ENABLE_SENSOR_ERR;
+        }
+    }
+    state.subscribed = true;
+    state.samplingPeriodNs = samplingPeriodNs;
+    state.maxReportDelayNs = maxReportDelayNs;
+    return ERR_OK;
+}
+
+int32_t VirtualSensorManager::Unsubscribe(int32_t sensorId, InputState &state)
+{
+    state = InputState();
+    SensorManager &sensorManager = SensorManager::GetInstance();
+    if (sensorManager.IsOtherClientUsingSensor(sensorId, static_cast<int32_t>(getpid()))) {
+        SEN_HILOGD("Other client is using this sensor, sensorId:%{public}d", sensorId);
+        return ERR_OK;
+    }
+    if (SensorHdiConnection::GetInstance().DisableSensor(sensorId) != ERR_OK) {
+        SEN_HILOGE("DisableSensor failed, sensorId:%{public}d", sensorId);
+        return DISABLE_SENSOR_ERR;
+    }
+    ClientInfo::GetInstance().ClearDataQueue(sensorId);
+    return sensorManager.AfterDisableSensor(sensorId);
+}
+
+void VirtualSensorManager::UpdateActiveOutputs(size_t plugin)
+{
+    uint32_t active = 0;
+    for (const auto &outputIt : outputs_) {
+        const OutputState &output = outputIt.second;
+        if ((output.plugin == plugin) && output.enabled) {
+            active |= (1u << output.index);
+        }
+    }
+    activeOutputs_[plugin].store(active, std::memory_order_release);
+}
+
+size_t VirtualSensorManager::Process(SensorDataSpan events, sptr<ReportDataCallback> dataCallback, int64_t hdiTimeNs)
+{
+    CHKPR(dataCallback, 0);
+    if (events.empty()) {
+        return 0;
+    }
+    size_t reported = 0;
+    for (size_t plugin = 0; plugin < plugins_.size(); ++plugin) {
+        uint32_t active = activeOutputs_[plugin].load(std::memory_order_acquire);
+        if (active == 0) {
+            continue;
+        }
+        derivedEvents_.clear();
+        plugins_[plugin]->Process(events, active, derivedEvents_);
+        for (auto &event : derivedEvents_) {
+            dataCallback->ReportEventCallback(&event, dataCallback, hdiTimeNs);
+        }
+        reported += derivedEvents_.size();
+    }
+    return reported;
+}
+}  // namespace Sensors
+}  // namespace OHOS
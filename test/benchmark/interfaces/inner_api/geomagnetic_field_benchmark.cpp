@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "geomagnetic_field.h"
+
+namespace {
+constexpr uint32_t RANDOM_SEED = 20230101;
+constexpr int64_t BASE_TIME_MILLIS = 1700000000000;
+constexpr int64_t TIME_STEP_MILLIS = 1000;
+constexpr float ALTITUDE_MAX = 10000.0f;
+
+GeomagneticPositions GeneratePositions(size_t count, bool sharedTime)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_real_distribution<float> latitude(-90.0f, 90.0f);
+    std::uniform_real_distribution<float> longitude(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> altitude(0.0f, ALTITUDE_MAX);
+    GeomagneticPositions positions;
+    for (size_t i = 0; i < count; ++i) {
+        positions.latitudes.push_back(latitude(generator));
+        positions.longitudes.push_back(longitude(generator));
+        positions.altitudes.push_back(altitude(generator));
+        if (!sharedTime) {
+            positions.timeMillis.push_back(BASE_TIME_MILLIS + static_cast<int64_t>(i) * TIME_STEP_MILLIS);
+        }
+    }
+    if (sharedTime) {
+        positions.timeMillis.push_back(BASE_TIME_MILLIS);
+    }
+    return positions;
+}
+
+void BM_GeomagneticFieldSingle(benchmark::State &state)
+{
+    GeomagneticPositions positions = GeneratePositions(static_cast<size_t>(state.range(0)), false);
+    for (auto _ : state) {
+        for (size_t i = 0; i < positions.latitudes.size(); ++i) {
+            GeomagneticField field(positions.latitudes[i], positions.longitudes[i], positions.altitudes[i],
+                positions.timeMillis[i]);
+            benchmark::DoNotOptimize(field.ObtainX());
+        }
+    }
+    state.counters["points/s"] = benchmark::Counter(static_cast<double>(state.iterations() * state.range(0)),
+        benchmark::Counter::kIsRate);
+}
+
+void BM_GeomagneticFieldBatch(benchmark::State &state)
+{
+    GeomagneticPositions positions = GeneratePositions(static_cast<size_t>(state.range(0)), state.range(1) != 0);
+    GeomagneticComponents components;
+    for (auto _ : state) {
+        GeomagneticField::ObtainBatch(positions, components);
+        benchmark::DoNotOptimize(components.x.data());
+    }
+    state.counters["points/s"] = benchmark::Counter(static_cast<double>(state.iterations() * state.range(0)),
+        benchmark::Counter::kIsRate);
+}
+}  // namespace
+
+BENCHMARK(BM_GeomagneticFieldSingle)->Arg(1)->Arg(1024)->Arg(65536);
+// The second argument selects one shared time (1) or one time per position (0).
+BENCHMARK(BM_GeomagneticFieldBatch)->Args({ 1, 1 })->Args({ 1024, 1 })->Args({ 65536, 1 })->Args({ 65536, 0 });
+BENCHMARK_MAIN();
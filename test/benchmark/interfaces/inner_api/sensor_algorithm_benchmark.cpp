@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+#include "sensor_algorithm.h"
+
+namespace {
+constexpr uint32_t RANDOM_SEED = 20230101;
+
+RotationVectorBatch GenerateRotationVectors(size_t count)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+    RotationVectorBatch batch;
+    for (size_t i = 0; i < count; ++i) {
+        float x = component(generator);
+        float y = component(generator);
+        float z = component(generator);
+        float w = component(generator);
+        float norm = std::sqrt(x * x + y * y + z * z + w * w);
+        batch.x.push_back(x / norm);
+        batch.y.push_back(y / norm);
+        batch.z.push_back(z / norm);
+        batch.w.push_back(w / norm);
+    }
+    return batch;
+}
+
+void BM_OrientationSingle(benchmark::State &state)
+{
+    RotationVectorBatch batch = GenerateRotationVectors(static_cast<size_t>(state.range(0)));
+    SensorAlgorithm sensorAlgorithm;
+    std::vector<float> rotationVector(SensorAlgorithm::QUATERNION_LENGTH);
+    std::vector<float> rotationMatrix(SensorAlgorithm::THREE_DIMENSIONAL_MATRIX_LENGTH);
+    std::vector<float> rotationAngle(SensorAlgorithm::ROTATION_VECTOR_LENGTH);
+    for (auto _ : state) {
+        for (size_t i = 0; i < batch.x.size(); ++i) {
+            rotationVector = { batch.x[i], batch.y[i], batch.z[i], batch.w[i] };
+            sensorAlgorithm.CreateRotationMatrix(rotationVector, rotationMatrix);
+            sensorAlgorithm.GetDirection(rotationMatrix, rotationAngle);
+            benchmark::DoNotOptimize(rotationAngle.data());
+        }
+    }
+    state.counters["samples/s"] = benchmark::Counter(static_cast<double>(state.iterations() * state.range(0)),
+        benchmark::Counter::kIsRate);
+}
+
+void BM_OrientationArray(benchmark::State &state)
+{
+    RotationVectorBatch batch = GenerateRotationVectors(static_cast<size_t>(state.range(0)));
+    SensorAlgorithm sensorAlgorithm;
+    std::array<float, SensorAlgorithm::THREE_DIMENSIONAL_MATRIX_LENGTH> rotationMatrix;
+    SensorAlgorithm::Vector3 rotationAngle;
+    for (auto _ : state) {
+        for (size_t i = 0; i < batch.x.size(); ++i) {
+            SensorAlgorithm::Quaternion rotationVector = { batch.x[i], batch.y[i], batch.z[i], batch.w[i] };
+            sensorAlgorithm.CreateRotationMatrix(rotationVector, rotationMatrix);
+            sensorAlgorithm.GetDirection(rotationMatrix, rotationAngle);
+            benchmark::DoNotOptimize(rotationAngle.data());
+        }
+    }
+    state.counters["samples/s"] = benchmark::Counter(static_cast<double>(state.iterations() * state.range(0)),
+        benchmark::Counter::kIsRate);
+}
+
+void BM_OrientationBatch(benchmark::State &state)
+{
+    RotationVectorBatch batch = GenerateRotationVectors(static_cast<size_t>(state.range(0)));
+    SensorAlgorithm sensorAlgorithm;
+    RotationMatrixBatch rotationMatrices;
+    OrientationBatch rotationAngles;
+    for (auto _ : state) {
+        sensorAlgorithm.CreateRotationMatrixBatch(batch, rotationMatrices);
+        sensorAlgorithm.GetDirectionBatch(rotationMatrices, rotationAngles);
+        benchmark::DoNotOptimize(rotationAngles.z.data());
+    }
+    state.counters["samples/s"] = benchmark::Counter(static_cast<double>(state.iterations() * state.range(0)),
+        benchmark::Counter::kIsRate);
+}
+
+void BM_QuaternionBatch(benchmark::State &state)
+{
+    RotationVectorBatch batch = GenerateRotationVectors(static_cast<size_t>(state.range(0)));
+    batch.w.clear();
+    SensorAlgorithm sensorAlgorithm;
+    QuaternionBatch quaternions;
+    for (auto _ : state) {
+        sensorAlgorithm.CreateQuaternionBatch(batch, quaternions);
+        benchmark::DoNotOptimize(quaternions.w.data());
+    }
+    state.counters["samples/s"] = benchmark::Counter(static_cast<double>(state.iterations() * state.range(0)),
+        benchmark::Counter::kIsRate);
+}
+}  // namespace
+
+// Sample counts of one FIFO delivery up to a long recording.
+BENCHMARK(BM_OrientationSingle)->Arg(16)->Arg(256)->Arg(65536);
+BENCHMARK(BM_OrientationArray)->Arg(16)->Arg(256)->Arg(65536);
+BENCHMARK(BM_OrientationBatch)->Arg(16)->Arg(256)->Arg(65536);
+BENCHMARK(BM_QuaternionBatch)->Arg(16)->Arg(256)->Arg(65536);
+BENCHMARK_MAIN();
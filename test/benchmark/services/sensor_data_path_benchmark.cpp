@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "compatible_connection.h"
+#include "client_info.h"
+#include "hdi_service_impl.h"
+#include "report_data_callback.h"
+#include "sensor_agent_type.h"
+#include "sensor_basic_data_channel.h"
+#include "sensor_basic_info.h"
+#include "sensor_data_processer.h"
+#include "sensor_latency_tracker.h"
+#include "sensor_metrics.h"
+
+namespace OHOS {
+namespace Sensors {
+namespace {
+constexpr int32_t BENCHMARK_SENSOR_ID = SENSOR_TYPE_ID_ACCELEROMETER;
+constexpr int32_t BASE_CLIENT_PID = 100000;
+constexpr int32_t CLIENT_UID = 100000;
+constexpr uint32_t LOAD_SEED = 2023;
+constexpr int64_t US_NS = 1000;
+constexpr std::chrono::milliseconds RUN_TIME { 2000 };
+constexpr int32_t POLL_TIMEOUT_MS = 10;
+// One packet of the channel carries at most this many events, see SensorBasicDataChannel.
+constexpr size_t RECEIVE_EVENT_NUM = 100;
+constexpr double P50 = 0.5;
+constexpr double P99 = 0.99;
+
+struct ClientResult {
+    uint64_t events { 0 };
+    std::vector<int64_t> latenciesNs;
+};
+
+int64_t GetCpuTimeNs(clockid_t clockId)
+{
+    timespec time = { 0, 0 };
+    clock_gettime(clockId, &time);
+    return static_cast<int64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+}
+
+double GetPercentileUs(std::vector<int64_t> &latenciesNs, double percentile)
+{
+    if (latenciesNs.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(percentile * (latenciesNs.size() - 1));
+    std::nth_element(latenciesNs.begin(), latenciesNs.begin() + index, latenciesNs.end());
+    return static_cast<double>(latenciesNs[index]) / US_NS;
+}
+
+// Reads the channel like the client data channel does and measures the latency since the sample time, the mock HDI
+// stamps each sample with its CLOCK_MONOTONIC deadline.
+void ReceiveThread(sptr<SensorBasicDataChannel> channel, const std::atomic_bool &isStop, ClientResult &result)
+{
+    std::vector<SensorData> events(RECEIVE_EVENT_NUM);
+    pollfd pollFd = { channel->GetReceiveDataFd(), POLLIN, 0 };
+    while (!isStop.load(std::memory_order_relaxed)) {
+        if (poll(&pollFd, 1, POLL_TIMEOUT_MS) <= 0) {
+            continue;
+        }
+        ssize_t length = recv(pollFd.fd, events.data(), events.size() * sizeof(SensorData), MSG_DONTWAIT);
+        if (length <= 0) {
+            continue;
+        }
+        int64_t nowNs = SensorLatencyTracker::GetMonotonicTimeNs();
+        size_t eventNum = static_cast<size_t>(length) / sizeof(SensorData);
+        for (size_t i = 0; i < eventNum; ++i) {
+            result.latenciesNs.push_back(nowNs - events[i].timestamp);
+        }
+        result.events += eventNum;
+    }
+    // Events already in the socket when the run stops are delivered, count them too.
+    ssize_t length = 0;
+    while ((length = recv(pollFd.fd, events.data(), events.size() * sizeof(SensorData), MSG_DONTWAIT)) > 0) {
+        result.events += static_cast<size_t>(length) / sizeof(SensorData);
+    }
+}
+
+// The mock HDI keeps every registered callback, the connection is registered once for all runs.
+struct DataPathEnvironment {
+    DataPathEnvironment()
+    {
+        reportDataCallback = new (std::nothrow) ReportDataCallback();
+        if (reportDataCallback != nullptr) {
+            connection.RegisterDataReport(&ReportDataCallback::ReportEventCallback, reportDataCallback);
+        }
+    }
+    CompatibleConnection connection;
+    sptr<ReportDataCallback> reportDataCallback;
+};
+
+/**
+ * Runs the service data path in process: the mock HDI in load generator mode feeds CompatibleConnection, the data
+ * thread of SensorDataProcesser dispatches through ClientInfo to one socket channel per client, and one thread per
+ * client drains its channel. Binder is left out, the channels are registered in ClientInfo directly.
+ * Run with --benchmark_format=json for machine readable results.
+ */
+void BM_SensorDataPath(benchmark::State &state)
+{
+    const int32_t clientNum = static_cast<int32_t>(state.range(0));
+    const int64_t samplingPeriodNs = state.range(1) * US_NS;
+    const int64_t fifoDepth = state.range(2);
+    ClientInfo &clientInfo = ClientInfo::GetInstance();
+    std::vector<sptr<SensorBasicDataChannel>> channels;
+    for (int32_t i = 0; i < clientNum; ++i) {
+        int32_t pid = BASE_CLIENT_PID + i;
+        sptr<SensorBasicDataChannel> channel = new (std::nothrow) SensorBasicDataChannel();
+        if ((channel == nullptr) || (channel->CreateSensorBasicChannel() != ERR_OK)) {
+            state.SkipWithError("Create channel failed");
+            return;
+        }
+        channel->SetSensorStatus(true);
+        SensorBasicInfo sensorInfo;
+        sensorInfo.SetSamplingPeriodNs(samplingPeriodNs);
+        sensorInfo.SetMaxReportDelayNs(samplingPeriodNs * fifoDepth);
+        sensorInfo.SetSensorState(true);
+        sensorInfo.SetPermState(true);
+        clientInfo.UpdateAppThreadInfo(pid, CLIENT_UID, 0);
+        clientInfo.UpdateSensorChannel(pid, channel);
+        clientInfo.UpdateSensorInfo(BENCHMARK_SENSOR_ID, pid, sensorInfo);
+        channels.push_back(channel);
+    }
+    Sensor sensor;
+    sensor.SetSensorId(BENCHMARK_SENSOR_ID);
+    sensor.SetSensorTypeId(BENCHMARK_SENSOR_ID);
+    std::unordered_map<int32_t, Sensor> sensorMap = { { BENCHMARK_SENSOR_ID, sensor } };
+    static DataPathEnvironment environment;
+    CompatibleConnection &connection = environment.connection;
+    sptr<ReportDataCallback> reportDataCallback = environment.reportDataCallback;
+    sptr<SensorDataProcesser> dataProcesser = new (std::nothrow) SensorDataProcesser(sensorMap);
+    if ((dataProcesser == nullptr) || (reportDataCallback == nullptr)) {
+        state.SkipWithError("Create data processer failed");
+        return;
+    }
+    HdiServiceImpl::GetInstance().SetLoadGenerator({ LOAD_SEED, { { BENCHMARK_SENSOR_ID, samplingPeriodNs, 1 } } });
+
+    for (auto _ : state) {
+        std::atomic_bool isStop { false };
+        std::vector<ClientResult> results(clientNum);
+        std::vector<std::thread> clientThreads;
+        for (int32_t i = 0; i < clientNum; ++i) {
+            clientThreads.emplace_back(ReceiveThread, channels[i], std::cref(isStop), std::ref(results[i]));
+        }
+        std::atomic<int64_t> serviceCpuNs { 0 };
+        std::atomic_bool isDataThreadDone { false };
+        std::thread dataThread([&] {
+            int64_t startCpuNs = GetCpuTimeNs(CLOCK_THREAD_CPUTIME_ID);
+            while (!isStop.load(std::memory_order_relaxed)) {
+                dataProcesser->ProcessEvents(reportDataCallback);
+            }
+            serviceCpuNs.store(GetCpuTimeNs(CLOCK_THREAD_CPUTIME_ID) - startCpuNs);
+            isDataThreadDone.store(true);
+        });
+        DataPathMetricsSnapshot startMetrics = SensorMetrics::GetInstance().GetSnapshot();
+        int64_t startProcessCpuNs = GetCpuTimeNs(CLOCK_PROCESS_CPUTIME_ID);
+        connection.EnableSensor(BENCHMARK_SENSOR_ID);
+        std::this_thread::sleep_for(RUN_TIME);
+        connection.DisableSensor(BENCHMARK_SENSOR_ID);
+        int64_t processCpuNs = GetCpuTimeNs(CLOCK_PROCESS_CPUTIME_ID) - startProcessCpuNs;
+        DataPathMetricsSnapshot endMetrics = SensorMetrics::GetInstance().GetSnapshot();
+        isStop.store(true);
+        // ProcessEvents waits without a predicate, wake it until it has seen the stop flag.
+        while (!isDataThreadDone.load()) {
+            ISensorHdiConnection::dataCondition_.notify_all();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        dataThread.join();
+        for (auto &clientThread : clientThreads) {
+            clientThread.join();
+        }
+
+        uint64_t produced = endMetrics.enqueuedEvents - startMetrics.enqueuedEvents;
+        uint64_t delivered = 0;
+        std::vector<int64_t> latenciesNs;
+        for (auto &result : results) {
+            delivered += result.events;
+            latenciesNs.insert(latenciesNs.end(), result.latenciesNs.begin(), result.latenciesNs.end());
+        }
+        uint64_t expected = produced * static_cast<uint64_t>(clientNum);
+        double seconds = std::chrono::duration<double>(RUN_TIME).count();
+        state.counters["produced/s"] = static_cast<double>(produced) / seconds;
+        state.counters["delivered/s"] = static_cast<double>(delivered) / seconds;
+        state.counters["drop_rate"] = (expected == 0) ? 0.0 :
+            std::max(0.0, 1.0 - static_cast<double>(delivered) / static_cast<double>(expected));
+        state.counters["ring_overwritten"] =
+            static_cast<double>(endMetrics.overwrittenEvents - startMetrics.overwrittenEvents);
+        state.counters["service_cpu_ns/event"] = (produced == 0) ? 0.0 :
+            static_cast<double>(serviceCpuNs.load()) / static_cast<double>(produced);
+        state.counters["process_cpu_ns/event"] = (delivered == 0) ? 0.0 :
+            static_cast<double>(processCpuNs) / static_cast<double>(delivered);
+        state.counters["p50_us"] = GetPercentileUs(latenciesNs, P50);
+        state.counters["p99_us"] = GetPercentileUs(latenciesNs, P99);
+        state.counters["max_us"] = latenciesNs.empty() ? 0.0 :
+            static_cast<double>(*std::max_element(latenciesNs.begin(), latenciesNs.end())) / US_NS;
+    }
+
+    HdiServiceImpl::GetInstance().ClearLoadGenerator();
+    clientInfo.ClearSensorInfo(BENCHMARK_SENSOR_ID);
+    for (int32_t i = 0; i < clientNum; ++i) {
+        int32_t pid = BASE_CLIENT_PID + i;
+        clientInfo.DestroySensorChannel(pid);
+        clientInfo.DestroyAppThreadInfo(pid);
+    }
+}
+}  // namespace
+
+// Arguments: clients, sampling period in us, fifo depth of the clients.
+BENCHMARK(BM_SensorDataPath)
+    ->ArgNames({ "clients", "period_us", "fifo" })
+    ->Args({ 1, 5000, 1 })
+    ->Args({ 1, 1000, 1 })
+    ->Args({ 1, 1000, 10 })
+    ->Args({ 4, 1000, 1 })
+    ->Args({ 4, 1000, 10 })
+    ->Args({ 16, 1000, 1 })
+    ->Args({ 16, 250, 1 })
+    ->Args({ 16, 250, 20 })
+    ->Iterations(1)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+}  // namespace Sensors
+}  // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -13,6 +13,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <thread>
+
 #include <gtest/gtest.h>
 
 #include "geomagnetic_field.h"
@@ -32,6 +37,38 @@ constexpr int32_t QUATERNION_LENGTH = 4;
 constexpr int32_t ROTATION_VECTOR_LENGTH = 3;
 constexpr int32_t THREE_DIMENSIONAL_MATRIX_LENGTH = 9;
 constexpr float EPS = 0.01;
+constexpr int32_t GEOMAGNETIC_THREAD_COUNT = 4;
+constexpr int32_t GEOMAGNETIC_LOOP_COUNT = 1000;
+constexpr float BATCH_ANGLE_EPS = 1e-6f;
+constexpr int32_t ROTATION_GRID_STEPS = 24;
+constexpr double TWO_PI = 6.283185307179586;
+
+// Angle difference, an angle at pi and one at -pi are the same.
+double AngleError(float left, float right)
+{
+    return std::fabs(std::remainder(static_cast<double>(left) - right, TWO_PI));
+}
+
+// Rotation vectors on a grid over the unit ball, w follows from x, y and z.
+RotationVectorBatch MakeRotationGrid()
+{
+    RotationVectorBatch batch;
+    for (int32_t i = 0; i <= ROTATION_GRID_STEPS; ++i) {
+        for (int32_t j = 0; j <= ROTATION_GRID_STEPS; ++j) {
+            for (int32_t k = 0; k <= ROTATION_GRID_STEPS; ++k) {
+                float x = 2.0f * i / ROTATION_GRID_STEPS - 1.0f;
+                float y = 2.0f * j / ROTATION_GRID_STEPS - 1.0f;
+                float z = 2.0f * k / ROTATION_GRID_STEPS - 1.0f;
+                if (x * x + y * y + z * z <= 1.0f) {
+                    batch.x.push_back(x);
+                    batch.y.push_back(y);
+                    batch.z.push_back(z);
+                }
+            }
+        }
+    }
+    return batch;
+}
 } // namespace
 
 class SensorAlgorithmTest : public testing::Test {
@@ -341,5 +378,185 @@ HWTEST_F(SensorAlgorithmTest, SensorAlgorithmTest_028, TestSize.Level1)
     ASSERT_TRUE(fabs(geomagneticField.ObtainLevelIntensity() - 6572.02294921875) < EPS);
     ASSERT_TRUE(fabs(geomagneticField.ObtainTotalIntensity() - 55000.0703125) < EPS);
 }
+
+HWTEST_F(SensorAlgorithmTest, SensorAlgorithmTest_029, TestSize.Level1)
+{
+    GeomagneticField reference(30.0, 120.0, 100.0, 1700000000000);
+    std::vector<std::thread> workers;
+    std::vector<int32_t> mismatches(GEOMAGNETIC_THREAD_COUNT, 0);
+    for (int32_t i = 0; i < GEOMAGNETIC_THREAD_COUNT; ++i) {
+        workers.emplace_back([i, &reference, &mismatches]() {
+            for (int32_t j = 0; j < GEOMAGNETIC_LOOP_COUNT; ++j) {
+                GeomagneticField other(-45.0, -60.0, 0.0, 1580486400000);
+                GeomagneticField field(30.0, 120.0, 100.0, 1700000000000);
+                if ((field.ObtainX() != reference.ObtainX()) || (field.ObtainY() != reference.ObtainY()) ||
+                    (field.ObtainZ() != reference.ObtainZ())) {
+                    ++mismatches[i];
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (int32_t count : mismatches) {
+        ASSERT_EQ(count, 0);
+    }
+}
+
+HWTEST_F(SensorAlgorithmTest, SensorAlgorithmTest_030, TestSize.Level1)
+{
+    GeomagneticPositions positions;
+    positions.latitudes = { 80.0, 30.0, -45.0, 0.0, 89.9, -89.9, 12.5, 60.0, 45.0 };
+    positions.longitudes = { 0.0, 120.0, -60.0, 180.0, 10.0, -10.0, 77.0, -150.0, 5.0 };
+    positions.altitudes = { 0.0, 100.0, 0.0, 5000.0, 0.0, 0.0, 250.0, 1000.0, 0.0 };
+    positions.timeMillis = { 1580486400000 };
+    GeomagneticComponents components;
+    ASSERT_EQ(GeomagneticField::ObtainBatch(positions, components), OHOS::Sensors::SUCCESS);
+    ASSERT_EQ(components.x.size(), positions.latitudes.size());
+    for (size_t i = 0; i < positions.latitudes.size(); ++i) {
+        GeomagneticField field(positions.latitudes[i], positions.longitudes[i], positions.altitudes[i],
+            positions.timeMillis[0]);
+        ASSERT_TRUE(fabs(components.x[i] - field.ObtainX()) < EPS);
+        ASSERT_TRUE(fabs(components.y[i] - field.ObtainY()) < EPS);
+        ASSERT_TRUE(fabs(components.z[i] - field.ObtainZ()) < EPS);
+    }
+    positions.timeMillis = { 1580486400000, 1700000000000 };
+    ASSERT_EQ(GeomagneticField::ObtainBatch(positions, components), OHOS::Sensors::PARAMETER_ERROR);
+}
+
+HWTEST_F(SensorAlgorithmTest, SensorAlgorithmTest_031, TestSize.Level1)
+{
+    GeomagneticField exact(31.201, 121.401, 10.0, 1700000000000);
+    GeomagneticField::SetCacheMode(GeomagneticField::CreateCacheConfig(10.0, 16));
+    GeomagneticField::ResetCacheStats();
+    GeomagneticField first(31.201, 121.401, 10.0, 1700000000000);
+    GeomagneticField second(31.2011, 121.4011, 11.0, 1700000001000);
+    GeomagneticCacheStats stats = GeomagneticField::GetCacheStats();
+    GeomagneticField::SetCacheMode(GeomagneticCacheConfig());
+    ASSERT_EQ(stats.misses, 1);
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(first.ObtainX(), second.ObtainX());
+    ASSERT_EQ(first.ObtainZ(), second.ObtainZ());
+    ASSERT_TRUE(fabs(first.ObtainX() - exact.ObtainX()) < 10.0);
+    ASSERT_TRUE(fabs(first.ObtainY() - exact.ObtainY()) < 10.0);
+    ASSERT_TRUE(fabs(first.ObtainZ() - exact.ObtainZ()) < 10.0);
+}
+
+HWTEST_F(SensorAlgorithmTest, SensorAlgorithmTest_032, TestSize.Level1)
+{
+    std::vector<float> rotationVector = {0.52, -0.336, -0.251};
+    std::vector<float> expected(16);
+    ASSERT_EQ(sensorAlgorithm.CreateRotationMatrix(rotationVector, expected), OHOS::Sensors::SUCCESS);
+    std::array<float, 16> rotationMatrix;
+    ASSERT_EQ(sensorAlgorithm.CreateRotationMatrix(std::array<float, 3> {0.52, -0.336, -0.251}, rotationMatrix),
+        OHOS::Sensors::SUCCESS);
+    for (size_t i = 0; i < rotationMatrix.size(); ++i) {
+        ASSERT_EQ(rotationMatrix[i], expected[i]);
+    }
+    std::vector<float> remapped(16);
+    ASSERT_EQ(sensorAlgorithm.TransformCoordinateSystem(expected, 2, 1, remapped), OHOS::Sensors::SUCCESS);
+    ASSERT_EQ(sensorAlgorithm.TransformCoordinateSystem(rotationMatrix, 2, 1, rotationMatrix), OHOS::Sensors::SUCCESS);
+    for (size_t i = 0; i < rotationMatrix.size(); ++i) {
+        ASSERT_EQ(rotationMatrix[i], remapped[i]);
+    }
+}
+
+HWTEST_F(SensorAlgorithmTest, SensorAlgorithmTest_033, TestSize.Level1)
+{
+    std::vector<RotationVectorData> samples = {
+        {0.52, -0.336, -0.251, 0.745}, {0.0, 0.0, 0.0, 1.0}, {-0.5, 0.5, -0.5, -0.5}, {0.1, 0.2, 0.3, 0.927},
+        {0.0, 0.0, 0.707, 0.707}
+    };
+    std::vector<SensorEvent> events(samples.size() + 1);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        events[i].sensorTypeId = SENSOR_TYPE_ID_ROTATION_VECTOR;
+        events[i].data = reinterpret_cast<uint8_t *>(&samples[i]);
+        events[i].dataLen = sizeof(RotationVectorData);
+    }
+    events.back().sensorTypeId = SENSOR_TYPE_ID_ACCELEROMETER;
+    RotationVectorBatch batch;
+    int32_t num = static_cast<int32_t>(events.size());
+    ASSERT_EQ(sensorAlgorithm.LoadRotationVectors(events.data(), num, batch), OHOS::Sensors::SUCCESS);
+    ASSERT_EQ(batch.x.size(), samples.size());
+    RotationMatrixBatch rotationMatrices;
+    OrientationBatch rotationAngles;
+    ASSERT_EQ(sensorAlgorithm.CreateRotationMatrixBatch(batch, rotationMatrices), OHOS::Sensors::SUCCESS);
+    ASSERT_EQ(sensorAlgorithm.GetDirectionBatch(rotationMatrices, rotationAngles), OHOS::Sensors::SUCCESS);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        std::vector<float> rotationVector = { samples[i].x, samples[i].y, samples[i].z, samples[i].w };
+        std::vector<float> rotationMatrix(9);
+        std::vector<float> rotationAngle(3);
+        ASSERT_EQ(sensorAlgorithm.CreateRotationMatrix(rotationVector, rotationMatrix), OHOS::Sensors::SUCCESS);
+        ASSERT_EQ(sensorAlgorithm.GetDirection(rotationMatrix, rotationAngle), OHOS::Sensors::SUCCESS);
+        for (size_t k = 0; k < rotationMatrix.size(); ++k) {
+            ASSERT_TRUE(fabs(rotationMatrices.elements[k][i] - rotationMatrix[k]) < EPS);
+        }
+        ASSERT_TRUE(fabs(rotationAngles.z[i] - rotationAngle[0]) < EPS);
+        ASSERT_TRUE(fabs(rotationAngles.x[i] - rotationAngle[1]) < EPS);
+        ASSERT_TRUE(fabs(rotationAngles.y[i] - rotationAngle[2]) < EPS);
+    }
+    batch.w.pop_back();
+    ASSERT_EQ(sensorAlgorithm.CreateRotationMatrixBatch(batch, rotationMatrices), OHOS::Sensors::PARAMETER_ERROR);
+}
+
+HWTEST_F(SensorAlgorithmTest, SensorAlgorithmTest_034, TestSize.Level1)
+{
+    RotationVectorBatch batch = MakeRotationGrid();
+    RotationMatrixBatch rotationMatrices;
+    ASSERT_EQ(sensorAlgorithm.CreateRotationMatrixBatch(batch, rotationMatrices), OHOS::Sensors::SUCCESS);
+    // The angles do not depend on the scale of the matrix, tiny and huge scales must not underflow or overflow.
+    for (float scale : { 1.0f, 1e-20f, 1e18f }) {
+        RotationMatrixBatch scaled = rotationMatrices;
+        for (auto &element : scaled.elements) {
+            for (auto &value : element) {
+                value *= scale;
+            }
+        }
+        OrientationBatch rotationAngles;
+        ASSERT_EQ(sensorAlgorithm.GetDirectionBatch(scaled, rotationAngles), OHOS::Sensors::SUCCESS);
+        for (size_t i = 0; i < batch.x.size(); ++i) {
+            std::vector<float> rotationMatrix(THREE_DIMENSIONAL_MATRIX_LENGTH);
+            for (size_t k = 0; k < rotationMatrix.size(); ++k) {
+                rotationMatrix[k] = scaled.elements[k][i];
+            }
+            std::vector<float> rotationAngle(ROTATION_VECTOR_LENGTH);
+            ASSERT_EQ(sensorAlgorithm.GetDirection(rotationMatrix, rotationAngle), OHOS::Sensors::SUCCESS);
+            ASSERT_LT(AngleError(rotationAngles.z[i], rotationAngle[0]), BATCH_ANGLE_EPS);
+            ASSERT_LT(AngleError(rotationAngles.x[i], rotationAngle[1]), BATCH_ANGLE_EPS);
+            ASSERT_LT(AngleError(rotationAngles.y[i], rotationAngle[2]), BATCH_ANGLE_EPS);
+        }
+    }
+}
+
+HWTEST_F(SensorAlgorithmTest, SensorAlgorithmTest_035, TestSize.Level1)
+{
+    RotationVectorBatch batch = MakeRotationGrid();
+    RotationMatrixBatch curRotationMatrices;
+    ASSERT_EQ(sensorAlgorithm.CreateRotationMatrixBatch(batch, curRotationMatrices), OHOS::Sensors::SUCCESS);
+    // Each rotation is compared with the reversed grid, so the differences cover the whole range of asin.
+    std::reverse(batch.x.begin(), batch.x.end());
+    std::reverse(batch.y.begin(), batch.y.end());
+    std::reverse(batch.z.begin(), batch.z.end());
+    RotationMatrixBatch preRotationMatrices;
+    ASSERT_EQ(sensorAlgorithm.CreateRotationMatrixBatch(batch, preRotationMatrices), OHOS::Sensors::SUCCESS);
+    OrientationBatch angleChanges;
+    ASSERT_EQ(sensorAlgorithm.GetAngleModifyBatch(curRotationMatrices, preRotationMatrices, angleChanges),
+        OHOS::Sensors::SUCCESS);
+    for (size_t i = 0; i < batch.x.size(); ++i) {
+        std::vector<float> curRotationMatrix(THREE_DIMENSIONAL_MATRIX_LENGTH);
+        std::vector<float> preRotationMatrix(THREE_DIMENSIONAL_MATRIX_LENGTH);
+        for (size_t k = 0; k < curRotationMatrix.size(); ++k) {
+            curRotationMatrix[k] = curRotationMatrices.elements[k][i];
+            preRotationMatrix[k] = preRotationMatrices.elements[k][i];
+        }
+        std::vector<float> angleChange(ROTATION_VECTOR_LENGTH);
+        ASSERT_EQ(sensorAlgorithm.GetAngleModify(curRotationMatrix, preRotationMatrix, angleChange),
+            OHOS::Sensors::SUCCESS);
+        ASSERT_LT(AngleError(angleChanges.z[i], angleChange[0]), BATCH_ANGLE_EPS);
+        ASSERT_LT(AngleError(angleChanges.x[i], angleChange[1]), BATCH_ANGLE_EPS);
+        ASSERT_LT(AngleError(angleChanges.y[i], angleChange[2]), BATCH_ANGLE_EPS);
+    }
+}
 } // namespace Sensors
 } // namespace OHOS
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dump_data_ring.h"
+#include "sensor_log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "DumpDataRingTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr int32_t FEW_EVENTS = 5;
+constexpr int32_t WRAP_EVENTS = MAX_DUMP_DATA_SIZE * 2 + 5;
+// The writer races the reader until enough copies of a full ring succeeded, bounded in case the reader keeps
+// giving up.
+constexpr int32_t MIN_CONSISTENT_READS = 1000;
+constexpr int64_t MAX_CONCURRENT_EVENTS = 50000000;
+
+// Every field is derived from the sequence number, so an event mixing two writes is detected.
+SensorData MakeEvent(int64_t sequence)
+{
+    SensorData data {};
+    data.sensorTypeId = static_cast<int32_t>(sequence);
+    data.version = static_cast<int32_t>(sequence);
+    data.timestamp = sequence;
+    data.option = static_cast<int32_t>(sequence);
+    data.mode = static_cast<int32_t>(sequence);
+    for (int32_t i = 0; i < SENSOR_MAX_LENGTH; ++i) {
+        data.data[i] = static_cast<uint8_t>(sequence);
+    }
+    data.dataLen = static_cast<uint32_t>(sequence);
+    return data;
+}
+
+bool IsConsistent(const SensorData &data)
+{
+    SensorData expected = MakeEvent(data.timestamp);
+    return (data.sensorTypeId == expected.sensorTypeId) && (data.version == expected.version) &&
+        (data.option == expected.option) && (data.mode == expected.mode) && (data.dataLen == expected.dataLen) &&
+        std::equal(std::begin(data.data), std::end(data.data), std::begin(expected.data));
+}
+
+std::vector<int64_t> GetTimestamps(const std::vector<SensorData> &events)
+{
+    std::vector<int64_t> timestamps;
+    for (const auto &event : events) {
+        timestamps.push_back(event.timestamp);
+    }
+    return timestamps;
+}
+
+std::vector<int64_t> MakeTimestamps(int64_t first, int64_t last)
+{
+    std::vector<int64_t> timestamps;
+    for (int64_t timestamp = first; timestamp < last; ++timestamp) {
+        timestamps.push_back(timestamp);
+    }
+    return timestamps;
+}
+}  // namespace
+
+class DumpDataRingTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void DumpDataRingTest::SetUpTestCase() {}
+
+void DumpDataRingTest::TearDownTestCase() {}
+
+void DumpDataRingTest::SetUp() {}
+
+void DumpDataRingTest::TearDown() {}
+
+HWTEST_F(DumpDataRingTest, DumpDataRingTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("DumpDataRingTest_001 in");
+    // Events come back oldest first, an empty ring reads as empty.
+    DumpDataRing ring;
+    std::vector<SensorData> events;
+    ASSERT_TRUE(ring.Read(events));
+    EXPECT_TRUE(events.empty());
+    for (int32_t i = 0; i < FEW_EVENTS; ++i) {
+        ring.Push(MakeEvent(i));
+    }
+    ASSERT_TRUE(ring.Read(events));
+    EXPECT_EQ(GetTimestamps(events), MakeTimestamps(0, FEW_EVENTS));
+    for (const auto &event : events) {
+        EXPECT_TRUE(IsConsistent(event));
+    }
+}
+
+HWTEST_F(DumpDataRingTest, DumpDataRingTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("DumpDataRingTest_002 in");
+    // Past MAX_DUMP_DATA_SIZE events the oldest are overwritten and the rest stay in order across the wrap.
+    DumpDataRing ring;
+    std::vector<SensorData> events;
+    for (int32_t i = 0; i < WRAP_EVENTS; ++i) {
+        ring.Push(MakeEvent(i));
+        ASSERT_TRUE(ring.Read(events));
+        int64_t first = (i + 1 > MAX_DUMP_DATA_SIZE) ? (i + 1 - MAX_DUMP_DATA_SIZE) : 0;
+        ASSERT_EQ(GetTimestamps(events), MakeTimestamps(first, i + 1)) << "pushed:" << (i + 1);
+    }
+}
+
+HWTEST_F(DumpDataRingTest, DumpDataRingTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("DumpDataRingTest_003 in");
+    // Clear drops the stored events only, the next events are kept as usual, also once the ring wrapped.
+    DumpDataRing ring;
+    std::vector<SensorData> events;
+    for (int32_t i = 0; i < WRAP_EVENTS; ++i) {
+        ring.Push(MakeEvent(i));
+    }
+    ring.Clear();
+    ASSERT_TRUE(ring.Read(events));
+    EXPECT_TRUE(events.empty());
+    for (int32_t i = WRAP_EVENTS; i < WRAP_EVENTS + FEW_EVENTS; ++i) {
+        ring.Push(MakeEvent(i));
+    }
+    ASSERT_TRUE(ring.Read(events));
+    EXPECT_EQ(GetTimestamps(events), MakeTimestamps(WRAP_EVENTS, WRAP_EVENTS + FEW_EVENTS));
+}
+
+HWTEST_F(DumpDataRingTest, DumpDataRingTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("DumpDataRingTest_004 in");
+    // A reader racing the writer never sees a torn event, nor a gap or a reordering between events.
+    DumpDataRing ring;
+    std::atomic_bool isDone = false;
+    std::atomic_int32_t readCount = 0;
+    int64_t pushCount = 0;
+    std::thread writer([&ring, &isDone, &readCount, &pushCount] {
+        while ((readCount < MIN_CONSISTENT_READS) && (pushCount < MAX_CONCURRENT_EVENTS)) {
+            ring.Push(MakeEvent(pushCount++));
+        }
+        isDone = true;
+    });
+    int32_t failCount = 0;
+    bool isTorn = false;
+    bool isOutOfOrder = false;
+    std::vector<SensorData> events;
+    // Failures are only recorded here, the writer must be joined before the test may return.
+    while (!isDone) {
+        if (!ring.Read(events)) {
+            ++failCount;
+            continue;
+        }
+        if (events.size() == MAX_DUMP_DATA_SIZE) {
+            ++readCount;
+        }
+        for (size_t i = 0; i < events.size(); ++i) {
+            isTorn = isTorn || !IsConsistent(events[i]);
+            isOutOfOrder = isOutOfOrder || ((i > 0) && (events[i].timestamp != events[i - 1].timestamp + 1));
+        }
+    }
+    writer.join();
+    SEN_HILOGI("Pushed:%{public}" PRId64 ", consistent reads:%{public}d, given up:%{public}d", pushCount,
+        readCount.load(), failCount);
+    EXPECT_FALSE(isTorn);
+    EXPECT_FALSE(isOutOfOrder);
+    EXPECT_GT(readCount, 0);
+    ASSERT_TRUE(ring.Read(events));
+    EXPECT_EQ(GetTimestamps(events), MakeTimestamps(pushCount - MAX_DUMP_DATA_SIZE, pushCount));
+}
+}  // namespace Sensors
+}  // namespace OHOS
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "fusion_sensor.h"
+#include "sensor_agent_type.h"
+#include "sensor_log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "FusionSensorTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr float ACC_RANGE = 78.4f;
+constexpr int64_t ACC_MIN_PERIOD_NS = 2000000;
+constexpr int64_t GYRO_MIN_PERIOD_NS = 5000000;
+constexpr int64_t ACC_MAX_PERIOD_NS = 1000000000;
+constexpr int64_t GYRO_MAX_PERIOD_NS = 200000000;
+constexpr int64_t PERIOD_NS = 10000000;
+constexpr float GRAVITY = 9.80665f;
+constexpr float EPS = 1e-3f;
+constexpr size_t QUATERNION_SIZE = 4 * sizeof(float);
+constexpr size_t VECTOR_SIZE = 3 * sizeof(float);
+
+Sensor MakeSensor(int32_t sensorId, float maxRange, int64_t minPeriodNs, int64_t maxPeriodNs)
+{
+    Sensor sensor;
+    sensor.SetSensorId(sensorId);
+    sensor.SetSensorTypeId(sensorId);
+    sensor.SetMaxRange(maxRange);
+    sensor.SetPower(1.0f);
+    sensor.SetMinSamplePeriodNs(minPeriodNs);
+    sensor.SetMaxSamplePeriodNs(maxPeriodNs);
+    return sensor;
+}
+
+std::vector<Sensor> MakeHdiSensors()
+{
+    return {
+        MakeSensor(SENSOR_TYPE_ID_ACCELEROMETER, ACC_RANGE, ACC_MIN_PERIOD_NS, ACC_MAX_PERIOD_NS),
+        MakeSensor(SENSOR_TYPE_ID_GYROSCOPE, 0.0f, GYRO_MIN_PERIOD_NS, GYRO_MAX_PERIOD_NS),
+        MakeSensor(SENSOR_TYPE_ID_MAGNETIC_FIELD, 0.0f, 0, 0),
+    };
+}
+
+SensorData MakeEvent(int32_t sensorId, int64_t timestamp, float x, float y, float z)
+{
+    SensorData event = {};
+    event.sensorTypeId = sensorId;
+    event.timestamp = timestamp;
+    event.mode = SENSOR_REALTIME_MODE;
+    float values[] = { x, y, z };
+    memcpy(event.data, values, sizeof(values));
+    event.dataLen = sizeof(values);
+    return event;
+}
+
+// Bit of the output with the given id, in the order returned by Init.
+uint32_t OutputBit(const std::vector<VirtualSensorOutput> &outputs, int32_t sensorId)
+{
+    auto it = std::find_if(outputs.begin(), outputs.end(),
+        [sensorId](const VirtualSensorOutput &output) { return output.sensor.GetSensorId() == sensorId; });
+    return (it == outputs.end()) ? 0 : (1u << static_cast<uint32_t>(it - outputs.begin()));
+}
+
+// Accelerometer first, then two gyroscope samples PERIOD_NS apart, the device lies flat and still.
+std::vector<SensorData> MakeFlatEvents()
+{
+    return {
+        MakeEvent(SENSOR_TYPE_ID_ACCELEROMETER, PERIOD_NS, 0.0f, 0.0f, GRAVITY),
+        MakeEvent(SENSOR_TYPE_ID_MAGNETIC_FIELD, PERIOD_NS, 0.0f, 20.0f, -40.0f),
+        MakeEvent(SENSOR_TYPE_ID_GYROSCOPE, PERIOD_NS, 0.0f, 0.0f, 0.0f),
+        MakeEvent(SENSOR_TYPE_ID_GYROSCOPE, 2 * PERIOD_NS, 0.0f, 0.0f, 0.0f),
+    };
+}
+
+std::vector<SensorData> Process(FusionSensor &fusion, const std::vector<SensorData> &events, uint32_t active)
+{
+    std::vector<SensorData> outputs;
+    fusion.Process(SensorDataSpan(events.data(), events.size()), active, outputs);
+    return outputs;
+}
+}  // namespace
+
+class FusionSensorTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void FusionSensorTest::SetUpTestCase() {}
+
+void FusionSensorTest::TearDownTestCase() {}
+
+void FusionSensorTest::SetUp() {}
+
+void FusionSensorTest::TearDown() {}
+
+HWTEST_F(FusionSensorTest, FusionSensorTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("FusionSensorTest_001 in");
+    FusionSensor fusion;
+    std::vector<VirtualSensorOutput> outputs = fusion.Init(MakeHdiSensors());
+    ASSERT_EQ(outputs.size(), 4);
+    for (const auto &output : outputs) {
+        const Sensor &sensor = output.sensor;
+        bool useMagnetometer = (sensor.GetSensorId() == SENSOR_TYPE_ID_ROTATION_VECTOR);
+        EXPECT_EQ(output.inputs.size(), useMagnetometer ? 3 : 2);
+        // The slowest input bounds the rate, the fastest maximum period bounds the other end.
+        EXPECT_EQ(sensor.GetMinSamplePeriodNs(), GYRO_MIN_PERIOD_NS);
+        EXPECT_EQ(sensor.GetMaxSamplePeriodNs(), GYRO_MAX_PERIOD_NS);
+        EXPECT_FLOAT_EQ(sensor.GetPower(), useMagnetometer ? 3.0f : 2.0f);
+    }
+    EXPECT_NE(OutputBit(outputs, SENSOR_TYPE_ID_GAME_ROTATION_VECTOR), 0);
+    EXPECT_NE(OutputBit(outputs, SENSOR_TYPE_ID_GRAVITY), 0);
+    auto linear = std::find_if(outputs.begin(), outputs.end(), [](const VirtualSensorOutput &output) {
+        return output.sensor.GetSensorId() == SENSOR_TYPE_ID_LINEAR_ACCELERATION;
+    });
+    ASSERT_NE(linear, outputs.end());
+    EXPECT_FLOAT_EQ(linear->sensor.GetMaxRange(), ACC_RANGE);
+}
+
+HWTEST_F(FusionSensorTest, FusionSensorTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("FusionSensorTest_002 in");
+    // One derived event per gyroscope sample, stamped with the time of that sample.
+    FusionSensor fusion;
+    std::vector<VirtualSensorOutput> outputs = fusion.Init(MakeHdiSensors());
+    uint32_t gameBit = OutputBit(outputs, SENSOR_TYPE_ID_GAME_ROTATION_VECTOR);
+    std::vector<SensorData> derived = Process(fusion, MakeFlatEvents(), gameBit);
+    ASSERT_EQ(derived.size(), 2);
+    for (size_t i = 0; i < derived.size(); ++i) {
+        EXPECT_EQ(derived[i].sensorTypeId, SENSOR_TYPE_ID_GAME_ROTATION_VECTOR);
+        EXPECT_EQ(derived[i].timestamp, static_cast<int64_t>(i + 1) * PERIOD_NS);
+        EXPECT_EQ(derived[i].mode, SENSOR_REALTIME_MODE);
+        EXPECT_EQ(derived[i].dataLen, QUATERNION_SIZE);
+    }
+    const float *q = reinterpret_cast<const float *>(derived[1].data);
+    EXPECT_NEAR(q[3], 1.0f, EPS);
+}
+
+HWTEST_F(FusionSensorTest, FusionSensorTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("FusionSensorTest_003 in");
+    // Gravity and linear acceleration share the filter without magnetometer.
+    FusionSensor fusion;
+    std::vector<VirtualSensorOutput> outputs = fusion.Init(MakeHdiSensors());
+    uint32_t active = OutputBit(outputs, SENSOR_TYPE_ID_GRAVITY) |
+        OutputBit(outputs, SENSOR_TYPE_ID_LINEAR_ACCELERATION);
+    std::vector<SensorData> derived = Process(fusion, MakeFlatEvents(), active);
+    ASSERT_EQ(derived.size(), 4);
+    for (const auto &event : derived) {
+        EXPECT_EQ(event.dataLen, VECTOR_SIZE);
+        const float *values = reinterpret_cast<const float *>(event.data);
+        float z = (event.sensorTypeId == SENSOR_TYPE_ID_GRAVITY) ? GRAVITY : 0.0f;
+        EXPECT_NEAR(values[0], 0.0f, EPS);
+        EXPECT_NEAR(values[1], 0.0f, EPS);
+        EXPECT_NEAR(values[2], z, EPS);
+    }
+}
+
+HWTEST_F(FusionSensorTest, FusionSensorTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("FusionSensorTest_004 in");
+    // The rotation vector waits for the magnetometer, the game rotation vector does not.
+    FusionSensor fusion;
+    std::vector<VirtualSensorOutput> outputs = fusion.Init(MakeHdiSensors());
+    uint32_t rotationBit = OutputBit(outputs, SENSOR_TYPE_ID_ROTATION_VECTOR);
+    std::vector<SensorData> events = MakeFlatEvents();
+    events.erase(events.begin() + 1);
+    EXPECT_TRUE(Process(fusion, events, rotationBit).empty());
+    std::vector<SensorData> derived = Process(fusion, MakeFlatEvents(), rotationBit);
+    ASSERT_EQ(derived.size(), 2);
+    EXPECT_EQ(derived[0].sensorTypeId, SENSOR_TYPE_ID_ROTATION_VECTOR);
+}
+
+HWTEST_F(FusionSensorTest, FusionSensorTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("FusionSensorTest_005 in");
+    // Other sensors and short payloads are ignored.
+    FusionSensor fusion;
+    std::vector<VirtualSensorOutput> outputs = fusion.Init(MakeHdiSensors());
+    uint32_t gameBit = OutputBit(outputs, SENSOR_TYPE_ID_GAME_ROTATION_VECTOR);
+    std::vector<SensorData> events = MakeFlatEvents();
+    SensorData shortGyro = MakeEvent(SENSOR_TYPE_ID_GYROSCOPE, 3 * PERIOD_NS, 0.0f, 0.0f, 0.0f);
+    shortGyro.dataLen = sizeof(float);
+    events.push_back(shortGyro);
+    events.push_back(MakeEvent(SENSOR_TYPE_ID_AMBIENT_LIGHT, 3 * PERIOD_NS, 1.0f, 0.0f, 0.0f));
+    EXPECT_EQ(Process(fusion, events, gameBit).size(), 2);
+}
+}  // namespace Sensors
+}  // namespace OHOS
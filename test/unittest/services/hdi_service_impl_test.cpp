@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hdi_service_impl.h"
+#include "sensor_errors.h"
+#include "sensor_log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "HdiServiceImplTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr int64_t FAST_PERIOD_NS = 10000000;
+constexpr int64_t SLOW_PERIOD_NS = 50000000;
+constexpr int32_t RUN_TIME_MS = 500;
+constexpr int32_t SHORT_RUN_TIME_MS = 200;
+// Far longer than the test runs, a sensor still on this period reports nothing.
+constexpr int64_t LOAD_PERIOD_NS = 5000000000;
+constexpr uint32_t FIFO_DEPTH = 4;
+constexpr uint32_t SEED = 1234;
+constexpr uint32_t ACCELEROMETER_DATA_LEN = 3 * sizeof(float);
+constexpr uint32_t SAR_DATA_LEN = sizeof(float);
+
+struct ReceivedEvent {
+    int32_t sensorTypeId;
+    int64_t timestamp;
+    uint32_t dataLen;
+};
+
+std::mutex g_eventMutex;
+std::vector<ReceivedEvent> g_events;
+std::vector<size_t> g_batchSizes;
+std::atomic_int32_t g_deathCount = 0;
+
+// The event data points into the mock and is only valid during the call, the fields checked are copied.
+void RecordBatch(SensorEvent *events, size_t eventNum)
+{
+    std::lock_guard<std::mutex> eventLock(g_eventMutex);
+    g_batchSizes.push_back(eventNum);
+    for (size_t i = 0; i < eventNum; ++i) {
+        g_events.push_back({ events[i].sensorTypeId, events[i].timestamp, events[i].dataLen });
+    }
+}
+
+std::vector<ReceivedEvent> TakeEvents(int32_t sensorId)
+{
+    std::lock_guard<std::mutex> eventLock(g_eventMutex);
+    std::vector<ReceivedEvent> events;
+    std::copy_if(g_events.begin(), g_events.end(), std::back_inserter(events),
+        [sensorId](const ReceivedEvent &event) { return event.sensorTypeId == sensorId; });
+    return events;
+}
+
+void ClearEvents()
+{
+    std::lock_guard<std::mutex> eventLock(g_eventMutex);
+    g_events.clear();
+    g_batchSizes.clear();
+}
+
+void RecordDeath()
+{
+    ++g_deathCount;
+}
+}  // namespace
+
+class HdiServiceImplTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void HdiServiceImplTest::SetUpTestCase()
+{
+    HdiServiceImpl::GetInstance().RegisterBatch(RecordBatch);
+    HdiServiceImpl::GetInstance().RegisterDeathCallback(RecordDeath);
+}
+
+void HdiServiceImplTest::TearDownTestCase() {}
+
+void HdiServiceImplTest::SetUp()
+{
+    ClearEvents();
+}
+
+void HdiServiceImplTest::TearDown()
+{
+    HdiServiceImpl::GetInstance().ClearLoadGenerator();
+}
+
+HWTEST_F(HdiServiceImplTest, HdiServiceImplTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("HdiServiceImplTest_001 in");
+    // Every sensor in the list can be enabled, the mock lists the accelerometer, the color and the SAR sensor.
+    HdiServiceImpl &hdiService = HdiServiceImpl::GetInstance();
+    std::vector<SensorInfo> sensorList;
+    ASSERT_EQ(hdiService.GetSensorList(sensorList), ERR_OK);
+    std::vector<int32_t> sensorIds;
+    for (const auto &sensorInfo : sensorList) {
+        sensorIds.push_back(sensorInfo.sensorId);
+        EXPECT_EQ(sensorInfo.sensorId, sensorInfo.sensorTypeId);
+        EXPECT_EQ(hdiService.EnableSensor(sensorInfo.sensorId), ERR_OK);
+    }
+    for (int32_t sensorId : sensorIds) {
+        EXPECT_EQ(hdiService.DisableSensor(sensorId), ERR_OK);
+    }
+    std::sort(sensorIds.begin(), sensorIds.end());
+    std::vector<int32_t> expectedIds = { SENSOR_TYPE_ID_ACCELEROMETER, SENSOR_TYPE_ID_COLOR, SENSOR_TYPE_ID_SAR };
+    EXPECT_EQ(sensorIds, expectedIds);
+}
+
+HWTEST_F(HdiServiceImplTest, HdiServiceImplTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("HdiServiceImplTest_002 in");
+    // Two sensors at different rates each keep their own period.
+    HdiServiceImpl &hdiService = HdiServiceImpl::GetInstance();
+    ASSERT_EQ(hdiService.SetBatch(SENSOR_TYPE_ID_ACCELEROMETER, FAST_PERIOD_NS, 0), ERR_OK);
+    ASSERT_EQ(hdiService.SetBatch(SENSOR_TYPE_ID_SAR, SLOW_PERIOD_NS, 0), ERR_OK);
+    ASSERT_EQ(hdiService.EnableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    ASSERT_EQ(hdiService.EnableSensor(SENSOR_TYPE_ID_SAR), ERR_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(RUN_TIME_MS));
+    EXPECT_EQ(hdiService.DisableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    EXPECT_EQ(hdiService.DisableSensor(SENSOR_TYPE_ID_SAR), ERR_OK);
+    std::vector<ReceivedEvent> fastEvents = TakeEvents(SENSOR_TYPE_ID_ACCELEROMETER);
+    std::vector<ReceivedEvent> slowEvents = TakeEvents(SENSOR_TYPE_ID_SAR);
+    ASSERT_GE(slowEvents.size(), 2);
+    EXPECT_GT(fastEvents.size(), slowEvents.size() * 2);
+    // Timestamps are the sample deadlines, so consecutive events are exactly one period apart.
+    for (size_t i = 1; i < fastEvents.size(); ++i) {
+        EXPECT_EQ(fastEvents[i].timestamp - fastEvents[i - 1].timestamp, FAST_PERIOD_NS);
+        EXPECT_EQ(fastEvents[i].dataLen, ACCELEROMETER_DATA_LEN);
+    }
+    for (size_t i = 1; i < slowEvents.size(); ++i) {
+        EXPECT_EQ(slowEvents[i].timestamp - slowEvents[i - 1].timestamp, SLOW_PERIOD_NS);
+        EXPECT_EQ(slowEvents[i].dataLen, SAR_DATA_LEN);
+    }
+    // The sensors are served in deadline order, their events interleave by timestamp.
+    std::lock_guard<std::mutex> eventLock(g_eventMutex);
+    EXPECT_TRUE(std::is_sorted(g_events.begin(), g_events.end(),
+        [](const ReceivedEvent &left, const ReceivedEvent &right) { return left.timestamp < right.timestamp; }));
+}
+
+HWTEST_F(HdiServiceImplTest, HdiServiceImplTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("HdiServiceImplTest_003 in");
+    // A report interval of several samples holds the events back and flushes them together, like a FIFO.
+    HdiServiceImpl &hdiService = HdiServiceImpl::GetInstance();
+    ASSERT_EQ(hdiService.SetBatch(SENSOR_TYPE_ID_ACCELEROMETER, FAST_PERIOD_NS, FAST_PERIOD_NS * FIFO_DEPTH), ERR_OK);
+    ASSERT_EQ(hdiService.EnableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(RUN_TIME_MS));
+    EXPECT_EQ(hdiService.DisableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    ASSERT_EQ(hdiService.SetBatch(SENSOR_TYPE_ID_ACCELEROMETER, FAST_PERIOD_NS, 0), ERR_OK);
+    std::vector<ReceivedEvent> events = TakeEvents(SENSOR_TYPE_ID_ACCELEROMETER);
+    std::lock_guard<std::mutex> eventLock(g_eventMutex);
+    ASSERT_FALSE(g_batchSizes.empty());
+    for (size_t batchSize : g_batchSizes) {
+        EXPECT_EQ(batchSize, FIFO_DEPTH);
+    }
+    // The held events keep their sample time.
+    for (size_t i = 1; i < events.size(); ++i) {
+        EXPECT_EQ(events[i].timestamp - events[i - 1].timestamp, FAST_PERIOD_NS);
+    }
+}
+
+HWTEST_F(HdiServiceImplTest, HdiServiceImplTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("HdiServiceImplTest_004 in");
+    // The load generator overrides the rate, clearing it goes back to the rate set through SetBatch right away.
+    HdiServiceImpl &hdiService = HdiServiceImpl::GetInstance();
+    ASSERT_EQ(hdiService.SetBatch(SENSOR_TYPE_ID_ACCELEROMETER, FAST_PERIOD_NS, 0), ERR_OK);
+    LoadGeneratorConfig config = { SEED, { { SENSOR_TYPE_ID_ACCELEROMETER, LOAD_PERIOD_NS, FIFO_DEPTH } } };
+    ASSERT_EQ(hdiService.SetLoadGenerator(config), ERR_OK);
+    ASSERT_EQ(hdiService.EnableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(SHORT_RUN_TIME_MS));
+    EXPECT_TRUE(TakeEvents(SENSOR_TYPE_ID_ACCELEROMETER).empty());
+    hdiService.ClearLoadGenerator();
+    std::this_thread::sleep_for(std::chrono::milliseconds(SHORT_RUN_TIME_MS));
+    EXPECT_EQ(hdiService.DisableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    std::vector<ReceivedEvent> events = TakeEvents(SENSOR_TYPE_ID_ACCELEROMETER);
+    ASSERT_GE(events.size(), 2);
+    for (size_t i = 1; i < events.size(); ++i) {
+        EXPECT_EQ(events[i].timestamp - events[i - 1].timestamp, FAST_PERIOD_NS);
+    }
+}
+
+HWTEST_F(HdiServiceImplTest, HdiServiceImplTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("HdiServiceImplTest_005 in");
+    // After a death the sensors and the data callbacks are gone, the death callbacks are notified once.
+    HdiServiceImpl &hdiService = HdiServiceImpl::GetInstance();
+    ASSERT_EQ(hdiService.EnableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    int32_t deathCount = g_deathCount;
+    hdiService.SimulateDeath();
+    EXPECT_EQ(g_deathCount, deathCount + 1);
+    EXPECT_EQ(hdiService.DisableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_NO_INIT);
+    ClearEvents();
+    ASSERT_EQ(hdiService.EnableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(SHORT_RUN_TIME_MS));
+    EXPECT_TRUE(TakeEvents(SENSOR_TYPE_ID_ACCELEROMETER).empty());
+    // Registering again, as the service does on reconnect, brings the events back.
+    ASSERT_EQ(hdiService.RegisterBatch(RecordBatch), ERR_OK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(SHORT_RUN_TIME_MS));
+    EXPECT_EQ(hdiService.DisableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ERR_OK);
+    EXPECT_FALSE(TakeEvents(SENSOR_TYPE_ID_ACCELEROMETER).empty());
+}
+}  // namespace Sensors
+}  // namespace OHOS
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+#include "orientation_filter.h"
+#include "sensor_log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "OrientationFilterTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+using Vector3 = OrientationFilter::Vector3;
+constexpr float GRAVITY = 9.80665f;
+constexpr float EPS = 1e-3f;
+// 1 degree.
+constexpr float ANGLE_TOLERANCE = 0.0175f;
+constexpr int64_t PERIOD_NS = 10000000;
+constexpr int64_t NS_PER_SECOND = 1000000000;
+constexpr float TILT = 0.5f;
+constexpr float YAW_RATE = 1.0f;
+const Vector3 FLAT = { 0.0f, 0.0f, GRAVITY };
+const Vector3 FIELD = { 0.0f, 20.0f, -40.0f };
+const Vector3 ZERO_RATE = { 0.0f, 0.0f, 0.0f };
+
+float Dot(const Vector3 &a, const Vector3 &b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+float Norm(const Vector3 &v)
+{
+    return std::sqrt(Dot(v, v));
+}
+
+float Angle(const Vector3 &a, const Vector3 &b)
+{
+    float cosine = Dot(a, b) / (Norm(a) * Norm(b));
+    return std::acos(std::fmin(1.0f, std::fmax(-1.0f, cosine)));
+}
+
+// Feed 'seconds' of samples at PERIOD_NS, returning the timestamp after the last one.
+int64_t Feed(OrientationFilter &filter, const Vector3 &gyro, int64_t timestamp, int64_t seconds)
+{
+    int64_t end = timestamp + seconds * NS_PER_SECOND;
+    for (; timestamp < end; timestamp += PERIOD_NS) {
+        filter.Update(gyro, timestamp);
+    }
+    return timestamp;
+}
+}  // namespace
+
+class OrientationFilterTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void OrientationFilterTest::SetUpTestCase() {}
+
+void OrientationFilterTest::TearDownTestCase() {}
+
+void OrientationFilterTest::SetUp() {}
+
+void OrientationFilterTest::TearDown() {}
+
+HWTEST_F(OrientationFilterTest, OrientationFilterTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("OrientationFilterTest_001 in");
+    // The attitude is only valid once the samples needed to seed it have arrived.
+    OrientationFilter gameFilter(false);
+    EXPECT_FALSE(gameFilter.Update(ZERO_RATE, PERIOD_NS));
+    gameFilter.SetAccelerometer(FLAT);
+    EXPECT_TRUE(gameFilter.Update(ZERO_RATE, PERIOD_NS));
+    OrientationFilter filter(true);
+    filter.SetAccelerometer(FLAT);
+    EXPECT_FALSE(filter.Update(ZERO_RATE, PERIOD_NS));
+    filter.SetMagnetometer(FIELD);
+    EXPECT_TRUE(filter.Update(ZERO_RATE, PERIOD_NS));
+    filter.Reset();
+    EXPECT_FALSE(filter.Update(ZERO_RATE, PERIOD_NS));
+}
+
+HWTEST_F(OrientationFilterTest, OrientationFilterTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("OrientationFilterTest_002 in");
+    // A device lying flat and still: identity attitude, all of the acceleration is gravity.
+    OrientationFilter filter(false);
+    filter.SetAccelerometer(FLAT);
+    Feed(filter, ZERO_RATE, PERIOD_NS, 1);
+    OrientationFilter::Quaternion q = filter.GetQuaternion();
+    EXPECT_NEAR(q[0], 0.0f, EPS);
+    EXPECT_NEAR(q[1], 0.0f, EPS);
+    EXPECT_NEAR(q[2], 0.0f, EPS);
+    EXPECT_NEAR(q[3], 1.0f, EPS);
+    Vector3 gravity = filter.GetGravity();
+    Vector3 linear = filter.GetLinearAcceleration();
+    for (size_t i = 0; i < gravity.size(); ++i) {
+        EXPECT_NEAR(gravity[i], FLAT[i], EPS);
+        EXPECT_NEAR(linear[i], 0.0f, EPS);
+    }
+}
+
+HWTEST_F(OrientationFilterTest, OrientationFilterTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("OrientationFilterTest_003 in");
+    // Seeded flat, then tilted without any gyroscope signal: the accelerometer correction pulls gravity over.
+    OrientationFilter filter(false);
+    filter.SetAccelerometer(FLAT);
+    int64_t timestamp = Feed(filter, ZERO_RATE, PERIOD_NS, 1);
+    Vector3 tilted = { 0.0f, GRAVITY * std::sin(TILT), GRAVITY * std::cos(TILT) };
+    filter.SetAccelerometer(tilted);
+    timestamp = Feed(filter, ZERO_RATE, timestamp, 1);
+    float early = Angle(filter.GetGravity(), tilted);
+    EXPECT_GT(early, ANGLE_TOLERANCE);
+    EXPECT_LT(early, TILT);
+    Feed(filter, ZERO_RATE, timestamp, 20);
+    EXPECT_LT(Angle(filter.GetGravity(), tilted), ANGLE_TOLERANCE);
+    EXPECT_NEAR(Norm(filter.GetLinearAcceleration()), 0.0f, GRAVITY * ANGLE_TOLERANCE);
+}
+
+HWTEST_F(OrientationFilterTest, OrientationFilterTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("OrientationFilterTest_004 in");
+    // A turn about gravity is integrated from the gyroscope and leaves gravity untouched.
+    OrientationFilter filter(false);
+    filter.SetAccelerometer(FLAT);
+    int64_t timestamp = Feed(filter, ZERO_RATE, PERIOD_NS, 1);
+    Feed(filter, { 0.0f, 0.0f, YAW_RATE }, timestamp, 1);
+    OrientationFilter::Quaternion q = filter.GetQuaternion();
+    float halfYaw = 0.5f * YAW_RATE;
+    EXPECT_NEAR(q[0], 0.0f, EPS);
+    EXPECT_NEAR(q[1], 0.0f, EPS);
+    EXPECT_NEAR(q[2], std::sin(halfYaw), ANGLE_TOLERANCE);
+    EXPECT_NEAR(q[3], std::cos(halfYaw), ANGLE_TOLERANCE);
+    EXPECT_LT(Angle(filter.GetGravity(), FLAT), ANGLE_TOLERANCE);
+}
+
+HWTEST_F(OrientationFilterTest, OrientationFilterTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("OrientationFilterTest_005 in");
+    // With the magnetometer the heading follows the field: a field rotated about gravity rotates the attitude.
+    float yaw = 0.8f;
+    Vector3 rotated = { -FIELD[1] * std::sin(yaw), FIELD[1] * std::cos(yaw), FIELD[2] };
+    OrientationFilter reference(true);
+    reference.SetAccelerometer(FLAT);
+    reference.SetMagnetometer(FIELD);
+    Feed(reference, ZERO_RATE, PERIOD_NS, 1);
+    OrientationFilter filter(true);
+    filter.SetAccelerometer(FLAT);
+    filter.SetMagnetometer(rotated);
+    Feed(filter, ZERO_RATE, PERIOD_NS, 1);
+    OrientationFilter::Quaternion q = reference.GetQuaternion();
+    OrientationFilter::Quaternion p = filter.GetQuaternion();
+    // Relative yaw from the z and w components, both attitudes are pure rotations about z.
+    float relative = 2.0f * (std::atan2(q[2], q[3]) - std::atan2(p[2], p[3]));
+    EXPECT_NEAR(relative, yaw, ANGLE_TOLERANCE);
+}
+}  // namespace Sensors
+}  // namespace OHOS
@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "report_data_callback.h"
+#include "sensor_errors.h"
+#include "sensor_latency_tracker.h"
+#include "sensor_log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "ReportDataCallbackTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr int32_t SENSOR_ID = 1;
+constexpr int64_t HDI_TIME_NS = 123456;
+constexpr int32_t WRAP_MARGIN = 3;
+constexpr int32_t BATCH_NUM = 10;
+constexpr int32_t OVERFLOW_NUM = 100;
+
+// Events numbered by timestamp, so the order in the ring can be checked.
+std::vector<SensorData> MakeEvents(int64_t firstTimestamp, int32_t count)
+{
+    std::vector<SensorData> events(count);
+    for (int32_t i = 0; i < count; ++i) {
+        events[i].sensorTypeId = SENSOR_ID;
+        events[i].timestamp = firstTimestamp + i;
+    }
+    return events;
+}
+
+// Consumes events as the data thread does and returns their timestamps.
+std::vector<int64_t> Drain(CircularEventBuf &eventsBuf, int32_t count)
+{
+    std::vector<int64_t> timestamps;
+    for (int32_t i = 0; (i < count) && (eventsBuf.eventNum > 0); ++i) {
+        timestamps.push_back(eventsBuf.circularBuf[eventsBuf.readPos].timestamp);
+        eventsBuf.readPos = (eventsBuf.readPos + 1) % CIRCULAR_BUF_LEN;
+        eventsBuf.eventNum--;
+    }
+    return timestamps;
+}
+
+std::vector<int64_t> MakeTimestamps(int64_t firstTimestamp, int32_t count)
+{
+    std::vector<int64_t> timestamps;
+    for (int32_t i = 0; i < count; ++i) {
+        timestamps.push_back(firstTimestamp + i);
+    }
+    return timestamps;
+}
+}  // namespace
+
+class ReportDataCallbackTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+
+protected:
+    sptr<ReportDataCallback> callback_;
+};
+
+void ReportDataCallbackTest::SetUpTestCase() {}
+
+void ReportDataCallbackTest::TearDownTestCase() {}
+
+void ReportDataCallbackTest::SetUp()
+{
+    callback_ = new (std::nothrow) ReportDataCallback();
+}
+
+void ReportDataCallbackTest::TearDown()
+{
+    SensorLatencyTracker::SetEnabled(false);
+    callback_ = nullptr;
+}
+
+HWTEST_F(ReportDataCallbackTest, ReportDataCallbackTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("ReportDataCallbackTest_001 in");
+    // A batch written WRAP_MARGIN slots before the end of the ring continues at slot 0 in order.
+    ASSERT_NE(callback_, nullptr);
+    CircularEventBuf &eventsBuf = callback_->GetEventData();
+    int32_t leadNum = CIRCULAR_BUF_LEN - WRAP_MARGIN;
+    std::vector<SensorData> lead = MakeEvents(0, leadNum);
+    ASSERT_EQ(callback_->ReportEventsCallback(lead.data(), leadNum, callback_, 0), ERR_OK);
+    ASSERT_EQ(Drain(eventsBuf, leadNum).size(), leadNum);
+    SensorLatencyTracker::SetEnabled(true);
+    std::vector<SensorData> batch = MakeEvents(leadNum, BATCH_NUM);
+    ASSERT_EQ(callback_->ReportEventsCallback(batch.data(), BATCH_NUM, callback_, HDI_TIME_NS), ERR_OK);
+    EXPECT_EQ(eventsBuf.eventNum, BATCH_NUM);
+    EXPECT_EQ(eventsBuf.readPos, leadNum);
+    EXPECT_EQ(eventsBuf.writePosition, BATCH_NUM - WRAP_MARGIN);
+    // The stamps follow the events into the wrapped slots.
+    for (int32_t i = 0; i < BATCH_NUM; ++i) {
+        EXPECT_EQ(eventsBuf.latencyStamps[(leadNum + i) % CIRCULAR_BUF_LEN].hdiCallbackNs, HDI_TIME_NS);
+    }
+    EXPECT_EQ(Drain(eventsBuf, BATCH_NUM), MakeTimestamps(leadNum, BATCH_NUM));
+}
+
+HWTEST_F(ReportDataCallbackTest, ReportDataCallbackTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("ReportDataCallbackTest_002 in");
+    // A batch larger than the free space overwrites the oldest events, readPos moves to the oldest survivor.
+    ASSERT_NE(callback_, nullptr);
+    CircularEventBuf &eventsBuf = callback_->GetEventData();
+    int32_t leadNum = CIRCULAR_BUF_LEN - OVERFLOW_NUM / 2;
+    std::vector<SensorData> lead = MakeEvents(0, leadNum);
+    ASSERT_EQ(callback_->ReportEventsCallback(lead.data(), leadNum, callback_, 0), ERR_OK);
+    EXPECT_EQ(eventsBuf.readPos, 0);
+    std::vector<SensorData> batch = MakeEvents(leadNum, OVERFLOW_NUM);
+    ASSERT_EQ(callback_->ReportEventsCallback(batch.data(), OVERFLOW_NUM, callback_, 0), ERR_OK);
+    int32_t totalNum = leadNum + OVERFLOW_NUM;
+    EXPECT_EQ(eventsBuf.eventNum, CIRCULAR_BUF_LEN);
+    EXPECT_EQ(eventsBuf.writePosition, totalNum - CIRCULAR_BUF_LEN);
+    EXPECT_EQ(eventsBuf.readPos, eventsBuf.writePosition);
+    EXPECT_EQ(Drain(eventsBuf, CIRCULAR_BUF_LEN), MakeTimestamps(totalNum - CIRCULAR_BUF_LEN, CIRCULAR_BUF_LEN));
+}
+
+HWTEST_F(ReportDataCallbackTest, ReportDataCallbackTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("ReportDataCallbackTest_003 in");
+    // A batch longer than the ring keeps only its newest CIRCULAR_BUF_LEN events.
+    ASSERT_NE(callback_, nullptr);
+    CircularEventBuf &eventsBuf = callback_->GetEventData();
+    std::vector<SensorData> lead = MakeEvents(0, BATCH_NUM);
+    ASSERT_EQ(callback_->ReportEventsCallback(lead.data(), BATCH_NUM, callback_, 0), ERR_OK);
+    int32_t batchNum = CIRCULAR_BUF_LEN + OVERFLOW_NUM;
+    std::vector<SensorData> batch = MakeEvents(BATCH_NUM, batchNum);
+    ASSERT_EQ(callback_->ReportEventsCallback(batch.data(), batchNum, callback_, 0), ERR_OK);
+    EXPECT_EQ(eventsBuf.eventNum, CIRCULAR_BUF_LEN);
+    EXPECT_EQ(eventsBuf.writePosition, BATCH_NUM);
+    EXPECT_EQ(eventsBuf.readPos, BATCH_NUM);
+    EXPECT_EQ(Drain(eventsBuf, CIRCULAR_BUF_LEN), MakeTimestamps(BATCH_NUM + OVERFLOW_NUM, CIRCULAR_BUF_LEN));
+}
+
+HWTEST_F(ReportDataCallbackTest, ReportDataCallbackTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("ReportDataCallbackTest_004 in");
+    // Single events and batches mix, each overwrite moves readPos past the dropped event.
+    ASSERT_NE(callback_, nullptr);
+    CircularEventBuf &eventsBuf = callback_->GetEventData();
+    std::vector<SensorData> lead = MakeEvents(0, CIRCULAR_BUF_LEN);
+    ASSERT_EQ(callback_->ReportEventsCallback(lead.data(), CIRCULAR_BUF_LEN, callback_, 0), ERR_OK);
+    EXPECT_EQ(eventsBuf.readPos, 0);
+    std::vector<SensorData> single = MakeEvents(CIRCULAR_BUF_LEN, 1);
+    ASSERT_EQ(callback_->ReportEventCallback(single.data(), callback_, 0), ERR_OK);
+    EXPECT_EQ(eventsBuf.eventNum, CIRCULAR_BUF_LEN);
+    EXPECT_EQ(eventsBuf.readPos, 1);
+    std::vector<SensorData> batch = MakeEvents(CIRCULAR_BUF_LEN + 1, BATCH_NUM);
+    ASSERT_EQ(callback_->ReportEventsCallback(batch.data(), BATCH_NUM, callback_, 0), ERR_OK);
+    EXPECT_EQ(eventsBuf.readPos, BATCH_NUM + 1);
+    EXPECT_EQ(Drain(eventsBuf, CIRCULAR_BUF_LEN), MakeTimestamps(BATCH_NUM + 1, CIRCULAR_BUF_LEN));
+    // An empty ring takes a batch without touching readPos.
+    int32_t readPos = eventsBuf.readPos;
+    ASSERT_EQ(callback_->ReportEventsCallback(batch.data(), BATCH_NUM, callback_, 0), ERR_OK);
+    EXPECT_EQ(eventsBuf.readPos, readPos);
+    EXPECT_EQ(eventsBuf.eventNum, BATCH_NUM);
+}
+}  // namespace Sensors
+}  // namespace OHOS
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sensor_data_processer.h"
+#include "sensor_log.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorDataProcesserTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr int64_t SENSOR_PERIOD_NS = 10000000;
+constexpr int64_t START_NS = 5000000000;
+constexpr int64_t GAP_NS = 1000000000;
+// Sensor timestamps wander by up to 1/5 of the period around their grid, two neighbours then differ by less than
+// the half period the due check tolerates.
+constexpr int64_t JITTER_NS = SENSOR_PERIOD_NS / 5;
+constexpr size_t EVENT_NUM = 1000;
+
+// Feeds events at the given timestamps and returns the timestamps of the forwarded ones.
+std::vector<int64_t> Forward(sptr<FifoCacheData> fifoCacheData, const std::vector<int64_t> &timestamps,
+    const ChannelPeriod &period)
+{
+    std::vector<int64_t> forwarded;
+    for (int64_t timestamp : timestamps) {
+        SensorData data = {};
+        data.timestamp = timestamp;
+        if (SensorDataProcesser::IsEventDue(fifoCacheData, data, period)) {
+            forwarded.push_back(timestamp);
+        }
+    }
+    return forwarded;
+}
+
+std::vector<int64_t> GenerateTimestamps(int64_t startNs, int64_t periodNs, size_t count)
+{
+    std::vector<int64_t> timestamps;
+    for (size_t i = 0; i < count; ++i) {
+        timestamps.push_back(startNs + static_cast<int64_t>(i) * periodNs);
+    }
+    return timestamps;
+}
+
+double GetAveragePeriod(const std::vector<int64_t> &forwarded)
+{
+    if (forwarded.size() < 2) {
+        return 0.0;
+    }
+    return static_cast<double>(forwarded.back() - forwarded.front()) / (forwarded.size() - 1);
+}
+}  // namespace
+
+class SensorDataProcesserTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void SensorDataProcesserTest::SetUpTestCase() {}
+
+void SensorDataProcesserTest::TearDownTestCase() {}
+
+void SensorDataProcesserTest::SetUp() {}
+
+void SensorDataProcesserTest::TearDown() {}
+
+HWTEST_F(SensorDataProcesserTest, SensorDataProcesserTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("SensorDataProcesserTest_001 in");
+    // A client at the sensor rate gets every event, one at half the rate every other event.
+    std::vector<int64_t> timestamps = GenerateTimestamps(START_NS, SENSOR_PERIOD_NS, EVENT_NUM);
+    sptr<FifoCacheData> sameRate = new (std::nothrow) FifoCacheData();
+    ASSERT_NE(sameRate, nullptr);
+    EXPECT_EQ(Forward(sameRate, timestamps, { SENSOR_PERIOD_NS, SENSOR_PERIOD_NS }).size(), EVENT_NUM);
+    sptr<FifoCacheData> halfRate = new (std::nothrow) FifoCacheData();
+    ASSERT_NE(halfRate, nullptr);
+    std::vector<int64_t> forwarded = Forward(halfRate, timestamps, { SENSOR_PERIOD_NS * 2, SENSOR_PERIOD_NS });
+    ASSERT_EQ(forwarded.size(), EVENT_NUM / 2);
+    for (size_t i = 1; i < forwarded.size(); ++i) {
+        EXPECT_EQ(forwarded[i] - forwarded[i - 1], SENSOR_PERIOD_NS * 2);
+    }
+}
+
+HWTEST_F(SensorDataProcesserTest, SensorDataProcesserTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("SensorDataProcesserTest_002 in");
+    // A client asking faster than the sensor runs gets every event, without a burst to catch up.
+    sptr<FifoCacheData> fifoCacheData = new (std::nothrow) FifoCacheData();
+    ASSERT_NE(fifoCacheData, nullptr);
+    std::vector<int64_t> timestamps = GenerateTimestamps(START_NS, SENSOR_PERIOD_NS, EVENT_NUM);
+    std::vector<int64_t> forwarded = Forward(fifoCacheData, timestamps, { SENSOR_PERIOD_NS / 4, SENSOR_PERIOD_NS });
+    EXPECT_EQ(forwarded.size(), EVENT_NUM);
+    EXPECT_EQ(fifoCacheData->GetNextDueTimestamp(), timestamps.back() + SENSOR_PERIOD_NS / 4);
+}
+
+HWTEST_F(SensorDataProcesserTest, SensorDataProcesserTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("SensorDataProcesserTest_003 in");
+    // Off a harmonic the events alternate between two and three sensor periods, 25ms on average.
+    sptr<FifoCacheData> fifoCacheData = new (std::nothrow) FifoCacheData();
+    ASSERT_NE(fifoCacheData, nullptr);
+    int64_t clientPeriodNs = SENSOR_PERIOD_NS * 5 / 2;
+    std::vector<int64_t> timestamps = GenerateTimestamps(START_NS, SENSOR_PERIOD_NS, EVENT_NUM);
+    std::vector<int64_t> forwarded = Forward(fifoCacheData, timestamps, { clientPeriodNs, SENSOR_PERIOD_NS });
+    EXPECT_NEAR(GetAveragePeriod(forwarded), static_cast<double>(clientPeriodNs), SENSOR_PERIOD_NS / 100.0);
+    for (size_t i = 1; i < forwarded.size(); ++i) {
+        int64_t spacingNs = forwarded[i] - forwarded[i - 1];
+        EXPECT_TRUE((spacingNs == SENSOR_PERIOD_NS * 2) || (spacingNs == SENSOR_PERIOD_NS * 3)) << spacingNs;
+    }
+}
+
+HWTEST_F(SensorDataProcesserTest, SensorDataProcesserTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("SensorDataProcesserTest_004 in");
+    // Jittering timestamps lose no event at the sensor rate and keep the average at a lower rate.
+    std::vector<int64_t> timestamps = GenerateTimestamps(START_NS, SENSOR_PERIOD_NS, EVENT_NUM);
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+        timestamps[i] += ((i % 3 == 0) ? JITTER_NS : ((i % 3 == 1) ? -JITTER_NS : 0));
+    }
+    sptr<FifoCacheData> sameRate = new (std::nothrow) FifoCacheData();
+    ASSERT_NE(sameRate, nullptr);
+    EXPECT_EQ(Forward(sameRate, timestamps, { SENSOR_PERIOD_NS, SENSOR_PERIOD_NS }).size(), EVENT_NUM);
+    sptr<FifoCacheData> halfRate = new (std::nothrow) FifoCacheData();
+    ASSERT_NE(halfRate, nullptr);
+    std::vector<int64_t> forwarded = Forward(halfRate, timestamps, { SENSOR_PERIOD_NS * 2, SENSOR_PERIOD_NS });
+    EXPECT_NEAR(GetAveragePeriod(forwarded), static_cast<double>(SENSOR_PERIOD_NS * 2), SENSOR_PERIOD_NS / 10.0);
+    for (size_t i = 1; i < forwarded.size(); ++i) {
+        int64_t spacingNs = forwarded[i] - forwarded[i - 1];
+        EXPECT_GE(spacingNs, SENSOR_PERIOD_NS * 2 - JITTER_NS * 2);
+        EXPECT_LE(spacingNs, SENSOR_PERIOD_NS * 2 + JITTER_NS * 2);
+    }
+}
+
+HWTEST_F(SensorDataProcesserTest, SensorDataProcesserTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("SensorDataProcesserTest_005 in");
+    sptr<FifoCacheData> fifoCacheData = new (std::nothrow) FifoCacheData();
+    ASSERT_NE(fifoCacheData, nullptr);
+    ChannelPeriod period = { SENSOR_PERIOD_NS * 2, SENSOR_PERIOD_NS };
+    std::vector<int64_t> timestamps = GenerateTimestamps(START_NS, SENSOR_PERIOD_NS, EVENT_NUM);
+    (void)Forward(fifoCacheData, timestamps, period);
+    // After a gap the first event is due and the cadence restarts from it, there is no burst to catch up.
+    int64_t resumeNs = timestamps.back() + GAP_NS;
+    std::vector<int64_t> resumed = Forward(fifoCacheData, GenerateTimestamps(resumeNs, SENSOR_PERIOD_NS, 5), period);
+    std::vector<int64_t> expected = { resumeNs, resumeNs + SENSOR_PERIOD_NS * 2, resumeNs + SENSOR_PERIOD_NS * 4 };
+    EXPECT_EQ(resumed, expected);
+    // Timestamps restarting from an earlier time are due at once as well.
+    resumed = Forward(fifoCacheData, GenerateTimestamps(START_NS, SENSOR_PERIOD_NS, 3), period);
+    expected = { START_NS, START_NS + SENSOR_PERIOD_NS * 2 };
+    EXPECT_EQ(resumed, expected);
+}
+}  // namespace Sensors
+}  // namespace OHOS
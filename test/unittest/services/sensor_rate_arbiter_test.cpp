@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <climits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sensor_log.h"
+#include "sensor_rate_arbiter.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorRateArbiterTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr int32_t SENSOR_ID = 1;
+constexpr int32_t PID = 1000;
+constexpr int32_t OTHER_PID = 1001;
+constexpr int64_t PERIOD_NS = 10000000;
+constexpr int64_t DELAY_NS = 100000000;
+// The applied values are kept while a slower request stays within 1/10 of them.
+constexpr int64_t PERIOD_MARGIN_NS = PERIOD_NS / 10;
+constexpr int64_t DELAY_MARGIN_NS = DELAY_NS / 10;
+
+SensorRateSnapshot GetRateSnapshot(int32_t sensorId)
+{
+    std::vector<SensorRateSnapshot> snapshots;
+    SensorRateArbiter::GetInstance().GetRateSnapshots(snapshots);
+    for (const auto &snapshot : snapshots) {
+        if (snapshot.sensorId == sensorId) {
+            return snapshot;
+        }
+    }
+    return { sensorId, 0, false, 0, 0, 0, 0 };
+}
+}  // namespace
+
+class SensorRateArbiterTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void SensorRateArbiterTest::SetUpTestCase() {}
+
+void SensorRateArbiterTest::TearDownTestCase() {}
+
+void SensorRateArbiterTest::SetUp() {}
+
+void SensorRateArbiterTest::TearDown()
+{
+    SensorRateArbiter::GetInstance().RemoveSensor(SENSOR_ID);
+}
+
+HWTEST_F(SensorRateArbiterTest, SensorRateArbiterTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("SensorRateArbiterTest_001 in");
+    SensorRateArbiter &arbiter = SensorRateArbiter::GetInstance();
+    EXPECT_EQ(arbiter.GetBestSensorInfo(SENSOR_ID).GetSamplingPeriodNs(), LLONG_MAX);
+    arbiter.UpdateRequest(SENSOR_ID, PID, PERIOD_NS * 2, DELAY_NS);
+    arbiter.UpdateRequest(SENSOR_ID, OTHER_PID, PERIOD_NS, DELAY_NS * 2);
+    SensorBasicInfo bestInfo = arbiter.GetBestSensorInfo(SENSOR_ID);
+    EXPECT_EQ(bestInfo.GetSamplingPeriodNs(), PERIOD_NS);
+    EXPECT_EQ(bestInfo.GetMaxReportDelayNs(), DELAY_NS);
+    // A new request of a pid replaces its previous one.
+    arbiter.UpdateRequest(SENSOR_ID, OTHER_PID, PERIOD_NS * 3, DELAY_NS * 2);
+    EXPECT_EQ(arbiter.GetBestSensorInfo(SENSOR_ID).GetSamplingPeriodNs(), PERIOD_NS * 2);
+    arbiter.RemoveRequest(SENSOR_ID, PID);
+    bestInfo = arbiter.GetBestSensorInfo(SENSOR_ID);
+    EXPECT_EQ(bestInfo.GetSamplingPeriodNs(), PERIOD_NS * 3);
+    EXPECT_EQ(bestInfo.GetMaxReportDelayNs(), DELAY_NS * 2);
+}
+
+HWTEST_F(SensorRateArbiterTest, SensorRateArbiterTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("SensorRateArbiterTest_002 in");
+    SensorRateArbiter &arbiter = SensorRateArbiter::GetInstance();
+    arbiter.UpdateRequest(SENSOR_ID, PID, PERIOD_NS, DELAY_NS);
+    EXPECT_TRUE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS));
+    arbiter.CommitReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS);
+    EXPECT_FALSE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS));
+    // Slower right at the 10% edge keeps the applied values, one step past it does not.
+    EXPECT_FALSE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS + PERIOD_MARGIN_NS, DELAY_NS));
+    EXPECT_TRUE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS + PERIOD_MARGIN_NS + 1, DELAY_NS));
+    EXPECT_FALSE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS + DELAY_MARGIN_NS));
+    EXPECT_TRUE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS + DELAY_MARGIN_NS + 1));
+    // Faster or shorter is applied at once.
+    EXPECT_TRUE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS - 1, DELAY_NS));
+    EXPECT_TRUE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS - 1));
+    SensorRateSnapshot snapshot = GetRateSnapshot(SENSOR_ID);
+    EXPECT_EQ(snapshot.reconfigCount, 1U);
+    EXPECT_EQ(snapshot.skippedCount, 2U);
+    EXPECT_EQ(arbiter.GetAppliedSamplingPeriod(SENSOR_ID), PERIOD_NS);
+}
+
+HWTEST_F(SensorRateArbiterTest, SensorRateArbiterTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("SensorRateArbiterTest_003 in");
+    SensorRateArbiter &arbiter = SensorRateArbiter::GetInstance();
+    arbiter.UpdateRequest(SENSOR_ID, PID, PERIOD_NS, DELAY_NS);
+    arbiter.CommitReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS);
+    uint64_t reconfigCount = GetRateSnapshot(SENSOR_ID).reconfigCount;
+    // The last unsubscribe disables the sensor, the next subscribe must set the batch again even if unchanged.
+    arbiter.RemoveRequest(SENSOR_ID, PID);
+    EXPECT_EQ(arbiter.GetBestSensorInfo(SENSOR_ID).GetSamplingPeriodNs(), LLONG_MAX);
+    arbiter.RemoveSensor(SENSOR_ID);
+    EXPECT_EQ(arbiter.GetAppliedSamplingPeriod(SENSOR_ID), LLONG_MAX);
+    SensorRateSnapshot snapshot = GetRateSnapshot(SENSOR_ID);
+    EXPECT_FALSE(snapshot.isApplied);
+    EXPECT_EQ(snapshot.requestCount, 0U);
+    EXPECT_EQ(snapshot.reconfigCount, reconfigCount);
+    arbiter.UpdateRequest(SENSOR_ID, PID, PERIOD_NS, DELAY_NS);
+    EXPECT_EQ(arbiter.GetAppliedSamplingPeriod(SENSOR_ID), PERIOD_NS);
+    EXPECT_TRUE(arbiter.NeedReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS));
+}
+
+HWTEST_F(SensorRateArbiterTest, SensorRateArbiterTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("SensorRateArbiterTest_004 in");
+    SensorRateArbiter &arbiter = SensorRateArbiter::GetInstance();
+    arbiter.UpdateRequest(SENSOR_ID, PID, PERIOD_NS, DELAY_NS);
+    arbiter.UpdateRequest(SENSOR_ID, OTHER_PID, PERIOD_NS * 2, DELAY_NS);
+    arbiter.CommitReconfigure(SENSOR_ID, PERIOD_NS, DELAY_NS);
+    // The faster client leaves, the slower one is beyond the hysteresis and the sensor slows down.
+    arbiter.RemoveRequest(SENSOR_ID, PID);
+    SensorBasicInfo bestInfo = arbiter.GetBestSensorInfo(SENSOR_ID);
+    EXPECT_TRUE(arbiter.NeedReconfigure(SENSOR_ID, bestInfo.GetSamplingPeriodNs(), bestInfo.GetMaxReportDelayNs()));
+    arbiter.CommitReconfigure(SENSOR_ID, bestInfo.GetSamplingPeriodNs(), bestInfo.GetMaxReportDelayNs());
+    EXPECT_EQ(arbiter.GetAppliedSamplingPeriod(SENSOR_ID), PERIOD_NS * 2);
+}
+
+HWTEST_F(SensorRateArbiterTest, SensorRateArbiterTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("SensorRateArbiterTest_005 in");
+    SensorRateArbiter &arbiter = SensorRateArbiter::GetInstance();
+    // Two clients request the same values, one leaving keeps the values of the other.
+    arbiter.UpdateRequest(SENSOR_ID, PID, PERIOD_NS, DELAY_NS);
+    arbiter.UpdateRequest(SENSOR_ID, OTHER_PID, PERIOD_NS, DELAY_NS);
+    arbiter.RemoveRequest(SENSOR_ID, PID);
+    arbiter.RemoveRequest(SENSOR_ID, PID);
+    SensorBasicInfo bestInfo = arbiter.GetBestSensorInfo(SENSOR_ID);
+    EXPECT_EQ(bestInfo.GetSamplingPeriodNs(), PERIOD_NS);
+    EXPECT_EQ(bestInfo.GetMaxReportDelayNs(), DELAY_NS);
+    EXPECT_EQ(GetRateSnapshot(SENSOR_ID).requestCount, 1U);
+}
+}  // namespace Sensors
+}  // namespace OHOS
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sensor_errors.h"
+#include "sensor_log.h"
+#include "sensor_state_restorer.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorStateRestorerTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr int32_t FIRST_SENSOR_ID = 1;
+constexpr int32_t FEW_SENSORS = 5;
+// Several times the number of restore threads.
+constexpr int32_t MANY_SENSORS = 20;
+constexpr size_t MAX_RESTORE_THREAD_NUM = 4;
+constexpr int32_t RESTORE_TIME_MS = 5;
+constexpr int64_t PERIOD_NS = 10000000;
+constexpr int64_t NEW_PERIOD_NS = 20000000;
+constexpr int64_t DELAY_NS = 100000000;
+
+// Records the calls of the restore and cancel functions, which may come from several threads.
+class RestoreRecorder {
+public:
+    void AddRestore(int32_t sensorId, int64_t samplingPeriodNs)
+    {
+        std::lock_guard<std::mutex> recordLock(recordMutex_);
+        restoredPeriods_[sensorId].push_back(samplingPeriodNs);
+    }
+
+    void AddCancel(int32_t sensorId)
+    {
+        std::lock_guard<std::mutex> recordLock(recordMutex_);
+        canceledSensors_.push_back(sensorId);
+    }
+
+    std::map<int32_t, std::vector<int64_t>> GetRestoredPeriods()
+    {
+        std::lock_guard<std::mutex> recordLock(recordMutex_);
+        return restoredPeriods_;
+    }
+
+    std::vector<int32_t> GetCanceledSensors()
+    {
+        std::lock_guard<std::mutex> recordLock(recordMutex_);
+        return canceledSensors_;
+    }
+
+private:
+    std::mutex recordMutex_;
+    std::map<int32_t, std::vector<int64_t>> restoredPeriods_;
+    std::vector<int32_t> canceledSensors_;
+};
+
+void EnableSensors(SensorStateRestorer &restorer, int32_t sensorNum)
+{
+    for (int32_t sensorId = FIRST_SENSOR_ID; sensorId < FIRST_SENSOR_ID + sensorNum; ++sensorId) {
+        restorer.UpdateBatch(sensorId, PERIOD_NS, DELAY_NS);
+        restorer.SetState(sensorId, true);
+    }
+}
+}  // namespace
+
+class SensorStateRestorerTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void SensorStateRestorerTest::SetUpTestCase() {}
+
+void SensorStateRestorerTest::TearDownTestCase() {}
+
+void SensorStateRestorerTest::SetUp() {}
+
+void SensorStateRestorerTest::TearDown() {}
+
+HWTEST_F(SensorStateRestorerTest, SensorStateRestorerTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("SensorStateRestorerTest_001 in");
+    // Sensors failing to restore are left out of the count and not canceled, the others are restored as usual.
+    SensorStateRestorer restorer;
+    EnableSensors(restorer, FEW_SENSORS);
+    int32_t disabledSensorId = FIRST_SENSOR_ID + FEW_SENSORS;
+    restorer.UpdateBatch(disabledSensorId, PERIOD_NS, DELAY_NS);
+    RestoreRecorder recorder;
+    auto restoreSensor = [&recorder](int32_t sensorId, const SensorBasicInfo &info) {
+        recorder.AddRestore(sensorId, info.GetSamplingPeriodNs());
+        return ((sensorId % 2) == 0) ? ENABLE_SENSOR_ERR : ERR_OK;
+    };
+    size_t restoredNum = restorer.Restore(restoreSensor, [&recorder](int32_t sensorId) {
+        recorder.AddCancel(sensorId);
+    });
+    EXPECT_EQ(restoredNum, 3);
+    std::map<int32_t, std::vector<int64_t>> restoredPeriods = recorder.GetRestoredPeriods();
+    EXPECT_EQ(restoredPeriods.size(), FEW_SENSORS);
+    for (const auto &it : restoredPeriods) {
+        EXPECT_EQ(it.second, std::vector<int64_t>({ PERIOD_NS })) << "sensorId:" << it.first;
+    }
+    EXPECT_EQ(restoredPeriods.find(disabledSensorId), restoredPeriods.end());
+    EXPECT_TRUE(recorder.GetCanceledSensors().empty());
+}
+
+HWTEST_F(SensorStateRestorerTest, SensorStateRestorerTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("SensorStateRestorerTest_002 in");
+    // With more sensors than threads, each sensor is restored exactly once and no more than the thread limit at once.
+    SensorStateRestorer restorer;
+    EnableSensors(restorer, MANY_SENSORS);
+    RestoreRecorder recorder;
+    std::atomic<size_t> runningNum { 0 };
+    std::atomic<size_t> maxRunningNum { 0 };
+    auto restoreSensor = [&recorder, &runningNum, &maxRunningNum](int32_t sensorId, const SensorBasicInfo &info) {
+        size_t running = ++runningNum;
+        size_t maxRunning = maxRunningNum;
+        while ((running > maxRunning) && !maxRunningNum.compare_exchange_weak(maxRunning, running)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(RESTORE_TIME_MS));
+        recorder.AddRestore(sensorId, info.GetSamplingPeriodNs());
+        --runningNum;
+        return ERR_OK;
+    };
+    size_t restoredNum = restorer.Restore(restoreSensor, [&recorder](int32_t sensorId) {
+        recorder.AddCancel(sensorId);
+    });
+    EXPECT_EQ(restoredNum, MANY_SENSORS);
+    std::map<int32_t, std::vector<int64_t>> restoredPeriods = recorder.GetRestoredPeriods();
+    EXPECT_EQ(restoredPeriods.size(), MANY_SENSORS);
+    for (const auto &it : restoredPeriods) {
+        EXPECT_EQ(it.second.size(), 1) << "sensorId:" << it.first;
+    }
+    EXPECT_GT(maxRunningNum, 1);
+    EXPECT_LE(maxRunningNum, MAX_RESTORE_THREAD_NUM);
+    EXPECT_TRUE(recorder.GetCanceledSensors().empty());
+}
+
+HWTEST_F(SensorStateRestorerTest, SensorStateRestorerTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("SensorStateRestorerTest_003 in");
+    // A sensor disabled while its restore is in flight is canceled afterwards, one whose batch changed meanwhile
+    // is restored again with the new batch.
+    SensorStateRestorer restorer;
+    EnableSensors(restorer, FEW_SENSORS);
+    int32_t disabledSensorId = FIRST_SENSOR_ID;
+    int32_t rebatchedSensorId = FIRST_SENSOR_ID + 1;
+    RestoreRecorder recorder;
+    auto restoreSensor = [&restorer, &recorder, disabledSensorId, rebatchedSensorId](int32_t sensorId,
+        const SensorBasicInfo &info) {
+        recorder.AddRestore(sensorId, info.GetSamplingPeriodNs());
+        if (sensorId == disabledSensorId) {
+            restorer.SetState(sensorId, false);
+        } else if ((sensorId == rebatchedSensorId) && (info.GetSamplingPeriodNs() == PERIOD_NS)) {
+            restorer.UpdateBatch(sensorId, NEW_PERIOD_NS, DELAY_NS);
+        }
+        return ERR_OK;
+    };
+    size_t restoredNum = restorer.Restore(restoreSensor, [&recorder](int32_t sensorId) {
+        recorder.AddCancel(sensorId);
+    });
+    EXPECT_EQ(restoredNum, FEW_SENSORS);
+    EXPECT_EQ(recorder.GetCanceledSensors(), std::vector<int32_t>({ disabledSensorId }));
+    std::map<int32_t, std::vector<int64_t>> restoredPeriods = recorder.GetRestoredPeriods();
+    EXPECT_EQ(restoredPeriods[disabledSensorId], std::vector<int64_t>({ PERIOD_NS }));
+    EXPECT_EQ(restoredPeriods[rebatchedSensorId], std::vector<int64_t>({ PERIOD_NS, NEW_PERIOD_NS }));
+    // Nothing is left to restore for the disabled sensor on the next restart.
+    RestoreRecorder nextRecorder;
+    restoredNum = restorer.Restore([&nextRecorder](int32_t sensorId, const SensorBasicInfo &info) {
+        nextRecorder.AddRestore(sensorId, info.GetSamplingPeriodNs());
+        return ERR_OK;
+    }, [](int32_t sensorId) {});
+    EXPECT_EQ(restoredNum, FEW_SENSORS - 1);
+    restoredPeriods = nextRecorder.GetRestoredPeriods();
+    EXPECT_EQ(restoredPeriods.find(disabledSensorId), restoredPeriods.end());
+    EXPECT_EQ(restoredPeriods[rebatchedSensorId], std::vector<int64_t>({ NEW_PERIOD_NS }));
+}
+}  // namespace Sensors
+}  // namespace OHOS
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sensor_agent_type.h"
+#include "sensor_errors.h"
+#include "sensor_log.h"
+#include "sensor_trace_file.h"
+#include "sensor_trace_recorder.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorTraceFileTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+const std::string TRACE_PATH = "/data/test/sensor_trace_file_test.trace";
+constexpr int64_t START_TIME_NS = 1000000000;
+constexpr int64_t RECORD_INTERVAL_NS = 10000000;
+constexpr int64_t TIMESTAMP_NS = 987654321;
+constexpr size_t RECORD_NUM = 5;
+constexpr float EPS = 1e-6f;
+
+SensorData MakeEvent(int32_t sensorId, int64_t timestamp, float value)
+{
+    SensorData event = {};
+    event.sensorTypeId = sensorId;
+    event.version = 1;
+    event.timestamp = timestamp;
+    event.option = 2;
+    event.mode = SENSOR_REALTIME_MODE;
+    float values[] = { value, value + 1.0f, value + 2.0f };
+    memcpy(event.data, values, sizeof(values));
+    event.dataLen = sizeof(values);
+    return event;
+}
+
+// Writes a header and RECORD_NUM records spaced RECORD_INTERVAL_NS apart, the last record cut by cutBytes.
+void WriteTrace(uint64_t headerCount, size_t cutBytes)
+{
+    SensorTraceHeader header = {
+        .magic = SENSOR_TRACE_MAGIC,
+        .version = SENSOR_TRACE_VERSION,
+        .headerSize = sizeof(SensorTraceHeader),
+        .recordSize = sizeof(SensorTraceRecord),
+        .recordCount = headerCount,
+        .startTimeNs = START_TIME_NS,
+    };
+    std::vector<SensorTraceRecord> records(RECORD_NUM);
+    for (size_t i = 0; i < RECORD_NUM; ++i) {
+        SensorData event = MakeEvent(SENSOR_TYPE_ID_ACCELEROMETER, TIMESTAMP_NS + i, static_cast<float>(i));
+        ToTraceRecord(event, START_TIME_NS + static_cast<int64_t>(i) * RECORD_INTERVAL_NS, records[i]);
+    }
+    std::ofstream traceFile(TRACE_PATH, std::ios::binary | std::ios::trunc);
+    ASSERT_TRUE(traceFile.is_open());
+    traceFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    traceFile.write(reinterpret_cast<const char *>(records.data()), RECORD_NUM * sizeof(SensorTraceRecord) -
+        cutBytes);
+}
+}  // namespace
+
+class SensorTraceFileTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void SensorTraceFileTest::SetUpTestCase() {}
+
+void SensorTraceFileTest::TearDownTestCase() {}
+
+void SensorTraceFileTest::SetUp() {}
+
+void SensorTraceFileTest::TearDown()
+{
+    (void)remove(TRACE_PATH.c_str());
+}
+
+HWTEST_F(SensorTraceFileTest, SensorTraceFileTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("SensorTraceFileTest_001 in");
+    SensorData event = MakeEvent(SENSOR_TYPE_ID_GYROSCOPE, TIMESTAMP_NS, 1.5f);
+    SensorTraceRecord record;
+    ToTraceRecord(event, START_TIME_NS, record);
+    EXPECT_EQ(record.recordTimeNs, START_TIME_NS);
+    SensorData replayed;
+    FromTraceRecord(record, replayed);
+    EXPECT_EQ(replayed.sensorTypeId, event.sensorTypeId);
+    EXPECT_EQ(replayed.version, event.version);
+    EXPECT_EQ(replayed.timestamp, event.timestamp);
+    EXPECT_EQ(replayed.option, event.option);
+    EXPECT_EQ(replayed.mode, event.mode);
+    EXPECT_EQ(replayed.dataLen, event.dataLen);
+    EXPECT_EQ(memcmp(replayed.data, event.data, sizeof(event.data)), 0);
+}
+
+HWTEST_F(SensorTraceFileTest, SensorTraceFileTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("SensorTraceFileTest_002 in");
+    SensorData event = MakeEvent(SENSOR_TYPE_ID_GYROSCOPE, TIMESTAMP_NS, 1.5f);
+    event.dataLen = SENSOR_MAX_LENGTH + 1;
+    SensorTraceRecord record;
+    ToTraceRecord(event, START_TIME_NS, record);
+    EXPECT_EQ(record.dataLen, static_cast<uint32_t>(SENSOR_MAX_LENGTH));
+    record.dataLen = SENSOR_MAX_LENGTH + 1;
+    SensorData replayed;
+    FromTraceRecord(record, replayed);
+    EXPECT_EQ(replayed.dataLen, static_cast<uint32_t>(SENSOR_MAX_LENGTH));
+}
+
+HWTEST_F(SensorTraceFileTest, SensorTraceFileTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("SensorTraceFileTest_003 in");
+    WriteTrace(RECORD_NUM, 0);
+    SensorTraceFile traceFile;
+    ASSERT_EQ(traceFile.Open(TRACE_PATH), ERR_OK);
+    ASSERT_EQ(traceFile.GetRecordCount(), RECORD_NUM);
+    EXPECT_EQ(traceFile.GetStartTimeNs(), START_TIME_NS);
+    EXPECT_EQ(traceFile.LowerBound(0), 0U);
+    EXPECT_EQ(traceFile.LowerBound(RECORD_INTERVAL_NS), 1U);
+    EXPECT_EQ(traceFile.LowerBound(RECORD_INTERVAL_NS + 1), 2U);
+    EXPECT_EQ(traceFile.LowerBound((RECORD_NUM - 1) * RECORD_INTERVAL_NS), RECORD_NUM - 1);
+    EXPECT_EQ(traceFile.LowerBound(RECORD_NUM * RECORD_INTERVAL_NS), RECORD_NUM);
+    for (size_t i = 0; i < RECORD_NUM; ++i) {
+        const SensorTraceRecord &record = traceFile.GetRecord(i);
+        EXPECT_EQ(record.timestamp, TIMESTAMP_NS + static_cast<int64_t>(i));
+        float value = 0.0f;
+        memcpy(&value, record.data, sizeof(value));
+        EXPECT_NEAR(value, static_cast<float>(i), EPS);
+    }
+}
+
+HWTEST_F(SensorTraceFileTest, SensorTraceFileTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("SensorTraceFileTest_004 in");
+    // The header promises more records than a truncated file holds, the cut record is left out.
+    WriteTrace(RECORD_NUM, 1);
+    SensorTraceFile traceFile;
+    ASSERT_EQ(traceFile.Open(TRACE_PATH), ERR_OK);
+    EXPECT_EQ(traceFile.GetRecordCount(), RECORD_NUM - 1);
+    EXPECT_EQ(traceFile.LowerBound(RECORD_NUM * RECORD_INTERVAL_NS), RECORD_NUM - 1);
+    // An unfinished recording has no count in the header, the complete records are counted.
+    WriteTrace(0, sizeof(SensorTraceRecord) / 2);
+    ASSERT_EQ(traceFile.Open(TRACE_PATH), ERR_OK);
+    EXPECT_EQ(traceFile.GetRecordCount(), RECORD_NUM - 1);
+    // A header count below the file size wins.
+    WriteTrace(2, 0);
+    ASSERT_EQ(traceFile.Open(TRACE_PATH), ERR_OK);
+    EXPECT_EQ(traceFile.GetRecordCount(), 2U);
+}
+
+HWTEST_F(SensorTraceFileTest, SensorTraceFileTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("SensorTraceFileTest_005 in");
+    SensorTraceRecorder &recorder = SensorTraceRecorder::GetInstance();
+    ASSERT_EQ(recorder.Start(TRACE_PATH), ERR_OK);
+    for (size_t i = 0; i < RECORD_NUM; ++i) {
+        recorder.Record(MakeEvent(SENSOR_TYPE_ID_ACCELEROMETER, TIMESTAMP_NS + i, static_cast<float>(i)));
+    }
+    ASSERT_EQ(recorder.Stop(), ERR_OK);
+    EXPECT_EQ(recorder.GetStats().writtenRecords, RECORD_NUM);
+    SensorTraceFile traceFile;
+    ASSERT_EQ(traceFile.Open(TRACE_PATH), ERR_OK);
+    ASSERT_EQ(traceFile.GetRecordCount(), RECORD_NUM);
+    int64_t lastRecordTimeNs = traceFile.GetStartTimeNs();
+    for (size_t i = 0; i < RECORD_NUM; ++i) {
+        const SensorTraceRecord &record = traceFile.GetRecord(i);
+        EXPECT_GE(record.recordTimeNs, lastRecordTimeNs);
+        lastRecordTimeNs = record.recordTimeNs;
+        EXPECT_EQ(record.sensorTypeId, SENSOR_TYPE_ID_ACCELEROMETER);
+        EXPECT_EQ(record.timestamp, TIMESTAMP_NS + static_cast<int64_t>(i));
+    }
+}
+}  // namespace Sensors
+}  // namespace OHOS
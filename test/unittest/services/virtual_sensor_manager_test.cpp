@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <climits>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "client_info.h"
+#include "sensor_agent_type.h"
+#include "sensor_errors.h"
+#include "sensor_hdi_connection.h"
+#include "sensor_manager.h"
+#include "virtual_sensor_manager.h"
+
+#undef LOG_TAG
+#define LOG_TAG "VirtualSensorManagerTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr int32_t INVALID_SENSOR_ID = -1;
+constexpr int64_t PERIOD_NS = 10000000;
+constexpr int64_t OTHER_PERIOD_NS = 20000000;
+constexpr float GRAVITY = 9.80665f;
+// Outputs fed by the accelerometer and the gyroscope only.
+const std::vector<int32_t> GAME_OUTPUTS = {
+    SENSOR_TYPE_ID_GAME_ROTATION_VECTOR,
+    SENSOR_TYPE_ID_GRAVITY,
+    SENSOR_TYPE_ID_LINEAR_ACCELERATION
+};
+std::vector<Sensor> g_hdiSensors;
+
+Sensor MakeSensor(int32_t sensorId)
+{
+    Sensor sensor;
+    sensor.SetSensorId(sensorId);
+    sensor.SetSensorTypeId(sensorId);
+    return sensor;
+}
+
+SensorData MakeEvent(int32_t sensorId, int64_t timestamp, float z)
+{
+    SensorData event = {};
+    event.sensorTypeId = sensorId;
+    event.timestamp = timestamp;
+    float values[] = { 0.0f, 0.0f, z };
+    memcpy(event.data, values, sizeof(values));
+    event.dataLen = sizeof(values);
+    return event;
+}
+
+// A derived sensor this device can serve, or INVALID_SENSOR_ID when the HDI lacks its inputs or reports it itself.
+int32_t FindGameOutput(const VirtualSensorManager &manager)
+{
+    for (int32_t sensorId : GAME_OUTPUTS) {
+        if (manager.IsVirtualSensor(sensorId)) {
+            return sensorId;
+        }
+    }
+    return INVALID_SENSOR_ID;
+}
+
+int64_t GetPidPeriod(int32_t sensorId, int32_t pid)
+{
+    return ClientInfo::GetInstance().GetCurPidSensorInfo(sensorId, pid).GetSamplingPeriodNs();
+}
+}  // namespace
+
+class VirtualSensorManagerTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void VirtualSensorManagerTest::SetUpTestCase()
+{
+    SensorHdiConnection &hdiConnection = SensorHdiConnection::GetInstance();
+    ASSERT_EQ(hdiConnection.ConnectHdi(), ERR_OK);
+    ASSERT_EQ(hdiConnection.GetSensorList(g_hdiSensors), ERR_OK);
+}
+
+void VirtualSensorManagerTest::TearDownTestCase() {}
+
+void VirtualSensorManagerTest::SetUp() {}
+
+void VirtualSensorManagerTest::TearDown() {}
+
+HWTEST_F(VirtualSensorManagerTest, VirtualSensorManagerTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("VirtualSensorManagerTest_001 in");
+    VirtualSensorManager manager;
+    manager.Init({ MakeSensor(SENSOR_TYPE_ID_ACCELEROMETER), MakeSensor(SENSOR_TYPE_ID_GYROSCOPE),
+        MakeSensor(SENSOR_TYPE_ID_MAGNETIC_FIELD) });
+    EXPECT_EQ(manager.GetVirtualSensors().size(), 4);
+    EXPECT_TRUE(manager.IsVirtualSensor(SENSOR_TYPE_ID_ROTATION_VECTOR));
+    EXPECT_TRUE(manager.IsInputSensor(SENSOR_TYPE_ID_ACCELEROMETER));
+    EXPECT_TRUE(manager.IsInputSensor(SENSOR_TYPE_ID_MAGNETIC_FIELD));
+    EXPECT_FALSE(manager.IsInputSensor(SENSOR_TYPE_ID_AMBIENT_LIGHT));
+    EXPECT_FALSE(manager.IsVirtualSensor(SENSOR_TYPE_ID_ACCELEROMETER));
+}
+
+HWTEST_F(VirtualSensorManagerTest, VirtualSensorManagerTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("VirtualSensorManagerTest_002 in");
+    // Sensors the HDI reports itself are not shadowed, outputs without their inputs are not published.
+    VirtualSensorManager manager;
+    manager.Init({ MakeSensor(SENSOR_TYPE_ID_ACCELEROMETER), MakeSensor(SENSOR_TYPE_ID_GYROSCOPE),
+        MakeSensor(SENSOR_TYPE_ID_GAME_ROTATION_VECTOR) });
+    EXPECT_FALSE(manager.IsVirtualSensor(SENSOR_TYPE_ID_GAME_ROTATION_VECTOR));
+    EXPECT_FALSE(manager.IsVirtualSensor(SENSOR_TYPE_ID_ROTATION_VECTOR));
+    EXPECT_TRUE(manager.IsVirtualSensor(SENSOR_TYPE_ID_GRAVITY));
+    EXPECT_FALSE(manager.IsInputSensor(SENSOR_TYPE_ID_MAGNETIC_FIELD));
+    VirtualSensorManager accOnly;
+    accOnly.Init({ MakeSensor(SENSOR_TYPE_ID_ACCELEROMETER) });
+    EXPECT_TRUE(accOnly.GetVirtualSensors().empty());
+    EXPECT_FALSE(accOnly.IsInputSensor(SENSOR_TYPE_ID_ACCELEROMETER));
+}
+
+HWTEST_F(VirtualSensorManagerTest, VirtualSensorManagerTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("VirtualSensorManagerTest_003 in");
+    VirtualSensorManager manager;
+    manager.Init({ MakeSensor(SENSOR_TYPE_ID_ACCELEROMETER), MakeSensor(SENSOR_TYPE_ID_GYROSCOPE) });
+    EXPECT_EQ(manager.EnableSensor(SENSOR_TYPE_ID_ACCELEROMETER), ENABLE_SENSOR_ERR);
+    EXPECT_EQ(manager.DisableSensor(SENSOR_TYPE_ID_ACCELEROMETER), DISABLE_SENSOR_ERR);
+    EXPECT_EQ(manager.SetBatch(SENSOR_TYPE_ID_ACCELEROMETER, PERIOD_NS, 0), SET_SENSOR_CONFIG_ERR);
+    // Before the sensor is enabled the parameters are only recorded, no input is subscribed.
+    int32_t pid = static_cast<int32_t>(getpid());
+    EXPECT_EQ(manager.SetBatch(SENSOR_TYPE_ID_GRAVITY, PERIOD_NS, 0), ERR_OK);
+    EXPECT_EQ(GetPidPeriod(SENSOR_TYPE_ID_GYROSCOPE, pid), LLONG_MAX);
+    // Nothing is derived while every output is disabled.
+    std::vector<SensorData> events = { MakeEvent(SENSOR_TYPE_ID_ACCELEROMETER, PERIOD_NS, GRAVITY),
+        MakeEvent(SENSOR_TYPE_ID_GYROSCOPE, PERIOD_NS, 0.0f) };
+    sptr<ReportDataCallback> callback = new (std::nothrow) ReportDataCallback();
+    ASSERT_NE(callback, nullptr);
+    EXPECT_EQ(manager.Process(SensorDataSpan(events.data(), events.size()), callback), 0);
+}
+
+HWTEST_F(VirtualSensorManagerTest, VirtualSensorManagerTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("VirtualSensorManagerTest_004 in");
+    VirtualSensorManager manager;
+    manager.Init(g_hdiSensors);
+    int32_t sensorId = FindGameOutput(manager);
+    if (sensorId == INVALID_SENSOR_ID) {
+        SEN_HILOGW("The HDI does not report the accelerometer and the gyroscope");
+        return;
+    }
+    // Another client keeps the accelerometer: disabling the derived sensor only drops this process's request.
+    int32_t pid = static_cast<int32_t>(getpid());
+    int32_t otherPid = pid + 1;
+    SensorManager &sensorManager = SensorManager::GetInstance();
+    ASSERT_TRUE(sensorManager.SaveSubscriber(SENSOR_TYPE_ID_ACCELEROMETER, otherPid, OTHER_PERIOD_NS, 0));
+    ASSERT_EQ(manager.SetBatch(sensorId, PERIOD_NS, 0), ERR_OK);
+    ASSERT_EQ(manager.EnableSensor(sensorId), ERR_OK);
+    EXPECT_EQ(GetPidPeriod(SENSOR_TYPE_ID_ACCELEROMETER, pid), PERIOD_NS);
+    EXPECT_EQ(GetPidPeriod(SENSOR_TYPE_ID_GYROSCOPE, pid), PERIOD_NS);
+    EXPECT_EQ(manager.DisableSensor(sensorId), ERR_OK);
+    EXPECT_EQ(GetPidPeriod(SENSOR_TYPE_ID_ACCELEROMETER, pid), LLONG_MAX);
+    EXPECT_EQ(GetPidPeriod(SENSOR_TYPE_ID_ACCELEROMETER, otherPid), OTHER_PERIOD_NS);
+    EXPECT_TRUE(ClientInfo::GetInstance().GetSensorState(SENSOR_TYPE_ID_ACCELEROMETER));
+    // The gyroscope had no other client and is released.
+    EXPECT_FALSE(ClientInfo::GetInstance().GetSensorState(SENSOR_TYPE_ID_GYROSCOPE));
+    ClientInfo::GetInstance().RemoveSubscriber(SENSOR_TYPE_ID_ACCELEROMETER, otherPid);
+}
+
+HWTEST_F(VirtualSensorManagerTest, VirtualSensorManagerTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("VirtualSensorManagerTest_005 in");
+    VirtualSensorManager manager;
+    manager.Init(g_hdiSensors);
+    int32_t sensorId = FindGameOutput(manager);
+    if (sensorId == INVALID_SENSOR_ID) {
+        SEN_HILOGW("The HDI does not report the accelerometer and the gyroscope");
+        return;
+    }
+    ASSERT_EQ(manager.SetBatch(sensorId, PERIOD_NS, 0), ERR_OK);
+    ASSERT_EQ(manager.EnableSensor(sensorId), ERR_OK);
+    // Derived events are written to the ring of the data callback, one per gyroscope sample.
+    std::vector<SensorData> events = { MakeEvent(SENSOR_TYPE_ID_ACCELEROMETER, PERIOD_NS, GRAVITY),
+        MakeEvent(SENSOR_TYPE_ID_GYROSCOPE, PERIOD_NS, 0.0f),
+        MakeEvent(SENSOR_TYPE_ID_GYROSCOPE, 2 * PERIOD_NS, 0.0f) };
+    sptr<ReportDataCallback> callback = new (std::nothrow) ReportDataCallback();
+    ASSERT_NE(callback, nullptr);
+    EXPECT_EQ(manager.Process(SensorDataSpan(events.data(), events.size()), callback), 2);
+    CircularEventBuf &eventsBuf = callback->GetEventData();
+    ASSERT_EQ(eventsBuf.eventNum, 2);
+    EXPECT_EQ(eventsBuf.circularBuf[eventsBuf.readPos].sensorTypeId, sensorId);
+    EXPECT_EQ(eventsBuf.circularBuf[eventsBuf.readPos].timestamp, PERIOD_NS);
+    EXPECT_EQ(manager.DisableSensor(sensorId), ERR_OK);
+    EXPECT_EQ(manager.Process(SensorDataSpan(events.data(), events.size()), callback), 0);
+}
+}  // namespace Sensors
+}  // namespace OHOS
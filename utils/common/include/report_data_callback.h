@@ -18,6 +18,7 @@
 
 #include "refbase.h"
 #include "sensor_data_event.h"
+#include "sensor_latency_tracker.h"
 
 namespace OHOS {
 namespace Sensors {
@@ -26,6 +27,8 @@ constexpr int32_t SENSOR_DATA_LENGTH = 64;
 
 struct CircularEventBuf {
     struct SensorData *circularBuf;
+    // Stamps of the event in the slot of the same index, see SensorLatencyTracker.
+    struct LatencyStamps *latencyStamps;
     int32_t readPos;
     int32_t writePosition;
     int32_t eventNum;
@@ -35,12 +38,38 @@ class ReportDataCallback : public RefBase {
 public:
     ReportDataCallback();
     ~ReportDataCallback();
-    int32_t ReportEventCallback(SensorData *sensorData, sptr<ReportDataCallback> cb);
+
+    /**
+     * @brief Write an event to the ring, overwriting the oldest one when the ring is full.
+     *
+     * @param sensorData Event to write.
+     * @param cb Callback owning the ring.
+     * @param hdiTimeNs Stamp of the HDI callback that produced the event, 0 if it is not tracked.
+     *
+     * @return ERR_OK on success, an error code otherwise.
+     */
+    int32_t ReportEventCallback(SensorData *sensorData, sptr<ReportDataCallback> cb, int64_t hdiTimeNs);
+
+    /**
+     * @brief Write a burst of events to the ring in one go, for HDI FIFO flushes. The events are copied with at most
+     * two memcpy, the write position is updated once. When the burst does not fit, the oldest events are overwritten
+     * as with ReportEventCallback. The caller holds the data mutex and wakes the data thread once afterwards.
+     *
+     * @param sensorData Events in report order.
+     * @param eventNum Number of events.
+     * @param cb Callback owning the ring.
+     * @param hdiTimeNs Stamp of the HDI callback that delivered the burst, 0 if it is not tracked.
+     *
+     * @return ERR_OK on success, an error code otherwise.
+     */
+    int32_t ReportEventsCallback(SensorData *sensorData, int32_t eventNum, sptr<ReportDataCallback> cb,
+        int64_t hdiTimeNs);
     CircularEventBuf &GetEventData();
     CircularEventBuf eventsBuf_;
 };
 
-using ReportDataCb = int32_t (ReportDataCallback::*)(SensorData *sensorData, sptr<ReportDataCallback> cb);
+using ReportDataCb = int32_t (ReportDataCallback::*)(SensorData *sensorData, sptr<ReportDataCallback> cb,
+    int64_t hdiTimeNs);
 } // namespace Sensors
 } // namespace OHOS
 #endif // REPORT_DATA_CALLBACK_H
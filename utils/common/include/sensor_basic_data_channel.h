@@ -23,6 +23,8 @@
 #include "refbase.h"
 
 #include "sensor_data_event.h"
+#include "sensor_metrics.h"
+#include "sensor_slot_table.h"
 
 namespace OHOS {
 namespace Sensors {
@@ -42,6 +44,23 @@ public:
     bool GetSensorStatus() const;
     void SetSensorStatus(bool isActive);
     const std::unordered_map<int32_t, SensorData> &GetDataCacheBuf() const;
+    ChannelMetrics &GetMetrics();
+
+    /**
+     * @brief Record events of a sensor successfully sent on the channel.
+     *
+     * @param sensorId Sensor id of the events.
+     * @param eventNum Number of events sent.
+     * @param sendTimeNs Monotonic time of the send.
+     */
+    void RecordDelivery(int32_t sensorId, size_t eventNum, int64_t sendTimeNs);
+
+    /**
+     * @brief Get the deliveries per sensor, the spacing bounds start anew after each call.
+     *
+     * @param deliveryStats Delivery statistics by sensor id.
+     */
+    void GetDeliveryStats(std::unordered_map<int32_t, DeliveryStats> &deliveryStats);
 
 private:
     int32_t sendFd_;
@@ -49,6 +68,8 @@ private:
     bool isActive_;
     std::mutex statusLock_;
     std::unordered_map<int32_t, SensorData> dataCacheBuf_;
+    ChannelMetrics metrics_;
+    SensorSlotTable<DeliveryCounters, MAX_METRICS_SENSOR_NUM> deliveryCounters_;
 };
 } // namespace Sensors
 } // namespace OHOS
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_LATENCY_TRACKER_H
+#define SENSOR_LATENCY_TRACKER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "nocopyable.h"
+#include "singleton.h"
+
+#include "sensor_slot_table.h"
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * Points an event passes in the service on its way from the driver to a client channel. The stamps are kept beside
+ * the event ring in LatencyStamps, SensorData carries none.
+ */
+enum LatencyStage : int32_t {
+    LATENCY_STAGE_HDI_CALLBACK = 0,
+    LATENCY_STAGE_ENQUEUE = 1,
+    LATENCY_STAGE_DEQUEUE = 2,
+    LATENCY_STAGE_SEND = 3,
+    LATENCY_STAGE_MAX = 4,
+};
+
+// Stamps of the event in one ring slot, written with the event while stamping is on.
+struct LatencyStamps {
+    int64_t hdiCallbackNs;
+    int64_t enqueueNs;
+};
+
+constexpr uint32_t LATENCY_SUB_BUCKET_BITS = 2;
+constexpr uint32_t LATENCY_BUCKET_NUM = 128;
+constexpr size_t MAX_LATENCY_SENSOR_NUM = 16;
+constexpr uint32_t LATENCY_SNAPSHOT_MAGIC = 0x54414c53;
+constexpr uint32_t LATENCY_SNAPSHOT_VERSION = 2;
+
+struct LatencyStats {
+    int32_t sensorId;
+    LatencyStage stage;
+    uint64_t count;
+    uint64_t p50Us;
+    uint64_t p99Us;
+    uint64_t maxUs;
+};
+
+/**
+ * Lock-free latency histograms of the service data path, one per sensor and stage. Each histogram holds the time from
+ * the HDI callback to the stage in microseconds, in log-linear buckets of 2^LATENCY_SUB_BUCKET_BITS steps per power of
+ * two. Stamping is off until SetEnabled(true), stamps taken before the last enable are never recorded.
+ */
+class SensorLatencyTracker : public Singleton<SensorLatencyTracker> {
+public:
+    SensorLatencyTracker() = default;
+    virtual ~SensorLatencyTracker() = default;
+    static int64_t GetMonotonicTimeNs();
+    static void SetEnabled(bool enabled);
+    static bool IsEnabled();
+
+    /**
+     * @brief Get a stamp for the current stage, the clock is only read while stamping is on.
+     *
+     * @return Returns the monotonic time in ns, 0 if stamping is off.
+     */
+    static int64_t GetStampNs();
+
+    /**
+     * @brief Record the enqueue and dequeue stages of an event, called once per event when it is taken from the ring.
+     *
+     * @param sensorId Sensor id of the event.
+     * @param stamps Stamps of the ring slot of the event.
+     *
+     * @return Returns the HDI callback time later stages of the event count from, 0 if the event is not tracked.
+     */
+    int64_t RecordDispatch(int32_t sensorId, const LatencyStamps &stamps);
+
+    /**
+     * @brief Record the send stage, called once a send to a client channel succeeded, so an event sent to N channels
+     * is counted N times.
+     *
+     * @param sensorId Sensor id of the event.
+     * @param hdiTimeNs HDI callback time returned by RecordDispatch, the send is skipped if 0.
+     * @param sendTimeNs Monotonic time the send started.
+     */
+    void RecordSend(int32_t sensorId, int64_t hdiTimeNs, int64_t sendTimeNs);
+    std::vector<LatencyStats> GetStats();
+
+    /**
+     * @brief Serialize the histograms in host byte order: a header of magic, version, stage count, bucket count,
+     * sub bucket bits and sensor count as uint32_t, then per sensor the sensor id as int32_t and per stage the count,
+     * sum and maximum in microseconds as uint64_t followed by the bucket counts as uint32_t.
+     *
+     * @return Snapshot bytes.
+     */
+    std::vector<uint8_t> GetSnapshot();
+
+private:
+    DISALLOW_COPY_AND_MOVE(SensorLatencyTracker);
+    struct LatencyHistogram {
+        std::atomic<uint64_t> count { 0 };
+        std::atomic<uint64_t> sumUs { 0 };
+        std::atomic<uint64_t> maxUs { 0 };
+        std::array<std::atomic<uint32_t>, LATENCY_BUCKET_NUM> buckets {};
+    };
+    using LatencyHistograms = std::array<LatencyHistogram, LATENCY_STAGE_MAX>;
+    void Record(int32_t sensorId, LatencyStage stage, int64_t hdiTimeNs, int64_t nowNs);
+    void Add(LatencyHistogram &histogram, uint64_t latencyUs);
+    uint64_t GetPercentile(const LatencyHistogram &histogram, uint32_t percent) const;
+    SensorSlotTable<LatencyHistograms, MAX_LATENCY_SENSOR_NUM> histograms_;
+};
+} // namespace Sensors
+} // namespace OHOS
+#endif // SENSOR_LATENCY_TRACKER_H
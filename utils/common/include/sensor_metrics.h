@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_METRICS_H
+#define SENSOR_METRICS_H
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+#include "nocopyable.h"
+#include "singleton.h"
+
+#include "sensor_slot_table.h"
+
+namespace OHOS {
+namespace Sensors {
+constexpr size_t MAX_METRICS_SENSOR_NUM = 32;
+
+// Counters of one data channel, updated by the sender without locks.
+struct ChannelMetrics {
+    std::atomic<uint64_t> sentEvents { 0 };
+    std::atomic<uint64_t> failedEvents { 0 };
+    std::atomic<uint64_t> cachedEvents { 0 };
+    std::atomic<uint64_t> eagainCount { 0 };
+};
+
+struct ChannelMetricsSnapshot {
+    int32_t pid;
+    int32_t uid;
+    uint64_t sentEvents;
+    uint64_t failedEvents;
+    uint64_t cachedEvents;
+    uint64_t eagainCount;
+};
+
+// Deliveries of one sensor on a data channel, updated by the sender without locks. Events sent together share a
+// send time. The spacing bounds cover the sends since the last read.
+struct DeliveryCounters {
+    std::atomic<uint64_t> eventCount { 0 };
+    std::atomic<int64_t> firstSendNs { 0 };
+    std::atomic<int64_t> lastSendNs { 0 };
+    std::atomic<int64_t> minSpacingNs { LLONG_MAX };
+    std::atomic<int64_t> maxSpacingNs { 0 };
+};
+
+struct DeliveryStats {
+    uint64_t eventCount;
+    int64_t firstSendNs;
+    int64_t lastSendNs;
+    // LLONG_MAX and 0 when no two sends happened since the last read.
+    int64_t minSpacingNs;
+    int64_t maxSpacingNs;
+};
+
+struct DeliverySnapshot {
+    int32_t sensorId;
+    int32_t pid;
+    int64_t requestedPeriodNs;
+    DeliveryStats stats;
+};
+
+struct SensorMetricsSnapshot {
+    int32_t sensorId;
+    uint64_t eventsIn;
+    uint64_t eventsOut;
+};
+
+struct DataPathMetricsSnapshot {
+    // Monotonic time of the snapshot and of the start of counting.
+    int64_t timestampNs;
+    int64_t startTimeNs;
+    uint64_t enqueuedEvents;
+    uint64_t overwrittenEvents;
+    uint64_t ringHighWater;
+    uint64_t batchCount;
+    uint64_t batchEvents;
+    uint64_t maxBatchSize;
+    uint64_t hdiDeathCount;
+    uint64_t hdiReconnectCount;
+    // Time from the HDI death notification to the sensors being restored, and to the first event enqueued after it.
+    int64_t lastReconnectNs;
+    int64_t maxReconnectNs;
+    int64_t lastDataGapNs;
+    int64_t maxDataGapNs;
+    std::vector<SensorMetricsSnapshot> sensors;
+};
+
+/**
+ * Data path counters of the service: the event ring, the dispatch batches, the events in and out per sensor and
+ * the HDI reconnects. The counters are relaxed atomics and the per-sensor ones live in a fixed slot table, so
+ * updating them takes no lock; rates are computed by the reader from two snapshots.
+ */
+class SensorMetrics : public Singleton<SensorMetrics> {
+public:
+    SensorMetrics();
+    virtual ~SensorMetrics() = default;
+
+    /**
+     * @brief Count an event written to the ring.
+     *
+     * @param eventNum Events in the ring after the write.
+     * @param overwritten Whether the ring was full and the oldest event was overwritten.
+     */
+    void AddEnqueue(int32_t eventNum, bool overwritten);
+
+    /**
+     * @brief Count a burst of events written to the ring.
+     *
+     * @param eventNum Events in the ring after the write.
+     * @param enqueued Events written.
+     * @param overwritten Events lost to the write, older ring events or the oldest events of the burst itself.
+     */
+    void AddEnqueueBatch(int32_t eventNum, uint32_t enqueued, uint32_t overwritten);
+    void AddBatch(uint32_t batchSize);
+
+    /**
+     * @brief Mark the death of the HDI service, the reconnect duration and the data gap are measured from here.
+     */
+    void AddHdiDeath();
+
+    /**
+     * @brief Mark the end of a reconnect, the sensors of the new HDI instance are enabled again.
+     */
+    void AddHdiReconnect();
+    void AddEventIn(int32_t sensorId);
+    void AddEventOut(int32_t sensorId, uint64_t eventNum);
+    DataPathMetricsSnapshot GetSnapshot();
+
+private:
+    DISALLOW_COPY_AND_MOVE(SensorMetrics);
+    struct SensorCounters {
+        std::atomic<uint64_t> eventsIn { 0 };
+        std::atomic<uint64_t> eventsOut { 0 };
+    };
+    void UpdateMax(std::atomic<uint64_t> &maxValue, uint64_t value);
+    void CheckDataResumed();
+    int64_t startTimeNs_ { 0 };
+    std::atomic<uint64_t> enqueuedEvents_ { 0 };
+    std::atomic<uint64_t> overwrittenEvents_ { 0 };
+    std::atomic<uint64_t> ringHighWater_ { 0 };
+    std::atomic<uint64_t> batchCount_ { 0 };
+    std::atomic<uint64_t> batchEvents_ { 0 };
+    std::atomic<uint64_t> maxBatchSize_ { 0 };
+    std::atomic<uint64_t> hdiDeathCount_ { 0 };
+    std::atomic<uint64_t> hdiReconnectCount_ { 0 };
+    std::atomic<int64_t> hdiDeathTimeNs_ { 0 };
+    // Set by a death until the first event enqueued after it, a relaxed load on the enqueue path otherwise.
+    std::atomic_bool isWaitingData_ { false };
+    std::atomic<uint64_t> lastReconnectNs_ { 0 };
+    std::atomic<uint64_t> maxReconnectNs_ { 0 };
+    std::atomic<uint64_t> lastDataGapNs_ { 0 };
+    std::atomic<uint64_t> maxDataGapNs_ { 0 };
+    SensorSlotTable<SensorCounters, MAX_METRICS_SENSOR_NUM> sensorCounters_;
+};
+} // namespace Sensors
+} // namespace OHOS
+#endif // SENSOR_METRICS_H
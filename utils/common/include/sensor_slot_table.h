@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SENSOR_SLOT_TABLE_H
+#define SENSOR_SLOT_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * Fixed table of per-sensor statistics for the data path. A sensor claims a slot by compare and swap on first use
+ * and keeps it, so lookups never lock and never allocate. Sensors beyond the capacity are not tracked.
+ */
+template<typename T, size_t N>
+class SensorSlotTable {
+public:
+    /**
+     * @brief Find the slot of a sensor, claiming a free one if the sensor has none yet.
+     *
+     * @param sensorId Sensor id.
+     *
+     * @return Slot value, or nullptr if the table is full.
+     */
+    T *Get(int32_t sensorId)
+    {
+        for (auto &slot : slots_) {
+            int32_t slotSensorId = slot.sensorId.load(std::memory_order_acquire);
+            if (slotSensorId == sensorId) {
+                return &slot.value;
+            }
+            if (slotSensorId != INVALID_SLOT_SENSOR_ID) {
+                continue;
+            }
+            // Slots are claimed in order, a free slot means the sensor has none yet.
+            if (slot.sensorId.compare_exchange_strong(slotSensorId, sensorId, std::memory_order_acq_rel) ||
+                (slotSensorId == sensorId)) {
+                return &slot.value;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Find the slot of a sensor without claiming one.
+     *
+     * @param sensorId Sensor id.
+     *
+     * @return Slot value, or nullptr if the sensor has none.
+     */
+    T *Find(int32_t sensorId)
+    {
+        for (auto &slot : slots_) {
+            int32_t slotSensorId = slot.sensorId.load(std::memory_order_acquire);
+            if (slotSensorId == sensorId) {
+                return &slot.value;
+            }
+            if (slotSensorId == INVALID_SLOT_SENSOR_ID) {
+                break;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Visit the claimed slots in claim order.
+     *
+     * @param visitor Called with the sensor id and the slot value.
+     */
+    template<typename Visitor>
+    void ForEach(Visitor visitor) const
+    {
+        for (const auto &slot : slots_) {
+            int32_t sensorId = slot.sensorId.load(std::memory_order_acquire);
+            if (sensorId == INVALID_SLOT_SENSOR_ID) {
+                break;
+            }
+            visitor(sensorId, slot.value);
+        }
+    }
+
+private:
+    static constexpr int32_t INVALID_SLOT_SENSOR_ID = -1;
+    struct Slot {
+        std::atomic<int32_t> sensorId { INVALID_SLOT_SENSOR_ID };
+        T value;
+    };
+    std::array<Slot, N> slots_;
+};
+} // namespace Sensors
+} // namespace OHOS
+#endif // SENSOR_SLOT_TABLE_H
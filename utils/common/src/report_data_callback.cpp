@@ -14,7 +14,13 @@
  */
 
 #include "report_data_callback.h"
+
+#include <algorithm>
+
+#include "securec.h"
 #include "sensor_errors.h"
+#include "sensor_latency_tracker.h"
+#include "sensor_metrics.h"
 
 #undef LOG_TAG
 #define LOG_TAG "ReportDataCallback"
@@ -25,8 +31,16 @@ using namespace OHOS::HiviewDFX;
 
 ReportDataCallback::ReportDataCallback()
 {
+    eventsBuf_.latencyStamps = nullptr;
     eventsBuf_.circularBuf = new (std::nothrow) SensorData[CIRCULAR_BUF_LEN];
     CHKPL(eventsBuf_.circularBuf);
+    eventsBuf_.latencyStamps = new (std::nothrow) LatencyStamps[CIRCULAR_BUF_LEN]();
+    if (eventsBuf_.latencyStamps == nullptr) {
+        SEN_HILOGE("Create latency stamps failed");
+        delete[] eventsBuf_.circularBuf;
+        eventsBuf_.circularBuf = nullptr;
+        return;
+    }
     eventsBuf_.readPos = 0;
     eventsBuf_.writePosition = 0;
     eventsBuf_.eventNum = 0;
@@ -39,12 +53,17 @@ ReportDataCallback::~ReportDataCallback()
         eventsBuf_.circularBuf = nullptr;
     }
     eventsBuf_.circularBuf = nullptr;
+    if (eventsBuf_.latencyStamps != nullptr) {
+        delete[] eventsBuf_.latencyStamps;
+        eventsBuf_.latencyStamps = nullptr;
+    }
     eventsBuf_.readPos = 0;
     eventsBuf_.writePosition = 0;
     eventsBuf_.eventNum = 0;
 }
 
-int32_t ReportDataCallback::ReportEventCallback(SensorData *sensorData, sptr<ReportDataCallback> cb)
+int32_t ReportDataCallback::ReportEventCallback(SensorData *sensorData, sptr<ReportDataCallback> cb,
+    int64_t hdiTimeNs)
 {
     CHKPR(sensorData, ERROR);
     if (cb == nullptr || cb->eventsBuf_.circularBuf == nullptr) {
@@ -57,6 +76,7 @@ int32_t ReportDataCallback::ReportEventCallback(SensorData *sensorData, sptr<Rep
         SEN_HILOGE("Leftsize and toendlen cannot be less than zero");
         return ERROR;
     }
+    int32_t pos = (toEndLen == 0) ? 0 : cb->eventsBuf_.writePosition;
     if (toEndLen == 0) {
             cb->eventsBuf_.circularBuf[0] = *sensorData;
             cb->eventsBuf_.writePosition = 1;
@@ -64,6 +84,9 @@ int32_t ReportDataCallback::ReportEventCallback(SensorData *sensorData, sptr<Rep
             cb->eventsBuf_.circularBuf[cb->eventsBuf_.writePosition] = *sensorData;
             cb->eventsBuf_.writePosition += 1;
     }
+    if (SensorLatencyTracker::IsEnabled()) {
+        cb->eventsBuf_.latencyStamps[pos] = { hdiTimeNs, SensorLatencyTracker::GetMonotonicTimeNs() };
+    }
     if (leftSize < 1) {
         cb->eventsBuf_.readPos = cb->eventsBuf_.writePosition;
     }
@@ -74,6 +97,51 @@ int32_t ReportDataCallback::ReportEventCallback(SensorData *sensorData, sptr<Rep
     if (cb->eventsBuf_.writePosition == CIRCULAR_BUF_LEN) {
         cb->eventsBuf_.writePosition = 0;
     }
+    SensorMetrics::GetInstance().AddEnqueue(cb->eventsBuf_.eventNum, leftSize < 1);
+    return ERR_OK;
+}
+
+int32_t ReportDataCallback::ReportEventsCallback(SensorData *sensorData, int32_t eventNum,
+    sptr<ReportDataCallback> cb, int64_t hdiTimeNs)
+{
+    CHKPR(sensorData, ERROR);
+    if (cb == nullptr || cb->eventsBuf_.circularBuf == nullptr) {
+        SEN_HILOGE("Callback or circularBuf or event cannot be null");
+        return ERROR;
+    }
+    if (eventNum <= 0) {
+        return ERR_OK;
+    }
+    CircularEventBuf &eventsBuf = cb->eventsBuf_;
+    // Only the newest CIRCULAR_BUF_LEN events can survive the write.
+    int32_t skipNum = std::max(eventNum - CIRCULAR_BUF_LEN, 0);
+    SensorData *src = sensorData + skipNum;
+    int32_t writeNum = eventNum - skipNum;
+    int32_t firstNum = std::min(writeNum, CIRCULAR_BUF_LEN - eventsBuf.writePosition);
+    errno_t ret = memcpy_s(eventsBuf.circularBuf + eventsBuf.writePosition,
+        (CIRCULAR_BUF_LEN - eventsBuf.writePosition) * sizeof(SensorData), src, firstNum * sizeof(SensorData));
+    if ((ret == EOK) && (writeNum > firstNum)) {
+        ret = memcpy_s(eventsBuf.circularBuf, CIRCULAR_BUF_LEN * sizeof(SensorData), src + firstNum,
+            (writeNum - firstNum) * sizeof(SensorData));
+    }
+    if (ret != EOK) {
+        SEN_HILOGE("Copy events failed, ret:%{public}d", ret);
+        return ERROR;
+    }
+    if (SensorLatencyTracker::IsEnabled()) {
+        LatencyStamps stamps = { hdiTimeNs, SensorLatencyTracker::GetMonotonicTimeNs() };
+        for (int32_t i = 0; i < writeNum; ++i) {
+            eventsBuf.latencyStamps[(eventsBuf.writePosition + i) % CIRCULAR_BUF_LEN] = stamps;
+        }
+    }
+    int32_t overwrittenNum = std::max(eventsBuf.eventNum + eventNum - CIRCULAR_BUF_LEN, 0);
+    eventsBuf.writePosition = (eventsBuf.writePosition + writeNum) % CIRCULAR_BUF_LEN;
+    eventsBuf.eventNum = std::min(eventsBuf.eventNum + eventNum, CIRCULAR_BUF_LEN);
+    if (overwrittenNum > 0) {
+        eventsBuf.readPos = eventsBuf.writePosition;
+    }
+    SensorMetrics::GetInstance().AddEnqueueBatch(eventsBuf.eventNum, static_cast<uint32_t>(eventNum),
+        static_cast<uint32_t>(overwrittenNum));
     return ERR_OK;
 }
 
@@ -15,6 +15,8 @@
 
 #include "sensor_basic_data_channel.h"
 
+#include <climits>
+
 #include <fcntl.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -33,6 +35,20 @@ namespace {
 constexpr int32_t SENSOR_READ_DATA_SIZE = sizeof(SensorData) * 100;
 constexpr int32_t DEFAULT_CHANNEL_SIZE = 2 * 1024;
 constexpr int32_t SOCKET_PAIR_SIZE = 2;
+
+void UpdateMin(std::atomic<int64_t> &minValue, int64_t value)
+{
+    int64_t current = minValue.load(std::memory_order_relaxed);
+    while ((value < current) && !minValue.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void UpdateMax(std::atomic<int64_t> &maxValue, int64_t value)
+{
+    int64_t current = maxValue.load(std::memory_order_relaxed);
+    while ((value > current) && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
 }  // namespace
 
 SensorBasicDataChannel::SensorBasicDataChannel() : sendFd_(-1), receiveFd_(-1), isActive_(false)
@@ -150,10 +166,17 @@ int32_t SensorBasicDataChannel::SendData(const void *vaddr, size_t size)
     do {
         length = send(sendFd_, vaddr, size, MSG_DONTWAIT | MSG_NOSIGNAL);
     } while (errno == EINTR);
+    // The channel carries SensorData only.
+    uint64_t eventNum = size / sizeof(SensorData);
     if (length < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            metrics_.eagainCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        metrics_.failedEvents.fetch_add(eventNum, std::memory_order_relaxed);
         SEN_HILOGD("Send fail:%{public}d, length:%{public}d", errno, (int32_t)length);
         return SENSOR_CHANNEL_SEND_DATA_ERR;
     }
+    metrics_.sentEvents.fetch_add(eventNum, std::memory_order_relaxed);
     return ERR_OK;
 }
 
@@ -200,6 +223,56 @@ const std::unordered_map<int32_t, SensorData> &SensorBasicDataChannel::GetDataCa
     return dataCacheBuf_;
 }
 
+ChannelMetrics &SensorBasicDataChannel::GetMetrics()
+{
+    return metrics_;
+}
+
+void SensorBasicDataChannel::RecordDelivery(int32_t sensorId, size_t eventNum, int64_t sendTimeNs)
+{
+    if (eventNum == 0) {
+        return;
+    }
+    DeliveryCounters *counters = deliveryCounters_.Get(sensorId);
+    if (counters == nullptr) {
+        SEN_HILOGD("Delivery slots are used up, sensorId:%{public}d", sensorId);
+        return;
+    }
+    if (counters->eventCount.load(std::memory_order_relaxed) == 0) {
+        counters->firstSendNs.store(sendTimeNs, std::memory_order_relaxed);
+    } else {
+        int64_t spacingNs = sendTimeNs - counters->lastSendNs.load(std::memory_order_relaxed);
+        UpdateMin(counters->minSpacingNs, spacingNs);
+        UpdateMax(counters->maxSpacingNs, spacingNs);
+    }
+    // Events sent together reach the client at once.
+    if (eventNum > 1) {
+        UpdateMin(counters->minSpacingNs, 0);
+    }
+    counters->lastSendNs.store(sendTimeNs, std::memory_order_relaxed);
+    counters->eventCount.fetch_add(eventNum, std::memory_order_release);
+}
+
+void SensorBasicDataChannel::GetDeliveryStats(std::unordered_map<int32_t, DeliveryStats> &deliveryStats)
+{
+    deliveryCounters_.ForEach([&deliveryStats](int32_t sensorId, const DeliveryCounters &counters) {
+        uint64_t eventCount = counters.eventCount.load(std::memory_order_acquire);
+        if (eventCount == 0) {
+            return;
+        }
+        deliveryStats[sensorId] = { eventCount, counters.firstSendNs.load(std::memory_order_relaxed),
+            counters.lastSendNs.load(std::memory_order_relaxed), 0, 0 };
+    });
+    for (auto &statsIt : deliveryStats) {
+        DeliveryCounters *counters = deliveryCounters_.Find(statsIt.first);
+        if (counters == nullptr) {
+            continue;
+        }
+        statsIt.second.minSpacingNs = counters->minSpacingNs.exchange(LLONG_MAX, std::memory_order_relaxed);
+        statsIt.second.maxSpacingNs = counters->maxSpacingNs.exchange(0, std::memory_order_relaxed);
+    }
+}
+
 bool SensorBasicDataChannel::GetSensorStatus() const
 {
     return isActive_;
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_latency_tracker.h"
+
+#include <algorithm>
+#include <ctime>
+#include <utility>
+
+#include "sensor_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorLatencyTracker"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+namespace {
+constexpr int64_t SECOND_NS = 1000000000;
+constexpr int64_t US_NS = 1000;
+constexpr uint64_t SUB_BUCKET_NUM = 1ULL << LATENCY_SUB_BUCKET_BITS;
+constexpr uint32_t PERCENT_BASE = 100;
+constexpr uint32_t P50 = 50;
+constexpr uint32_t P99 = 99;
+constexpr uint32_t HIGHEST_BIT_INDEX = 63;
+std::atomic<bool> g_latencyEnabled { false };
+std::atomic<int64_t> g_enabledTimeNs { 0 };
+
+// Values below SUB_BUCKET_NUM get a bucket each, above that every power of two is split in SUB_BUCKET_NUM buckets.
+uint32_t GetBucketIndex(uint64_t valueUs)
+{
+    if (valueUs < SUB_BUCKET_NUM) {
+        return static_cast<uint32_t>(valueUs);
+    }
+    uint32_t exponent = HIGHEST_BIT_INDEX - static_cast<uint32_t>(__builtin_clzll(valueUs));
+    uint32_t shift = exponent - LATENCY_SUB_BUCKET_BITS;
+    uint64_t index = ((exponent - LATENCY_SUB_BUCKET_BITS + 1) << LATENCY_SUB_BUCKET_BITS) +
+        ((valueUs >> shift) & (SUB_BUCKET_NUM - 1));
+    return static_cast<uint32_t>(std::min<uint64_t>(index, LATENCY_BUCKET_NUM - 1));
+}
+
+uint64_t GetBucketUpperBound(uint32_t index)
+{
+    if (index < SUB_BUCKET_NUM) {
+        return index;
+    }
+    uint32_t shift = (index >> LATENCY_SUB_BUCKET_BITS) - 1;
+    uint64_t lowerBound = (SUB_BUCKET_NUM + (index & (SUB_BUCKET_NUM - 1))) << shift;
+    return lowerBound + (1ULL << shift) - 1;
+}
+
+template<typename T>
+void Append(std::vector<uint8_t> &snapshot, T value)
+{
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&value);
+    snapshot.insert(snapshot.end(), bytes, bytes + sizeof(value));
+}
+}  // namespace
+
+int64_t SensorLatencyTracker::GetMonotonicTimeNs()
+{
+    timespec time = { 0, 0 };
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return static_cast<int64_t>(time.tv_sec) * SECOND_NS + time.tv_nsec;
+}
+
+void SensorLatencyTracker::SetEnabled(bool enabled)
+{
+    // Ring slots keep the stamps of an earlier tracing period, the enable time tells them apart.
+    if (enabled && !g_latencyEnabled.load(std::memory_order_relaxed)) {
+        g_enabledTimeNs.store(GetMonotonicTimeNs(), std::memory_order_relaxed);
+    }
+    g_latencyEnabled.store(enabled, std::memory_order_release);
+}
+
+bool SensorLatencyTracker::IsEnabled()
+{
+    return g_latencyEnabled.load(std::memory_order_relaxed);
+}
+
+int64_t SensorLatencyTracker::GetStampNs()
+{
+    return IsEnabled() ? GetMonotonicTimeNs() : 0;
+}
+
+void SensorLatencyTracker::Record(int32_t sensorId, LatencyStage stage, int64_t hdiTimeNs, int64_t nowNs)
+{
+    if ((nowNs < hdiTimeNs) || (stage <= LATENCY_STAGE_HDI_CALLBACK) || (stage >= LATENCY_STAGE_MAX)) {
+        return;
+    }
+    LatencyHistograms *histograms = histograms_.Get(sensorId);
+    if (histograms == nullptr) {
+        SEN_HILOGD("Latency slots are used up, sensorId:%{public}d", sensorId);
+        return;
+    }
+    Add((*histograms)[stage], static_cast<uint64_t>((nowNs - hdiTimeNs) / US_NS));
+}
+
+int64_t SensorLatencyTracker::RecordDispatch(int32_t sensorId, const LatencyStamps &stamps)
+{
+    if (!IsEnabled()) {
+        return 0;
+    }
+    int64_t hdiTimeNs = stamps.hdiCallbackNs;
+    if ((hdiTimeNs <= 0) || (hdiTimeNs < g_enabledTimeNs.load(std::memory_order_relaxed))) {
+        return 0;
+    }
+    Record(sensorId, LATENCY_STAGE_ENQUEUE, hdiTimeNs, stamps.enqueueNs);
+    Record(sensorId, LATENCY_STAGE_DEQUEUE, hdiTimeNs, GetMonotonicTimeNs());
+    return hdiTimeNs;
+}
+
+void SensorLatencyTracker::RecordSend(int32_t sensorId, int64_t hdiTimeNs, int64_t sendTimeNs)
+{
+    if (hdiTimeNs > 0) {
+        Record(sensorId, LATENCY_STAGE_SEND, hdiTimeNs, sendTimeNs);
+    }
+}
+
+std::vector<LatencyStats> SensorLatencyTracker::GetStats()
+{
+    std::vector<LatencyStats> stats;
+    histograms_.ForEach([this, &stats](int32_t sensorId, const LatencyHistograms &histograms) {
+        for (int32_t stage = LATENCY_STAGE_ENQUEUE; stage < LATENCY_STAGE_MAX; ++stage) {
+            const LatencyHistogram &histogram = histograms[stage];
+            uint64_t count = histogram.count.load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            stats.push_back({ sensorId, static_cast<LatencyStage>(stage), count, GetPercentile(histogram, P50),
+                GetPercentile(histogram, P99), histogram.maxUs.load(std::memory_order_relaxed) });
+        }
+    });
+    return stats;
+}
+
+std::vector<uint8_t> SensorLatencyTracker::GetSnapshot()
+{
+    std::vector<std::pair<int32_t, const LatencyHistograms *>> claimedSlots;
+    histograms_.ForEach([&claimedSlots](int32_t sensorId, const LatencyHistograms &histograms) {
+        claimedSlots.emplace_back(sensorId, &histograms);
+    });
+    std::vector<uint8_t> snapshot;
+    Append(snapshot, LATENCY_SNAPSHOT_MAGIC);
+    Append(snapshot, LATENCY_SNAPSHOT_VERSION);
+    Append(snapshot, static_cast<uint32_t>(LATENCY_STAGE_MAX));
+    Append(snapshot, LATENCY_BUCKET_NUM);
+    Append(snapshot, LATENCY_SUB_BUCKET_BITS);
+    Append(snapshot, static_cast<uint32_t>(claimedSlots.size()));
+    for (const auto &claimedSlot : claimedSlots) {
+        Append(snapshot, claimedSlot.first);
+        for (const auto &histogram : *claimedSlot.second) {
+            Append(snapshot, histogram.count.load(std::memory_order_relaxed));
+            Append(snapshot, histogram.sumUs.load(std::memory_order_relaxed));
+            Append(snapshot, histogram.maxUs.load(std::memory_order_relaxed));
+            for (const auto &bucket : histogram.buckets) {
+                Append(snapshot, bucket.load(std::memory_order_relaxed));
+            }
+        }
+    }
+    return snapshot;
+}
+
+void SensorLatencyTracker::Add(LatencyHistogram &histogram, uint64_t latencyUs)
+{
+    histogram.buckets[GetBucketIndex(latencyUs)].fetch_add(1, std::memory_order_relaxed);
+    histogram.sumUs.fetch_add(latencyUs, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+    uint64_t maxUs = histogram.maxUs.load(std::memory_order_relaxed);
+    while ((latencyUs > maxUs) &&
+        !histogram.maxUs.compare_exchange_weak(maxUs, latencyUs, std::memory_order_relaxed)) {
+    }
+}
+
+uint64_t SensorLatencyTracker::GetPercentile(const LatencyHistogram &histogram, uint32_t percent) const
+{
+    std::array<uint32_t, LATENCY_BUCKET_NUM> buckets;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKET_NUM; ++i) {
+        buckets[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+        total += buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t rank = (total * percent + PERCENT_BASE - 1) / PERCENT_BASE;
+    uint64_t maxUs = histogram.maxUs.load(std::memory_order_relaxed);
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKET_NUM; ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // Upper bound of the bucket, the estimate is never below the true percentile.
+            return std::min(GetBucketUpperBound(i), maxUs);
+        }
+    }
+    return maxUs;
+}
+}  // namespace Sensors
+}  // namespace OHOS
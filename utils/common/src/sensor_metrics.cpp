@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sensor_metrics.h"
+
+#include "sensor_errors.h"
+#include "sensor_latency_tracker.h"
+
+#undef LOG_TAG
+#define LOG_TAG "SensorMetrics"
+
+namespace OHOS {
+namespace Sensors {
+using namespace OHOS::HiviewDFX;
+
+SensorMetrics::SensorMetrics() : startTimeNs_(SensorLatencyTracker::GetMonotonicTimeNs()) {}
+
+void SensorMetrics::AddEnqueue(int32_t eventNum, bool overwritten)
+{
+    CheckDataResumed();
+    enqueuedEvents_.fetch_add(1, std::memory_order_relaxed);
+    if (overwritten) {
+        overwrittenEvents_.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (eventNum > 0) {
+        UpdateMax(ringHighWater_, static_cast<uint64_t>(eventNum));
+    }
+}
+
+void SensorMetrics::AddEnqueueBatch(int32_t eventNum, uint32_t enqueued, uint32_t overwritten)
+{
+    CheckDataResumed();
+    enqueuedEvents_.fetch_add(enqueued, std::memory_order_relaxed);
+    if (overwritten > 0) {
+        overwrittenEvents_.fetch_add(overwritten, std::memory_order_relaxed);
+    }
+    if (eventNum > 0) {
+        UpdateMax(ringHighWater_, static_cast<uint64_t>(eventNum));
+    }
+}
+
+void SensorMetrics::AddBatch(uint32_t batchSize)
+{
+    batchCount_.fetch_add(1, std::memory_order_relaxed);
+    batchEvents_.fetch_add(batchSize, std::memory_order_relaxed);
+    UpdateMax(maxBatchSize_, batchSize);
+}
+
+void SensorMetrics::AddHdiDeath()
+{
+    hdiDeathCount_.fetch_add(1, std::memory_order_relaxed);
+    hdiDeathTimeNs_.store(SensorLatencyTracker::GetMonotonicTimeNs(), std::memory_order_relaxed);
+    isWaitingData_.store(true, std::memory_order_release);
+}
+
+void SensorMetrics::AddHdiReconnect()
+{
+    hdiReconnectCount_.fetch_add(1, std::memory_order_relaxed);
+    int64_t reconnectNs = SensorLatencyTracker::GetMonotonicTimeNs() - hdiDeathTimeNs_.load(std::memory_order_relaxed);
+    lastReconnectNs_.store(static_cast<uint64_t>(reconnectNs), std::memory_order_relaxed);
+    UpdateMax(maxReconnectNs_, static_cast<uint64_t>(reconnectNs));
+}
+
+void SensorMetrics::CheckDataResumed()
+{
+    if (!isWaitingData_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    if (!isWaitingData_.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+    int64_t dataGapNs = SensorLatencyTracker::GetMonotonicTimeNs() - hdiDeathTimeNs_.load(std::memory_order_relaxed);
+    lastDataGapNs_.store(static_cast<uint64_t>(dataGapNs), std::memory_order_relaxed);
+    UpdateMax(maxDataGapNs_, static_cast<uint64_t>(dataGapNs));
+}
+
+void SensorMetrics::AddEventIn(int32_t sensorId)
+{
+    SensorCounters *counters = sensorCounters_.Get(sensorId);
+    if (counters == nullptr) {
+        SEN_HILOGD("Metrics slots are used up, sensorId:%{public}d", sensorId);
+        return;
+    }
+    counters->eventsIn.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SensorMetrics::AddEventOut(int32_t sensorId, uint64_t eventNum)
+{
+    SensorCounters *counters = sensorCounters_.Get(sensorId);
+    if (counters == nullptr) {
+        SEN_HILOGD("Metrics slots are used up, sensorId:%{public}d", sensorId);
+        return;
+    }
+    counters->eventsOut.fetch_add(eventNum, std::memory_order_relaxed);
+}
+
+DataPathMetricsSnapshot SensorMetrics::GetSnapshot()
+{
+    DataPathMetricsSnapshot snapshot;
+    snapshot.timestampNs = SensorLatencyTracker::GetMonotonicTimeNs();
+    snapshot.startTimeNs = startTimeNs_;
+    snapshot.enqueuedEvents = enqueuedEvents_.load(std::memory_order_relaxed);
+    snapshot.overwrittenEvents = overwrittenEvents_.load(std::memory_order_relaxed);
+    snapshot.ringHighWater = ringHighWater_.load(std::memory_order_relaxed);
+    snapshot.batchCount = batchCount_.load(std::memory_order_relaxed);
+    snapshot.batchEvents = batchEvents_.load(std::memory_order_relaxed);
+    snapshot.maxBatchSize = maxBatchSize_.load(std::memory_order_relaxed);
+    snapshot.hdiDeathCount = hdiDeathCount_.load(std::memory_order_relaxed);
+    snapshot.hdiReconnectCount = hdiReconnectCount_.load(std::memory_order_relaxed);
+    snapshot.lastReconnectNs = static_cast<int64_t>(lastReconnectNs_.load(std::memory_order_relaxed));
+    snapshot.maxReconnectNs = static_cast<int64_t>(maxReconnectNs_.load(std::memory_order_relaxed));
+    snapshot.lastDataGapNs = static_cast<int64_t>(lastDataGapNs_.load(std::memory_order_relaxed));
+    snapshot.maxDataGapNs = static_cast<int64_t>(maxDataGapNs_.load(std::memory_order_relaxed));
+    sensorCounters_.ForEach([&snapshot](int32_t sensorId, const SensorCounters &counters) {
+        snapshot.sensors.push_back({ sensorId, counters.eventsIn.load(std::memory_order_relaxed),
+            counters.eventsOut.load(std::memory_order_relaxed) });
+    });
+    return snapshot;
+}
+
+void SensorMetrics::UpdateMax(std::atomic<uint64_t> &maxValue, uint64_t value)
+{
+    uint64_t current = maxValue.load(std::memory_order_relaxed);
+    while ((value > current) && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+}  // namespace Sensors
+}  // namespace OHOS
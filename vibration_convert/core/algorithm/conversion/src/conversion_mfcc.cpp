@@ -33,7 +33,7 @@ constexpr uint32_t MEL_FILTERS_OR_COEFFS_MAX { 4096 * 4096 };
 int32_t ConversionMfcc::HandleMelFilterAndLogSquare(const std::vector<float> &powerSpectrum)
 {
     size_t powerSpectrumSize = powerSpectrum.size();
-    if ((powerSpectrumSize == 0) || (powerSpectrumSize >= numBins_)) {
+    if ((powerSpectrumSize == 0) || (powerSpectrumSize < numBins_)) {
         SEN_HILOGE("Invalid parameter");
         return Sensors::PARAMETER_ERROR;
     }
@@ -225,7 +225,6 @@ int32_t ConversionMfcc::FiltersMel(int32_t nFft, MfccInputPara para,
     size_t nMels = static_cast<size_t>(para.nMels);
     double fMin = para.minFreq;
     frmCount = nFft / 2;
-    std::vector<double> basis(nMels * frmCount, 0.0);
     // generate mel frequencies.
     double minMel = OHOS::Sensors::ConvertHtkMel(fMin);
     double maxMel = OHOS::Sensors::ConvertHtkMel(fMax);
@@ -239,10 +238,11 @@ int32_t ConversionMfcc::FiltersMel(int32_t nFft, MfccInputPara para,
         nextMel += stepMel;
     }
     std::vector<double> binFs(frmCount);
-    for (int32_t j = 0; j < frmCount; j++) {
+    for (size_t j = 0; j < frmCount; j++) {
         binFs[j] = stepHz * j;
     }
-    int32_t index = 0;
+    // Written directly in the transposed (column-major) layout, bin j of filter m lands at j * nMels + m.
+    melBasis.assign(nMels * frmCount, 0.0);
     for (size_t i = 2; i < filterHzPos.size(); i++) {
         double prevFreq = filterHzPos[i - 2];
         double thisFreq = filterHzPos[i - 1];
@@ -251,16 +251,16 @@ int32_t ConversionMfcc::FiltersMel(int32_t nFft, MfccInputPara para,
             SEN_HILOGE("The divisor cannot be 0");
             return Sensors::ERROR;
         }
-        for (int32_t j = 0; j < frmCount; j++) {
+        size_t melIdx = i - 2;
+        for (size_t j = 0; j < frmCount; j++) {
             double binFreq = binFs[j];
             double lower = (binFreq - prevFreq) / (thisFreq - prevFreq);
             double upper = (nextFreq - binFreq) / (nextFreq - thisFreq);
             double min = IsLessNotEqual(lower, upper) ? lower : upper;
             min = IsGreatNotEqual(min, 0.0) ? min : 0.0;
-            basis[index++] = min * 2.0 / (nextFreq - prevFreq);
+            melBasis[j * nMels + melIdx] = min * 2.0 / (nextFreq - prevFreq);
         }
     }
-    melBasis = OHOS::Sensors::TransposeMatrix(nMels, basis);
     if (melBasis.empty()) {
         SEN_HILOGE("melBasis is empty");
         return Sensors::ERROR;
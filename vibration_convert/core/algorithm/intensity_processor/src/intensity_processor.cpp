@@ -18,6 +18,7 @@
 #include "audio_utils.h"
 #include "sensor_log.h"
 #include "sensors_errors.h"
+#include "vector_kernels.h"
 
 #undef LOG_TAG
 #define LOG_TAG "IntensityProcessor"
@@ -31,48 +32,38 @@ constexpr double VOLUME_DB_COEF { 10.0 };
 std::vector<double> IntensityProcessor::GetRMS(const std::vector<double> &data, int32_t hopLength, bool centerFlag)
 {
     CALL_LOG_ENTER;
-    std::vector<double> rmseEnvelop;
     if ((data.empty()) || (hopLength < 1)) {
         SEN_HILOGE("data is empty or hopLength is less than 1");
-        return rmseEnvelop;
+        return {};
     }
-    std::vector<double> paddingData;
-    if (centerFlag) {
-        AudioUtils audioUtil;
-        paddingData = audioUtil.PadData(data, hopLength);
-    } else {
-        paddingData = data;
-    }
-    size_t paddingDataSize = paddingData.size();
-    size_t frmN = paddingDataSize / static_cast<size_t>(hopLength);
+    // Center padding is virtual, frames are clipped against the original samples instead of copying the signal.
+    size_t dataSize = data.size();
+    size_t hop = static_cast<size_t>(hopLength);
+    size_t padding = centerFlag ? (hop / 2) : 0;
+    size_t frmN = (dataSize + 2 * padding) / hop;
+    std::vector<double> rmseEnvelop(frmN, 0.0);
     for (size_t i = 0; i < frmN; ++i) {
-        double accum = 0.0;
-        int32_t index = i * hopLength;
-        for (int32_t j = 0; j < hopLength; ++j, ++index) {
-            accum += pow(paddingData[index], 2);
-        }
-        rmseEnvelop.push_back(sqrt(accum / hopLength));
+        size_t frameBegin = i * hop;
+        size_t first = (frameBegin > padding) ? (frameBegin - padding) : 0;
+        size_t last = std::min(((frameBegin + hop) > padding) ? (frameBegin + hop - padding) : 0, dataSize);
+        double accum = (first < last) ? SumOfSquares(data.data() + first, last - first) : 0.0;
+        rmseEnvelop[i] = sqrt(accum / hopLength);
     }
     return rmseEnvelop;
 }
 
 std::vector<double> IntensityProcessor::EnergyEnvelop(const std::vector<double> &data, int32_t nFft, int32_t hopLength)
 {
-    std::vector<double> dataAbsPower;
-    size_t dataSize = data.size();
-    for (size_t i = 0; i < dataSize; ++i) {
-        dataAbsPower.push_back(data[i] * data[i]);
-    }
-    std::vector<double> oneFrmData;
-    std::vector<double> blockAmplitudeSum;
-    auto it = dataAbsPower.begin();
-    for (size_t i = 0; (i + nFft) < dataSize;) {
-        oneFrmData.assign(it + i, it + i + nFft);
-        double accum = accumulate(begin(oneFrmData), end(oneFrmData), 0);
-        blockAmplitudeSum.emplace_back(accum);
-        i += hopLength;
+    if ((nFft < 1) || (hopLength < 1)) {
+        SEN_HILOGE("nFft or hopLength is less than 1");
+        return {};
     }
-    return blockAmplitudeSum;
+    size_t dataSize = data.size();
+    size_t frameLength = static_cast<size_t>(nFft);
+    size_t hop = static_cast<size_t>(hopLength);
+    // Frames start while (start + nFft) < dataSize.
+    size_t frmN = (dataSize > frameLength) ? ((dataSize - frameLength + hop - 1) / hop) : 0;
+    return FrameSumOfSquares(data.data(), frmN, frameLength, hop);
 }
 
 int32_t IntensityProcessor::RmseNormalize(const std::vector<double> &rmseEnvelope, double lowerDelta,
@@ -101,21 +92,14 @@ int32_t IntensityProcessor::RmseNormalize(const std::vector<double> &rmseEnvelop
 std::vector<double> IntensityProcessor::VolumeInLinary(const std::vector<double> &data, int32_t hopLength)
 {
     CALL_LOG_ENTER;
-    std::vector<double> dataAbsPower;
-    size_t dataSize = data.size();
-    for (size_t i = 0; i < dataSize; ++i) {
-        dataAbsPower.push_back(abs(data[i]));
+    if (hopLength < 1) {
+        SEN_HILOGE("hopLength is less than 1");
+        return {};
     }
-    std::vector<double> oneFrmData;
-    std::vector<double> blockAmplitudeSum;
-    auto it = dataAbsPower.begin();
-    for (size_t i = 0; (i + hopLength) < dataSize;) {
-        oneFrmData.assign(it + i, it + i + hopLength);
-        double accum = accumulate(oneFrmData.begin(), oneFrmData.end(), 0);
-        blockAmplitudeSum.push_back(accum);
-        i += hopLength;
-    }
-    return blockAmplitudeSum;
+    size_t dataSize = data.size();
+    size_t hop = static_cast<size_t>(hopLength);
+    size_t frmN = (dataSize > hop) ? ((dataSize - 1) / hop) : 0;
+    return FrameSumOfAbs(data.data(), frmN, hop, hop);
 }
 
 std::vector<double> IntensityProcessor::VolumeInDB(const std::vector<double> &data, int32_t hopLength)
@@ -67,10 +67,8 @@ private:
     int32_t GetMelBias(int32_t numBins, int32_t nFft, size_t &frmCount, std::vector<double> &melBias);
     std::vector<double> MatrixDot(size_t matrixAcols, const std::vector<double> &matrixA,
         size_t matrixBcols, const std::vector<double> &matrixB);
-    std::vector<double> MatrixDiff(size_t valueCols, const std::vector<double> &values);
-    std::vector<double> PowerDB(const std::vector<double> &values);
-    std::optional<double> Median(const std::vector<double> &values);
-    std::optional<double> Mean(const std::vector<double> &values);
+    int32_t SpectralFlux(size_t valueCols, std::vector<double> &values);
+    void PowerDB(std::vector<double> &values);
 
 private:
     bool htkFlag_ { false };
@@ -23,6 +23,7 @@
 #include "conversion_mfcc.h"
 #include "sensor_log.h"
 #include "sensors_errors.h"
+#include "statistics.h"
 #include "utils.h"
 
 #undef LOG_TAG
@@ -40,6 +41,9 @@ constexpr uint32_t SEMITONE_NUM_COEFFS = 13;
 constexpr double ONSET_PEAK_THRESHOLD_RATIO = 0.4;
 constexpr double MIN_FREQ = 0.0;
 constexpr double MAX_FREQ = SAMPLE_RATE / 2.0;
+// Tile sizes of the mel projection, 8 result columns of 128 mels and 256 bins of matrixB fit in L1.
+constexpr size_t DOT_FRAME_BLOCK = 8;
+constexpr size_t DOT_BIN_BLOCK = 256;
 }  // namespace
 
 std::vector<double> Onset::MatrixDot(size_t matrixAcols, const std::vector<double> &matrixA,
@@ -55,68 +59,78 @@ std::vector<double> Onset::MatrixDot(size_t matrixAcols, const std::vector<doubl
     }
     size_t aRows = matrixA.size() / matrixAcols;
     size_t bRows = matrixB.size() / matrixBcols;
-    std::vector<double> result(aRows * matrixBcols);
-    for (size_t i = 0; i < aRows; ++i) {
-        for (size_t j = 0; j < matrixBcols; ++j) {
-            // bRows must equal to matrixAcols.
-            int32_t idx = j * aRows + i;
-            double sum = 0.0;
-            for (size_t k = 0; k < bRows; ++k) {
-                // Multiply each column of the matrixB by each row of the matrixA, and then sum it up.
-                sum += matrixA[k * aRows + i] * matrixB[j * bRows + k];
+    // bRows must not exceed matrixAcols.
+    if ((aRows == 0) || (bRows > matrixAcols)) {
+        SEN_HILOGE("Matrix dimension mismatch, aRows:%{public}zu, bRows:%{public}zu, matrixAcols:%{public}zu",
+            aRows, bRows, matrixAcols);
+        return {};
+    }
+    // Both matrices are column-major. The columns of matrixA (mel filter weights of one fft bin) are mostly zero,
+    // so only the nonzero row span of each column takes part in the product.
+    std::vector<size_t> spanBegin(matrixAcols, 0);
+    std::vector<size_t> spanEnd(matrixAcols, 0);
+    for (size_t k = 0; k < matrixAcols; ++k) {
+        const double *column = matrixA.data() + k * aRows;
+        size_t first = 0;
+        while ((first < aRows) && (column[first] == 0.0)) {
+            ++first;
+        }
+        size_t last = aRows;
+        while ((last > first) && (column[last - 1] == 0.0)) {
+            --last;
+        }
+        spanBegin[k] = first;
+        spanEnd[k] = last;
+    }
+    std::vector<double> result(aRows * matrixBcols, 0.0);
+    // Tile over frames and bins so the active panel of matrixA and the result columns stay in cache. Each element
+    // still accumulates its products in ascending bin order, so the result matches the naive triple loop.
+    for (size_t jBlock = 0; jBlock < matrixBcols; jBlock += DOT_FRAME_BLOCK) {
+        size_t jEnd = std::min(jBlock + DOT_FRAME_BLOCK, matrixBcols);
+        for (size_t kBlock = 0; kBlock < bRows; kBlock += DOT_BIN_BLOCK) {
+            size_t kEnd = std::min(kBlock + DOT_BIN_BLOCK, bRows);
+            for (size_t j = jBlock; j < jEnd; ++j) {
+                const double *bColumn = matrixB.data() + j * bRows;
+                double *resultColumn = result.data() + j * aRows;
+                for (size_t k = kBlock; k < kEnd; ++k) {
+                    double weight = bColumn[k];
+                    const double *aColumn = matrixA.data() + k * aRows;
+                    for (size_t i = spanBegin[k]; i < spanEnd[k]; ++i) {
+                        resultColumn[i] += aColumn[i] * weight;
+                    }
+                }
             }
-            result[idx] = sum;
         }
     }
     return result;
 }
 
-std::vector<double> Onset::MatrixDiff(size_t valueCols, const std::vector<double> &values)
+int32_t Onset::SpectralFlux(size_t valueCols, std::vector<double> &values)
 {
-    if ((valueCols == 0) || (values.empty())) {
+    if ((valueCols <= 1) || (values.empty())) {
         SEN_HILOGE("Invalid parameter");
-        return {};
+        return Sensors::PARAMETER_ERROR;
     }
     size_t valueRows = values.size() / valueCols;
-    std::vector<double> result;
+    // Column i is overwritten only after column i + 1 has been read, so the difference can run in place.
     for (size_t i = 0; i < (valueCols - 1); ++i) {
+        double *current = values.data() + i * valueRows;
+        const double *next = current + valueRows;
         for (size_t j = 0; j < valueRows; ++j) {
-            result.push_back(values[(i + 1) * valueRows + j] - values[i * valueRows + j]);
+            double diff = next[j] - current[j];
+            current[j] = IsGreatNotEqual(diff, 0.0) ? diff : 0.0;
         }
     }
-    return result;
-}
-
-std::optional<double> Onset::Median(const std::vector<double> &values)
-{
-    if (values.empty()) {
-        SEN_HILOGE("values is empty");
-        return std::nullopt;
-    }
-    std::vector<double> result = values;
-    sort(result.begin(), result.end());
-    double valueMedian = result[result.size() / 2];
-    return valueMedian;
-}
-
-std::optional<double> Onset::Mean(const std::vector<double> &values)
-{
-    if (values.empty()) {
-        SEN_HILOGE("values is empty");
-        return std::nullopt;
-    }
-    double sumValue = accumulate(values.begin(), values.end(), 0);
-    return sumValue / values.size();
+    values.resize((valueCols - 1) * valueRows);
+    return Sensors::SUCCESS;
 }
 
 // Need to subtract an offset value.
-std::vector<double> Onset::PowerDB(const std::vector<double> &values)
+void Onset::PowerDB(std::vector<double> &values)
 {
-    std::vector<double> logSpectrum;
     for (size_t i = 0; i < values.size(); ++i) {
-        logSpectrum.push_back(POWER_DB_COEF * log(std::max(EPS_MIN, values[i])));
+        values[i] = POWER_DB_COEF * log(std::max(EPS_MIN, values[i]));
     }
-    return logSpectrum;
 }
 
 int32_t Onset::Sfft(const std::vector<double> &data, int32_t hopLength, int32_t &frmCount,
@@ -193,10 +207,10 @@ int32_t Onset::CheckOnset(const std::vector<double> &data, int32_t nFft, int32_t
         SEN_HILOGE("magnitudes is empty");
         return Sensors::ERROR;
     }
-    std::vector<double> frmMagnitudes;
+    std::vector<double> frmMagnitudes(magnitudes.size(), 0.0);
     for (size_t i = 0; i < magnitudes.size(); ++i) {
-        frmMagnitudes.push_back(static_cast<double>(magnitudes[i]));
-        frmMagnitudes[i] = pow(frmMagnitudes[i], 2);
+        double magnitude = static_cast<double>(magnitudes[i]);
+        frmMagnitudes[i] = magnitude * magnitude;
     }
     size_t biasFrmCount = 0;
     std::vector<double> melBias;
@@ -204,24 +218,17 @@ int32_t Onset::CheckOnset(const std::vector<double> &data, int32_t nFft, int32_t
         SEN_HILOGE("GetMelBias failed");
         return Sensors::ERROR;
     }
-    std::vector<double> onsetEnvelope = MatrixDot(biasFrmCount, melBias, sfftFrmCount, frmMagnitudes);
-    if (onsetEnvelope.empty()) {
+    std::vector<double> dbEnvelopeDiff = MatrixDot(biasFrmCount, melBias, sfftFrmCount, frmMagnitudes);
+    if (dbEnvelopeDiff.empty()) {
         SEN_HILOGE("onsetEnvelope is empty");
         return Sensors::ERROR;
     }
-    std::vector<double> dbEnvelope = PowerDB(onsetEnvelope);
-    if (dbEnvelope.empty()) {
-        SEN_HILOGE("dbEnvelope is empty");
+    PowerDB(dbEnvelopeDiff);
+    // Half-wave rectified difference between consecutive frames, computed in place.
+    if (SpectralFlux(sfftFrmCount, dbEnvelopeDiff) != Sensors::SUCCESS) {
+        SEN_HILOGE("SpectralFlux failed");
         return Sensors::ERROR;
     }
-    std::vector<double> dbEnvelopeDiff = MatrixDiff(sfftFrmCount, dbEnvelope);
-    if (dbEnvelopeDiff.empty()) {
-        SEN_HILOGE("dbEnvelopeDiff is empty");
-        return Sensors::ERROR;
-    }
-    for (size_t i = 0; i < dbEnvelopeDiff.size(); ++i) {
-        dbEnvelopeDiff[i] = (IsGreatNotEqual(dbEnvelopeDiff[i], 0.0)) ? dbEnvelopeDiff[i] : 0.0;
-    }
     if (sfftFrmCount <= 1) {
         SEN_HILOGE("sfftFrmCount is less than or equal to 1");
         return Sensors::ERROR;
@@ -229,10 +236,13 @@ int32_t Onset::CheckOnset(const std::vector<double> &data, int32_t nFft, int32_t
     size_t cols = sfftFrmCount - 1;
     size_t rows = dbEnvelopeDiff.size() / cols;
     onsetInfo_.Clear();
+    onsetInfo_.envelopes.reserve(cols);
+    // Reused across frames, nth_element only needs a scratch copy of one frame.
     std::vector<double> oneFrmValues;
+    oneFrmValues.reserve(rows);
     for (size_t i = 0; i < cols; ++i) {
         oneFrmValues.assign(dbEnvelopeDiff.begin() + i * rows, dbEnvelopeDiff.begin() + ((i + 1) * rows));
-        std::optional<double> median = Median(oneFrmValues);
+        std::optional<double> median = MedianInPlace(oneFrmValues);
         if (!median) {
             SEN_HILOGE("Median failed");
             return Sensors::ERROR;
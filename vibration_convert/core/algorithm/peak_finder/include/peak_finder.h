@@ -18,6 +18,8 @@
 
 #include <vector>
 
+#include "statistics.h"
+
 namespace OHOS {
 namespace Sensors {
 /**
@@ -145,9 +147,9 @@ private:
     std::vector<bool> SplitVoiceSlienceRange(int32_t dataSize,const std::vector<int32_t> &envelopeStart,
         const std::vector<int32_t> &envelopeLast);
     std::vector<int32_t> FilterSecondaryPeak(const std::vector<double> &envelope, const std::vector<int32_t> &peaks, double lowerAmp);
-    int32_t DeletePeaks(const std::vector<double> &envelope, int32_t startPos, int32_t endPos,
+    int32_t DeletePeaks(const RangeMinTable &rangeMin, int32_t startPos, int32_t endPos,
         MountainPosition &mountainPosition, int32_t &index);
-    int32_t DetectValley(const std::vector<double> &envelope, int32_t startPos, int32_t endPos,
+    int32_t DetectValley(const RangeMinTable &rangeMin, int32_t startPos, int32_t endPos,
         const MountainPosition &mountainPosition, ValleyPoint &valleyPoint);
 
     double GetLowestPeakValue(const std::vector<double> &envelope, const std::vector<int32_t> &peaks);
@@ -21,6 +21,7 @@
 
 #include "sensor_log.h"
 #include "sensors_errors.h"
+#include "statistics.h"
 #include "utils.h"
 
 #undef LOG_TAG
@@ -92,12 +93,8 @@ std::vector<bool> PeakFinder::GetVoiceFlag(const std::vector<double> &data, cons
         }
     }
     size_t envelopeLength = triangularEnvelope.size();
-    auto it = triangularEnvelope.begin();
-    for (size_t i = 0; i < envelopeLength; i++) {
-        if ((i + MAX_N) >= envelopeLength) {
-            break;
-        }
-        triangularEnvelope[i] = *max_element(it + i, it + i + MAX_N);
+    if (envelopeLength > MAX_N) {
+        SlidingWindowMax(triangularEnvelope, MAX_N, envelopeLength - MAX_N);
     }
     MountainPosition mountainPosition;
     // Obtain the independent envelope of each peak point
@@ -119,15 +116,24 @@ std::vector<bool> PeakFinder::SplitVoiceSlienceRange(int32_t dataSize, const std
         SEN_HILOGE("Invalid parameter");
         return {};
     }
-    std::vector<bool> vioceFlag(dataSize, false);
     std::vector<bool> segmentFlag(ceil(static_cast<double>(dataSize) / hopLength_), false);
-    for (size_t i = 0; i < envelopeStart.size(); ++i) {
-        for (int32_t boundary = envelopeStart[i]; boundary <= envelopeLast[i]; ++boundary) {
-            if (boundary > vioceFlag.size()) {
-                break;
-            }
-            vioceFlag[boundary] = true;
+    // Mark the envelopes through a difference array, overlapping envelopes are not rescanned.
+    std::vector<int32_t> coverage(dataSize + 1, 0);
+    size_t envelopeCount = std::min(envelopeStart.size(), envelopeLast.size());
+    for (size_t i = 0; i < envelopeCount; ++i) {
+        int32_t first = std::max(envelopeStart[i], 0);
+        int32_t last = std::min(envelopeLast[i], dataSize - 1);
+        if (first > last) {
+            continue;
         }
+        ++coverage[first];
+        --coverage[last + 1];
+    }
+    std::vector<bool> vioceFlag(dataSize, false);
+    int32_t covered = 0;
+    for (int32_t i = 0; i < dataSize; ++i) {
+        covered += coverage[i];
+        vioceFlag[i] = (covered > 0);
     }
     for (int32_t i = 0; i < dataSize; ) {
         if (vioceFlag[i]) {
@@ -217,22 +223,30 @@ std::vector<int32_t> PeakFinder::PeakFilterMinRange(const std::vector<double> &d
     if (peaks.empty() || peaks.size() <= 1) {
         return peaks;
     }
-    for (size_t i = 0; i < (peaks.size() - 1); i++) {
-        if (fabs(peaks[i] - peaks[i + 1]) < minSampleCount) {
-            if (peaks[i + 1] > data.size()) {
-                SEN_HILOGW("peaks value greater than data size");
-                return peaks;
-            }
-            if (data[peaks[i]] >= data[peaks[i + 1]]) {
-                auto it = (peaks.begin() + i + 1);
-                peaks.erase(it);
-            } else {
-                auto it = (peaks.begin() + i);
-                peaks.erase(it);
-            }
-            --i;
+    // Single pass: 'current' is the survivor of the run of peaks closer than minSampleCount to their successor.
+    std::vector<int32_t> filtered;
+    filtered.reserve(peaks.size());
+    int32_t current = peaks[0];
+    for (size_t i = 1; i < peaks.size(); i++) {
+        int32_t next = peaks[i];
+        if (fabs(current - next) >= minSampleCount) {
+            filtered.push_back(current);
+            current = next;
+            continue;
+        }
+        if (next > data.size()) {
+            SEN_HILOGW("peaks value greater than data size");
+            filtered.push_back(current);
+            filtered.insert(filtered.end(), peaks.begin() + i, peaks.end());
+            peaks = filtered;
+            return peaks;
+        }
+        if (data[current] < data[next]) {
+            current = next;
         }
     }
+    filtered.push_back(current);
+    peaks = filtered;
     return peaks;
 }
 
@@ -240,22 +254,18 @@ std::vector<int32_t> PeakFinder::PeakFilterMinRange(const std::vector<double> &d
 std::vector<int32_t> PeakFinder::FilterLowPeak(const std::vector<double> &envelope, const std::vector<int32_t> &peaks,
     double removeRatio)
 {
-    std::vector<int32_t> peakPoint = peaks;
-    size_t peaksSize = peakPoint.size();
-    if (peaksSize == 0) {
-        return peakPoint;
-    }
-    std::vector<double> peakValue;
-
-    for (size_t i = 0; i < peaksSize; i++) {
-        peakValue.push_back(envelope[peakPoint[i]]);
+    if (peaks.empty()) {
+        return peaks;
     }
-    double threshold = *max_element(peakValue.begin(), peakValue.end()) * removeRatio;
-    for (int32_t i = (peaksSize - 1); i >= 0; i--) {
-        if (peakValue[i] < threshold) {
-            peakPoint.erase(peakPoint.begin() + i);
-        }
+    double maxPeak = envelope[peaks[0]];
+    for (size_t i = 1; i < peaks.size(); i++) {
+        maxPeak = std::max(maxPeak, envelope[peaks[i]]);
     }
+    double threshold = maxPeak * removeRatio;
+    std::vector<int32_t> peakPoint;
+    peakPoint.reserve(peaks.size());
+    std::copy_if(peaks.begin(), peaks.end(), std::back_inserter(peakPoint),
+        [&envelope, threshold](int32_t peak) { return envelope[peak] >= threshold; });
     return peakPoint;
 }
 
@@ -271,6 +281,8 @@ std::vector<int32_t> PeakFinder::FilterSecondaryPeak(const std::vector<double> &
         SEN_HILOGE("firstPos is empty");
         return {};
     }
+    // Valley searches between peaks become O(1) range-minimum queries.
+    RangeMinTable rangeMin(envelope);
     int32_t lastFirstPos = wholeEnvelop.firstPos[0];
     int32_t lastEndPos = wholeEnvelop.lastPos[0];
     size_t frontIndex = 0;
@@ -300,7 +312,7 @@ std::vector<int32_t> PeakFinder::FilterSecondaryPeak(const std::vector<double> &
         // The peak points are enveloped together, and the drop of the secondary peak is less than 30 %.
         // Delete this peak point
         int32_t index = 0;
-        if (DeletePeaks(envelope, frontIndex, toIndex, wholeEnvelop, index) != Sensors::SUCCESS) {
+        if (DeletePeaks(rangeMin, frontIndex, toIndex, wholeEnvelop, index) != Sensors::SUCCESS) {
             SEN_HILOGE("DeletePeaks failed");
             return {};
         }
@@ -316,14 +328,15 @@ std::vector<int32_t> PeakFinder::FilterSecondaryPeak(const std::vector<double> &
 }
 
 // The peak points are enveloped together, and the drop of the secondary peak is less than 30 %. Delete this peak point.
-int32_t PeakFinder::DeletePeaks(const std::vector<double> &envelope, int32_t startPos, int32_t endPos,
+int32_t PeakFinder::DeletePeaks(const RangeMinTable &rangeMin, int32_t startPos, int32_t endPos,
     MountainPosition &mountainPosition, int32_t &endIndex)
 {
+    const std::vector<double> &envelope = rangeMin.Values();
     bool delFlag = true;
     while (delFlag) {
         ValleyPoint valleyPoint;
         // The valley in both peaks detection.
-        if (DetectValley(envelope, startPos, endPos, mountainPosition, valleyPoint) != Sensors::SUCCESS) {
+        if (DetectValley(rangeMin, startPos, endPos, mountainPosition, valleyPoint) != Sensors::SUCCESS) {
             SEN_HILOGE("DetectValley failed");
             return Sensors::ERROR;
         }
@@ -378,40 +391,37 @@ bool PeakFinder::GetDeleteFlagOfPeak(const std::vector<double> &envelope, int32_
 }
 
 // The valley in both peaks detection.
-int32_t PeakFinder::DetectValley(const std::vector<double> &envelope, int32_t startPos, int32_t endPos,
+int32_t PeakFinder::DetectValley(const RangeMinTable &rangeMin, int32_t startPos, int32_t endPos,
     const MountainPosition &mountainPosition, ValleyPoint &valleyPoint)
 {
     if (mountainPosition.peakPos.empty()) {
         SEN_HILOGE("peakPos is empty");
         return Sensors::ERROR;
     }
-    if (startPos < 0 || endPos < 0) {
+    if (startPos < 0 || endPos < 0 || endPos < startPos) {
         SEN_HILOGE("startPos or endPos is wrong");
         return Sensors::ERROR;
     }
-    valleyPoint.values.resize(mountainPosition.peakPos.size() + 1);
-    valleyPoint.pos.resize(mountainPosition.peakPos.size() + 1);
-
     if ((startPos >= mountainPosition.firstPos.size()) || (endPos >= mountainPosition.lastPos.size())) {
         SEN_HILOGE("The parameter is invalid or out of bounds");
         return Sensors::ERROR;
     }
+    const std::vector<double> &envelope = rangeMin.Values();
+    // One valley before each peak in [startPos, endPos] plus the trailing one.
+    size_t valleyCount = static_cast<size_t>(endPos - startPos) + 2;
+    valleyPoint.values.resize(valleyCount);
+    valleyPoint.pos.resize(valleyCount);
     int32_t valleyPos = mountainPosition.firstPos[startPos];
     if (startPos > 0) {
-        int32_t startIndex = mountainPosition.peakPos[startPos - 1];
-        int32_t endindex = mountainPosition.peakPos[startPos];
-        auto iter = std::min_element((envelope.begin() + startIndex), (envelope.begin() + endindex));
-        valleyPos = iter - envelope.begin();
+        valleyPos = static_cast<int32_t>(rangeMin.Query(mountainPosition.peakPos[startPos - 1],
+            mountainPosition.peakPos[startPos]));
     }
     int32_t indexCount = 0;
     valleyPoint.values[indexCount] = envelope[valleyPos];
     valleyPoint.pos[indexCount] = valleyPos;
     ++indexCount;
     for (int32_t i = startPos; i < endPos; i++) {
-        int32_t startIndex = mountainPosition.peakPos[i];
-        int32_t endindex = mountainPosition.peakPos[i + 1];
-        auto iter = std::min_element((envelope.begin() + startIndex), (envelope.begin() + endindex));
-        valleyPos = iter - envelope.begin();
+        valleyPos = static_cast<int32_t>(rangeMin.Query(mountainPosition.peakPos[i], mountainPosition.peakPos[i + 1]));
         valleyPoint.values[indexCount] = envelope[valleyPos];
         valleyPoint.pos[indexCount] = valleyPos;
         ++indexCount;
@@ -486,12 +496,12 @@ double PeakFinder::GetLowestPeakValue(const std::vector<double> &envelope, const
         SEN_HILOGE("peaks is empty");
         return Sensors::ERROR;
     }
-    std::vector<double> peakValues;
-    for (size_t i = 0; i < peaks.size(); i++) {
-        peakValues.push_back(envelope[peaks[i]]);
+    double maxPeak = envelope[peaks[0]];
+    double minPeak = maxPeak;
+    for (size_t i = 1; i < peaks.size(); i++) {
+        maxPeak = std::max(maxPeak, envelope[peaks[i]]);
+        minPeak = std::min(minPeak, envelope[peaks[i]]);
     }
-    double maxPeak = *max_element(peakValues.begin(), peakValues.end());
-    double minPeak = *min_element(peakValues.begin(), peakValues.end());
     if (maxPeak > PEAKMAX_THRESHOLD_HIGH) {
         minPeak *= PEAK_LOWDELTA_RATIO_HIGH;
     } else if (maxPeak > PEAKMAX_THRESHIOLD_MID) {
@@ -667,11 +677,8 @@ int32_t PeakFinder::GetIsolatedEnvelope(const std::vector<double> &data, const s
         }
     }
     size_t envelopeSize = triangularEnvelope.size();
-    size_t j = 0;
-    while ((j + MAX_N) <= envelopeSize) {
-        double maxValue = *std::max_element(triangularEnvelope.begin() + j, triangularEnvelope.begin() + j + MAX_N);
-        triangularEnvelope[j] = maxValue;
-        ++j;
+    if (envelopeSize >= MAX_N) {
+        SlidingWindowMax(triangularEnvelope, MAX_N, envelopeSize - MAX_N + 1);
     }
     int32_t leastCount = 2 * hopLength_;
     MountainPosition mountainPosition;
@@ -687,7 +694,8 @@ int32_t PeakFinder::GetIsolatedEnvelope(const std::vector<double> &data, const s
     ValleyPoint valleyPoint;
     size_t envPeakLen = mountainPosition.peakPos.size() - 1;
     // The valleyes in both peaks to detection
-    if (DetectValley(triangularEnvelope, 0, envPeakLen, mountainPosition, valleyPoint) != Sensors::SUCCESS) {
+    RangeMinTable rangeMin(triangularEnvelope);
+    if (DetectValley(rangeMin, 0, envPeakLen, mountainPosition, valleyPoint) != Sensors::SUCCESS) {
         SEN_HILOGE("DetectValley failed");
         return Sensors::ERROR;
     }
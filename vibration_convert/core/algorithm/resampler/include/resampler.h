@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * Polyphase FIR resampler for a rational ratio upFactor / downFactor.
+ * A Kaiser windowed-sinc low pass filter is designed once in {@link Init} and split into upFactor phases, each
+ * output sample is one inner product between a phase and the most recent input samples. Interleaved multichannel
+ * input is filtered per channel, filter history is kept between {@link Process} calls so that a signal may be fed
+ * in blocks.
+ * The filter length grows linearly with the larger factor, so after reduction both factors are limited to
+ * {@link MAX_FILTER_FACTOR}. {@link Resample} serves larger pure decimations by averaging blocks instead.
+ */
+class Resampler {
+public:
+    /** Largest reduced factor a filter bank is designed for, about 2300 taps per phase. */
+    static constexpr uint32_t MAX_FILTER_FACTOR { 64 };
+
+    Resampler() = default;
+    ~Resampler() = default;
+
+    /**
+     * @brief Design the filter bank, the ratio is reduced by its greatest common divisor.
+     *
+     * @param upFactor Interpolation factor, must be greater than 0.
+     * @param downFactor Decimation factor, must be greater than 0.
+     * Both factors must not exceed {@link MAX_FILTER_FACTOR} once reduced.
+     * @param channels Number of interleaved channels, must be greater than 0.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    int32_t Init(uint32_t upFactor, uint32_t downFactor, uint32_t channels);
+
+    /**
+     * @brief Resample one block of interleaved samples and append the result to 'output'.
+     * The output lags the input by {@link GetDelay} output frames.
+     *
+     * @param input Interleaved samples, the size must be a multiple of the channel count.
+     * @param output Resampled interleaved samples are appended here.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    int32_t Process(const std::vector<double> &input, std::vector<double> &output);
+
+    /**
+     * @brief Clear the filter history, the filter bank is kept.
+     */
+    void Reset();
+
+    /**
+     * @brief Group delay of the filter, in output frames.
+     */
+    double GetDelay() const;
+
+    /**
+     * @brief Resample a whole signal with the group delay compensated.
+     * The output holds ceil(frames * upFactor / downFactor) frames aligned with the input.
+     * A decimation whose reduced downFactor exceeds {@link MAX_FILTER_FACTOR} averages downFactor input frames
+     * centered on each output frame, other ratios beyond that bound are rejected.
+     *
+     * @param input Interleaved samples, trailing samples of an incomplete frame are ignored.
+     * @param upFactor Interpolation factor.
+     * @param downFactor Decimation factor.
+     * @param channels Number of interleaved channels.
+     * @param output Resampled interleaved samples.
+     *
+     * @return Returns <b>0</b> if the operation is successful; returns a non-zero value otherwise.
+     */
+    static int32_t Resample(const std::vector<double> &input, uint32_t upFactor, uint32_t downFactor,
+        uint32_t channels, std::vector<double> &output);
+
+private:
+    static void AverageBlocks(const std::vector<double> &input, uint32_t downFactor, uint32_t channels,
+        std::vector<double> &output);
+    void DesignFilterBank();
+    void ProcessFrames(const double *input, size_t frameCount, std::vector<double> &output);
+
+private:
+    uint32_t upFactor_ { 1 };
+    uint32_t downFactor_ { 1 };
+    uint32_t channels_ { 1 };
+    size_t tapsPerPhase_ { 0 };
+    // Phase p holds tapsPerPhase_ coefficients in reversed order, stored contiguously at p * tapsPerPhase_.
+    std::vector<double> filterBank_;
+    // Per channel: the last (tapsPerPhase_ - 1) input samples followed by the current block.
+    std::vector<std::vector<double>> channelBuffers_;
+    // Input frame of the next output, relative to the start of the current block.
+    size_t inputIndex_ { 0 };
+    uint32_t phase_ { 0 };
+};
+}  // namespace Sensors
+}  // namespace OHOS
+#endif // RESAMPLER_H
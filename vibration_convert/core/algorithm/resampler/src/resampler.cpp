@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "sensor_log.h"
+#include "sensors_errors.h"
+#include "vector_kernels.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Resampler"
+
+namespace OHOS {
+namespace Sensors {
+namespace {
+// Zero crossings of the windowed sinc on each side of its center.
+constexpr double ZERO_CROSSINGS { 16.0 };
+// Passband edge as a fraction of the lower Nyquist frequency.
+constexpr double ROLLOFF { 0.9 };
+// About 80 dB of stopband attenuation.
+constexpr double KAISER_BETA { 8.0 };
+constexpr double BESSEL_EPSILON { 1e-12 };
+constexpr int32_t BESSEL_MAX_TERMS { 64 };
+constexpr double HALF { 0.5 };
+
+// Zeroth order modified Bessel function of the first kind, by its power series.
+double BesselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * HALF;
+    for (int32_t k = 1; k < BESSEL_MAX_TERMS; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < (sum * BESSEL_EPSILON)) {
+            break;
+        }
+    }
+    return sum;
+}
+
+double Sinc(double x)
+{
+    if (std::fabs(x) < BESSEL_EPSILON) {
+        return 1.0;
+    }
+    double arg = M_PI * x;
+    return std::sin(arg) / arg;
+}
+}  // namespace
+
+int32_t Resampler::Init(uint32_t upFactor, uint32_t downFactor, uint32_t channels)
+{
+    if ((upFactor == 0) || (downFactor == 0) || (channels == 0)) {
+        SEN_HILOGE("Invalid parameter, upFactor:%{public}u, downFactor:%{public}u, channels:%{public}u",
+            upFactor, downFactor, channels);
+        return Sensors::PARAMETER_ERROR;
+    }
+    uint32_t divisor = std::gcd(upFactor, downFactor);
+    if (((upFactor / divisor) > MAX_FILTER_FACTOR) || ((downFactor / divisor) > MAX_FILTER_FACTOR)) {
+        SEN_HILOGE("Ratio too large, upFactor:%{public}u, downFactor:%{public}u", upFactor, downFactor);
+        return Sensors::PARAMETER_ERROR;
+    }
+    upFactor_ = upFactor / divisor;
+    downFactor_ = downFactor / divisor;
+    channels_ = channels;
+    filterBank_.clear();
+    tapsPerPhase_ = 0;
+    if (upFactor_ != downFactor_) {
+        DesignFilterBank();
+    }
+    channelBuffers_.assign(channels_, std::vector<double>());
+    Reset();
+    return Sensors::SUCCESS;
+}
+
+void Resampler::DesignFilterBank()
+{
+    double maxFactor = static_cast<double>(std::max(upFactor_, downFactor_));
+    // Cutoff in cycles per sample at the interpolated rate.
+    double cutoff = ROLLOFF * HALF / maxFactor;
+    size_t halfLength = static_cast<size_t>(std::ceil(ZERO_CROSSINGS * maxFactor / ROLLOFF));
+    tapsPerPhase_ = (2 * halfLength + upFactor_) / upFactor_;
+    size_t filterLength = tapsPerPhase_ * upFactor_;
+    double center = static_cast<double>(filterLength - 1) * HALF;
+    double windowNorm = BesselI0(KAISER_BETA);
+    filterBank_.assign(filterLength, 0.0);
+    for (size_t j = 0; j < filterLength; ++j) {
+        double offset = static_cast<double>(j) - center;
+        double ratio = (center > 0.0) ? (offset / center) : 0.0;
+        double window = BesselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / windowNorm;
+        // The interpolation gain upFactor_ restores the amplitude lost by zero stuffing.
+        double tap = upFactor_ * 2.0 * cutoff * Sinc(2.0 * cutoff * offset) * window;
+        size_t phase = j % upFactor_;
+        size_t k = j / upFactor_;
+        filterBank_[phase * tapsPerPhase_ + (tapsPerPhase_ - 1 - k)] = tap;
+    }
+}
+
+void Resampler::Reset()
+{
+    size_t history = (tapsPerPhase_ > 0) ? (tapsPerPhase_ - 1) : 0;
+    for (auto &buffer : channelBuffers_) {
+        buffer.assign(history, 0.0);
+    }
+    inputIndex_ = 0;
+    phase_ = 0;
+}
+
+double Resampler::GetDelay() const
+{
+    if (tapsPerPhase_ == 0) {
+        return 0.0;
+    }
+    double center = static_cast<double>(tapsPerPhase_ * upFactor_ - 1) * HALF;
+    return center / downFactor_;
+}
+
+int32_t Resampler::Process(const std::vector<double> &input, std::vector<double> &output)
+{
+    if (channelBuffers_.empty()) {
+        SEN_HILOGE("Resampler is not initialized");
+        return Sensors::ERROR;
+    }
+    if ((input.size() % channels_) != 0) {
+        SEN_HILOGE("Incomplete frame, input.size():%{public}zu, channels:%{public}u", input.size(), channels_);
+        return Sensors::PARAMETER_ERROR;
+    }
+    ProcessFrames(input.data(), input.size() / channels_, output);
+    return Sensors::SUCCESS;
+}
+
+void Resampler::ProcessFrames(const double *input, size_t frameCount, std::vector<double> &output)
+{
+    if (filterBank_.empty()) {
+        output.insert(output.end(), input, input + frameCount * channels_);
+        return;
+    }
+    size_t history = tapsPerPhase_ - 1;
+    for (uint32_t c = 0; c < channels_; ++c) {
+        std::vector<double> &buffer = channelBuffers_[c];
+        buffer.resize(history + frameCount);
+        for (size_t i = 0; i < frameCount; ++i) {
+            buffer[history + i] = input[i * channels_ + c];
+        }
+    }
+    size_t expected = (frameCount * upFactor_) / downFactor_ + 1;
+    output.reserve(output.size() + expected * channels_);
+    while (inputIndex_ < frameCount) {
+        // The window ends at input frame inputIndex_, which sits at buffer position history + inputIndex_.
+        const double *taps = filterBank_.data() + static_cast<size_t>(phase_) * tapsPerPhase_;
+        for (uint32_t c = 0; c < channels_; ++c) {
+            output.push_back(DotProduct(channelBuffers_[c].data() + inputIndex_, taps, tapsPerPhase_));
+        }
+        phase_ += downFactor_;
+        inputIndex_ += phase_ / upFactor_;
+        phase_ %= upFactor_;
+    }
+    inputIndex_ -= frameCount;
+    for (auto &buffer : channelBuffers_) {
+        std::copy(buffer.end() - history, buffer.end(), buffer.begin());
+        buffer.resize(history);
+    }
+}
+
+void Resampler::AverageBlocks(const std::vector<double> &input, uint32_t downFactor, uint32_t channels,
+    std::vector<double> &output)
+{
+    size_t frameCount = input.size() / channels;
+    size_t outFrames = (frameCount + downFactor - 1) / downFactor;
+    size_t half = downFactor / 2;
+    double scale = 1.0 / downFactor;
+    output.assign(outFrames * channels, 0.0);
+    for (size_t n = 0; n < outFrames; ++n) {
+        // Frames outside the signal count as zeros, the same as the tail flush of the filter path.
+        size_t center = n * downFactor;
+        size_t first = (center > half) ? (center - half) : 0;
+        size_t last = std::min(center + downFactor - half, frameCount);
+        for (uint32_t c = 0; c < channels; ++c) {
+            double sum = 0.0;
+            for (size_t i = first; i < last; ++i) {
+                sum += input[i * channels + c];
+            }
+            output[n * channels + c] = sum * scale;
+        }
+    }
+}
+
+int32_t Resampler::Resample(const std::vector<double> &input, uint32_t upFactor, uint32_t downFactor,
+    uint32_t channels, std::vector<double> &output)
+{
+    if ((upFactor != 0) && (channels != 0) && ((downFactor % upFactor) == 0) &&
+        ((downFactor / upFactor) > MAX_FILTER_FACTOR)) {
+        AverageBlocks(input, downFactor / upFactor, channels, output);
+        return Sensors::SUCCESS;
+    }
+    Resampler resampler;
+    int32_t ret = resampler.Init(upFactor, downFactor, channels);
+    if (ret != Sensors::SUCCESS) {
+        SEN_HILOGE("Init failed");
+        return ret;
+    }
+    size_t frameCount = input.size() / channels;
+    size_t upFrames = frameCount * resampler.upFactor_;
+    size_t outFrames = (upFrames + resampler.downFactor_ - 1) / resampler.downFactor_;
+    output.clear();
+    if (resampler.filterBank_.empty()) {
+        output.assign(input.begin(), input.begin() + frameCount * channels);
+        return Sensors::SUCCESS;
+    }
+    // Start at the filter center so that output frame n lines up with input time n * downFactor / upFactor.
+    size_t center = (resampler.tapsPerPhase_ * resampler.upFactor_ - 1) / 2;
+    resampler.inputIndex_ = center / resampler.upFactor_;
+    resampler.phase_ = static_cast<uint32_t>(center % resampler.upFactor_);
+    output.reserve(outFrames * channels);
+    resampler.ProcessFrames(input.data(), frameCount, output);
+    // Flush the last outputs with zeros past the end of the signal.
+    size_t tailFrames = resampler.inputIndex_ + center / resampler.upFactor_ + 1;
+    std::vector<double> tail(tailFrames * channels, 0.0);
+    resampler.ProcessFrames(tail.data(), tailFrames, output);
+    output.resize(outFrames * channels, 0.0);
+    return Sensors::SUCCESS;
+}
+}  // namespace Sensors
+}  // namespace OHOS
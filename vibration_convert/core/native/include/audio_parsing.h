@@ -39,12 +39,18 @@ public:
 
 private:
     int32_t RawFileDescriptorCheck();
+    int32_t ParseChunks(const uint8_t *fileBase, size_t fileSize, size_t &dataOffset);
+    int32_t ParseFormatChunk(const uint8_t *chunk, uint32_t chunkSize);
+    int32_t DecodeAudioData(const uint8_t *data, size_t sampleCount);
+    // Average the interleaved channels of the decoded samples in place, one value per frame remains.
+    void DownmixChannels(size_t channels);
     void PrintAttributeChunk();
 
 private:
     RawFileDescriptor rawFd_;
     AudioData audioData_;
     AttributeChunk attributeChunk_;
+    uint16_t sampleFormat_ { 0 };
 };
 }  // namespace Sensors
 }  // namespace OHOS
@@ -156,7 +156,8 @@ private:
     void OutputTransientEventsByInsertTime(const std::vector<double> &onsetTimes,
         const std::vector<IntensityData> &intensityDatas, const std::vector<int32_t> &freqNorms,
         std::vector<int32_t> &transientIndexs, std::vector<double> &transientEventTimes);
-    void GetIndex(const UnionTransientEvent &unionTransientEvent, const std::vector<IntensityData> &intensityDatas);
+    void GetIndex(const UnionTransientEvent &unionTransientEvent, const std::vector<IntensityData> &intensityDatas,
+        size_t &minIndex, size_t &maxIndex);
     void OutputTransientEventsAlign(const std::vector<UnionTransientEvent> &unionTransientEvents,
         const std::vector<IntensityData> &intensityDatas, const std::vector<int32_t> &freqNorms,
         std::vector<int32_t> &transientIndexs, std::vector<double> &transientEventTimes);
@@ -16,15 +16,19 @@
 #include "audio_parsing.h"
 
 #include <algorithm>
+#include <array>
 #include <cerrno>
 #include <cinttypes>
+#include <cstring>
 #include <fstream>
 
+#include <sys/mman.h>
 #include <sys/stat.h>
 
 #include <securec.h>
 
 #include "generate_vibration_json_file.h"
+#include "resampler.h"
 #include "sensor_log.h"
 #include "sensors_errors.h"
 #include "vibration_convert_core.h"
@@ -37,11 +41,120 @@ namespace OHOS {
 namespace Sensors {
 namespace {
 constexpr int32_t MIN_SAMPLE_COUNT = 4096;
-constexpr uint32_t AUDIO_DATA_CONVERSION_FACTOR = INT32_MAX;
 constexpr int32_t AUDIO_DATA_MAX_NUMBER = 100000;
-constexpr int64_t LSEEK_FAIL = -1;
 constexpr int32_t TIME_MS = 1000;
 constexpr int32_t BITS_PER_BYTE = 8;
+constexpr size_t CHUNK_ID_SIZE = 4;
+constexpr size_t CHUNK_HEADER_SIZE = 8;
+constexpr size_t RIFF_HEADER_SIZE = 12;
+constexpr uint32_t FMT_CHUNK_MIN_SIZE = 16;
+constexpr uint32_t FMT_EXTENSIBLE_MIN_SIZE = 40;
+constexpr size_t FMT_CHANNELS_OFFSET = 2;
+constexpr size_t FMT_SAMPLE_RATE_OFFSET = 4;
+constexpr size_t FMT_BYTE_RATE_OFFSET = 8;
+constexpr size_t FMT_BLOCK_ALIGN_OFFSET = 12;
+constexpr size_t FMT_BITS_PER_SAMPLE_OFFSET = 14;
+constexpr size_t FMT_SUB_FORMAT_OFFSET = 24;
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+constexpr uint16_t BITS_PCM8 = 8;
+constexpr uint16_t BITS_PCM16 = 16;
+constexpr uint16_t BITS_PCM24 = 24;
+constexpr uint16_t BITS_PCM32 = 32;
+constexpr uint16_t BITS_FLOAT64 = 64;
+constexpr int32_t PCM8_ZERO_POINT = 128;
+constexpr uint32_t PCM24_SIGN_SHIFT = 8;
+constexpr uint32_t BYTE_SHIFT = 8;
+constexpr uint32_t TWO_BYTES_SHIFT = 16;
+constexpr size_t PCM24_BYTES = 3;
+constexpr double PCM8_SCALE = 1.0 / 128.0;
+constexpr double PCM16_SCALE = 1.0 / 32768.0;
+constexpr double PCM24_SCALE = 1.0 / 8388608.0;
+constexpr double PCM32_SCALE = 1.0 / INT32_MAX;
+constexpr double FLOAT_SCALE = 1.0;
+// Samples copied out of the mapping per bounds checked copy.
+constexpr size_t DECODE_BLOCK_SAMPLES = 1024;
+const char RIFF_ID[] = "RIFF";
+const char WAVE_ID[] = "WAVE";
+const char FMT_ID[] = "fmt ";
+const char DATA_ID[] = "data";
+
+template<typename T>
+T ReadLittleEndian(const uint8_t *src)
+{
+    T value;
+    (void)memcpy_s(&value, sizeof(T), src, sizeof(T));
+    return value;
+}
+
+// The mapped data has no alignment guarantee: each block is copied into an aligned buffer with one bounds check,
+// then converted by a plain loop the compiler can vectorize.
+template<typename T>
+void DecodeBlocks(const uint8_t *data, size_t sampleCount, double scale, double *dst)
+{
+    std::array<T, DECODE_BLOCK_SAMPLES> block;
+    for (size_t start = 0; start < sampleCount; start += DECODE_BLOCK_SAMPLES) {
+        size_t count = std::min(DECODE_BLOCK_SAMPLES, sampleCount - start);
+        (void)memcpy_s(block.data(), sizeof(block), data + start * sizeof(T), count * sizeof(T));
+        double *out = dst + start;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = static_cast<double>(block[i]) * scale;
+        }
+    }
+}
+
+/**
+ * Read-only private mapping of the [offset, offset + length) range of a file descriptor.
+ * The mapping start is aligned down to the page size, Data() points at the requested offset.
+ */
+class MappedFileRange {
+public:
+    MappedFileRange(int32_t fd, int64_t offset, int64_t length)
+    {
+        int64_t pageSize = static_cast<int64_t>(sysconf(_SC_PAGESIZE));
+        if (pageSize <= 0) {
+            SEN_HILOGE("sysconf page size failed, errno:%{public}d", errno);
+            return;
+        }
+        int64_t alignedOffset = offset - (offset % pageSize);
+        delta_ = static_cast<size_t>(offset - alignedOffset);
+        mapLength_ = static_cast<size_t>(length) + delta_;
+        addr_ = mmap(nullptr, mapLength_, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(alignedOffset));
+        if (addr_ == MAP_FAILED) {
+            SEN_HILOGE("mmap failed, errno:%{public}d", errno);
+            return;
+        }
+        (void)madvise(addr_, mapLength_, MADV_SEQUENTIAL);
+        size_ = static_cast<size_t>(length);
+    }
+
+    ~MappedFileRange()
+    {
+        if (addr_ != MAP_FAILED) {
+            (void)munmap(addr_, mapLength_);
+        }
+    }
+
+    const uint8_t *Data() const
+    {
+        if (addr_ == MAP_FAILED) {
+            return nullptr;
+        }
+        return static_cast<const uint8_t *>(addr_) + delta_;
+    }
+
+    size_t Size() const
+    {
+        return size_;
+    }
+
+private:
+    void *addr_ { MAP_FAILED };
+    size_t mapLength_ { 0 };
+    size_t delta_ { 0 };
+    size_t size_ { 0 };
+};
 }  // namespace
 
 AudioParsing::AudioParsing(const RawFileDescriptor &rawFd)
@@ -79,53 +192,182 @@ int32_t AudioParsing::ParseAudioFile()
         SEN_HILOGE("RawFileDescriptorCheck failed");
         return Sensors::ERROR;
     }
-    int64_t oft = lseek(rawFd_.fd, rawFd_.offset, SEEK_SET);
-    if (oft == LSEEK_FAIL) {
-        SEN_HILOGE("lseek fail, oft:%{public}" PRId64, oft);
-        return Sensors::ERROR;
-    }
-    (void)memset_s(&attributeChunk_, sizeof(AttributeChunk), 0, sizeof(AttributeChunk));
-    if (rawFd_.length < sizeof(AttributeChunk)) {
+    if (static_cast<uint64_t>(rawFd_.length) < RIFF_HEADER_SIZE + CHUNK_HEADER_SIZE) {
         SEN_HILOGE("Invalid parameter");
         return Sensors::PARAMETER_ERROR;
     }
+    MappedFileRange mappedFile(rawFd_.fd, rawFd_.offset, rawFd_.length);
+    const uint8_t *fileBase = mappedFile.Data();
+    CHKPR(fileBase, Sensors::ERROR);
+    (void)memset_s(&attributeChunk_, sizeof(AttributeChunk), 0, sizeof(AttributeChunk));
+    sampleFormat_ = 0;
+    size_t dataOffset = 0;
+    if (ParseChunks(fileBase, mappedFile.Size(), dataOffset) != Sensors::SUCCESS) {
+        SEN_HILOGE("ParseChunks failed");
+        return Sensors::ERROR;
+    }
+    PrintAttributeChunk();
+    size_t bytesPerSample = attributeChunk_.bitsPerSample / BITS_PER_BYTE;
+    size_t channels = attributeChunk_.fmtChannels;
+    // A trailing partial frame is dropped, as in the dataCount of GetAudioAttribute.
+    size_t frameCount = attributeChunk_.dataSize / (bytesPerSample * channels);
+    if (frameCount == 0) {
+        SEN_HILOGE("No audio data");
+        return Sensors::ERROR;
+    }
+    return DecodeAudioData(fileBase + dataOffset, frameCount * channels);
+}
 
-    ssize_t ret = read(rawFd_.fd, &attributeChunk_, sizeof(AttributeChunk));
-    if (ret <= 0) {
-        SEN_HILOGE("read audio attribute failed, errno:%{public}d", errno);
+int32_t AudioParsing::ParseChunks(const uint8_t *fileBase, size_t fileSize, size_t &dataOffset)
+{
+    CHKPR(fileBase, Sensors::ERROR);
+    if ((memcmp(fileBase, RIFF_ID, CHUNK_ID_SIZE) != 0) ||
+        (memcmp(fileBase + CHUNK_HEADER_SIZE, WAVE_ID, CHUNK_ID_SIZE) != 0)) {
+        SEN_HILOGE("Not a RIFF/WAVE file");
         return Sensors::ERROR;
     }
+    (void)memcpy_s(attributeChunk_.chunkID, CHUNK_ID_SIZE, fileBase, CHUNK_ID_SIZE);
+    attributeChunk_.chunkSize = ReadLittleEndian<uint32_t>(fileBase + CHUNK_ID_SIZE);
+    (void)memcpy_s(attributeChunk_.format, CHUNK_ID_SIZE, fileBase + CHUNK_HEADER_SIZE, CHUNK_ID_SIZE);
+    bool fmtFound = false;
+    bool dataFound = false;
+    uint64_t pos = RIFF_HEADER_SIZE;
+    // Chunks may appear in any order (LIST, fact, cue, ...), each body is padded to an even size.
+    while (((pos + CHUNK_HEADER_SIZE) <= fileSize) && !(fmtFound && dataFound)) {
+        const uint8_t *chunk = fileBase + pos;
+        uint32_t chunkSize = ReadLittleEndian<uint32_t>(chunk + CHUNK_ID_SIZE);
+        uint64_t body = pos + CHUNK_HEADER_SIZE;
+        uint64_t available = fileSize - body;
+        if (memcmp(chunk, FMT_ID, CHUNK_ID_SIZE) == 0) {
+            if ((chunkSize > available) || (ParseFormatChunk(fileBase + body, chunkSize) != Sensors::SUCCESS)) {
+                SEN_HILOGE("Invalid fmt chunk, chunkSize:%{public}u", chunkSize);
+                return Sensors::ERROR;
+            }
+            fmtFound = true;
+        } else if (memcmp(chunk, DATA_ID, CHUNK_ID_SIZE) == 0) {
+            if (chunkSize > available) {
+                SEN_HILOGW("data chunk truncated, chunkSize:%{public}u, available:%{public}" PRIu64,
+                    chunkSize, available);
+                chunkSize = static_cast<uint32_t>(available);
+            }
+            (void)memcpy_s(attributeChunk_.dataID, CHUNK_ID_SIZE, chunk, CHUNK_ID_SIZE);
+            attributeChunk_.dataSize = chunkSize;
+            dataOffset = static_cast<size_t>(body);
+            dataFound = true;
+        }
+        pos = body + chunkSize + (chunkSize & 1);
+    }
+    if (!fmtFound || !dataFound) {
+        SEN_HILOGE("Missing chunk, fmtFound:%{public}d, dataFound:%{public}d", fmtFound, dataFound);
+        return Sensors::ERROR;
+    }
+    return Sensors::SUCCESS;
+}
+
+int32_t AudioParsing::ParseFormatChunk(const uint8_t *chunk, uint32_t chunkSize)
+{
+    CHKPR(chunk, Sensors::ERROR);
+    if (chunkSize < FMT_CHUNK_MIN_SIZE) {
+        SEN_HILOGE("fmt chunk too small, chunkSize:%{public}u", chunkSize);
+        return Sensors::ERROR;
+    }
+    (void)memcpy_s(attributeChunk_.fmtID, CHUNK_ID_SIZE, FMT_ID, CHUNK_ID_SIZE);
+    attributeChunk_.fmtSize = chunkSize;
+    attributeChunk_.fmtTag = ReadLittleEndian<uint16_t>(chunk);
+    attributeChunk_.fmtChannels = ReadLittleEndian<uint16_t>(chunk + FMT_CHANNELS_OFFSET);
+    attributeChunk_.sampleRate = ReadLittleEndian<uint32_t>(chunk + FMT_SAMPLE_RATE_OFFSET);
+    attributeChunk_.byteRate = ReadLittleEndian<uint32_t>(chunk + FMT_BYTE_RATE_OFFSET);
+    attributeChunk_.blockAilgn = ReadLittleEndian<uint16_t>(chunk + FMT_BLOCK_ALIGN_OFFSET);
+    attributeChunk_.bitsPerSample = ReadLittleEndian<uint16_t>(chunk + FMT_BITS_PER_SAMPLE_OFFSET);
+    sampleFormat_ = attributeChunk_.fmtTag;
+    if ((sampleFormat_ == WAVE_FORMAT_EXTENSIBLE) && (chunkSize >= FMT_EXTENSIBLE_MIN_SIZE)) {
+        // The first two bytes of the SubFormat GUID carry the actual format tag.
+        sampleFormat_ = ReadLittleEndian<uint16_t>(chunk + FMT_SUB_FORMAT_OFFSET);
+    }
     if ((attributeChunk_.bitsPerSample == 0) || (attributeChunk_.fmtChannels == 0)) {
         SEN_HILOGE("The divisor cannot be 0");
         return Sensors::ERROR;
     }
-    size_t dataCount = attributeChunk_.dataSize /
-        ((attributeChunk_.bitsPerSample / BITS_PER_BYTE) * attributeChunk_.fmtChannels);
-    PrintAttributeChunk();
-    int32_t *dataBuffer = static_cast<int32_t *>(malloc(attributeChunk_.dataSize));
-    CHKPR(dataBuffer, Sensors::ERROR);
-    (void)memset_s(dataBuffer, attributeChunk_.dataSize, 0, attributeChunk_.dataSize);
+    uint16_t bits = attributeChunk_.bitsPerSample;
+    bool isValidPcm = (sampleFormat_ == WAVE_FORMAT_PCM) &&
+        ((bits == BITS_PCM8) || (bits == BITS_PCM16) || (bits == BITS_PCM24) || (bits == BITS_PCM32));
+    bool isValidFloat = (sampleFormat_ == WAVE_FORMAT_IEEE_FLOAT) && ((bits == BITS_PCM32) || (bits == BITS_FLOAT64));
+    if (!isValidPcm && !isValidFloat) {
+        SEN_HILOGE("Unsupported format, sampleFormat:%{public}hu, bitsPerSample:%{public}hu", sampleFormat_, bits);
+        return Sensors::ERROR;
+    }
+    return Sensors::SUCCESS;
+}
 
-    if (rawFd_.length < attributeChunk_.dataSize) {
-        free(dataBuffer);
-        SEN_HILOGE("Invalid parameter");
-        return Sensors::PARAMETER_ERROR;
+int32_t AudioParsing::DecodeAudioData(const uint8_t *data, size_t sampleCount)
+{
+    CHKPR(data, Sensors::ERROR);
+    audioData_.audioDatas.assign(sampleCount, 0.0);
+    double *dst = audioData_.audioDatas.data();
+    switch (attributeChunk_.bitsPerSample) {
+        case BITS_PCM8: {
+            for (size_t i = 0; i < sampleCount; ++i) {
+                dst[i] = static_cast<double>(static_cast<int32_t>(data[i]) - PCM8_ZERO_POINT) * PCM8_SCALE;
+            }
+            break;
+        }
+        case BITS_PCM16: {
+            DecodeBlocks<int16_t>(data, sampleCount, PCM16_SCALE, dst);
+            break;
+        }
+        case BITS_PCM24: {
+            for (size_t i = 0; i < sampleCount; ++i) {
+                const uint8_t *src = data + i * PCM24_BYTES;
+                uint32_t raw = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << BYTE_SHIFT) |
+                    (static_cast<uint32_t>(src[2]) << TWO_BYTES_SHIFT);
+                int32_t value = static_cast<int32_t>(raw << PCM24_SIGN_SHIFT) >> PCM24_SIGN_SHIFT;
+                dst[i] = static_cast<double>(value) * PCM24_SCALE;
+            }
+            break;
+        }
+        case BITS_PCM32: {
+            if (sampleFormat_ == WAVE_FORMAT_IEEE_FLOAT) {
+                DecodeBlocks<float>(data, sampleCount, FLOAT_SCALE, dst);
+            } else {
+                DecodeBlocks<int32_t>(data, sampleCount, PCM32_SCALE, dst);
+            }
+            break;
+        }
+        case BITS_FLOAT64: {
+            (void)memcpy_s(dst, sampleCount * sizeof(double), data, sampleCount * sizeof(double));
+            break;
+        }
+        default: {
+            SEN_HILOGE("Unsupported bitsPerSample:%{public}hu", attributeChunk_.bitsPerSample);
+            audioData_.audioDatas.clear();
+            return Sensors::ERROR;
+        }
     }
+    DownmixChannels(attributeChunk_.fmtChannels);
+    auto minMax = std::minmax_element(audioData_.audioDatas.begin(), audioData_.audioDatas.end());
+    audioData_.min = *minMax.first;
+    audioData_.max = *minMax.second;
+    return Sensors::SUCCESS;
+}
 
-    ret = read(rawFd_.fd, dataBuffer, attributeChunk_.dataSize);
-    if (ret <= 0) {
-        free(dataBuffer);
-        SEN_HILOGE("read audio data failed");
-        return Sensors::ERROR;
+void AudioParsing::DownmixChannels(size_t channels)
+{
+    if (channels <= 1) {
+        return;
     }
-    for (size_t i = 0; i < dataCount; ++i) {
-        double data = static_cast<double>(dataBuffer[i]) / AUDIO_DATA_CONVERSION_FACTOR;
-        audioData_.audioDatas.push_back(data);
+    std::vector<double> &samples = audioData_.audioDatas;
+    size_t frameCount = samples.size() / channels;
+    double scale = 1.0 / static_cast<double>(channels);
+    // Frame i is read from index i * channels onwards, so writing index i in place never overtakes the reads.
+    for (size_t i = 0; i < frameCount; ++i) {
+        const double *frame = samples.data() + i * channels;
+        double sum = 0.0;
+        for (size_t channel = 0; channel < channels; ++channel) {
+            sum += frame[channel];
+        }
+        samples[i] = sum * scale;
     }
-    audioData_.max = *std::max_element(audioData_.audioDatas.begin(), audioData_.audioDatas.end());
-    audioData_.min = *std::min_element(audioData_.audioDatas.begin(), audioData_.audioDatas.end());
-    free(dataBuffer);
-    return Sensors::SUCCESS;
+    samples.resize(frameCount);
 }
 
 int32_t AudioParsing::GetAudioAttribute(AudioAttribute &audioAttribute) const
@@ -164,10 +406,12 @@ int32_t AudioParsing::GetAudioData(int32_t samplingInterval, AudioData &data) co
             samplingInterval = dataCount / AUDIO_DATA_MAX_NUMBER + 1;
         }
     }
-    for (size_t i = 0; i < dataCount; ++i) {
-        if (i % samplingInterval == 0) {
-            data.audioDatas.push_back(audioData_.audioDatas[i]);
-        }
+    // Low pass filtered before decimation, so the preview does not alias.
+    int32_t ret = Resampler::Resample(audioData_.audioDatas, 1, static_cast<uint32_t>(samplingInterval), 1,
+        data.audioDatas);
+    if (ret != Sensors::SUCCESS) {
+        SEN_HILOGE("Resample failed");
+        return ret;
     }
     data.max = audioData_.max;
     data.min = audioData_.min;
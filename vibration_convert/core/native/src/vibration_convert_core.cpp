@@ -17,6 +17,7 @@
 #include <numeric>
 
 #include "generate_vibration_json_file.h"
+#include "resampler.h"
 #include "sensor_log.h"
 #include "sensors_errors.h"
 #include "vibration_convert_core.h"
@@ -57,7 +58,9 @@ constexpr double RMSE_LOWDELTA_RATIO_LOW { 0.03 };
 constexpr double RMSE_LOWDELTA_RATIO_STEP { 0.01 };
 constexpr int32_t RMSE_LOWDELTA_ITERATION_TIMES { 8 };
 constexpr double SLOP_DELTA_MIN { 0.1745329251 }; // PI / 18
-constexpr int32_t RESAMPLE_MULTIPLE { 4 };
+// The source is treated as interleaved stereo and brought down to half of its frame rate.
+constexpr uint32_t RESAMPLE_CHANNELS { 2 };
+constexpr uint32_t RESAMPLE_DOWN_FACTOR { 2 };
 constexpr size_t LOCAL_ENVELOPE_MAX_LEN { 16 };
 constexpr size_t MIN_SKIP { 3 };
 constexpr double AMPLITUDE_DB_MAX { 1.0 };
@@ -82,7 +85,7 @@ int32_t VibrationConvertCore::GetAudioData()
     }
     std::vector<IntensityData> intensityDatas;
     // Processing intensity data, output parameters:intensityDatas
-    ret = DetectRmsIntensity(data, rmsILowerDelta, intensityDatas);
+    int32_t ret = DetectRmsIntensity(data, rmsILowerDelta, intensityDatas);
     if (ret != Sensors::SUCCESS) {
         SEN_HILOGE("DetectRmsIntensity failed");
         return ret;
@@ -141,11 +144,10 @@ int32_t VibrationConvertCore::ResampleAudioData(const std::vector<double> &srcDa
         SEN_HILOGE("srcDatas is empty");
         return Sensors::ERROR;
     }
-    size_t originDataSize = srcDatas.size();
-    srcAudioDatas_.clear();
-    for (size_t i = 0; i < (originDataSize - 1); i += RESAMPLE_MULTIPLE) {
-        srcAudioDatas_.push_back(srcDatas[i]);
-        srcAudioDatas_.push_back(srcDatas[i+1]);
+    int32_t ret = Resampler::Resample(srcDatas, 1, RESAMPLE_DOWN_FACTOR, RESAMPLE_CHANNELS, srcAudioDatas_);
+    if (ret != Sensors::SUCCESS) {
+        SEN_HILOGE("Resample failed");
+        return ret;
     }
     return Sensors::SUCCESS;
 }
@@ -923,13 +925,13 @@ void VibrationConvertCore::AddTransientEventData(TransientEvent transientEvent)
     transientEvents_.push_back(transientEvent);
 }
 
-void VibrationConvertCore::GetIdex(const UnionTransientEvent &unionTransientEvent,
-    const std::vector<IntensityData> &intensityDatas)
+void VibrationConvertCore::GetIndex(const UnionTransientEvent &unionTransientEvent,
+    const std::vector<IntensityData> &intensityDatas, size_t &minIndex, size_t &maxIndex)
 {
     // get max index.
     size_t beginIndex = unionTransientEvent.onsetIdx;
     size_t endIndex = beginIndex + onsetMinSkip_;
-    size_t maxIndex = beginIndex;
+    maxIndex = beginIndex;
     double maxRmseEnvelope = intensityDatas[beginIndex].rmseEnvelope;
     for (size_t k = (beginIndex + 1); k < endIndex; k++) {
         if (intensityDatas[k].rmseEnvelope > maxRmseEnvelope) {
@@ -944,7 +946,7 @@ void VibrationConvertCore::GetIdex(const UnionTransientEvent &unionTransientEven
     // get min index.
     beginIndex = fromIndex;
     endIndex = unionTransientEvent.onsetIdx + 1;
-    size_t minIndex = beginIndex;
+    minIndex = beginIndex;
     double minRmseEnvelope = intensityDatas[beginIndex].rmseEnvelope;
     for (size_t k = (beginIndex + 1); k < endIndex; k++) {
         if (intensityDatas[k].rmseEnvelope < minRmseEnvelope) {
@@ -975,7 +977,9 @@ void VibrationConvertCore::OutputTransientEventsAlign(const std::vector<UnionTra
                 continue;
             }
         }
-        GetIdex(unionTransientEvents[i], intensityDatas);
+        size_t minIndex = 0;
+        size_t maxIndex = 0;
+        GetIndex(unionTransientEvents[i], intensityDatas, minIndex, maxIndex);
         auto it = find(transientIndexs.begin(), transientIndexs.end(), minIndex);
         if (it == transientIndexs.end()) {
             transientEventTimes.push_back(intensityDatas[minIndex].rmseTimeNorm);
@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark_utils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+#include "utils.h"
+
+namespace OHOS {
+namespace Sensors {
+namespace {
+constexpr uint32_t RANDOM_SEED = 2023;
+constexpr size_t BURST_LEN = 5000;
+constexpr size_t BURST_PERIOD = 3;
+constexpr double QUIET_LEVEL = 0.01;
+std::atomic<uint64_t> g_allocationCount { 0 };
+
+void *CountedAlloc(size_t size)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return malloc((size == 0) ? 1 : size);
+}
+
+void *CountedAlignedAlloc(size_t size, std::align_val_t alignment)
+{
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    size_t align = std::max(static_cast<size_t>(alignment), sizeof(void *));
+    void *ptr = nullptr;
+    if (posix_memalign(&ptr, align, (size == 0) ? 1 : size) != 0) {
+        return nullptr;
+    }
+    return ptr;
+}
+}  // namespace
+
+std::vector<double> GenerateSignal(int64_t seconds)
+{
+    std::mt19937 generator(RANDOM_SEED);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<double> signal(static_cast<size_t>(seconds * SAMPLE_RATE));
+    for (size_t i = 0; i < signal.size(); ++i) {
+        double level = (((i / BURST_LEN) % BURST_PERIOD) == 0) ? 1.0 : QUIET_LEVEL;
+        signal[i] = level * distribution(generator);
+    }
+    return signal;
+}
+
+uint64_t GetAllocationCount()
+{
+    return g_allocationCount.load(std::memory_order_relaxed);
+}
+
+void SetPerCallCounters(benchmark::State &state, size_t samples, uint64_t allocations)
+{
+    double calls = static_cast<double>(state.iterations());
+    state.counters["ns/sample"] = benchmark::Counter(calls * static_cast<double>(samples),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    state.counters["allocs/call"] = (calls == 0) ? 0.0 : static_cast<double>(allocations) / calls;
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(samples));
+}
+}  // namespace Sensors
+}  // namespace OHOS
+
+// Replace the global allocation functions so every container growth on the measured paths is counted.
+void *operator new(size_t size)
+{
+    void *ptr = OHOS::Sensors::CountedAlloc(size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return OHOS::Sensors::CountedAlloc(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return OHOS::Sensors::CountedAlloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+// Over-aligned types (alignas above __STDCPP_DEFAULT_NEW_ALIGNMENT__) go through the align_val_t overloads.
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    void *ptr = OHOS::Sensors::CountedAlignedAlloc(size, alignment);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return OHOS::Sensors::CountedAlignedAlloc(size, alignment);
+}
+
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept
+{
+    return OHOS::Sensors::CountedAlignedAlloc(size, alignment);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t, std::align_val_t) noexcept
+{
+    free(ptr);
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BENCHMARK_UTILS_H
+#define BENCHMARK_UTILS_H
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace OHOS {
+namespace Sensors {
+constexpr int64_t ONE_SECOND = 1;
+constexpr int64_t TEN_SECONDS = 10;
+constexpr int64_t ONE_MINUTE = 60;
+constexpr int64_t TEN_MINUTES = 600;
+
+/**
+ * @brief Generate a reproducible test signal at SAMPLE_RATE: bursts of white noise separated by quiet stretches, so
+ * the onset, peak and envelope stages all have work to do.
+ *
+ * @param seconds Signal duration in seconds.
+ *
+ * @return Returns the samples in [-1, 1].
+ */
+std::vector<double> GenerateSignal(int64_t seconds);
+
+/**
+ * @brief Get the number of operator new calls since the process started, counted by benchmark_utils.cpp. The
+ * plain, nothrow and aligned forms are all counted.
+ */
+uint64_t GetAllocationCount();
+
+/**
+ * @brief Report the per call cost of a benchmark in the shared units: ns/sample and allocs/call.
+ *
+ * @param state Benchmark state after the timing loop.
+ * @param samples Number of input samples processed by one call.
+ * @param allocations Number of allocations made by all the calls of the timing loop.
+ */
+void SetPerCallCounters(benchmark::State &state, size_t samples, uint64_t allocations);
+}  // namespace Sensors
+}  // namespace OHOS
+#endif // BENCHMARK_UTILS_H
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "benchmark_utils.h"
+#include "onset.h"
+#include "sensors_errors.h"
+#include "utils.h"
+
+namespace OHOS {
+namespace Sensors {
+// Frame counts at ONSET_HOP_LEN: 1 s ~ 43, 10 s ~ 430, 60 s ~ 2584, 600 s ~ 25840 frames of 128 mels x 1024 bins.
+static void BM_CheckOnset(benchmark::State &state)
+{
+    std::vector<double> signal = GenerateSignal(state.range(0));
+    uint64_t startAllocations = GetAllocationCount();
+    for (auto _ : state) {
+        Onset onset;
+        OnsetInfo onsetInfo;
+        if (onset.CheckOnset(signal, NFFT, ONSET_HOP_LEN, onsetInfo) != Sensors::SUCCESS) {
+            state.SkipWithError("CheckOnset failed");
+            break;
+        }
+        benchmark::DoNotOptimize(onsetInfo.envelopes.data());
+    }
+    SetPerCallCounters(state, signal.size(), GetAllocationCount() - startAllocations);
+    state.counters["frames"] = static_cast<double>(signal.size() / ONSET_HOP_LEN);
+}
+BENCHMARK(BM_CheckOnset)->Arg(ONE_SECOND)->Arg(TEN_SECONDS)->Arg(ONE_MINUTE)->Arg(TEN_MINUTES)
+    ->Unit(benchmark::kMillisecond);
+}  // namespace Sensors
+}  // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "benchmark_utils.h"
+#include "conversion_mfcc.h"
+#include "fft.h"
+#include "intensity_processor.h"
+#include "peak_finder.h"
+#include "sensors_errors.h"
+#include "utils.h"
+#include "vibration_convert_core.h"
+#include "vibration_convert_type.h"
+
+namespace OHOS {
+namespace Sensors {
+namespace {
+constexpr int32_t MAGNITUDE_SIZE = NFFT / 2;
+constexpr int32_t MEL_FILTERS = 128;
+constexpr uint32_t MFCC_COEFFS = 13;
+constexpr double PEAK_THRESHOLD_RATIO = 0.4;
+constexpr int32_t TRANSIENT_DETECTION = 30;
+constexpr int32_t INTENSITY_TRESHOLD = 30;
+constexpr int32_t FREQUENCY_TRESHOLD = 50;
+constexpr int32_t FREQUENCY_MAX_VALUE = 80;
+constexpr int32_t FREQUENCY_MIN_VALUE = 20;
+
+size_t GetFrameCount(size_t signalSize)
+{
+    return (signalSize < NFFT) ? 0 : ((signalSize - NFFT) / ONSET_HOP_LEN + 1);
+}
+
+void CopyFrame(const std::vector<double> &signal, size_t frame, std::vector<float> &frameData)
+{
+    auto begin = signal.begin() + frame * ONSET_HOP_LEN;
+    std::transform(begin, begin + NFFT, frameData.begin(), [](double sample) { return static_cast<float>(sample); });
+}
+}  // namespace
+
+// The FFT stages run over frames of NFFT samples at ONSET_HOP_LEN, the same framing as the onset STFT.
+// CalcFFT is the public entry of AlgRealFFT and AlgFFT.
+static void BM_CalcFFT(benchmark::State &state)
+{
+    std::vector<double> signal = GenerateSignal(state.range(0));
+    size_t frameCount = GetFrameCount(signal.size());
+    Fft fft;
+    fft.Init(NFFT);
+    std::vector<float> window(NFFT);
+    fft.GenWindow(WND_TYPE_HANNING, NFFT, window);
+    std::vector<float> frameData(NFFT);
+    uint64_t startAllocations = GetAllocationCount();
+    for (auto _ : state) {
+        for (size_t frame = 0; frame < frameCount; ++frame) {
+            CopyFrame(signal, frame, frameData);
+            fft.CalcFFT(frameData, window);
+        }
+        benchmark::ClobberMemory();
+    }
+    SetPerCallCounters(state, signal.size(), GetAllocationCount() - startAllocations);
+    state.counters["frames"] = static_cast<double>(frameCount);
+}
+BENCHMARK(BM_CalcFFT)->Arg(ONE_SECOND)->Arg(TEN_SECONDS)->Arg(ONE_MINUTE)->Arg(TEN_MINUTES)
+    ->Unit(benchmark::kMillisecond);
+
+// CalculatePowerSpectrum is the public entry of the power spectrum path, the FFT followed by the polar conversion.
+static void BM_CalculatePowerSpectrum(benchmark::State &state)
+{
+    std::vector<double> signal = GenerateSignal(state.range(0));
+    size_t frameCount = GetFrameCount(signal.size());
+    Fft fft;
+    fft.Init(NFFT);
+    std::vector<float> window(NFFT);
+    fft.GenWindow(WND_TYPE_HANNING, NFFT, window);
+    std::vector<float> frameData(NFFT);
+    std::vector<float> magnitude(MAGNITUDE_SIZE);
+    std::vector<float> phase(MAGNITUDE_SIZE);
+    uint64_t startAllocations = GetAllocationCount();
+    for (auto _ : state) {
+        for (size_t frame = 0; frame < frameCount; ++frame) {
+            CopyFrame(signal, frame, frameData);
+            fft.CalculatePowerSpectrum(frameData, window, magnitude, phase);
+        }
+        benchmark::DoNotOptimize(magnitude.data());
+    }
+    SetPerCallCounters(state, signal.size(), GetAllocationCount() - startAllocations);
+    state.counters["frames"] = static_cast<double>(frameCount);
+}
+BENCHMARK(BM_CalculatePowerSpectrum)->Arg(ONE_SECOND)->Arg(TEN_SECONDS)->Arg(ONE_MINUTE)->Arg(TEN_MINUTES)
+    ->Unit(benchmark::kMillisecond);
+
+// One Mfcc call per frame, the power spectra are computed before the timing loop.
+static void BM_Mfcc(benchmark::State &state)
+{
+    std::vector<double> signal = GenerateSignal(state.range(0));
+    size_t frameCount = GetFrameCount(signal.size());
+    Fft fft;
+    fft.Init(NFFT);
+    std::vector<float> window(NFFT);
+    fft.GenWindow(WND_TYPE_HANNING, NFFT, window);
+    std::vector<float> frameData(NFFT);
+    std::vector<float> phase(MAGNITUDE_SIZE);
+    std::vector<std::vector<float>> powerSpectra(frameCount, std::vector<float>(MAGNITUDE_SIZE));
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+        CopyFrame(signal, frame, frameData);
+        fft.CalculatePowerSpectrum(frameData, window, powerSpectra[frame], phase);
+        for (auto &value : powerSpectra[frame]) {
+            value *= value;
+        }
+    }
+    MfccInputPara para;
+    para.sampleRate = SAMPLE_RATE;
+    para.nMels = MEL_FILTERS;
+    para.minFreq = 0.0;
+    para.maxFreq = SAMPLE_RATE / 2.0;
+    ConversionMfcc mfcc;
+    if (mfcc.Init(MAGNITUDE_SIZE, MFCC_COEFFS, para) != Sensors::SUCCESS) {
+        state.SkipWithError("Mfcc init failed");
+        return;
+    }
+    uint64_t startAllocations = GetAllocationCount();
+    for (auto _ : state) {
+        for (const auto &powerSpectrum : powerSpectra) {
+            std::vector<double> coeffs = mfcc.Mfcc(powerSpectrum);
+            benchmark::DoNotOptimize(coeffs.data());
+        }
+    }
+    SetPerCallCounters(state, signal.size(), GetAllocationCount() - startAllocations);
+    state.counters["frames"] = static_cast<double>(frameCount);
+}
+BENCHMARK(BM_Mfcc)->Arg(ONE_SECOND)->Arg(TEN_SECONDS)->Arg(ONE_MINUTE)->Arg(TEN_MINUTES)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_GetRMS(benchmark::State &state)
+{
+    std::vector<double> signal = GenerateSignal(state.range(0));
+    IntensityProcessor intensityProcessor;
+    uint64_t startAllocations = GetAllocationCount();
+    for (auto _ : state) {
+        std::vector<double> rmses = intensityProcessor.GetRMS(signal, ENERGY_HOP_LEN, true);
+        benchmark::DoNotOptimize(rmses.data());
+    }
+    SetPerCallCounters(state, signal.size(), GetAllocationCount() - startAllocations);
+}
+BENCHMARK(BM_GetRMS)->Arg(ONE_SECOND)->Arg(TEN_SECONDS)->Arg(ONE_MINUTE)->Arg(TEN_MINUTES)
+    ->Unit(benchmark::kMillisecond);
+
+// DetectPeak runs on the RMS envelope of the signal, ns/sample is still given per audio sample.
+static void BM_DetectPeak(benchmark::State &state)
+{
+    std::vector<double> signal = GenerateSignal(state.range(0));
+    IntensityProcessor intensityProcessor;
+    std::vector<double> envelope = intensityProcessor.GetRMS(signal, ENERGY_HOP_LEN, true);
+    PeakFinder peakFinder;
+    size_t peakCount = 0;
+    uint64_t startAllocations = GetAllocationCount();
+    for (auto _ : state) {
+        std::vector<int32_t> peaks = peakFinder.DetectPeak(envelope, PEAK_THRESHOLD_RATIO);
+        peakCount = peaks.size();
+        benchmark::DoNotOptimize(peaks.data());
+    }
+    SetPerCallCounters(state, signal.size(), GetAllocationCount() - startAllocations);
+    state.counters["envelope"] = static_cast<double>(envelope.size());
+    state.counters["peaks"] = static_cast<double>(peakCount);
+}
+BENCHMARK(BM_DetectPeak)->Arg(ONE_SECOND)->Arg(TEN_SECONDS)->Arg(ONE_MINUTE)->Arg(TEN_MINUTES)
+    ->Unit(benchmark::kMicrosecond);
+
+// The full conversion, including the resampling and the demo.json written into the working directory.
+static void BM_ConvertAudioToHaptic(benchmark::State &state)
+{
+    std::vector<double> signal = GenerateSignal(state.range(0));
+    AudioSetting audioSetting;
+    audioSetting.transientDetection = TRANSIENT_DETECTION;
+    audioSetting.intensityTreshold = INTENSITY_TRESHOLD;
+    audioSetting.frequencyTreshold = FREQUENCY_TRESHOLD;
+    audioSetting.frequencyMaxValue = FREQUENCY_MAX_VALUE;
+    audioSetting.frequencyMinValue = FREQUENCY_MIN_VALUE;
+    size_t eventCount = 0;
+    uint64_t startAllocations = GetAllocationCount();
+    for (auto _ : state) {
+        VibrationConvertCore vibrationConvertCore;
+        std::vector<HapticEvent> hapticEvents;
+        if (vibrationConvertCore.ConvertAudioToHaptic(audioSetting, signal, hapticEvents) != Sensors::SUCCESS) {
+            state.SkipWithError("ConvertAudioToHaptic failed");
+            break;
+        }
+        eventCount = hapticEvents.size();
+    }
+    SetPerCallCounters(state, signal.size(), GetAllocationCount() - startAllocations);
+    state.counters["events"] = static_cast<double>(eventCount);
+}
+BENCHMARK(BM_ConvertAudioToHaptic)->Arg(ONE_SECOND)->Arg(TEN_SECONDS)->Arg(ONE_MINUTE)->Arg(TEN_MINUTES)
+    ->Unit(benchmark::kMillisecond);
+}  // namespace Sensors
+}  // namespace OHOS
+
+BENCHMARK_MAIN();
@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "audio_parsing.h"
+#include "sensor_log.h"
+#include "sensors_errors.h"
+#include "vibration_convert_type.h"
+
+#undef LOG_TAG
+#define LOG_TAG "AudioParsingTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr uint16_t FORMAT_PCM = 0x0001;
+constexpr uint16_t FORMAT_ADPCM = 0x0002;
+constexpr uint16_t FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t BITS_PCM16 = 16;
+constexpr uint16_t BITS_FLOAT32 = 32;
+constexpr uint32_t SAMPLE_RATE = 44100;
+constexpr uint32_t FMT_CHUNK_SIZE = 16;
+constexpr uint32_t BITS_PER_BYTE = 8;
+constexpr uint16_t STEREO = 2;
+constexpr double EPS = 0.0001;
+// More samples than one decode block, so the block boundary is crossed.
+constexpr size_t FLOAT_SAMPLE_COUNT = 3000;
+constexpr size_t FILE_OFFSET = 100;
+
+void AppendBytes(std::vector<uint8_t> &buffer, const void *data, size_t size)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+template<typename T>
+void AppendValue(std::vector<uint8_t> &buffer, T value)
+{
+    AppendBytes(buffer, &value, sizeof(T));
+}
+
+void AppendChunk(std::vector<uint8_t> &buffer, const char *chunkId, const std::vector<uint8_t> &body,
+    uint32_t chunkSize)
+{
+    AppendBytes(buffer, chunkId, strlen(chunkId));
+    AppendValue(buffer, chunkSize);
+    AppendBytes(buffer, body.data(), body.size());
+    if ((body.size() & 1) != 0) {
+        buffer.push_back(0);
+    }
+}
+
+std::vector<uint8_t> BuildFormat(uint16_t formatTag, uint16_t bitsPerSample, uint16_t channels = 1)
+{
+    std::vector<uint8_t> fmt;
+    uint16_t blockAlign = bitsPerSample / BITS_PER_BYTE * channels;
+    AppendValue(fmt, formatTag);
+    AppendValue(fmt, channels);
+    AppendValue(fmt, SAMPLE_RATE);
+    AppendValue(fmt, SAMPLE_RATE * blockAlign);
+    AppendValue(fmt, blockAlign);
+    AppendValue(fmt, bitsPerSample);
+    return fmt;
+}
+
+std::vector<uint8_t> BuildWave(const std::vector<uint8_t> &chunks)
+{
+    std::vector<uint8_t> wave;
+    AppendBytes(wave, "RIFF", strlen("RIFF"));
+    AppendValue(wave, static_cast<uint32_t>(chunks.size() + strlen("WAVE")));
+    AppendBytes(wave, "WAVE", strlen("WAVE"));
+    AppendBytes(wave, chunks.data(), chunks.size());
+    return wave;
+}
+
+std::vector<uint8_t> BuildPcm16Data(const std::vector<int16_t> &samples)
+{
+    std::vector<uint8_t> data;
+    AppendBytes(data, samples.data(), samples.size() * sizeof(int16_t));
+    return data;
+}
+}  // namespace
+
+class AudioParsingTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+
+protected:
+    RawFileDescriptor WriteFile(const std::vector<uint8_t> &content, size_t offset = 0);
+    FILE *file_ { nullptr };
+};
+
+void AudioParsingTest::SetUpTestCase() {}
+
+void AudioParsingTest::TearDownTestCase() {}
+
+void AudioParsingTest::SetUp() {}
+
+void AudioParsingTest::TearDown()
+{
+    if (file_ != nullptr) {
+        fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+RawFileDescriptor AudioParsingTest::WriteFile(const std::vector<uint8_t> &content, size_t offset)
+{
+    RawFileDescriptor rawFd;
+    file_ = tmpfile();
+    if (file_ == nullptr) {
+        return rawFd;
+    }
+    std::vector<uint8_t> padding(offset, 0xFF);
+    fwrite(padding.data(), 1, padding.size(), file_);
+    fwrite(content.data(), 1, content.size(), file_);
+    fflush(file_);
+    rawFd.fd = fileno(file_);
+    rawFd.offset = static_cast<int64_t>(offset);
+    rawFd.length = static_cast<int64_t>(content.size());
+    return rawFd;
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_001 in");
+    std::vector<int16_t> samples = { 0, 16384, -32768, 32767, -16384 };
+    std::vector<uint8_t> chunks;
+    AppendChunk(chunks, "fmt ", BuildFormat(FORMAT_PCM, BITS_PCM16), FMT_CHUNK_SIZE);
+    AppendChunk(chunks, "data", BuildPcm16Data(samples), samples.size() * sizeof(int16_t));
+    AudioParsing audioParsing(WriteFile(BuildWave(chunks)));
+    ASSERT_EQ(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+    AudioAttribute attribute;
+    ASSERT_EQ(audioParsing.GetAudioAttribute(attribute), Sensors::SUCCESS);
+    EXPECT_EQ(attribute.sampleRate, SAMPLE_RATE);
+    EXPECT_EQ(attribute.dataCount, samples.size());
+    AudioData audioData;
+    ASSERT_EQ(audioParsing.GetAudioData(1, audioData), Sensors::SUCCESS);
+    ASSERT_EQ(audioData.audioDatas.size(), samples.size());
+    EXPECT_NEAR(audioData.audioDatas[1], 0.5, EPS);
+    EXPECT_NEAR(audioData.audioDatas[2], -1.0, EPS);
+    EXPECT_NEAR(audioData.min, -1.0, EPS);
+    EXPECT_NEAR(audioData.max, 1.0, EPS);
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_002 in");
+    // A LIST chunk of odd size before fmt: its body is padded to an even size.
+    std::vector<uint8_t> list = { 'I', 'N', 'F' };
+    std::vector<int16_t> samples = { 100, 200, 300, 400 };
+    std::vector<uint8_t> chunks;
+    AppendChunk(chunks, "LIST", list, list.size());
+    AppendChunk(chunks, "fmt ", BuildFormat(FORMAT_PCM, BITS_PCM16), FMT_CHUNK_SIZE);
+    AppendChunk(chunks, "data", BuildPcm16Data(samples), samples.size() * sizeof(int16_t));
+    AudioParsing audioParsing(WriteFile(BuildWave(chunks)));
+    ASSERT_EQ(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+    AudioAttribute attribute;
+    ASSERT_EQ(audioParsing.GetAudioAttribute(attribute), Sensors::SUCCESS);
+    EXPECT_EQ(attribute.dataCount, samples.size());
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_003 in");
+    // The data chunk claims more bytes than the file holds, only the available samples are decoded.
+    std::vector<int16_t> samples = { 1000, 2000, 3000 };
+    std::vector<uint8_t> chunks;
+    AppendChunk(chunks, "fmt ", BuildFormat(FORMAT_PCM, BITS_PCM16), FMT_CHUNK_SIZE);
+    AppendChunk(chunks, "data", BuildPcm16Data(samples), samples.size() * sizeof(int16_t) * 2);
+    AudioParsing audioParsing(WriteFile(BuildWave(chunks)));
+    ASSERT_EQ(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+    AudioAttribute attribute;
+    ASSERT_EQ(audioParsing.GetAudioAttribute(attribute), Sensors::SUCCESS);
+    EXPECT_EQ(attribute.dataCount, samples.size());
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_004 in");
+    // The fmt chunk runs past the end of the file.
+    std::vector<uint8_t> chunks;
+    std::vector<uint8_t> fmt = BuildFormat(FORMAT_PCM, BITS_PCM16);
+    fmt.resize(FMT_CHUNK_SIZE / 2);
+    AppendChunk(chunks, "fmt ", fmt, FMT_CHUNK_SIZE);
+    AudioParsing audioParsing(WriteFile(BuildWave(chunks)));
+    EXPECT_NE(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_005 in");
+    std::vector<int16_t> samples = { 1, 2, 3, 4 };
+    std::vector<uint8_t> chunks;
+    AppendChunk(chunks, "fmt ", BuildFormat(FORMAT_ADPCM, BITS_PCM16), FMT_CHUNK_SIZE);
+    AppendChunk(chunks, "data", BuildPcm16Data(samples), samples.size() * sizeof(int16_t));
+    AudioParsing audioParsing(WriteFile(BuildWave(chunks)));
+    EXPECT_NE(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_006, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_006 in");
+    std::vector<uint8_t> chunks;
+    AppendChunk(chunks, "fmt ", BuildFormat(FORMAT_PCM, BITS_PCM16), FMT_CHUNK_SIZE);
+    AudioParsing audioParsing(WriteFile(BuildWave(chunks)));
+    EXPECT_NE(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_007, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_007 in");
+    // Float samples behind an unaligned offset in the file.
+    std::vector<float> samples(FLOAT_SAMPLE_COUNT);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        samples[i] = static_cast<float>(i) / FLOAT_SAMPLE_COUNT;
+    }
+    std::vector<uint8_t> data;
+    AppendBytes(data, samples.data(), samples.size() * sizeof(float));
+    std::vector<uint8_t> chunks;
+    AppendChunk(chunks, "fmt ", BuildFormat(FORMAT_IEEE_FLOAT, BITS_FLOAT32), FMT_CHUNK_SIZE);
+    AppendChunk(chunks, "data", data, data.size());
+    AudioParsing audioParsing(WriteFile(BuildWave(chunks), FILE_OFFSET));
+    ASSERT_EQ(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+    AudioData audioData;
+    ASSERT_EQ(audioParsing.GetAudioData(1, audioData), Sensors::SUCCESS);
+    ASSERT_EQ(audioData.audioDatas.size(), samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_NEAR(audioData.audioDatas[i], samples[i], EPS);
+    }
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_008, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_008 in");
+    std::vector<uint8_t> wave = { 'R', 'I', 'F', 'X', 0, 0, 0, 0, 'W', 'A', 'V', 'E', 0, 0, 0, 0, 0, 0, 0, 0 };
+    AudioParsing audioParsing(WriteFile(wave));
+    EXPECT_NE(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+}
+
+HWTEST_F(AudioParsingTest, AudioParsingTest_009, TestSize.Level1)
+{
+    SEN_HILOGI("AudioParsingTest_009 in");
+    // Interleaved stereo frames are averaged to one value each, the trailing half frame is dropped.
+    std::vector<int16_t> samples = { 16384, -16384, 32767, 32767, -32768, 0, 8192, 8192, 1000 };
+    size_t frameCount = samples.size() / STEREO;
+    std::vector<uint8_t> chunks;
+    AppendChunk(chunks, "fmt ", BuildFormat(FORMAT_PCM, BITS_PCM16, STEREO), FMT_CHUNK_SIZE);
+    AppendChunk(chunks, "data", BuildPcm16Data(samples), samples.size() * sizeof(int16_t));
+    AudioParsing audioParsing(WriteFile(BuildWave(chunks)));
+    ASSERT_EQ(audioParsing.ParseAudioFile(), Sensors::SUCCESS);
+    AudioAttribute attribute;
+    ASSERT_EQ(audioParsing.GetAudioAttribute(attribute), Sensors::SUCCESS);
+    EXPECT_EQ(attribute.dataCount, frameCount);
+    AudioData audioData;
+    ASSERT_EQ(audioParsing.GetAudioData(1, audioData), Sensors::SUCCESS);
+    ASSERT_EQ(audioData.audioDatas.size(), frameCount);
+    EXPECT_NEAR(audioData.audioDatas[0], 0.0, EPS);
+    EXPECT_NEAR(audioData.audioDatas[1], 1.0, EPS);
+    EXPECT_NEAR(audioData.audioDatas[2], -0.5, EPS);
+    EXPECT_NEAR(audioData.audioDatas[3], 0.25, EPS);
+    EXPECT_NEAR(audioData.min, -0.5, EPS);
+    EXPECT_NEAR(audioData.max, 1.0, EPS);
+}
+}  // namespace Sensors
+}  // namespace OHOS
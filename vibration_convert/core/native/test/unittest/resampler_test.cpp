@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "resampler.h"
+#include "sensor_log.h"
+#include "sensors_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "ResamplerTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr size_t SIGNAL_LENGTH = 8192;
+constexpr uint32_t DOWN_FACTOR = 4;
+// Frequencies in cycles per input sample, the output Nyquist frequency is 0.125 for DOWN_FACTOR.
+constexpr double PASSBAND_FREQUENCY = 0.02;
+constexpr double STOPBAND_FREQUENCY = 0.3;
+constexpr double PASSBAND_TOLERANCE = 0.01;
+// 60 dB below the input amplitude.
+constexpr double ALIAS_LIMIT = 1e-3;
+// Output frames skipped at both ends, where the filter sees the zero padding.
+constexpr size_t EDGE_FRAMES = 200;
+constexpr double EPS = 1e-12;
+constexpr uint32_t LARGE_DOWN_FACTOR = 1000;
+constexpr double DC_VALUE = 0.5;
+
+std::vector<double> GenerateSine(size_t length, double frequency)
+{
+    std::vector<double> signal(length);
+    for (size_t i = 0; i < length; ++i) {
+        signal[i] = std::sin(2.0 * M_PI * frequency * i);
+    }
+    return signal;
+}
+
+double InteriorPeak(const std::vector<double> &output)
+{
+    double peak = 0.0;
+    for (size_t i = EDGE_FRAMES; (i + EDGE_FRAMES) < output.size(); ++i) {
+        peak = std::max(peak, std::fabs(output[i]));
+    }
+    return peak;
+}
+}  // namespace
+
+class ResamplerTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void ResamplerTest::SetUpTestCase() {}
+
+void ResamplerTest::TearDownTestCase() {}
+
+void ResamplerTest::SetUp() {}
+
+void ResamplerTest::TearDown() {}
+
+HWTEST_F(ResamplerTest, ResamplerTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("ResamplerTest_001 in");
+    // Equal factors reduce to 1/1 and pass the signal through unchanged.
+    std::vector<double> input = GenerateSine(SIGNAL_LENGTH, PASSBAND_FREQUENCY);
+    std::vector<double> output;
+    ASSERT_EQ(Resampler::Resample(input, 1, 1, 1, output), Sensors::SUCCESS);
+    EXPECT_EQ(output, input);
+    ASSERT_EQ(Resampler::Resample(input, 3, 3, 2, output), Sensors::SUCCESS);
+    EXPECT_EQ(output, input);
+}
+
+HWTEST_F(ResamplerTest, ResamplerTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("ResamplerTest_002 in");
+    std::vector<double> input = GenerateSine(SIGNAL_LENGTH, PASSBAND_FREQUENCY);
+    std::vector<double> output;
+    ASSERT_EQ(Resampler::Resample(input, 1, DOWN_FACTOR, 1, output), Sensors::SUCCESS);
+    ASSERT_EQ(output.size(), SIGNAL_LENGTH / DOWN_FACTOR);
+    // Unity gain in the passband and output frame n lines up with input frame n * DOWN_FACTOR.
+    for (size_t i = EDGE_FRAMES; (i + EDGE_FRAMES) < output.size(); ++i) {
+        EXPECT_NEAR(output[i], input[i * DOWN_FACTOR], PASSBAND_TOLERANCE) << "frame:" << i;
+    }
+}
+
+HWTEST_F(ResamplerTest, ResamplerTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("ResamplerTest_003 in");
+    // Plain decimation would fold this tone to 0.2 of the output rate at full amplitude.
+    std::vector<double> input = GenerateSine(SIGNAL_LENGTH, STOPBAND_FREQUENCY);
+    std::vector<double> output;
+    ASSERT_EQ(Resampler::Resample(input, 1, DOWN_FACTOR, 1, output), Sensors::SUCCESS);
+    EXPECT_LT(InteriorPeak(output), ALIAS_LIMIT);
+}
+
+HWTEST_F(ResamplerTest, ResamplerTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("ResamplerTest_004 in");
+    // Streaming in uneven blocks gives the same samples as one block.
+    std::vector<double> input = GenerateSine(SIGNAL_LENGTH, PASSBAND_FREQUENCY);
+    Resampler whole;
+    ASSERT_EQ(whole.Init(2, 3, 1), Sensors::SUCCESS);
+    std::vector<double> expected;
+    ASSERT_EQ(whole.Process(input, expected), Sensors::SUCCESS);
+    Resampler blocks;
+    ASSERT_EQ(blocks.Init(2, 3, 1), Sensors::SUCCESS);
+    std::vector<double> output;
+    size_t blockLength = 1;
+    for (size_t start = 0; start < input.size(); start += blockLength, blockLength = blockLength * 2 + 1) {
+        size_t end = std::min(start + blockLength, input.size());
+        std::vector<double> block(input.begin() + start, input.begin() + end);
+        ASSERT_EQ(blocks.Process(block, output), Sensors::SUCCESS);
+    }
+    ASSERT_EQ(output.size(), expected.size());
+    for (size_t i = 0; i < output.size(); ++i) {
+        EXPECT_NEAR(output[i], expected[i], EPS) << "frame:" << i;
+    }
+}
+
+HWTEST_F(ResamplerTest, ResamplerTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("ResamplerTest_005 in");
+    // Factors beyond the filter bound are rejected instead of designing a huge filter.
+    Resampler resampler;
+    EXPECT_EQ(resampler.Init(1, Resampler::MAX_FILTER_FACTOR + 1, 1), Sensors::PARAMETER_ERROR);
+    EXPECT_EQ(resampler.Init(Resampler::MAX_FILTER_FACTOR + 1, 1, 1), Sensors::PARAMETER_ERROR);
+    EXPECT_EQ(resampler.Init(1, Resampler::MAX_FILTER_FACTOR, 1), Sensors::SUCCESS);
+    std::vector<double> input(SIGNAL_LENGTH, 0.0);
+    std::vector<double> output;
+    EXPECT_EQ(Resampler::Resample(input, 2, LARGE_DOWN_FACTOR + 1, 1, output), Sensors::PARAMETER_ERROR);
+}
+
+HWTEST_F(ResamplerTest, ResamplerTest_006, TestSize.Level1)
+{
+    SEN_HILOGI("ResamplerTest_006 in");
+    // Large decimations average blocks, a constant stays constant away from the edges.
+    std::vector<double> input(SIGNAL_LENGTH * 2, DC_VALUE);
+    std::vector<double> output;
+    ASSERT_EQ(Resampler::Resample(input, 1, LARGE_DOWN_FACTOR, 2, output), Sensors::SUCCESS);
+    size_t outFrames = (SIGNAL_LENGTH + LARGE_DOWN_FACTOR - 1) / LARGE_DOWN_FACTOR;
+    ASSERT_EQ(output.size(), outFrames * 2);
+    for (size_t i = 2; (i + 2) < output.size(); ++i) {
+        EXPECT_NEAR(output[i], DC_VALUE, EPS) << "sample:" << i;
+    }
+    // An interval far beyond the signal length still yields one frame.
+    ASSERT_EQ(Resampler::Resample(input, 1, UINT32_MAX, 2, output), Sensors::SUCCESS);
+    EXPECT_EQ(output.size(), 2);
+}
+}  // namespace Sensors
+}  // namespace OHOS
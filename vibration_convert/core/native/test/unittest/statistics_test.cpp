@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sensor_log.h"
+#include "statistics.h"
+
+#undef LOG_TAG
+#define LOG_TAG "StatisticsTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr double EPS = 1e-9;
+constexpr size_t SIGNAL_LENGTH = 500;
+constexpr double CARRIER_STEP = 0.37;
+constexpr double ENVELOPE_STEP = 0.013;
+// Window lengths below, at and above the signal length, 0 keeps every value.
+const std::vector<size_t> WINDOWS = { 0, 1, 2, 5, 16, SIGNAL_LENGTH, SIGNAL_LENGTH + 1 };
+
+// Rounded so the signal has ties, which the median and the range queries must handle.
+std::vector<double> GenerateSignal(size_t length)
+{
+    std::vector<double> signal(length);
+    for (size_t i = 0; i < length; ++i) {
+        signal[i] = std::round(std::sin(CARRIER_STEP * i) * std::cos(ENVELOPE_STEP * i) * 8.0);
+    }
+    return signal;
+}
+
+// Values pushed into a moving statistic of the given window before and including 'index'.
+std::vector<double> GetWindow(const std::vector<double> &signal, size_t window, size_t index)
+{
+    size_t first = ((window == 0) || (index + 1 < window)) ? 0 : (index + 1 - window);
+    return std::vector<double>(signal.begin() + first, signal.begin() + index + 1);
+}
+
+double ReferenceMedian(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+} // namespace
+
+class StatisticsTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void StatisticsTest::SetUpTestCase() {}
+
+void StatisticsTest::TearDownTestCase() {}
+
+void StatisticsTest::SetUp() {}
+
+void StatisticsTest::TearDown() {}
+
+HWTEST_F(StatisticsTest, StatisticsTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("StatisticsTest_001 in");
+    std::vector<double> values = { 5.0, 1.0, 4.0, 2.0 };
+    std::optional<double> median = MedianInPlace(values);
+    ASSERT_TRUE(median.has_value());
+    EXPECT_DOUBLE_EQ(median.value(), 4.0);
+    std::optional<double> mean = Mean({ 1.0, 2.0, 2.5 });
+    ASSERT_TRUE(mean.has_value());
+    EXPECT_NEAR(mean.value(), 5.5 / 3.0, EPS);
+    std::vector<double> empty;
+    EXPECT_FALSE(MedianInPlace(empty).has_value());
+    EXPECT_FALSE(Mean(empty).has_value());
+}
+
+HWTEST_F(StatisticsTest, StatisticsTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("StatisticsTest_002 in");
+    std::vector<double> signal = GenerateSignal(SIGNAL_LENGTH);
+    for (size_t window : WINDOWS) {
+        MovingMean movingMean(window);
+        MovingMedian movingMedian(window);
+        for (size_t i = 0; i < signal.size(); ++i) {
+            std::vector<double> values = GetWindow(signal, window, i);
+            double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+            EXPECT_NEAR(movingMean.Push(signal[i]), mean, EPS) << "window:" << window << " index:" << i;
+            EXPECT_DOUBLE_EQ(movingMedian.Push(signal[i]), ReferenceMedian(values))
+                << "window:" << window << " index:" << i;
+        }
+    }
+}
+
+HWTEST_F(StatisticsTest, StatisticsTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("StatisticsTest_003 in");
+    std::vector<double> signal = GenerateSignal(SIGNAL_LENGTH);
+    RangeMinTable rangeMin(signal);
+    RangeMaxTable rangeMax(signal);
+    for (size_t first = 0; first < signal.size(); first += 7) {
+        for (size_t last = first + 1; last <= signal.size(); last += 3) {
+            auto minIt = std::min_element(signal.begin() + first, signal.begin() + last);
+            auto maxIt = std::max_element(signal.begin() + first, signal.begin() + last);
+            ASSERT_EQ(rangeMin.Query(first, last), static_cast<size_t>(minIt - signal.begin()));
+            ASSERT_EQ(rangeMax.Query(first, last), static_cast<size_t>(maxIt - signal.begin()));
+        }
+    }
+    EXPECT_EQ(rangeMax.Query(3, 3), 3);
+    EXPECT_EQ(rangeMax.Query(1, signal.size() + 1), 1);
+}
+
+HWTEST_F(StatisticsTest, StatisticsTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("StatisticsTest_004 in");
+    std::vector<double> signal = GenerateSignal(SIGNAL_LENGTH);
+    constexpr size_t window = 9;
+    size_t count = signal.size() - window + 1;
+    std::vector<double> values = signal;
+    SlidingWindowMax(values, window, count);
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_DOUBLE_EQ(values[i], *std::max_element(signal.begin() + i, signal.begin() + i + window));
+    }
+    // Positions past 'count' are left untouched.
+    for (size_t i = count; i < signal.size(); ++i) {
+        ASSERT_DOUBLE_EQ(values[i], signal[i]);
+    }
+}
+} // namespace Sensors
+} // namespace OHOS
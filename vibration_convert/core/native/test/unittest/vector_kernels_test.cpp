@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "sensor_log.h"
+#include "vector_kernels.h"
+
+#undef LOG_TAG
+#define LOG_TAG "VectorKernelsTest"
+
+namespace OHOS {
+namespace Sensors {
+using namespace testing::ext;
+using namespace OHOS::HiviewDFX;
+
+namespace {
+constexpr double EPS = 1e-9;
+// Lengths around the vector step of 4 samples, so every tail length is covered.
+const std::vector<size_t> LENGTHS = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 17, 1023 };
+constexpr size_t SIGNAL_LENGTH = 20000;
+// More frames than the incremental sum runs before it is recomputed.
+constexpr size_t FRAME_COUNT = 150;
+constexpr double CARRIER_STEP = 0.37;
+constexpr double ENVELOPE_STEP = 0.011;
+constexpr double DC_OFFSET = 0.25;
+
+std::vector<double> GenerateSignal(size_t length)
+{
+    std::vector<double> signal(length);
+    for (size_t i = 0; i < length; ++i) {
+        signal[i] = std::sin(CARRIER_STEP * i) * std::cos(ENVELOPE_STEP * i) - DC_OFFSET;
+    }
+    return signal;
+}
+
+double ReferenceSumOfSquares(const double *data, size_t count)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += data[i] * data[i];
+    }
+    return sum;
+}
+
+double ReferenceSumOfAbs(const double *data, size_t count)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += std::fabs(data[i]);
+    }
+    return sum;
+}
+
+double ReferenceDotProduct(const double *left, const double *right, size_t count)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += left[i] * right[i];
+    }
+    return sum;
+}
+
+void ExpectFramesNear(const std::vector<double> &frames, const double *data, size_t frameLength, size_t hopLength,
+    double (*reference)(const double *, size_t))
+{
+    ASSERT_EQ(frames.size(), FRAME_COUNT);
+    for (size_t i = 0; i < FRAME_COUNT; ++i) {
+        double expected = reference(data + i * hopLength, frameLength);
+        EXPECT_NEAR(frames[i], expected, EPS * frameLength) << "frame:" << i;
+    }
+}
+}  // namespace
+
+class VectorKernelsTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp();
+    void TearDown();
+};
+
+void VectorKernelsTest::SetUpTestCase() {}
+
+void VectorKernelsTest::TearDownTestCase() {}
+
+void VectorKernelsTest::SetUp() {}
+
+void VectorKernelsTest::TearDown() {}
+
+HWTEST_F(VectorKernelsTest, VectorKernelsTest_001, TestSize.Level1)
+{
+    SEN_HILOGI("VectorKernelsTest_001 in");
+    std::vector<double> signal = GenerateSignal(SIGNAL_LENGTH);
+    // Offset by one sample, so the loads are not 16-byte aligned.
+    const double *data = signal.data() + 1;
+    for (size_t length : LENGTHS) {
+        EXPECT_NEAR(SumOfSquares(data, length), ReferenceSumOfSquares(data, length), EPS) << "length:" << length;
+        EXPECT_NEAR(SumOfAbs(data, length), ReferenceSumOfAbs(data, length), EPS) << "length:" << length;
+    }
+}
+
+HWTEST_F(VectorKernelsTest, VectorKernelsTest_002, TestSize.Level1)
+{
+    SEN_HILOGI("VectorKernelsTest_002 in");
+    std::vector<double> left = GenerateSignal(SIGNAL_LENGTH);
+    std::vector<double> right = GenerateSignal(SIGNAL_LENGTH + 1);
+    for (size_t length : LENGTHS) {
+        EXPECT_NEAR(DotProduct(left.data(), right.data() + 1, length),
+            ReferenceDotProduct(left.data(), right.data() + 1, length), EPS) << "length:" << length;
+    }
+}
+
+HWTEST_F(VectorKernelsTest, VectorKernelsTest_003, TestSize.Level1)
+{
+    SEN_HILOGI("VectorKernelsTest_003 in");
+    // Overlapping frames take the incremental path.
+    size_t frameLength = 64;
+    size_t hopLength = 16;
+    std::vector<double> signal = GenerateSignal(SIGNAL_LENGTH);
+    std::vector<double> squares = FrameSumOfSquares(signal.data(), FRAME_COUNT, frameLength, hopLength);
+    ExpectFramesNear(squares, signal.data(), frameLength, hopLength, ReferenceSumOfSquares);
+    std::vector<double> abs = FrameSumOfAbs(signal.data(), FRAME_COUNT, frameLength, hopLength);
+    ExpectFramesNear(abs, signal.data(), frameLength, hopLength, ReferenceSumOfAbs);
+}
+
+HWTEST_F(VectorKernelsTest, VectorKernelsTest_004, TestSize.Level1)
+{
+    SEN_HILOGI("VectorKernelsTest_004 in");
+    // Disjoint frames are reduced one by one.
+    size_t frameLength = 37;
+    size_t hopLength = 40;
+    std::vector<double> signal = GenerateSignal(SIGNAL_LENGTH);
+    std::vector<double> squares = FrameSumOfSquares(signal.data(), FRAME_COUNT, frameLength, hopLength);
+    ExpectFramesNear(squares, signal.data(), frameLength, hopLength, ReferenceSumOfSquares);
+    std::vector<double> abs = FrameSumOfAbs(signal.data(), FRAME_COUNT, frameLength, hopLength);
+    ExpectFramesNear(abs, signal.data(), frameLength, hopLength, ReferenceSumOfAbs);
+}
+
+HWTEST_F(VectorKernelsTest, VectorKernelsTest_005, TestSize.Level1)
+{
+    SEN_HILOGI("VectorKernelsTest_005 in");
+    std::vector<double> frames = FrameSumOfSquares(nullptr, FRAME_COUNT, 1, 1);
+    ASSERT_EQ(frames.size(), FRAME_COUNT);
+    EXPECT_EQ(frames[0], 0.0);
+    std::vector<double> signal = GenerateSignal(SIGNAL_LENGTH);
+    frames = FrameSumOfAbs(signal.data(), FRAME_COUNT, 0, 1);
+    ASSERT_EQ(frames.size(), FRAME_COUNT);
+    EXPECT_EQ(frames[FRAME_COUNT - 1], 0.0);
+}
+}  // namespace Sensors
+}  // namespace OHOS
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <set>
+#include <vector>
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * @brief Median of the values, the upper one of the two middle values for an even count.
+ * Runs in linear time with std::nth_element, the order of 'values' is changed.
+ *
+ * @param values Values, used as scratch space.
+ *
+ * @return Returns the median, std::nullopt if 'values' is empty.
+ */
+std::optional<double> MedianInPlace(std::vector<double> &values);
+
+/**
+ * @brief Arithmetic mean of the values, accumulated in double.
+ *
+ * @param values Values.
+ *
+ * @return Returns the mean, std::nullopt if 'values' is empty.
+ */
+std::optional<double> Mean(const std::vector<double> &values);
+
+/**
+ * @brief Replace values[i] with the maximum of values[i, i + window) for every i < count, in linear time.
+ * The remaining values are left untouched.
+ *
+ * @param values Values, must hold at least count + window - 1 elements.
+ * @param window Window length.
+ * @param count Number of leading positions to process.
+ */
+void SlidingWindowMax(std::vector<double> &values, size_t window, size_t count);
+
+/**
+ * @brief Mean of the last 'window' pushed values, O(1) per update.
+ */
+class MovingMean {
+public:
+    explicit MovingMean(size_t window) : window_(window) {}
+    ~MovingMean() = default;
+
+    /**
+     * @brief Push a new value and return the mean over the current window.
+     */
+    double Push(double value);
+
+private:
+    size_t window_ { 0 };
+    double sum_ { 0.0 };
+    std::deque<double> values_;
+};
+
+/**
+ * @brief Median of the last 'window' pushed values, O(log window) per update.
+ * Uses the same upper-median convention as {@link MedianInPlace}.
+ */
+class MovingMedian {
+public:
+    explicit MovingMedian(size_t window) : window_(window) {}
+    ~MovingMedian() = default;
+
+    /**
+     * @brief Push a new value and return the median over the current window.
+     */
+    double Push(double value);
+
+private:
+    void Insert(double value);
+    void Erase(double value);
+    void Rebalance();
+
+private:
+    size_t window_ { 0 };
+    std::deque<double> values_;
+    /** Lower half, holds size / 2 values. */
+    std::multiset<double> low_;
+    /** Upper half, its smallest element is the median. */
+    std::multiset<double> high_;
+};
+
+/**
+ * @brief Sparse table answering range extremum queries on a fixed envelope in O(1) after O(n log n) setup.
+ * On ties the lowest index wins, which matches std::min_element / std::max_element.
+ *
+ * @tparam Compare std::less<double> for range minimum, std::greater<double> for range maximum.
+ */
+template<typename Compare>
+class SparseTable {
+public:
+    explicit SparseTable(const std::vector<double> &values) : values_(values)
+    {
+        size_t size = values_.size();
+        logs_.assign(size + 1, 0);
+        for (size_t i = 2; i <= size; ++i) {
+            logs_[i] = logs_[i / 2] + 1;
+        }
+        if (size == 0) {
+            return;
+        }
+        table_.emplace_back(size);
+        for (size_t i = 0; i < size; ++i) {
+            table_[0][i] = i;
+        }
+        for (size_t level = 1; (static_cast<size_t>(1) << level) <= size; ++level) {
+            size_t half = static_cast<size_t>(1) << (level - 1);
+            size_t count = size - (static_cast<size_t>(1) << level) + 1;
+            table_.emplace_back(count);
+            for (size_t i = 0; i < count; ++i) {
+                table_[level][i] = Select(table_[level - 1][i], table_[level - 1][i + half]);
+            }
+        }
+    }
+    ~SparseTable() = default;
+
+    /**
+     * @brief Index of the extremum within [first, last).
+     *
+     * @return Returns the index of the extremum, 'first' if the range is empty or out of bounds.
+     */
+    size_t Query(size_t first, size_t last) const
+    {
+        if ((first >= last) || (last > values_.size())) {
+            return first;
+        }
+        size_t level = logs_[last - first];
+        return Select(table_[level][first], table_[level][last - (static_cast<size_t>(1) << level)]);
+    }
+
+    const std::vector<double> &Values() const
+    {
+        return values_;
+    }
+
+private:
+    size_t Select(size_t left, size_t right) const
+    {
+        if (Compare()(values_[right], values_[left])) {
+            return right;
+        }
+        if (Compare()(values_[left], values_[right])) {
+            return left;
+        }
+        return (left < right) ? left : right;
+    }
+
+private:
+    const std::vector<double> &values_;
+    std::vector<size_t> logs_;
+    std::vector<std::vector<size_t>> table_;
+};
+
+using RangeMinTable = SparseTable<std::less<double>>;
+using RangeMaxTable = SparseTable<std::greater<double>>;
+}  // namespace Sensors
+}  // namespace OHOS
+#endif // STATISTICS_H
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VECTOR_KERNELS_H
+#define VECTOR_KERNELS_H
+
+#include <cstddef>
+#include <vector>
+
+namespace OHOS {
+namespace Sensors {
+/**
+ * @brief Sum of squares of 'count' samples starting at 'data'.
+ *
+ * @param data Start of the samples, may be unaligned.
+ * @param count Number of samples.
+ *
+ * @return Returns the sum of squares, 0.0 if 'count' is 0.
+ */
+double SumOfSquares(const double *data, size_t count);
+
+/**
+ * @brief Sum of absolute values of 'count' samples starting at 'data'.
+ *
+ * @param data Start of the samples, may be unaligned.
+ * @param count Number of samples.
+ *
+ * @return Returns the sum of absolute values, 0.0 if 'count' is 0.
+ */
+double SumOfAbs(const double *data, size_t count);
+
+/**
+ * @brief Inner product of two sample sequences.
+ *
+ * @param left Start of the first sequence.
+ * @param right Start of the second sequence.
+ * @param count Number of samples in each sequence.
+ *
+ * @return Returns the inner product, 0.0 if 'count' is 0.
+ */
+double DotProduct(const double *left, const double *right, size_t count);
+
+/**
+ * @brief Sum of squares for each analysis frame.
+ * Frame i covers [i * hopLength, i * hopLength + frameLength). When 'hopLength' is less than 'frameLength', the
+ * sum is updated incrementally, only the samples entering and leaving the window are visited.
+ *
+ * @param data Audio time series, must hold at least (frameCount - 1) * hopLength + frameLength samples.
+ * @param frameCount Number of frames.
+ * @param frameLength Length of analysis frame (in samples).
+ * @param hopLength Hop length.
+ *
+ * @return Returns the sum of squares for each frame.
+ */
+std::vector<double> FrameSumOfSquares(const double *data, size_t frameCount, size_t frameLength, size_t hopLength);
+
+/**
+ * @brief Sum of absolute values for each analysis frame, see {@link FrameSumOfSquares} for the frame layout.
+ */
+std::vector<double> FrameSumOfAbs(const double *data, size_t frameCount, size_t frameLength, size_t hopLength);
+}  // namespace Sensors
+}  // namespace OHOS
+#endif // VECTOR_KERNELS_H
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "statistics.h"
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+#include "sensor_log.h"
+#include "sensors_errors.h"
+
+#undef LOG_TAG
+#define LOG_TAG "Statistics"
+
+namespace OHOS {
+namespace Sensors {
+std::optional<double> MedianInPlace(std::vector<double> &values)
+{
+    if (values.empty()) {
+        SEN_HILOGE("values is empty");
+        return std::nullopt;
+    }
+    auto middle = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+std::optional<double> Mean(const std::vector<double> &values)
+{
+    if (values.empty()) {
+        SEN_HILOGE("values is empty");
+        return std::nullopt;
+    }
+    double sumValue = std::accumulate(values.begin(), values.end(), 0.0);
+    return sumValue / values.size();
+}
+
+void SlidingWindowMax(std::vector<double> &values, size_t window, size_t count)
+{
+    if ((window == 0) || (count == 0) || ((count + window - 1) > values.size())) {
+        SEN_HILOGE("Invalid parameter");
+        return;
+    }
+    // Indices of the window with strictly decreasing values, the front is the current maximum.
+    std::deque<size_t> candidates;
+    for (size_t i = 0; i < (window - 1); ++i) {
+        while (!candidates.empty() && (values[candidates.back()] <= values[i])) {
+            candidates.pop_back();
+        }
+        candidates.push_back(i);
+    }
+    for (size_t i = 0; i < count; ++i) {
+        size_t incoming = i + window - 1;
+        while (!candidates.empty() && (values[candidates.back()] <= values[incoming])) {
+            candidates.pop_back();
+        }
+        candidates.push_back(incoming);
+        double maxValue = values[candidates.front()];
+        // values[i] leaves the window before it is overwritten.
+        if (candidates.front() == i) {
+            candidates.pop_front();
+        }
+        values[i] = maxValue;
+    }
+}
+
+double MovingMean::Push(double value)
+{
+    values_.push_back(value);
+    sum_ += value;
+    if ((window_ > 0) && (values_.size() > window_)) {
+        sum_ -= values_.front();
+        values_.pop_front();
+    }
+    return sum_ / values_.size();
+}
+
+double MovingMedian::Push(double value)
+{
+    values_.push_back(value);
+    Insert(value);
+    if ((window_ > 0) && (values_.size() > window_)) {
+        Erase(values_.front());
+        values_.pop_front();
+    }
+    Rebalance();
+    return *high_.begin();
+}
+
+void MovingMedian::Insert(double value)
+{
+    if (!high_.empty() && (value < *high_.begin())) {
+        low_.insert(value);
+    } else {
+        high_.insert(value);
+    }
+}
+
+void MovingMedian::Erase(double value)
+{
+    auto it = high_.find(value);
+    if (it != high_.end()) {
+        high_.erase(it);
+        return;
+    }
+    it = low_.find(value);
+    if (it != low_.end()) {
+        low_.erase(it);
+    }
+}
+
+void MovingMedian::Rebalance()
+{
+    size_t total = low_.size() + high_.size();
+    while (low_.size() > (total / 2)) {
+        auto it = std::prev(low_.end());
+        high_.insert(*it);
+        low_.erase(it);
+    }
+    while (low_.size() < (total / 2)) {
+        low_.insert(*high_.begin());
+        high_.erase(high_.begin());
+    }
+}
+}  // namespace Sensors
+}  // namespace OHOS
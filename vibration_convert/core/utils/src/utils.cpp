@@ -27,6 +27,7 @@
 
 #include "sensor_log.h"
 #include "sensors_errors.h"
+#include "vector_kernels.h"
 
 #undef LOG_TAG
 #define LOG_TAG "Utils"
@@ -37,6 +38,7 @@ namespace{
 constexpr double PERCENTAGE_RANGE = 100.0;
 constexpr int32_t VOICE_MIN_INTENSITY_NORM = 25;
 constexpr size_t MAX_SIZE = 26460000;
+constexpr size_t TRANSPOSE_BLOCK = 32;
 }  // namespace
 
 bool IsPowerOfTwo(uint32_t x)
@@ -82,14 +84,20 @@ std::vector<double> TransposeMatrix(size_t rows, const std::vector<double> &valu
     }
     std::vector<double> dst(valuesSize, 0.0);
     size_t cols = valuesSize / rows;
-    size_t index = 0;
     if ((((cols - 1) * rows) + (rows - 1)) >= valuesSize) {
         SEN_HILOGE("dst cross-border access");
         return {};
     }
-    for (size_t i = 0; i < rows; i++) {
-        for (size_t j = 0; j < cols; j++) {
-            dst[j * rows + i] = values[index++];
+    // Transpose in square tiles so both the source rows and the destination rows stay in cache.
+    for (size_t iBlock = 0; iBlock < rows; iBlock += TRANSPOSE_BLOCK) {
+        size_t iEnd = std::min(iBlock + TRANSPOSE_BLOCK, rows);
+        for (size_t jBlock = 0; jBlock < cols; jBlock += TRANSPOSE_BLOCK) {
+            size_t jEnd = std::min(jBlock + TRANSPOSE_BLOCK, cols);
+            for (size_t i = iBlock; i < iEnd; i++) {
+                for (size_t j = jBlock; j < jEnd; j++) {
+                    dst[j * rows + i] = values[i * cols + j];
+                }
+            }
         }
     }
     return dst;
@@ -239,25 +247,13 @@ int32_t ProcessSilence(const std::vector<double> &values, const std::vector<bool
 std::vector<double> ObtainAmplitudeEnvelop(const std::vector<double> &data, size_t count, size_t hopLength)
 {
     CALL_LOG_ENTER;
-    if (data.empty() || (data.size() < count)) {
+    if (data.empty() || (data.size() < count) || (count == 0) || (hopLength == 0)) {
         SEN_HILOGE("data is empty or data is less than count");
         return {};
     }
-    std::vector<double> absData;
-    for (size_t i = 0; i < data.size(); i++) {
-        absData.push_back(fabs(data[i]));
-    }
-    std::vector<double> partAmplitude;
-    std::vector<double> enery;
-    std::vector<double>::iterator it = absData.begin();
-    double accum = 0.0;
-    for (size_t j = 0; j < (data.size() - count);) {
-        partAmplitude.assign(it + j, it + j + count);
-        accum = accumulate(partAmplitude.begin(), partAmplitude.end(), 0);
-        enery.push_back(accum);
-        j += hopLength;
-    }
-    return enery;
+    // Frames start while start < (data.size() - count).
+    size_t frameCount = (data.size() - count + hopLength - 1) / hopLength;
+    return FrameSumOfAbs(data.data(), frameCount, count, hopLength);
 }
 }  // namespace Sensors
 }  // namespace OHOS
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vector_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace OHOS {
+namespace Sensors {
+namespace {
+// Two lanes of double, lowered to NEON on aarch64 and SSE2 on x86_64.
+typedef double DoubleX2 __attribute__((vector_size(16)));
+constexpr size_t LANES = 2;
+// Two independent accumulators hide the add latency.
+constexpr size_t STEP = 2 * LANES;
+// An incremental window sum is recomputed from scratch after this many frames to bound rounding drift.
+constexpr size_t RESYNC_FRAMES = 64;
+
+inline DoubleX2 Load(const double *src)
+{
+    DoubleX2 value;
+    memcpy(&value, src, sizeof(value));
+    return value;
+}
+
+inline DoubleX2 Abs(DoubleX2 value)
+{
+    DoubleX2 result = { std::fabs(value[0]), std::fabs(value[1]) };
+    return result;
+}
+
+inline double HorizontalSum(DoubleX2 value)
+{
+    return value[0] + value[1];
+}
+
+template<typename Kernel>
+std::vector<double> FrameReduce(const double *data, size_t frameCount, size_t frameLength, size_t hopLength,
+    Kernel kernel)
+{
+    std::vector<double> frames(frameCount, 0.0);
+    if ((data == nullptr) || (frameLength == 0) || (hopLength == 0)) {
+        return frames;
+    }
+    if (hopLength >= frameLength) {
+        for (size_t i = 0; i < frameCount; ++i) {
+            frames[i] = kernel(data + i * hopLength, frameLength);
+        }
+        return frames;
+    }
+    double accum = 0.0;
+    for (size_t i = 0; i < frameCount; ++i) {
+        const double *frame = data + i * hopLength;
+        if ((i % RESYNC_FRAMES) == 0) {
+            accum = kernel(frame, frameLength);
+        } else {
+            accum += kernel(frame + frameLength - hopLength, hopLength) - kernel(frame - hopLength, hopLength);
+            accum = std::max(accum, 0.0);
+        }
+        frames[i] = accum;
+    }
+    return frames;
+}
+}  // namespace
+
+double SumOfSquares(const double *data, size_t count)
+{
+    DoubleX2 acc0 = { 0.0, 0.0 };
+    DoubleX2 acc1 = { 0.0, 0.0 };
+    size_t i = 0;
+    for (; (i + STEP) <= count; i += STEP) {
+        DoubleX2 v0 = Load(data + i);
+        DoubleX2 v1 = Load(data + i + LANES);
+        acc0 += v0 * v0;
+        acc1 += v1 * v1;
+    }
+    double sum = HorizontalSum(acc0 + acc1);
+    for (; i < count; ++i) {
+        sum += data[i] * data[i];
+    }
+    return sum;
+}
+
+double SumOfAbs(const double *data, size_t count)
+{
+    DoubleX2 acc0 = { 0.0, 0.0 };
+    DoubleX2 acc1 = { 0.0, 0.0 };
+    size_t i = 0;
+    for (; (i + STEP) <= count; i += STEP) {
+        acc0 += Abs(Load(data + i));
+        acc1 += Abs(Load(data + i + LANES));
+    }
+    double sum = HorizontalSum(acc0 + acc1);
+    for (; i < count; ++i) {
+        sum += std::fabs(data[i]);
+    }
+    return sum;
+}
+
+double DotProduct(const double *left, const double *right, size_t count)
+{
+    DoubleX2 acc0 = { 0.0, 0.0 };
+    DoubleX2 acc1 = { 0.0, 0.0 };
+    size_t i = 0;
+    for (; (i + STEP) <= count; i += STEP) {
+        acc0 += Load(left + i) * Load(right + i);
+        acc1 += Load(left + i + LANES) * Load(right + i + LANES);
+    }
+    double sum = HorizontalSum(acc0 + acc1);
+    for (; i < count; ++i) {
+        sum += left[i] * right[i];
+    }
+    return sum;
+}
+
+std::vector<double> FrameSumOfSquares(const double *data, size_t frameCount, size_t frameLength, size_t hopLength)
+{
+    return FrameReduce(data, frameCount, frameLength, hopLength, SumOfSquares);
+}
+
+std::vector<double> FrameSumOfAbs(const double *data, size_t frameCount, size_t frameLength, size_t hopLength)
+{
+    return FrameReduce(data, frameCount, frameLength, hopLength, SumOfAbs);
+}
+}  // namespace Sensors
+}  // namespace OHOS